@@ -34,6 +34,7 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #include <Library/MemoryAllocationLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/KeyMapLib.h>
+#include <Library/PcdLib.h>
 
 
 #define MAX_Q 256
@@ -57,6 +58,24 @@ typedef struct _EMU_GOP_SIMPLE_TEXTIN_EX_NOTIFY {
 
 #define GRAPHICS_OUTPUT_INVALIDE_MODE_NUMBER 0xffff
 
+//
+// When PcdEmuGopShadowBuffer is TRUE, Blt operates on a shadow buffer. The
+// rectangles it changes are sent to the host window every
+// GOP_SHADOW_FLUSH_PERIOD (in 100ns units), and when the window is closed.
+//
+#define GOP_DIRTY_RECT_MAX       8
+#define GOP_SHADOW_FLUSH_PERIOD  (20 * 10000)
+
+//
+// A rectangle of the screen, from (X0, Y0) included to (X1, Y1) excluded.
+//
+typedef struct {
+  UINTN                      X0;
+  UINTN                      Y0;
+  UINTN                      X1;
+  UINTN                      Y1;
+} GOP_RECT;
+
 typedef struct {
   UINT32                     HorizontalResolution;
   UINT32                     VerticalResolution;
@@ -104,6 +123,15 @@ typedef struct {
   EFI_SIMPLE_TEXT_INPUT_EX_PROTOCOL SimpleTextInEx;
   EFI_KEY_STATE                     KeyState;
   LIST_ENTRY                        NotifyList;
+
+  //
+  // Shadow buffer and the rectangles of it not yet sent to the window
+  //
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL     *ShadowBuffer;
+  UINTN                             ShadowBufferSize;
+  GOP_RECT                          DirtyRect[GOP_DIRTY_RECT_MAX];
+  UINTN                             DirtyRectCount;
+  EFI_EVENT                         FlushEvent;
 } GOP_PRIVATE_DATA;
 
 
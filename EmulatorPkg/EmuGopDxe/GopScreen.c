@@ -36,6 +36,263 @@ GOP_MODE_DATA mGopModeData[] = {
     };
 
 
+/**
+  Record that a rectangle of the shadow buffer was changed.
+
+  The rectangle is merged with a dirty rectangle it overlaps or touches. If
+  there is none and all the dirty rectangles are used, it is merged with the
+  dirty rectangle whose area grows least.
+
+  @param  Private      The GOP device.
+  @param  X            The left edge of the changed rectangle.
+  @param  Y            The top edge of the changed rectangle.
+  @param  Width        The width of the changed rectangle.
+  @param  Height       The height of the changed rectangle.
+
+**/
+STATIC
+VOID
+EmuGopAddDirtyRect (
+  IN  GOP_PRIVATE_DATA  *Private,
+  IN  UINTN             X,
+  IN  UINTN             Y,
+  IN  UINTN             Width,
+  IN  UINTN             Height
+  )
+{
+  GOP_RECT  Rect;
+  GOP_RECT  *Dirty;
+  UINTN     Index;
+  UINTN     Best;
+  UINTN     Growth;
+  UINTN     BestGrowth;
+
+  Rect.X0 = X;
+  Rect.Y0 = Y;
+  Rect.X1 = X + Width;
+  Rect.Y1 = Y + Height;
+
+  //
+  // Merge the rectangle with the dirty rectangles it overlaps or touches,
+  // until it is disjoint from all of them.
+  //
+  Index = 0;
+  while (Index < Private->DirtyRectCount) {
+    Dirty = &Private->DirtyRect[Index];
+    if (Rect.X0 <= Dirty->X1 && Dirty->X0 <= Rect.X1 &&
+        Rect.Y0 <= Dirty->Y1 && Dirty->Y0 <= Rect.Y1) {
+      Rect.X0 = MIN (Rect.X0, Dirty->X0);
+      Rect.Y0 = MIN (Rect.Y0, Dirty->Y0);
+      Rect.X1 = MAX (Rect.X1, Dirty->X1);
+      Rect.Y1 = MAX (Rect.Y1, Dirty->Y1);
+      Private->DirtyRectCount--;
+      *Dirty = Private->DirtyRect[Private->DirtyRectCount];
+      Index = 0;
+      continue;
+    }
+    Index++;
+  }
+
+  if (Private->DirtyRectCount < GOP_DIRTY_RECT_MAX) {
+    Private->DirtyRect[Private->DirtyRectCount++] = Rect;
+    return;
+  }
+
+  Best       = 0;
+  BestGrowth = MAX_UINTN;
+  for (Index = 0; Index < GOP_DIRTY_RECT_MAX; Index++) {
+    Dirty  = &Private->DirtyRect[Index];
+    Growth = (MAX (Rect.X1, Dirty->X1) - MIN (Rect.X0, Dirty->X0)) *
+             (MAX (Rect.Y1, Dirty->Y1) - MIN (Rect.Y0, Dirty->Y0)) -
+             (Dirty->X1 - Dirty->X0) * (Dirty->Y1 - Dirty->Y0);
+    if (Growth < BestGrowth) {
+      Best       = Index;
+      BestGrowth = Growth;
+    }
+  }
+
+  Dirty     = &Private->DirtyRect[Best];
+  Dirty->X0 = MIN (Rect.X0, Dirty->X0);
+  Dirty->Y0 = MIN (Rect.Y0, Dirty->Y0);
+  Dirty->X1 = MAX (Rect.X1, Dirty->X1);
+  Dirty->Y1 = MAX (Rect.Y1, Dirty->Y1);
+}
+
+
+/**
+  Send the dirty rectangles of the shadow buffer to the host window, one Blt
+  per rectangle.
+
+  The caller must be at TPL_NOTIFY, as Blt is.
+
+  @param  Private      The GOP device.
+
+**/
+STATIC
+VOID
+EmuGopFlushShadowBuffer (
+  IN  GOP_PRIVATE_DATA  *Private
+  )
+{
+  EMU_GRAPHICS_WINDOWS__BLT_ARGS  GopBltArgs;
+  GOP_RECT                        *Dirty;
+  UINTN                           Index;
+
+  if (Private->ShadowBuffer == NULL || Private->EmuGraphicsWindow == NULL) {
+    return;
+  }
+
+  for (Index = 0; Index < Private->DirtyRectCount; Index++) {
+    Dirty = &Private->DirtyRect[Index];
+    GopBltArgs.SourceX      = Dirty->X0;
+    GopBltArgs.SourceY      = Dirty->Y0;
+    GopBltArgs.DestinationX = Dirty->X0;
+    GopBltArgs.DestinationY = Dirty->Y0;
+    GopBltArgs.Width        = Dirty->X1 - Dirty->X0;
+    GopBltArgs.Height       = Dirty->Y1 - Dirty->Y0;
+    GopBltArgs.Delta        = Private->GraphicsOutput.Mode->Info->HorizontalResolution * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL);
+    Private->EmuGraphicsWindow->Blt (
+                                  Private->EmuGraphicsWindow,
+                                  (EFI_UGA_PIXEL *) Private->ShadowBuffer,
+                                  EfiUgaBltBufferToVideo,
+                                  &GopBltArgs
+                                  );
+  }
+
+  Private->DirtyRectCount = 0;
+}
+
+
+/**
+  Periodic timer notification function sending the dirty rectangles of the
+  shadow buffer to the host window.
+
+  @param  Event        The periodic timer event.
+  @param  Context      The GOP device.
+
+**/
+STATIC
+VOID
+EFIAPI
+EmuGopFlushShadowBufferEvent (
+  IN  EFI_EVENT  Event,
+  IN  VOID       *Context
+  )
+{
+  EFI_TPL  OriginalTPL;
+
+  OriginalTPL = gBS->RaiseTPL (TPL_NOTIFY);
+  EmuGopFlushShadowBuffer (Context);
+  gBS->RestoreTPL (OriginalTPL);
+}
+
+
+/**
+  Perform a Blt operation on the shadow buffer.
+
+  @param  Private      The GOP device.
+  @param  BltBuffer    Buffer containing data to blit into video buffer.
+  @param  BltOperation Operation to perform on BlitBuffer and video memory
+  @param  SourceX      X coordinate of source for the BltBuffer.
+  @param  SourceY      Y coordinate of source for the BltBuffer.
+  @param  DestinationX X coordinate of destination for the BltBuffer.
+  @param  DestinationY Y coordinate of destination for the BltBuffer.
+  @param  Width        Width of rectangle in BltBuffer in pixels.
+  @param  Height       Hight of rectangle in BltBuffer in pixels.
+  @param  Delta        The number of bytes in a row of BltBuffer.
+
+  @retval EFI_SUCCESS           The Blt operation completed.
+  @retval EFI_INVALID_PARAMETER A rectangle is outside of the screen.
+
+**/
+STATIC
+EFI_STATUS
+EmuGopShadowBlt (
+  IN  GOP_PRIVATE_DATA                        *Private,
+  IN  EFI_GRAPHICS_OUTPUT_BLT_PIXEL           *BltBuffer,   OPTIONAL
+  IN  EFI_GRAPHICS_OUTPUT_BLT_OPERATION       BltOperation,
+  IN  UINTN                                   SourceX,
+  IN  UINTN                                   SourceY,
+  IN  UINTN                                   DestinationX,
+  IN  UINTN                                   DestinationY,
+  IN  UINTN                                   Width,
+  IN  UINTN                                   Height,
+  IN  UINTN                                   Delta
+  )
+{
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *Screen;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *Source;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *Destination;
+  UINTN                          ScreenWidth;
+  UINTN                          ScreenHeight;
+  UINTN                          Index;
+  UINTN                          Row;
+
+  Screen       = Private->ShadowBuffer;
+  ScreenWidth  = Private->GraphicsOutput.Mode->Info->HorizontalResolution;
+  ScreenHeight = Private->GraphicsOutput.Mode->Info->VerticalResolution;
+
+  if (BltOperation == EfiBltVideoToBltBuffer || BltOperation == EfiBltVideoToVideo) {
+    if (SourceX + Width > ScreenWidth || SourceY + Height > ScreenHeight) {
+      return EFI_INVALID_PARAMETER;
+    }
+  }
+  if (BltOperation != EfiBltVideoToBltBuffer) {
+    if (DestinationX + Width > ScreenWidth || DestinationY + Height > ScreenHeight) {
+      return EFI_INVALID_PARAMETER;
+    }
+  }
+
+  switch (BltOperation) {
+  case EfiBltVideoFill:
+    Destination = Screen + DestinationY * ScreenWidth + DestinationX;
+    for (Index = 0; Index < Width; Index++) {
+      Destination[Index] = *BltBuffer;
+    }
+    for (Row = 1; Row < Height; Row++) {
+      CopyMem (Destination + Row * ScreenWidth, Destination, Width * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL));
+    }
+    break;
+
+  case EfiBltVideoToBltBuffer:
+    for (Row = 0; Row < Height; Row++) {
+      Source      = Screen + (SourceY + Row) * ScreenWidth + SourceX;
+      Destination = (EFI_GRAPHICS_OUTPUT_BLT_PIXEL *) ((UINT8 *) BltBuffer + (DestinationY + Row) * Delta) + DestinationX;
+      CopyMem (Destination, Source, Width * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL));
+    }
+    break;
+
+  case EfiBltBufferToVideo:
+    for (Row = 0; Row < Height; Row++) {
+      Source      = (EFI_GRAPHICS_OUTPUT_BLT_PIXEL *) ((UINT8 *) BltBuffer + (SourceY + Row) * Delta) + SourceX;
+      Destination = Screen + (DestinationY + Row) * ScreenWidth + DestinationX;
+      CopyMem (Destination, Source, Width * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL));
+    }
+    break;
+
+  case EfiBltVideoToVideo:
+    //
+    // Copy the rows in the order that does not overwrite the source rows
+    // not yet copied when the rectangles overlap.
+    //
+    for (Index = 0; Index < Height; Index++) {
+      Row = (DestinationY > SourceY) ? (Height - 1 - Index) : Index;
+      CopyMem (
+        Screen + (DestinationY + Row) * ScreenWidth + DestinationX,
+        Screen + (SourceY + Row) * ScreenWidth + SourceX,
+        Width * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL)
+        );
+    }
+    break;
+
+  default:
+    return EFI_INVALID_PARAMETER;
+  }
+
+  return EFI_SUCCESS;
+}
+
+
 /**
   Returns information for an available graphics mode that the graphics device
   and the set of active video output devices supports.
@@ -145,6 +402,24 @@ EmuGopSetMode (
                             ModeData->VerticalResolution
                             );
 
+  //
+  // Size the shadow buffer for the new mode, the pending changes of the
+  // previous mode are lost with it. Without a shadow buffer, Blt is sent to
+  // the window directly.
+  //
+  Private->DirtyRectCount = 0;
+  if (Private->FlushEvent != NULL &&
+      Private->ShadowBufferSize != ModeData->HorizontalResolution * ModeData->VerticalResolution * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL)) {
+    if (Private->ShadowBuffer != NULL) {
+      FreePool (Private->ShadowBuffer);
+    }
+    Private->ShadowBufferSize = ModeData->HorizontalResolution * ModeData->VerticalResolution * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL);
+    Private->ShadowBuffer     = AllocatePool (Private->ShadowBufferSize);
+    if (Private->ShadowBuffer == NULL) {
+      Private->ShadowBufferSize = 0;
+    }
+  }
+
 
   Fill.Red                      = 0x7f;
   Fill.Green                    = 0x7F;
@@ -231,6 +506,27 @@ EmuGopBlt (
   //
   OriginalTPL = gBS->RaiseTPL (TPL_NOTIFY);
 
+  if (Private->ShadowBuffer != NULL) {
+    Status = EmuGopShadowBlt (
+               Private,
+               BltBuffer,
+               BltOperation,
+               SourceX,
+               SourceY,
+               DestinationX,
+               DestinationY,
+               Width,
+               Height,
+               Delta
+               );
+    if (!EFI_ERROR (Status) && BltOperation != EfiBltVideoToBltBuffer) {
+      EmuGopAddDirtyRect (Private, DestinationX, DestinationY, Width, Height);
+    }
+
+    gBS->RestoreTPL (OriginalTPL);
+    return Status;
+  }
+
   //
   // Pack UGA Draw protocol parameters to EMU_GRAPHICS_WINDOWS__BLT_ARGS structure to adapt to
   // GopBlt() API of Unix UGA IO protocol.
@@ -320,6 +616,8 @@ EmuGopConstructor (
   GOP_PRIVATE_DATA    *Private
   )
 {
+  EFI_STATUS  Status;
+
   Private->ModeData = mGopModeData;
 
   Private->GraphicsOutput.QueryMode      = EmuGopQuerytMode;
@@ -354,6 +652,27 @@ EmuGopConstructor (
   Private->HardwareNeedsStarting  = TRUE;
   Private->EmuGraphicsWindow                  = NULL;
 
+  Private->ShadowBuffer     = NULL;
+  Private->ShadowBufferSize = 0;
+  Private->DirtyRectCount   = 0;
+  Private->FlushEvent       = NULL;
+  if (FeaturePcdGet (PcdEmuGopShadowBuffer)) {
+    Status = gBS->CreateEvent (
+                    EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                    TPL_CALLBACK,
+                    EmuGopFlushShadowBufferEvent,
+                    Private,
+                    &Private->FlushEvent
+                    );
+    if (!EFI_ERROR (Status)) {
+      Status = gBS->SetTimer (Private->FlushEvent, TimerPeriodic, GOP_SHADOW_FLUSH_PERIOD);
+      if (EFI_ERROR (Status)) {
+        gBS->CloseEvent (Private->FlushEvent);
+        Private->FlushEvent = NULL;
+      }
+    }
+  }
+
   EmuGopInitializeSimpleTextInForWindow (Private);
 
   EmuGopInitializeSimplePointerForWindow (Private);
@@ -368,6 +687,21 @@ EmuGopDestructor (
   GOP_PRIVATE_DATA     *Private
   )
 {
+  EFI_TPL  OriginalTPL;
+
+  if (Private->FlushEvent != NULL) {
+    gBS->CloseEvent (Private->FlushEvent);
+    Private->FlushEvent = NULL;
+  }
+
+  if (Private->ShadowBuffer != NULL) {
+    OriginalTPL = gBS->RaiseTPL (TPL_NOTIFY);
+    EmuGopFlushShadowBuffer (Private);
+    gBS->RestoreTPL (OriginalTPL);
+    FreePool (Private->ShadowBuffer);
+    Private->ShadowBuffer = NULL;
+  }
+
   if (!Private->HardwareNeedsStarting) {
     Private->EmuIoThunk->Close (Private->EmuIoThunk);
     Private->EmuGraphicsWindow = NULL;
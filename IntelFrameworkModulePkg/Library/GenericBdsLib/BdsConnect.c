@@ -202,6 +202,129 @@ BdsLibConnectDevicePath (
   return Status;
 }
 
+/**
+  Connect the drivers to one controller, measure how long it took and report
+  the controller in the debug log when the time reaches Threshold.
+
+  @param  Controller            The handle of the controller to connect.
+  @param  Recursive             Whether the child controllers are connected as well.
+  @param  Threshold             The connect time in milliseconds from which the
+                                controller is reported.
+
+  @return The status returned by gBS->ConnectController().
+
+**/
+EFI_STATUS
+BdsLibConnectControllerTimed (
+  IN EFI_HANDLE                 Controller,
+  IN BOOLEAN                    Recursive,
+  IN UINT32                     Threshold
+  )
+{
+  EFI_STATUS                Status;
+  UINT64                    Begin;
+  UINT64                    End;
+  UINT64                    StartValue;
+  UINT64                    EndValue;
+  UINT64                    Ticks;
+  UINT64                    Elapsed;
+  EFI_DEVICE_PATH_PROTOCOL  *DevicePath;
+  CHAR16                    *DevicePathStr;
+
+  Begin  = GetPerformanceCounter ();
+  Status = gBS->ConnectController (Controller, NULL, NULL, Recursive);
+  End    = GetPerformanceCounter ();
+
+  //
+  // Take the counter wrapping around into account, in either counting direction.
+  //
+  GetPerformanceCounterProperties (&StartValue, &EndValue);
+  if (EndValue >= StartValue) {
+    Ticks = (End >= Begin) ? (End - Begin) : ((EndValue - Begin) + (End - StartValue));
+  } else {
+    Ticks = (Begin >= End) ? (Begin - End) : ((Begin - EndValue) + (StartValue - End));
+  }
+  Elapsed = DivU64x32 (GetTimeInNanoSecond (Ticks), 1000000);
+
+  if (Elapsed >= Threshold) {
+    DevicePath    = DevicePathFromHandle (Controller);
+    DevicePathStr = NULL;
+    if (DevicePath != NULL) {
+      DevicePathStr = DevicePathToStr (DevicePath);
+    }
+    DEBUG ((
+      EFI_D_INFO,
+      "[Bds] Connect %6ld ms %r %s\n",
+      Elapsed,
+      Status,
+      (DevicePathStr != NULL) ? DevicePathStr : L"<no device path>"
+      ));
+    if (DevicePathStr != NULL) {
+      FreePool (DevicePathStr);
+    }
+  }
+
+  return Status;
+}
+
+/**
+  Connect all current system handles level by level, reporting every controller
+  whose own connect time reaches Threshold.
+
+  Each pass connects the drivers to every handle without recursion, so the time
+  measured for a controller does not include its children. The children show
+  up as new handles and are connected by the next pass, until a pass produces
+  no new handle.
+
+  @param  Threshold             The connect time in milliseconds from which a
+                                controller is reported.
+
+  @retval EFI_SUCCESS           All handles and their child handles have been connected.
+  @retval EFI_STATUS            Error status returned by of gBS->LocateHandleBuffer().
+
+**/
+EFI_STATUS
+BdsLibConnectAllEfiTimed (
+  IN UINT32                     Threshold
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       HandleCount;
+  UINTN       PreviousHandleCount;
+  EFI_HANDLE  *HandleBuffer;
+  UINTN       Index;
+  UINTN       Pass;
+
+  PreviousHandleCount = 0;
+  for (Pass = 0; ; Pass++) {
+    Status = gBS->LocateHandleBuffer (
+                    AllHandles,
+                    NULL,
+                    NULL,
+                    &HandleCount,
+                    &HandleBuffer
+                    );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    if ((Pass != 0) && (HandleCount <= PreviousHandleCount)) {
+      FreePool (HandleBuffer);
+      break;
+    }
+
+    DEBUG ((EFI_D_INFO, "[Bds] Connect pass %d: %d handles\n", Pass, HandleCount));
+    for (Index = 0; Index < HandleCount; Index++) {
+      BdsLibConnectControllerTimed (HandleBuffer[Index], FALSE, Threshold);
+    }
+
+    FreePool (HandleBuffer);
+    PreviousHandleCount = HandleCount;
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   This function will connect all current system handles recursively. 
   
@@ -223,6 +346,12 @@ BdsLibConnectAllEfi (
   UINTN       HandleCount;
   EFI_HANDLE  *HandleBuffer;
   UINTN       Index;
+  UINT32      Threshold;
+
+  Threshold = PcdGet32 (PcdBdsConnectReportThreshold);
+  if (Threshold != 0) {
+    return BdsLibConnectAllEfiTimed (Threshold);
+  }
 
   Status = gBS->LocateHandleBuffer (
                   AllHandles,
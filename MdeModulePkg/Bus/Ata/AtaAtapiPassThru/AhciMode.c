@@ -1079,6 +1079,373 @@ Exit:
   return Status;
 }
 
+/**
+  Start a native command queuing (FPDMA QUEUED) data transfer on specific port.
+
+  Unlike AhciDmaTransfer(), the command is built in a free command slot and the
+  port is kept running after the command is issued, so up to the queue depth of
+  the device commands can be outstanding at the same time. It is only used by
+  non-blocking mode: the first call issues the command and the following calls
+  check PxSACT and PxCI for its completion.
+
+  @param[in]       Instance            The ATA_ATAPI_PASS_THRU_INSTANCE protocol instance.
+  @param[in]       AhciRegisters       The pointer to the EFI_AHCI_REGISTERS.
+  @param[in]       Port                The number of port.
+  @param[in]       PortMultiplier      The number of port multiplier.
+  @param[in]       Read                The transfer direction.
+  @param[in]       AtaCommandBlock     The EFI_ATA_COMMAND_BLOCK data.
+  @param[in, out]  AtaStatusBlock      The EFI_ATA_STATUS_BLOCK data.
+  @param[in, out]  MemoryAddr          The pointer to the data buffer.
+  @param[in]       DataCount           The data count to be transferred.
+  @param[in]       Timeout             The timeout value of data transfer, uses 100ns as a unit.
+  @param[in]       Task                Pointer to the ATA_NONBLOCK_TASK used by
+                                       non-blocking mode.
+
+  @retval EFI_NOT_READY       The command is waiting for a free slot or is not
+                              completed yet.
+  @retval EFI_DEVICE_ERROR    The data transfer abort with error occurs.
+  @retval EFI_TIMEOUT         The operation is time out.
+  @retval EFI_UNSUPPORTED     Native command queuing is not available.
+  @retval EFI_SUCCESS         The data transfer executes successfully.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciNcqTransfer (
+  IN     ATA_ATAPI_PASS_THRU_INSTANCE *Instance,
+  IN     EFI_AHCI_REGISTERS           *AhciRegisters,
+  IN     UINT8                        Port,
+  IN     UINT8                        PortMultiplier,
+  IN     BOOLEAN                      Read,
+  IN     EFI_ATA_COMMAND_BLOCK        *AtaCommandBlock,
+  IN OUT EFI_ATA_STATUS_BLOCK         *AtaStatusBlock,
+  IN OUT VOID                         *MemoryAddr,
+  IN     UINT32                       DataCount,
+  IN     UINT64                       Timeout,
+  IN     ATA_NONBLOCK_TASK            *Task
+  )
+{
+  EFI_STATUS                    Status;
+  EFI_PCI_IO_PROTOCOL           *PciIo;
+  LIST_ENTRY                    *Node;
+  EFI_ATA_DEVICE_INFO           *DeviceInfo;
+  EFI_PHYSICAL_ADDRESS          PhyAddr;
+  VOID                          *Map;
+  UINTN                         MapLength;
+  EFI_PCI_IO_PROTOCOL_OPERATION Flag;
+  EFI_AHCI_COMMAND_FIS          CFis;
+  EFI_AHCI_NCQ_COMMAND_TABLE    *CommandTable;
+  EFI_AHCI_COMMAND_LIST         *CommandList;
+  DATA_64                       Data64;
+  UINT32                        PrdtNumber;
+  UINT32                        PrdtIndex;
+  UINTN                         RemainedData;
+  UINTN                         MemAddr;
+  UINT32                        QueueDepth;
+  UINT32                        Outstanding;
+  UINT32                        SlotBitMap;
+  UINT32                        SlotBit;
+  UINT8                         Slot;
+  UINT32                        Offset;
+  UINT32                        PortIs;
+  UINT32                        PortTfd;
+  UINT32                        PortSerr;
+  UINTN                         FisBaseAddr;
+  UINT8                         SdbStatus;
+
+  PciIo       = Instance->PciIo;
+  FisBaseAddr = (UINTN)AhciRegisters->AhciRFis + Port * sizeof (EFI_AHCI_RECEIVED_FIS);
+
+  if ((Task == NULL) || (AhciRegisters->NcqSlotMask == 0)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (!Task->IsStart) {
+    //
+    // Honor the queue depth reported by the device in IDENTIFY word 75.
+    //
+    Node = SearchDeviceInfoList (Instance, Port, PortMultiplier, EfiIdeHarddisk);
+    if (Node == NULL) {
+      return EFI_INVALID_PARAMETER;
+    }
+    DeviceInfo = ATA_ATAPI_DEVICE_INFO_FROM_THIS (Node);
+    QueueDepth = (DeviceInfo->IdentifyData->AtaData.queue_depth & 0x1F) + 1;
+
+    Outstanding = 0;
+    for (SlotBitMap = AhciRegisters->NcqPortSlotBitMap[Port]; SlotBitMap != 0; SlotBitMap &= SlotBitMap - 1) {
+      Outstanding++;
+    }
+
+    SlotBitMap = AhciRegisters->NcqSlotMask & ~AhciRegisters->NcqSlotBitMap;
+    if ((SlotBitMap == 0) || (Outstanding >= QueueDepth)) {
+      //
+      // All slots are busy. Try again when one of the queued commands completes.
+      //
+      return EFI_NOT_READY;
+    }
+
+    Slot    = (UINT8) LowBitSet32 (SlotBitMap);
+    SlotBit = (UINT32) (1 << Slot);
+
+    if (Read) {
+      Flag = EfiPciIoOperationBusMasterWrite;
+    } else {
+      Flag = EfiPciIoOperationBusMasterRead;
+    }
+
+    MapLength = DataCount;
+    Status = PciIo->Map (
+                      PciIo,
+                      Flag,
+                      MemoryAddr,
+                      &MapLength,
+                      &PhyAddr,
+                      &Map
+                      );
+
+    if (EFI_ERROR (Status) || (DataCount != MapLength)) {
+      return EFI_BAD_BUFFER_SIZE;
+    }
+
+    //
+    // The tag of a FPDMA QUEUED command is carried in bits 7:3 of the sector
+    // count field. The sector count itself is put in the feature field by caller.
+    //
+    AhciBuildCommandFis (&CFis, AtaCommandBlock);
+    CFis.AhciCFisSecCount = (UINT8) (Slot << 3);
+    CFis.AhciCFisDevHead  = BIT6;
+    CFis.AhciCFisPmNum    = PortMultiplier;
+
+    CommandTable = &AhciRegisters->AhciNcqCommandTable[Slot];
+    ZeroMem (CommandTable, sizeof (EFI_AHCI_NCQ_COMMAND_TABLE));
+    CopyMem (&CommandTable->CommandFis, &CFis, sizeof (EFI_AHCI_COMMAND_FIS));
+
+    PrdtNumber = (UINT32)DivU64x32 (((UINT64)DataCount + EFI_AHCI_MAX_DATA_PER_PRDT - 1), EFI_AHCI_MAX_DATA_PER_PRDT);
+    ASSERT (PrdtNumber <= EFI_AHCI_NCQ_MAX_PRDT);
+
+    RemainedData = (UINTN) DataCount;
+    MemAddr      = (UINTN) PhyAddr;
+    for (PrdtIndex = 0; PrdtIndex < PrdtNumber; PrdtIndex++) {
+      if (RemainedData < EFI_AHCI_MAX_DATA_PER_PRDT) {
+        CommandTable->PrdtTable[PrdtIndex].AhciPrdtDbc = (UINT32)RemainedData - 1;
+      } else {
+        CommandTable->PrdtTable[PrdtIndex].AhciPrdtDbc = EFI_AHCI_MAX_DATA_PER_PRDT - 1;
+      }
+
+      Data64.Uint64 = (UINT64)MemAddr;
+      CommandTable->PrdtTable[PrdtIndex].AhciPrdtDba  = Data64.Uint32.Lower32;
+      CommandTable->PrdtTable[PrdtIndex].AhciPrdtDbau = Data64.Uint32.Upper32;
+      RemainedData -= EFI_AHCI_MAX_DATA_PER_PRDT;
+      MemAddr      += EFI_AHCI_MAX_DATA_PER_PRDT;
+    }
+
+    if (PrdtNumber > 0) {
+      CommandTable->PrdtTable[PrdtNumber - 1].AhciPrdtIoc = 1;
+    }
+
+    CommandList = &AhciRegisters->AhciCmdList[Slot];
+    ZeroMem (CommandList, sizeof (EFI_AHCI_COMMAND_LIST));
+    CommandList->AhciCmdCfl   = EFI_AHCI_FIS_REGISTER_H2D_LENGTH / 4;
+    CommandList->AhciCmdW     = Read ? 0 : 1;
+    CommandList->AhciCmdPrdtl = PrdtNumber;
+    CommandList->AhciCmdPmp   = PortMultiplier;
+
+    Data64.Uint64 = (UINT64)(UINTN) &AhciRegisters->AhciNcqCommandTablePciAddr[Slot];
+    CommandList->AhciCmdCtba  = Data64.Uint32.Lower32;
+    CommandList->AhciCmdCtbau = Data64.Uint32.Upper32;
+
+    Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CMD;
+    if ((AhciRegisters->NcqPortSlotBitMap[Port] == 0) ||
+        ((AhciReadReg (PciIo, Offset) & EFI_AHCI_PORT_CMD_ST) == 0)) {
+      //
+      // No queued command is outstanding on this port, so it is safe to clear
+      // the port status and the last Set Device Bits FIS, and start the command
+      // list running.
+      //
+      ZeroMem ((VOID *) (FisBaseAddr + EFI_AHCI_SDB_FIS_OFFSET), EFI_AHCI_U_FIS_OFFSET - EFI_AHCI_SDB_FIS_OFFSET);
+      Status = AhciStartCommand (
+                 PciIo,
+                 Port,
+                 Slot,
+                 Timeout
+                 );
+      if (EFI_ERROR (Status)) {
+        PciIo->Unmap (PciIo, Map);
+        return Status;
+      }
+    } else {
+      //
+      // PxSACT and PxCI are write-1-to-set, so the other queued commands are
+      // not disturbed. PxSACT must be set before PxCI per AHCI 1.3 spec 5.6.4.
+      //
+      Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_SACT;
+      AhciWriteReg (PciIo, Offset, SlotBit);
+      Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CI;
+      AhciWriteReg (PciIo, Offset, SlotBit);
+    }
+
+    AhciRegisters->NcqSlotBitMap           |= SlotBit;
+    AhciRegisters->NcqPortSlotBitMap[Port] |= SlotBit;
+
+    Task->IsStart = TRUE;
+    Task->Map     = Map;
+    Task->NcqSlot = Slot;
+    return EFI_NOT_READY;
+  }
+
+  //
+  // Check whether the queued command is completed. The device clears the
+  // PxSACT bit of the tag through a Set Device Bits FIS. A command aborted by
+  // an error also leaves PxSACT and PxCI, so the error status of the port and
+  // of the Set Device Bits FIS is checked first.
+  //
+  SlotBit   = (UINT32) (1 << Task->NcqSlot);
+  if ((AhciRegisters->NcqPortSlotBitMap[Port] & SlotBit) == 0) {
+    //
+    // The slot was taken back when the port was stopped, and may already be
+    // used by a command of another port.
+    //
+    if (Task->Map != NULL) {
+      PciIo->Unmap (PciIo, Task->Map);
+      Task->Map = NULL;
+    }
+    Task->Packet->Asb->AtaStatus = 0x01;
+    return EFI_DEVICE_ERROR;
+  }
+
+  Offset    = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_IS;
+  PortIs    = AhciReadReg (PciIo, Offset);
+  Offset    = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_TFD;
+  PortTfd   = AhciReadReg (PciIo, Offset);
+  Offset    = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_SERR;
+  PortSerr  = AhciReadReg (PciIo, Offset);
+  SdbStatus = ((UINT8 *) (FisBaseAddr + EFI_AHCI_SDB_FIS_OFFSET))[2];
+
+  if (((PortIs & (EFI_AHCI_PORT_IS_TFES | EFI_AHCI_PORT_IS_HBFS | EFI_AHCI_PORT_IS_HBDS | EFI_AHCI_PORT_IS_IFS)) != 0) ||
+      ((PortTfd & EFI_AHCI_PORT_TFD_ERR) != 0) ||
+      ((PortSerr & EFI_AHCI_PORT_SERR_ERR_MASK) != 0) ||
+      ((SdbStatus & ATA_STSREG_ERR) != 0)) {
+    Status = EFI_DEVICE_ERROR;
+  } else {
+    Offset     = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_SACT;
+    SlotBitMap = AhciReadReg (PciIo, Offset);
+    Offset     = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CI;
+    SlotBitMap |= AhciReadReg (PciIo, Offset);
+
+    if ((SlotBitMap & SlotBit) == 0) {
+      Status = EFI_SUCCESS;
+    } else {
+      Task->RetryTimes--;
+      if (Task->InfiniteWait || (Task->RetryTimes != 0)) {
+        return EFI_NOT_READY;
+      }
+      Status = EFI_TIMEOUT;
+    }
+  }
+
+  AhciRegisters->NcqSlotBitMap           &= ~SlotBit;
+  AhciRegisters->NcqPortSlotBitMap[Port] &= ~SlotBit;
+
+  PciIo->Unmap (PciIo, Task->Map);
+  Task->Map = NULL;
+
+  if (EFI_ERROR (Status)) {
+    //
+    // An error on one queued command aborts all the others on the port. Stop
+    // the port and fail the other queued tasks of the port.
+    //
+    AhciNcqStopPort (Instance, AhciRegisters, Port);
+    Task->Packet->Asb->AtaStatus = 0x01;
+  } else if (AhciRegisters->NcqPortSlotBitMap[Port] == 0) {
+    AhciStopCommand (
+      PciIo,
+      Port,
+      Timeout
+      );
+
+    AhciDisableFisReceive (
+      PciIo,
+      Port,
+      Timeout
+      );
+  }
+
+  AhciDumpPortStatus (PciIo, Port, AtaStatusBlock);
+  return Status;
+}
+
+/**
+  Stop the specific port and give back all command slots used by native command
+  queuing on it. Any command still queued on the port is aborted: its task is
+  removed from the non-blocking task list and its event is signaled with an
+  error status.
+
+  @param[in]  Instance        The ATA_ATAPI_PASS_THRU_INSTANCE protocol instance.
+  @param[in]  AhciRegisters   The pointer to the EFI_AHCI_REGISTERS.
+  @param[in]  Port            The number of port.
+
+**/
+VOID
+EFIAPI
+AhciNcqStopPort (
+  IN     ATA_ATAPI_PASS_THRU_INSTANCE *Instance,
+  IN     EFI_AHCI_REGISTERS           *AhciRegisters,
+  IN     UINT8                        Port
+  )
+{
+  EFI_PCI_IO_PROTOCOL           *PciIo;
+  LIST_ENTRY                    *Entry;
+  LIST_ENTRY                    *NextEntry;
+  ATA_NONBLOCK_TASK             *Task;
+  EFI_TPL                       OldTpl;
+
+  PciIo = Instance->PciIo;
+
+  //
+  // Stop the DMA of the port before its buffers are unmapped.
+  //
+  AhciStopCommand (
+    PciIo,
+    Port,
+    ATA_ATAPI_TIMEOUT
+    );
+
+  AhciDisableFisReceive (
+    PciIo,
+    Port,
+    ATA_ATAPI_TIMEOUT
+    );
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  for (Entry = GetFirstNode (&Instance->NonBlockingTaskList);
+       !IsNull (&Instance->NonBlockingTaskList, Entry);
+       Entry = NextEntry) {
+    NextEntry = GetNextNode (&Instance->NonBlockingTaskList, Entry);
+    Task      = ATA_NON_BLOCK_TASK_FROM_ENTRY (Entry);
+
+    //
+    // The task which reported the error has already been unmapped, it is
+    // completed by its caller.
+    //
+    if (!Task->IsStart || (Task->Map == NULL) || (Task->Port != Port) ||
+        (Task->Packet->Protocol != EFI_ATA_PASS_THRU_PROTOCOL_FPDMA)) {
+      continue;
+    }
+
+    PciIo->Unmap (PciIo, Task->Map);
+    Task->Map = NULL;
+
+    RemoveEntryList (Entry);
+    Task->Packet->Asb->AtaStatus = 0x01;
+    gBS->SignalEvent (Task->Event);
+    FreePool (Task);
+  }
+
+  AhciRegisters->NcqSlotBitMap           &= ~AhciRegisters->NcqPortSlotBitMap[Port];
+  AhciRegisters->NcqPortSlotBitMap[Port]  = 0;
+  gBS->RestoreTPL (OldTpl);
+}
+
 /**
   Start a non data transfer on specific port.
 
@@ -1935,6 +2302,92 @@ AhciPacketCommandExecute (
   return Status;
 }
 
+/**
+  Allocate the per-slot command tables used by native command queuing.
+
+  On failure NcqSlotMask is left zero so that FPDMA QUEUED commands are rejected
+  and the caller falls back to the single slot DMA path.
+
+  @param  PciIo                 The PCI IO protocol instance.
+  @param  AhciRegisters         The pointer to the EFI_AHCI_REGISTERS.
+  @param  MaxCommandSlotNumber  The number of command slots per port supported by the HBA.
+  @param  Support64Bit          Whether the HBA supports 64bit addressing.
+
+**/
+VOID
+AhciCreateNcqCommandTable (
+  IN     EFI_PCI_IO_PROTOCOL    *PciIo,
+  IN OUT EFI_AHCI_REGISTERS     *AhciRegisters,
+  IN     UINT8                  MaxCommandSlotNumber,
+  IN     BOOLEAN                Support64Bit
+  )
+{
+  EFI_STATUS            Status;
+  UINTN                 Bytes;
+  VOID                  *Buffer;
+  UINT64                MaxNcqCommandTableSize;
+  EFI_PHYSICAL_ADDRESS  AhciNcqCommandTablePciAddr;
+
+  Buffer                 = NULL;
+  MaxNcqCommandTableSize = MaxCommandSlotNumber * sizeof (EFI_AHCI_NCQ_COMMAND_TABLE);
+
+  Status = PciIo->AllocateBuffer (
+                    PciIo,
+                    AllocateAnyPages,
+                    EfiBootServicesData,
+                    EFI_SIZE_TO_PAGES ((UINTN) MaxNcqCommandTableSize),
+                    &Buffer,
+                    0
+                    );
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  ZeroMem (Buffer, (UINTN)MaxNcqCommandTableSize);
+  Bytes  = (UINTN)MaxNcqCommandTableSize;
+
+  Status = PciIo->Map (
+                    PciIo,
+                    EfiPciIoOperationBusMasterCommonBuffer,
+                    Buffer,
+                    &Bytes,
+                    &AhciNcqCommandTablePciAddr,
+                    &AhciRegisters->MapNcqCommandTable
+                    );
+  if (EFI_ERROR (Status) || (Bytes != MaxNcqCommandTableSize)) {
+    goto Error2;
+  }
+
+  if ((!Support64Bit) && (AhciNcqCommandTablePciAddr > 0x100000000ULL)) {
+    goto Error1;
+  }
+
+  AhciRegisters->AhciNcqCommandTable        = Buffer;
+  AhciRegisters->AhciNcqCommandTablePciAddr = (EFI_AHCI_NCQ_COMMAND_TABLE *)(UINTN)AhciNcqCommandTablePciAddr;
+  AhciRegisters->MaxNcqCommandTableSize     = MaxNcqCommandTableSize;
+  //
+  // Slot 0 is left to the blocking and non-queued commands, which always build
+  // their command there.
+  //
+  AhciRegisters->NcqSlotMask                = ((UINT32) LShiftU64 (1, MaxCommandSlotNumber) - 1) & ~BIT0;
+  AhciRegisters->NcqSlotBitMap              = 0;
+  ZeroMem (AhciRegisters->NcqPortSlotBitMap, sizeof (AhciRegisters->NcqPortSlotBitMap));
+  return;
+
+Error1:
+  PciIo->Unmap (
+           PciIo,
+           AhciRegisters->MapNcqCommandTable
+           );
+Error2:
+  PciIo->FreeBuffer (
+           PciIo,
+           EFI_SIZE_TO_PAGES ((UINTN) MaxNcqCommandTableSize),
+           Buffer
+           );
+  AhciRegisters->MapNcqCommandTable = NULL;
+}
+
 /**
   Allocate transfer-related data struct which is used at AHCI mode.
 
@@ -1973,7 +2426,7 @@ AhciCreateTransferDescriptor (
   //
   // Get the number of command slots per port supported by this HBA.
   //
-  MaxCommandSlotNumber = (UINT8) (((Capability & 0x1F00) >> 8) + 1);
+  MaxCommandSlotNumber = (UINT8) (((Capability & EFI_AHCI_CAP_NCS_MASK) >> 8) + 1);
   Support64Bit         = (BOOLEAN) (((Capability & BIT31) != 0) ? TRUE : FALSE);
   
   PortImplementBitMap  = AhciReadReg(PciIo, EFI_AHCI_PI_OFFSET);
@@ -2142,6 +2595,14 @@ AhciCreateTransferDescriptor (
   }
   AhciRegisters->AhciCommandTablePciAddr = (EFI_AHCI_COMMAND_TABLE *)(UINTN)AhciCommandTablePciAddr;
 
+  //
+  // Allocate one small command table per command slot for native command queuing.
+  // NCQ is an optional optimization, so a failure here only leaves it disabled.
+  //
+  if ((Capability & EFI_AHCI_CAP_SNCQ) != 0) {
+    AhciCreateNcqCommandTable (PciIo, AhciRegisters, MaxCommandSlotNumber, Support64Bit);
+  }
+
   return EFI_SUCCESS;
   //
   // Map error or unable to map the whole CmdList buffer into a contiguous region.
@@ -17,7 +17,9 @@
 #define EFI_AHCI_BAR_INDEX                     0x05
 
 #define EFI_AHCI_CAPABILITY_OFFSET             0x0000
+#define   EFI_AHCI_CAP_NCS_MASK                0x1F00
 #define   EFI_AHCI_CAP_SSS                     BIT27
+#define   EFI_AHCI_CAP_SNCQ                    BIT30
 #define   EFI_AHCI_CAP_S64A                    BIT31
 #define EFI_AHCI_GHC_OFFSET                    0x0004
 #define   EFI_AHCI_GHC_RESET                   BIT0
@@ -61,6 +63,13 @@ typedef union {
 //
 #define EFI_AHCI_MAX_DATA_PER_PRDT             0x400000
 
+//
+// Each NCQ command slot owns a small command table. 8 PRDT entries cover the
+// largest FPDMA QUEUED transfer (65536 sectors) and keep the table size a
+// multiple of the 128 bytes alignment required by AHCI 1.3 spec.
+//
+#define EFI_AHCI_NCQ_MAX_PRDT                  8
+
 #define EFI_AHCI_FIS_REGISTER_H2D              0x27      //Register FIS - Host to Device
 #define   EFI_AHCI_FIS_REGISTER_H2D_LENGTH     20 
 #define EFI_AHCI_FIS_REGISTER_D2H              0x34      //Register FIS - Device to Host
@@ -174,6 +183,9 @@ typedef union {
 #define   EFI_AHCI_PORT_SERR_HE                BIT22
 #define   EFI_AHCI_PORT_SERR_LSE               BIT23
 #define   EFI_AHCI_PORT_SERR_TSTE              BIT24
+#define   EFI_AHCI_PORT_SERR_ERR_MASK          (EFI_AHCI_PORT_SERR_RDIE | EFI_AHCI_PORT_SERR_RCE | \
+                                                EFI_AHCI_PORT_SERR_TDIE | EFI_AHCI_PORT_SERR_PCDIE | \
+                                                EFI_AHCI_PORT_SERR_PE | EFI_AHCI_PORT_SERR_IE)
 #define   EFI_AHCI_PORT_SERR_UFT               BIT25
 #define   EFI_AHCI_PORT_SERR_EX                BIT26
 #define   EFI_AHCI_PORT_ERR_CLEAR              0xFFFFFFFF
@@ -266,6 +278,17 @@ typedef struct {
   EFI_AHCI_COMMAND_PRDT     PrdtTable[65535];     // The scatter/gather list for data transfer
 } EFI_AHCI_COMMAND_TABLE;
 
+//
+// Command table used by a native command queuing slot. It has the same layout
+// as EFI_AHCI_COMMAND_TABLE but only a limited scatter/gather list.
+//
+typedef struct {
+  EFI_AHCI_COMMAND_FIS      CommandFis;       // A software constructed FIS.
+  EFI_AHCI_ATAPI_COMMAND    AtapiCmd;         // 12 or 16 bytes ATAPI cmd.
+  UINT8                     Reserved[0x30];
+  EFI_AHCI_COMMAND_PRDT     PrdtTable[EFI_AHCI_NCQ_MAX_PRDT];
+} EFI_AHCI_NCQ_COMMAND_TABLE;
+
 //
 // Received FIS structure
 //
@@ -296,6 +319,18 @@ typedef struct {
   VOID                      *MapRFis;
   VOID                      *MapCmdList;
   VOID                      *MapCommandTable;
+  //
+  // For native command queuing. The command list is shared by all ports, so
+  // a slot is owned by one port at a time. NcqSlotBitMap records the slots in
+  // use and NcqPortSlotBitMap[] records the slots issued on each port.
+  //
+  EFI_AHCI_NCQ_COMMAND_TABLE *AhciNcqCommandTable;
+  EFI_AHCI_NCQ_COMMAND_TABLE *AhciNcqCommandTablePciAddr;
+  UINT64                    MaxNcqCommandTableSize;
+  VOID                      *MapNcqCommandTable;
+  UINT32                    NcqSlotMask;
+  UINT32                    NcqSlotBitMap;
+  UINT32                    NcqPortSlotBitMap[EFI_AHCI_MAX_PORTS];
 } EFI_AHCI_REGISTERS;
 
 /**
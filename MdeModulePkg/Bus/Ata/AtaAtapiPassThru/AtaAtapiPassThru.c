@@ -189,6 +189,7 @@ AtaPassThruPassThruExecute (
   EFI_ATA_PASS_THRU_CMD_PROTOCOL  Protocol;
   EFI_ATA_HC_WORK_MODE            Mode;
   EFI_STATUS                      Status;
+  BOOLEAN                         Read;
 
   Protocol = Packet->Protocol;
 
@@ -355,6 +356,22 @@ AtaPassThruPassThruExecute (
                      Task
                      );
           break;
+        case EFI_ATA_PASS_THRU_PROTOCOL_FPDMA:
+          Read   = (BOOLEAN) (Packet->Acb->AtaCommand != ATA_CMD_WRITE_FPDMA_QUEUED);
+          Status = AhciNcqTransfer (
+                     Instance,
+                     &Instance->AhciRegisters,
+                     (UINT8)Port,
+                     (UINT8)PortMultiplierPort,
+                     Read,
+                     Packet->Acb,
+                     Packet->Asb,
+                     Read ? Packet->InDataBuffer : Packet->OutDataBuffer,
+                     Read ? Packet->InTransferLength : Packet->OutTransferLength,
+                     Packet->Timeout,
+                     Task
+                     );
+          break;
         default :
           return EFI_UNSUPPORTED;
       }
@@ -384,23 +401,39 @@ AsyncNonBlockingTransferRoutine (
   )
 {
   LIST_ENTRY                   *Entry;
+  LIST_ENTRY                   *NextEntry;
   LIST_ENTRY                   *EntryHeader;
   ATA_NONBLOCK_TASK            *Task;
   EFI_STATUS                   Status;
   ATA_ATAPI_PASS_THRU_INSTANCE *Instance;
+  BOOLEAN                      IsQueued;
 
   Instance   = (ATA_ATAPI_PASS_THRU_INSTANCE *) Context;
   EntryHeader = &Instance->NonBlockingTaskList;
+
+  //
+  // A blocking command is in progress and owns command slot 0.
+  //
+  if ((Event != NULL) && (Instance->BlockingCommandCount != 0)) {
+    return;
+  }
+
   //
   // Get the Taks from the Taks List and execute it, until there is
   // no task in the list or the device is busy with task (EFI_NOT_READY).
   //
-  while (TRUE) {
-    if (!IsListEmpty (EntryHeader)) {
-      Entry = GetFirstNode (EntryHeader);
-      Task  = ATA_NON_BLOCK_TASK_FROM_ENTRY (Entry);
-    } else {
-      return;
+  // FPDMA QUEUED tasks don't block the tasks behind them, so the following
+  // FPDMA QUEUED tasks are issued into the free command slots. Any other task
+  // is only executed once it reaches the head of the list, that is after all
+  // the queued commands in front of it are completed.
+  //
+  for (Entry = GetFirstNode (EntryHeader); !IsNull (EntryHeader, Entry); Entry = NextEntry) {
+    NextEntry = GetNextNode (EntryHeader, Entry);
+    Task      = ATA_NON_BLOCK_TASK_FROM_ENTRY (Entry);
+    IsQueued  = (BOOLEAN) (Task->Packet->Protocol == EFI_ATA_PASS_THRU_PROTOCOL_FPDMA);
+
+    if (!IsQueued && (Entry != GetFirstNode (EntryHeader))) {
+      break;
     }
 
     Status = AtaPassThruPassThruExecute (
@@ -425,7 +458,9 @@ AsyncNonBlockingTransferRoutine (
     // is not finished yet. Otherwise the operation is successful.
     //
     if (Status == EFI_NOT_READY) {
-      break;
+      if (!IsQueued) {
+        break;
+      }
     } else {
       RemoveEntryList (&Task->Link);
       gBS->SignalEvent (Task->Event);
@@ -434,6 +469,41 @@ AsyncNonBlockingTransferRoutine (
   }
 }
 
+/**
+  Complete all the non-blocking tasks before a blocking command is executed,
+  and keep the timer from starting new ones until the blocking command ends.
+
+  The blocking commands are built in command slot 0 and stop the port when
+  they are done, which would abort the commands queued on the port. The
+  caller must decrement Instance->BlockingCommandCount when the blocking
+  command is done.
+
+  @param[in]  Instance    The ATA_ATAPI_PASS_THRU_INSTANCE protocol instance.
+
+**/
+VOID
+AtaPassThruDrainNonBlockingTasks (
+  IN ATA_ATAPI_PASS_THRU_INSTANCE  *Instance
+  )
+{
+  EFI_TPL  OldTpl;
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+  while (!IsListEmpty (&Instance->NonBlockingTaskList)) {
+    AsyncNonBlockingTransferRoutine (NULL, Instance);
+
+    //
+    // Wait for one period of the timer, the tasks count their retries in it.
+    //
+    MicroSecondDelay (1000);
+  }
+
+  Instance->BlockingCommandCount++;
+
+  gBS->RestoreTPL (OldTpl);
+}
+
 /**
   The Entry Point of module.
 
@@ -912,6 +982,17 @@ AtaAtapiPassThruStop (
 
   if (Instance->Mode == EfiAtaAhciMode) {
     AhciRegisters = &Instance->AhciRegisters;
+    if (AhciRegisters->AhciNcqCommandTable != NULL) {
+      PciIo->Unmap (
+               PciIo,
+               AhciRegisters->MapNcqCommandTable
+               );
+      PciIo->FreeBuffer (
+               PciIo,
+               EFI_SIZE_TO_PAGES ((UINTN) AhciRegisters->MaxNcqCommandTableSize),
+               AhciRegisters->AhciNcqCommandTable
+               );
+    }
     PciIo->Unmap (
              PciIo,
              AhciRegisters->MapCommandTable
@@ -1128,6 +1209,18 @@ DestroyAsynTaskList (
       Entry    = Entry->ForwardLink;
       Task     = ATA_NON_BLOCK_TASK_FROM_ENTRY (DelEntry);
 
+      //
+      // Abort the FPDMA QUEUED commands which are still outstanding. This
+      // completes and frees all the started FPDMA QUEUED tasks of the port,
+      // so the walk starts again from the head of the list.
+      //
+      if (Task->IsStart && (Task->Map != NULL) &&
+          (Task->Packet->Protocol == EFI_ATA_PASS_THRU_PROTOCOL_FPDMA)) {
+        AhciNcqStopPort (Instance, &Instance->AhciRegisters, (UINT8) Task->Port);
+        Entry = (&Instance->NonBlockingTaskList)->ForwardLink;
+        continue;
+      }
+
       RemoveEntryList (DelEntry);
       if (IsSigEvent) {
         Task->Packet->Asb->AtaStatus = 0x01;
@@ -1255,6 +1348,7 @@ AtaPassThruPassThru (
   UINT32                          MaxSectorCount;
   ATA_NONBLOCK_TASK               *Task;
   EFI_TPL                         OldTpl;
+  EFI_STATUS                      Status;
 
   Instance = ATA_PASS_THRU_PRIVATE_DATA_FROM_THIS (This);
 
@@ -1314,6 +1408,18 @@ AtaPassThruPassThru (
     }
   }
 
+  //
+  // Native command queuing is only available in non-blocking mode, on an AHCI
+  // controller supporting it and to a device reporting NCQ support in word 76.
+  //
+  if ((Packet->Protocol == EFI_ATA_PASS_THRU_PROTOCOL_FPDMA) &&
+      ((Event == NULL) ||
+       (Instance->Mode != EfiAtaAhciMode) ||
+       (Instance->AhciRegisters.NcqSlotMask == 0) ||
+       ((IdentifyData->AtaData.serial_ata_capabilities & BIT8) == 0))) {
+    return EFI_UNSUPPORTED;
+  }
+
   //
   // If the data buffer described by InDataBuffer/OutDataBuffer and InTransferLength/OutTransferLength
   // is too big to be transferred in a single command, then no data is transferred and EFI_BAD_BUFFER_SIZE
@@ -1352,13 +1458,17 @@ AtaPassThruPassThru (
 
     return EFI_SUCCESS;
   } else {
-    return AtaPassThruPassThruExecute (
-             Port,
-             PortMultiplierPort,
-             Packet,
-             Instance,
-             NULL
-             );
+    AtaPassThruDrainNonBlockingTasks (Instance);
+    Status = AtaPassThruPassThruExecute (
+               Port,
+               PortMultiplierPort,
+               Packet,
+               Instance,
+               NULL
+               );
+    Instance->BlockingCommandCount--;
+
+    return Status;
   }
 }
 
@@ -2038,7 +2148,9 @@ ExtScsiPassThruPassThru (
       Status = AtaPacketCommandExecute (Instance->PciIo, &Instance->IdeRegisters[Port], Port, PortMultiplier, Packet);
       break;
     case EfiAtaAhciMode:
+      AtaPassThruDrainNonBlockingTasks (Instance);
       Status = AhciPacketCommandExecute (Instance->PciIo, &Instance->AhciRegisters, Port, PortMultiplier, Packet);
+      Instance->BlockingCommandCount--;
       break;
     default :
       Status = EFI_DEVICE_ERROR;
@@ -120,6 +120,11 @@ typedef struct {
   //
   EFI_EVENT                         TimerEvent;
   LIST_ENTRY                        NonBlockingTaskList;
+  //
+  // Number of blocking commands in progress. The timer does not start the
+  // non-blocking tasks while it is not zero.
+  //
+  UINTN                             BlockingCommandCount;
 } ATA_ATAPI_PASS_THRU_INSTANCE;
 
 //
@@ -140,6 +145,7 @@ struct _ATA_NONBLOCK_TASK {
   VOID                              *TableMap;       // Pointer to PRD table map.
   EFI_ATA_DMA_PRD                   *MapBaseAddress; //  Pointer to range Base address for Map.
   UINTN                             PageCount;       //  The page numbers used by PCIO freebuffer.
+  UINT8                             NcqSlot;         //  The command slot used by a FPDMA QUEUED command.
 };
 
 //
@@ -536,6 +542,23 @@ AsyncNonBlockingTransferRoutine (
   VOID*      Context
   );
 
+/**
+  Complete all the non-blocking tasks before a blocking command is executed,
+  and keep the timer from starting new ones until the blocking command ends.
+
+  The blocking commands are built in command slot 0 and stop the port when
+  they are done, which would abort the commands queued on the port. The
+  caller must decrement Instance->BlockingCommandCount when the blocking
+  command is done.
+
+  @param[in]  Instance    The ATA_ATAPI_PASS_THRU_INSTANCE protocol instance.
+
+**/
+VOID
+AtaPassThruDrainNonBlockingTasks (
+  IN ATA_ATAPI_PASS_THRU_INSTANCE  *Instance
+  );
+
 /**
   Sends an ATA command to an ATA device that is attached to the ATA controller. This function
   supports both blocking I/O and non-blocking I/O. The blocking I/O functionality is required,
@@ -1150,6 +1173,71 @@ AhciDmaTransfer (
   IN     ATA_NONBLOCK_TASK            *Task
   );
 
+/**
+  Start a native command queuing (FPDMA QUEUED) data transfer on specific port.
+
+  Unlike AhciDmaTransfer(), the command is built in a free command slot and the
+  port is kept running after the command is issued, so up to the queue depth of
+  the device commands can be outstanding at the same time. It is only used by
+  non-blocking mode: the first call issues the command and the following calls
+  check PxSACT and PxCI for its completion.
+
+  @param[in]       Instance            The ATA_ATAPI_PASS_THRU_INSTANCE protocol instance.
+  @param[in]       AhciRegisters       The pointer to the EFI_AHCI_REGISTERS.
+  @param[in]       Port                The number of port.
+  @param[in]       PortMultiplier      The number of port multiplier.
+  @param[in]       Read                The transfer direction.
+  @param[in]       AtaCommandBlock     The EFI_ATA_COMMAND_BLOCK data.
+  @param[in, out]  AtaStatusBlock      The EFI_ATA_STATUS_BLOCK data.
+  @param[in, out]  MemoryAddr          The pointer to the data buffer.
+  @param[in]       DataCount           The data count to be transferred.
+  @param[in]       Timeout             The timeout value of data transfer, uses 100ns as a unit.
+  @param[in]       Task                Pointer to the ATA_NONBLOCK_TASK used by
+                                       non-blocking mode.
+
+  @retval EFI_NOT_READY       The command is waiting for a free slot or is not
+                              completed yet.
+  @retval EFI_DEVICE_ERROR    The data transfer abort with error occurs.
+  @retval EFI_TIMEOUT         The operation is time out.
+  @retval EFI_UNSUPPORTED     Native command queuing is not available.
+  @retval EFI_SUCCESS         The data transfer executes successfully.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciNcqTransfer (
+  IN     ATA_ATAPI_PASS_THRU_INSTANCE *Instance,
+  IN     EFI_AHCI_REGISTERS           *AhciRegisters,
+  IN     UINT8                        Port,
+  IN     UINT8                        PortMultiplier,
+  IN     BOOLEAN                      Read,
+  IN     EFI_ATA_COMMAND_BLOCK        *AtaCommandBlock,
+  IN OUT EFI_ATA_STATUS_BLOCK         *AtaStatusBlock,
+  IN OUT VOID                         *MemoryAddr,
+  IN     UINT32                       DataCount,
+  IN     UINT64                       Timeout,
+  IN     ATA_NONBLOCK_TASK            *Task
+  );
+
+/**
+  Stop the specific port and give back all command slots used by native command
+  queuing on it. Any command still queued on the port is aborted: its task is
+  removed from the non-blocking task list and its event is signaled with an
+  error status.
+
+  @param[in]  Instance        The ATA_ATAPI_PASS_THRU_INSTANCE protocol instance.
+  @param[in]  AhciRegisters   The pointer to the EFI_AHCI_REGISTERS.
+  @param[in]  Port            The number of port.
+
+**/
+VOID
+EFIAPI
+AhciNcqStopPort (
+  IN     ATA_ATAPI_PASS_THRU_INSTANCE *Instance,
+  IN     EFI_AHCI_REGISTERS           *AhciRegisters,
+  IN     UINT8                        Port
+  );
+
 /**
   Start a PIO data transfer on specific port.
 
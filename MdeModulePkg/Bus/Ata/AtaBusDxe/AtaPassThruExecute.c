@@ -343,6 +343,16 @@ IdentifyAtaDevice (
     AtaDevice->Lba48Bit = FALSE;
   }
 
+  //
+  // Check whether native command queuing is supported (WORD 76 bit 8). FPDMA
+  // QUEUED commands are DMA commands, so UDMA has to be supported as well.
+  //
+  if (AtaDevice->UdmaValid &&
+      (IdentifyData->serial_ata_capabilities != 0xFFFF) &&
+      ((IdentifyData->serial_ata_capabilities & BIT8) != 0)) {
+    AtaDevice->NcqValid = TRUE;
+  }
+
   //
   // Block Media Information:
   //
@@ -445,7 +455,10 @@ DiscoverAtaDevice (
 
   This function performs one ATA pass through transaction to transfer data from/to
   ATA device. It chooses the appropriate ATA command and protocol to invoke PassThru
-  interface of ATA pass through.
+  interface of ATA pass through. Non-blocking requests to a device supporting native
+  command queuing use FPDMA QUEUED commands, so that several of them can be
+  outstanding at the same time. If the ATA host controller can't queue commands,
+  NCQ is disabled for the device and the request is sent with a DMA command.
 
   @param[in, out]  AtaDevice       The ATA child device involved for the operation.
   @param[in, out]  TaskPacket      Pointer to a Pass Thru Command Packet. Optional,
@@ -477,8 +490,10 @@ TransferAtaDevice (
   IN EFI_EVENT                            Event OPTIONAL
   )
 {
+  EFI_STATUS                        Status;
   EFI_ATA_COMMAND_BLOCK             *Acb;
   EFI_ATA_PASS_THRU_COMMAND_PACKET  *Packet;
+  BOOLEAN                           NcqValid;
 
   //
   // Ensure AtaDevice->UdmaValid, AtaDevice->Lba48Bit and IsWrite are valid boolean values
@@ -489,6 +504,7 @@ TransferAtaDevice (
   //
   // Prepare for ATA command block.
   //
+  NcqValid = (BOOLEAN) (AtaDevice->NcqValid && (Event != NULL));
   Acb = ZeroMem (&AtaDevice->Acb, sizeof (EFI_ATA_COMMAND_BLOCK));
   Acb->AtaCommand = mAtaCommands[AtaDevice->UdmaValid][AtaDevice->Lba48Bit][IsWrite];
   Acb->AtaSectorNumber = (UINT8) StartLba;
@@ -496,7 +512,21 @@ TransferAtaDevice (
   Acb->AtaCylinderHigh = (UINT8) RShiftU64 (StartLba, 16);
   Acb->AtaDeviceHead = (UINT8) (BIT7 | BIT6 | BIT5 | (AtaDevice->PortMultiplierPort << 4));
   Acb->AtaSectorCount = (UINT8) TransferLength;
-  if (AtaDevice->Lba48Bit) {
+  if (NcqValid) {
+    //
+    // FPDMA QUEUED commands always use 48-bit LBA. The sector count is put in
+    // the feature registers, the sector count register carries the tag which
+    // is assigned by the ATA host controller driver.
+    //
+    Acb->AtaCommand         = IsWrite ? ATA_CMD_WRITE_FPDMA_QUEUED : ATA_CMD_READ_FPDMA_QUEUED;
+    Acb->AtaFeatures        = (UINT8) TransferLength;
+    Acb->AtaFeaturesExp     = (UINT8) (TransferLength >> 8);
+    Acb->AtaSectorCount     = 0;
+    Acb->AtaDeviceHead      = BIT6;
+    Acb->AtaSectorNumberExp = (UINT8) RShiftU64 (StartLba, 24);
+    Acb->AtaCylinderLowExp  = (UINT8) RShiftU64 (StartLba, 32);
+    Acb->AtaCylinderHighExp = (UINT8) RShiftU64 (StartLba, 40);
+  } else if (AtaDevice->Lba48Bit) {
     Acb->AtaSectorNumberExp = (UINT8) RShiftU64 (StartLba, 24);
     Acb->AtaCylinderLowExp = (UINT8) RShiftU64 (StartLba, 32);
     Acb->AtaCylinderHighExp = (UINT8) RShiftU64 (StartLba, 40);
@@ -522,7 +552,11 @@ TransferAtaDevice (
     Packet->InTransferLength = TransferLength;
   }
 
-  Packet->Protocol = mAtaPassThruCmdProtocols[AtaDevice->UdmaValid][IsWrite];
+  if (NcqValid) {
+    Packet->Protocol = EFI_ATA_PASS_THRU_PROTOCOL_FPDMA;
+  } else {
+    Packet->Protocol = mAtaPassThruCmdProtocols[AtaDevice->UdmaValid][IsWrite];
+  }
   Packet->Length = EFI_ATA_PASS_THRU_LENGTH_SECTOR_COUNT;
   //
   // |------------------------|-----------------|------------------------|-----------------|
@@ -557,7 +591,22 @@ TransferAtaDevice (
     Packet->Timeout  = EFI_TIMER_PERIOD_SECONDS (DivU64x32 (MultU64x32 (TransferLength, AtaDevice->BlockMedia.BlockSize), 3300000) + 31);
   }
 
-  return AtaDevicePassThru (AtaDevice, TaskPacket, Event);
+  Status = AtaDevicePassThru (AtaDevice, TaskPacket, Event);
+  if ((Status == EFI_UNSUPPORTED) && NcqValid) {
+    //
+    // The ATA host controller can't queue commands. Don't try NCQ again for
+    // this device and resend the request with a DMA command.
+    //
+    DEBUG ((EFI_D_INFO, "AtaBus - NCQ unsupported by host controller, disabled on Port %x\n", AtaDevice->Port));
+    AtaDevice->NcqValid = FALSE;
+    if (TaskPacket != NULL) {
+      FreeAlignedBuffer (TaskPacket->Asb, sizeof (EFI_ATA_STATUS_BLOCK));
+      FreePool (TaskPacket->Acb);
+    }
+    Status = TransferAtaDevice (AtaDevice, TaskPacket, Buffer, StartLba, TransferLength, IsWrite, Event);
+  }
+
+  return Status;
 }
 
 /**
@@ -812,7 +861,11 @@ AccessAtaDevice(
   if ((Token != NULL) && (Token->Event != NULL)) {
     OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
 
-    if (!IsListEmpty (&AtaDevice->AtaSubTaskList)) {
+    //
+    // Requests are serialized unless the device supports native command queuing,
+    // in which case the ATA host controller driver queues them in command slots.
+    //
+    if (!AtaDevice->NcqValid && !IsListEmpty (&AtaDevice->AtaSubTaskList)) {
       AtaTask = AllocateZeroPool (sizeof (ATA_BUS_ASYN_TASK));
       if (AtaTask == NULL) {
         gBS->RestoreTPL (OldTpl);
@@ -230,6 +230,7 @@ XhcCreateTransferTrb (
   UINT8                         SlotId;
   UINT8                         Dci;
   TRB                           *TrbStart;
+  LINK_TRB                      *LinkTrb;
   UINTN                         TotalLen;
   UINTN                         Len;
   UINTN                         TrbNum;
@@ -374,15 +375,20 @@ XhcCreateTransferTrb (
 
     case ED_BULK_OUT:
     case ED_BULK_IN:
+      //
+      // Build the whole bulk transfer as a single TD of chained Normal TRBs.
+      // Each TRB must not cross a 64KB boundary of the data buffer, and only
+      // the last one requests an interrupt, so the xHC reports the transfer
+      // with one Transfer Event unless a short packet terminates it early.
+      //
       TotalLen = 0;
       Len      = 0;
       TrbNum   = 0;
       TrbStart = (TRB *)(UINTN)EPRing->RingEnqueue;
       while (TotalLen < Urb->DataLen) {
-        if ((TotalLen + 0x10000) >= Urb->DataLen) {
+        Len = XHC_TRB_DATA_BOUNDARY - (((UINTN) Urb->DataPhy + TotalLen) & (XHC_TRB_DATA_BOUNDARY - 1));
+        if ((TotalLen + Len) >= Urb->DataLen) {
           Len = Urb->DataLen - TotalLen;
-        } else {
-          Len = 0x10000;
         }
         TrbStart = (TRB *)(UINTN)EPRing->RingEnqueue;
         TrbStart->TrbNormal.TRBPtrLo  = XHC_LOW_32BIT((UINT8 *) Urb->DataPhy + TotalLen);
@@ -391,9 +397,22 @@ XhcCreateTransferTrb (
         TrbStart->TrbNormal.TDSize    = 0;
         TrbStart->TrbNormal.IntTarget = 0;
         TrbStart->TrbNormal.ISP       = 1;
-        TrbStart->TrbNormal.IOC       = 1;
+        if ((TotalLen + Len) < Urb->DataLen) {
+          TrbStart->TrbNormal.CH      = 1;
+          TrbStart->TrbNormal.IOC     = 0;
+        } else {
+          TrbStart->TrbNormal.CH      = 0;
+          TrbStart->TrbNormal.IOC     = 1;
+        }
         TrbStart->TrbNormal.Type      = TRB_TYPE_NORMAL;
         //
+        // A Link TRB crossed in the middle of a TD must carry the chain bit as well.
+        //
+        LinkTrb = (LINK_TRB *) ((TRB_TEMPLATE *) TrbStart + 1);
+        if ((UINT8) LinkTrb->Type == TRB_TYPE_LINK) {
+          LinkTrb->CH = TrbStart->TrbNormal.CH;
+        }
+        //
         // Update the cycle bit
         //
         TrbStart->TrbNormal.CycleBit = EPRing->RingPCS & BIT0;
@@ -1003,15 +1022,22 @@ IsTransferRingTrb (
   TRB_TEMPLATE  *CheckedTrb;
   UINTN         Index;
 
-  CheckedTrb = Urb->Ring->RingSeg0;
+  CheckedTrb = Urb->TrbStart;
 
   ASSERT (Urb->Ring->TrbNumber == CMD_RING_TRB_NUMBER || Urb->Ring->TrbNumber == TR_RING_TRB_NUMBER);
 
-  for (Index = 0; Index < Urb->Ring->TrbNumber; Index++) {
+  //
+  // Only the TRBs of the URB's own TD are matched, so that a late event of an
+  // earlier transfer on the same ring isn't taken as the completion of this one.
+  //
+  for (Index = 0; Index < Urb->TrbNum; Index++) {
     if (Trb == CheckedTrb) {
       return TRUE;
     }
     CheckedTrb++;
+    if ((UINT8) CheckedTrb->Type == TRB_TYPE_LINK) {
+      CheckedTrb = (TRB_TEMPLATE *) Urb->Ring->RingSeg0;
+    }
   }
 
   return FALSE;
@@ -1044,6 +1070,8 @@ XhcCheckUrbResult (
   UINT32                  High;
   UINT32                  Low;
   EFI_PHYSICAL_ADDRESS    PhyAddr;
+  UINT64                  TrbData;
+  UINTN                   Completed;
 
   ASSERT ((Xhc != NULL) && (Urb != NULL));
 
@@ -1137,7 +1165,16 @@ XhcCheckUrbResult (
         if ((TRBType == TRB_TYPE_DATA_STAGE) ||
             (TRBType == TRB_TYPE_NORMAL) ||
             (TRBType == TRB_TYPE_ISOCH)) {
-          CheckedUrb->Completed += (CheckedUrb->DataLen - EvtTrb->Lenth);
+          //
+          // The data TRBs of a TD describe consecutive pieces of the data buffer, so
+          // the completed length is the offset of the reported TRB in the buffer plus
+          // what that TRB transferred.
+          //
+          TrbData   = ((TRANSFER_TRB_NORMAL *) TRBPtr)->TRBPtrLo | LShiftU64 ((UINT64) ((TRANSFER_TRB_NORMAL *) TRBPtr)->TRBPtrHi, 32);
+          Completed = (UINTN) (TrbData - (UINTN) CheckedUrb->DataPhy) + ((TRANSFER_TRB_NORMAL *) TRBPtr)->Lenth - EvtTrb->Lenth;
+          if (Completed > CheckedUrb->Completed) {
+            CheckedUrb->Completed = Completed;
+          }
         }
 
         break;
@@ -1150,13 +1187,16 @@ XhcCheckUrbResult (
     }
 
     //
-    // Only check first and end Trb event address
+    // Only check first and end Trb event address. A bulk transfer is a single
+    // chained TD which reports at most one event, and a short packet ends it
+    // without any further event for the remaining TRBs.
     //
-    if (TRBPtr == CheckedUrb->TrbStart) {
+    if ((TRBPtr == CheckedUrb->TrbStart) || (CheckedUrb->Ep.Type == XHC_BULK_TRANSFER)) {
       CheckedUrb->StartDone = TRUE;
     }
 
-    if (TRBPtr == CheckedUrb->TrbEnd) {
+    if ((TRBPtr == CheckedUrb->TrbEnd) ||
+        ((CheckedUrb->Ep.Type == XHC_BULK_TRANSFER) && (EvtTrb->Completecode == TRB_COMPLETION_SHORT_PACKET))) {
       CheckedUrb->EndDone = TRUE;
     }
 
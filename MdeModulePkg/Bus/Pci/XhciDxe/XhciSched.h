@@ -27,6 +27,11 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #define XHC_INT_TRANSFER_ASYNC                0x08
 #define XHC_INT_ONLY_TRANSFER_ASYNC           0x10
 
+//
+// A data TRB may not cross a 64KB boundary of its buffer.
+//
+#define XHC_TRB_DATA_BOUNDARY                 SIZE_64KB
+
 //
 // 6.4.6 TRB Types
 //
@@ -210,6 +210,13 @@ struct _USB_MASS_DEVICE {
   EFI_DISK_INFO_PROTOCOL    DiskInfo;
   USB_BOOT_INQUIRY_DATA     InquiryData;
   BOOLEAN                   Cdb16Byte;
+  UINT32                    MaxTransferSize;     ///< Preferred bytes carried by one READ/WRITE command
+  UINT8                     *ReadAheadBuffer;
+  UINTN                     ReadAheadBufferSize;
+  EFI_LBA                   ReadAheadLba;        ///< First block held by ReadAheadBuffer
+  UINTN                     ReadAheadBlocks;     ///< Blocks held by ReadAheadBuffer, 0 if empty
+  UINT32                    ReadAheadMediaId;
+  EFI_LBA                   NextLba;             ///< Block following the previous read request
 };
 
 #endif
@@ -765,6 +765,32 @@ ON_ERROR:
 }
 
 
+/**
+  Get the number of blocks carried by one READ/WRITE command.
+
+  @param  UsbMass                The USB mass storage device.
+
+  @return The number of blocks, which fits in the 16 bit transfer length of READ10/WRITE10.
+
+**/
+UINTN
+UsbBootMaxTransferBlocks (
+  IN USB_MASS_DEVICE          *UsbMass
+  )
+{
+  UINTN                     MaxBlock;
+
+  if (UsbMass->BlockIoMedia.BlockSize == 0) {
+    return USB_BOOT_IO_BLOCKS;
+  }
+
+  MaxBlock = UsbMass->MaxTransferSize / UsbMass->BlockIoMedia.BlockSize;
+  MaxBlock = MAX (MaxBlock, USB_BOOT_IO_BLOCKS);
+
+  return MIN (MaxBlock, MAX_UINT16);
+}
+
+
 /**
   Read some blocks from the device.
 
@@ -791,8 +817,10 @@ UsbBootReadBlocks (
   UINT32                    BlockSize;
   UINT32                    ByteSize;
   UINT32                    Timeout;
+  UINTN                     MaxBlock;
 
   BlockSize = UsbMass->BlockIoMedia.BlockSize;
+  MaxBlock  = UsbBootMaxTransferBlocks (UsbMass);
   Status    = EFI_SUCCESS;
 
   while (TotalBlock > 0) {
@@ -801,7 +829,7 @@ UsbBootReadBlocks (
     // on the device. We must split the total block because the READ10
     // command only has 16 bit transfer length (in the unit of block).
     //
-    Count     = (UINT16)((TotalBlock < USB_BOOT_IO_BLOCKS) ? TotalBlock : USB_BOOT_IO_BLOCKS);
+    Count     = (UINT16) MIN (TotalBlock, MaxBlock);
     ByteSize  = (UINT32)Count * BlockSize;
 
     //
@@ -867,8 +895,10 @@ UsbBootWriteBlocks (
   UINT32                BlockSize;
   UINT32                ByteSize;
   UINT32                Timeout;
+  UINTN                 MaxBlock;
 
   BlockSize = UsbMass->BlockIoMedia.BlockSize;
+  MaxBlock  = UsbBootMaxTransferBlocks (UsbMass);
   Status    = EFI_SUCCESS;
 
   while (TotalBlock > 0) {
@@ -877,7 +907,7 @@ UsbBootWriteBlocks (
     // on the device. We must split the total block because the WRITE10
     // command only has 16 bit transfer length (in the unit of block).
     //
-    Count     = (UINT16)((TotalBlock < USB_BOOT_IO_BLOCKS) ? TotalBlock : USB_BOOT_IO_BLOCKS);
+    Count     = (UINT16) MIN (TotalBlock, MaxBlock);
     ByteSize  = (UINT32)Count * BlockSize;
 
     //
@@ -943,15 +973,17 @@ UsbBootReadBlocks16 (
   UINT32                    BlockSize;
   UINT32                    ByteSize;
   UINT32                    Timeout;
+  UINTN                     MaxBlock;
 
   BlockSize = UsbMass->BlockIoMedia.BlockSize;
+  MaxBlock  = UsbBootMaxTransferBlocks (UsbMass);
   Status    = EFI_SUCCESS;
 
   while (TotalBlock > 0) {
     //
     // Split the total blocks into smaller pieces.
     //
-    Count     = (UINT16)((TotalBlock < USB_BOOT_IO_BLOCKS) ? TotalBlock : USB_BOOT_IO_BLOCKS);
+    Count     = (UINT16) MIN (TotalBlock, MaxBlock);
     ByteSize  = (UINT32)Count * BlockSize;
 
     //
@@ -1017,15 +1049,17 @@ UsbBootWriteBlocks16 (
   UINT32                BlockSize;
   UINT32                ByteSize;
   UINT32                Timeout;
+  UINTN                 MaxBlock;
 
   BlockSize = UsbMass->BlockIoMedia.BlockSize;
+  MaxBlock  = UsbBootMaxTransferBlocks (UsbMass);
   Status    = EFI_SUCCESS;
 
   while (TotalBlock > 0) {
     //
     // Split the total blocks into smaller pieces.
     //
-    Count     = (UINT16)((TotalBlock < USB_BOOT_IO_BLOCKS) ? TotalBlock : USB_BOOT_IO_BLOCKS);
+    Count     = (UINT16) MIN (TotalBlock, MaxBlock);
     ByteSize  = (UINT32)Count * BlockSize;
 
     //
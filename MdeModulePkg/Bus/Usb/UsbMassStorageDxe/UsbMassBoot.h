@@ -68,6 +68,15 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 //
 #define USB_BOOT_IO_BLOCKS              128
 
+//
+// Preferred size carried by one READ/WRITE command. Devices that report USB 3.0
+// or later in bcdUSB accept much larger transfers, which saves the CBW/CSW
+// round trips of the Bulk-Only Transport. At least USB_BOOT_IO_BLOCKS blocks
+// are carried whatever the block size is.
+//
+#define USB_BOOT_MAX_CARRY_SIZE         SIZE_64KB
+#define USB_BOOT_MAX_CARRY_SIZE_SS      SIZE_1MB
+
 //
 // Retry mass command times, set by experience
 //
@@ -242,6 +251,19 @@ UsbBootGetParams (
   IN USB_MASS_DEVICE          *UsbMass
   );
 
+/**
+  Get the number of blocks carried by one READ/WRITE command.
+
+  @param  UsbMass                The USB mass storage device.
+
+  @return The number of blocks, which fits in the 16 bit transfer length of READ10/WRITE10.
+
+**/
+UINTN
+UsbBootMaxTransferBlocks (
+  IN USB_MASS_DEVICE          *UsbMass
+  );
+
 /**
   Execute TEST UNIT READY command to check if the device is ready.
 
@@ -66,6 +66,7 @@ UsbMassReset (
   OldTpl  = gBS->RaiseTPL (TPL_NOTIFY);
 
   UsbMass = USB_MASS_DEVICE_FROM_BLOCK_IO (This);
+  UsbMass->ReadAheadBlocks = 0;
   Status  = UsbMass->Transport->Reset (UsbMass->Context, ExtendedVerification);
 
   gBS->RestoreTPL (OldTpl);
@@ -73,6 +74,138 @@ UsbMassReset (
   return Status;
 }
 
+/**
+  Read blocks from the device with the READ command matching the device.
+
+  @param  UsbMass                The USB mass storage device to read from
+  @param  Lba                    The start block number
+  @param  TotalBlock             Total block number to read
+  @param  Buffer                 The buffer to read to
+
+  @retval EFI_SUCCESS            Data are read into the buffer
+  @retval Others                 Failed to read all the data
+
+**/
+EFI_STATUS
+UsbMassReadDevice (
+  IN  USB_MASS_DEVICE       *UsbMass,
+  IN  EFI_LBA               Lba,
+  IN  UINTN                 TotalBlock,
+  OUT UINT8                 *Buffer
+  )
+{
+  if (UsbMass->Cdb16Byte) {
+    return UsbBootReadBlocks16 (UsbMass, Lba, TotalBlock, Buffer);
+  } else {
+    return UsbBootReadBlocks (UsbMass, (UINT32) Lba, TotalBlock, Buffer);
+  }
+}
+
+/**
+  Read blocks from the device through the read-ahead buffer.
+
+  Small reads that continue the previous read request are served from a buffer
+  filled by one maximum-sized READ command, so sequential small reads cost a
+  memory copy instead of a full CBW/data/CSW round trip each. Large and random
+  reads go to the device directly.
+
+  @param  UsbMass                The USB mass storage device to read from
+  @param  Lba                    The start block number
+  @param  TotalBlock             Total block number to read
+  @param  Buffer                 The buffer to read to
+
+  @retval EFI_SUCCESS            Data are read into the buffer
+  @retval Others                 Failed to read all the data
+
+**/
+EFI_STATUS
+UsbMassReadAheadBlocks (
+  IN  USB_MASS_DEVICE       *UsbMass,
+  IN  EFI_LBA               Lba,
+  IN  UINTN                 TotalBlock,
+  OUT UINT8                 *Buffer
+  )
+{
+  EFI_BLOCK_IO_MEDIA        *Media;
+  EFI_STATUS                Status;
+  BOOLEAN                   Sequential;
+  UINTN                     MaxBlock;
+  UINTN                     Count;
+
+  Media      = &UsbMass->BlockIoMedia;
+  Status     = EFI_SUCCESS;
+  MaxBlock   = UsbBootMaxTransferBlocks (UsbMass);
+  Sequential = (BOOLEAN) (Lba == UsbMass->NextLba);
+
+  UsbMass->NextLba = Lba + TotalBlock;
+
+  //
+  // The buffered blocks belong to the previous medium.
+  //
+  if (UsbMass->ReadAheadMediaId != Media->MediaId) {
+    UsbMass->ReadAheadBlocks = 0;
+  }
+
+  //
+  // (Re)allocate the buffer when the block size changes with the medium.
+  //
+  if (Sequential && (UsbMass->ReadAheadBufferSize != MaxBlock * Media->BlockSize)) {
+    if (UsbMass->ReadAheadBuffer != NULL) {
+      FreePool (UsbMass->ReadAheadBuffer);
+    }
+    UsbMass->ReadAheadBlocks     = 0;
+    UsbMass->ReadAheadBufferSize = MaxBlock * Media->BlockSize;
+    UsbMass->ReadAheadBuffer     = AllocatePool (UsbMass->ReadAheadBufferSize);
+    if (UsbMass->ReadAheadBuffer == NULL) {
+      UsbMass->ReadAheadBufferSize = 0;
+    }
+  }
+
+  while (TotalBlock > 0) {
+    if ((UsbMass->ReadAheadBlocks != 0) &&
+        (Lba >= UsbMass->ReadAheadLba) &&
+        (Lba < UsbMass->ReadAheadLba + UsbMass->ReadAheadBlocks)) {
+      Count = (UINTN) MIN (TotalBlock, UsbMass->ReadAheadLba + UsbMass->ReadAheadBlocks - Lba);
+      CopyMem (
+        Buffer,
+        UsbMass->ReadAheadBuffer + (UINTN) (Lba - UsbMass->ReadAheadLba) * Media->BlockSize,
+        Count * Media->BlockSize
+        );
+      Lba        += Count;
+      Buffer     += Count * Media->BlockSize;
+      TotalBlock -= Count;
+      continue;
+    }
+
+    if (!Sequential || (UsbMass->ReadAheadBuffer == NULL) || (TotalBlock >= MaxBlock)) {
+      return UsbMassReadDevice (UsbMass, Lba, TotalBlock, Buffer);
+    }
+
+    //
+    // Fill the buffer with the blocks starting at Lba, up to the end of the medium.
+    //
+    Count  = (UINTN) MIN (MaxBlock, Media->LastBlock - Lba + 1);
+    Status = UsbMassReadDevice (UsbMass, Lba, Count, UsbMass->ReadAheadBuffer);
+    if (EFI_ERROR (Status)) {
+      UsbMass->ReadAheadBlocks = 0;
+      if (Count <= TotalBlock) {
+        return Status;
+      }
+      //
+      // The blocks read ahead were not requested by the caller, a bad block
+      // among them or a device rejecting long transfers must not fail the
+      // request. Read only the requested blocks instead.
+      //
+      return UsbMassReadDevice (UsbMass, Lba, TotalBlock, Buffer);
+    }
+    UsbMass->ReadAheadLba     = Lba;
+    UsbMass->ReadAheadBlocks  = Count;
+    UsbMass->ReadAheadMediaId = Media->MediaId;
+  }
+
+  return Status;
+}
+
 /**
   Reads the requested number of blocks from the device.
 
@@ -171,11 +304,7 @@ UsbMassReadBlocks (
     goto ON_EXIT;
   }
 
-  if (UsbMass->Cdb16Byte) {
-    Status = UsbBootReadBlocks16 (UsbMass, Lba, TotalBlock, Buffer);
-  } else {
-    Status = UsbBootReadBlocks (UsbMass, (UINT32) Lba, TotalBlock, Buffer);
-  }
+  Status = UsbMassReadAheadBlocks (UsbMass, Lba, TotalBlock, Buffer);
 
   if (EFI_ERROR (Status)) {
     DEBUG ((EFI_D_ERROR, "UsbMassReadBlocks: UsbBootReadBlocks (%r) -> Reset\n", Status));
@@ -287,6 +416,15 @@ UsbMassWriteBlocks (
     goto ON_EXIT;
   }
 
+  //
+  // Drop the read-ahead blocks if they are overwritten.
+  //
+  if ((UsbMass->ReadAheadBlocks != 0) &&
+      (Lba < UsbMass->ReadAheadLba + UsbMass->ReadAheadBlocks) &&
+      (Lba + TotalBlock > UsbMass->ReadAheadLba)) {
+    UsbMass->ReadAheadBlocks = 0;
+  }
+
   //
   // Try to write the data even the device is marked as ReadOnly,
   // and clear the status should the write succeed.
@@ -346,9 +484,19 @@ UsbMassInitMedia (
 {
   EFI_BLOCK_IO_MEDIA          *Media;
   EFI_STATUS                  Status;
+  EFI_USB_DEVICE_DESCRIPTOR   DevDesc;
 
   Media = &UsbMass->BlockIoMedia;
 
+  //
+  // USB 3.0 devices get larger transfers per command.
+  //
+  UsbMass->MaxTransferSize = USB_BOOT_MAX_CARRY_SIZE;
+  Status = UsbMass->UsbIo->UsbGetDeviceDescriptor (UsbMass->UsbIo, &DevDesc);
+  if (!EFI_ERROR (Status) && (DevDesc.BcdUSB >= 0x0300)) {
+    UsbMass->MaxTransferSize = USB_BOOT_MAX_CARRY_SIZE_SS;
+  }
+
   //
   // Fields of EFI_BLOCK_IO_MEDIA are defined in UEFI 2.0 spec,
   // section for Block I/O Protocol.
@@ -985,6 +1133,9 @@ USBMassDriverBindingStop (
           );
   
     UsbMass->Transport->CleanUp (UsbMass->Context);
+    if (UsbMass->ReadAheadBuffer != NULL) {
+      FreePool (UsbMass->ReadAheadBuffer);
+    }
     FreePool (UsbMass);
     
     DEBUG ((EFI_D_INFO, "Success to stop non-multi-lun root handle\n"));
@@ -1056,6 +1207,9 @@ USBMassDriverBindingStop (
       if (((Index + 1) == NumberOfChildren) && AllChildrenStopped) {
         UsbMass->Transport->CleanUp (UsbMass->Context);
       }
+      if (UsbMass->ReadAheadBuffer != NULL) {
+        FreePool (UsbMass->ReadAheadBuffer);
+      }
       FreePool (UsbMass);
     }
   }
@@ -0,0 +1,101 @@
+/** @file
+  Disk I/O Cache Protocol is an EDK II-specific diagnostic interface produced by
+  DiskIoDxe on every controller for which the optional block cache is enabled.
+  It reports the cache effectiveness and allows the cached dirty blocks to be
+  written back on demand.
+
+  Copyright (c) 2014, Intel Corporation. All rights reserved.<BR>
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#ifndef __DISK_IO_CACHE_H__
+#define __DISK_IO_CACHE_H__
+
+#define EDKII_DISK_IO_CACHE_PROTOCOL_GUID \
+  { \
+    0xfb0edcf4, 0xfae5, 0x4122, { 0xb6, 0x0f, 0x73, 0xf8, 0x55, 0x35, 0xbb, 0xb0 } \
+  }
+
+typedef struct _EDKII_DISK_IO_CACHE_PROTOCOL  EDKII_DISK_IO_CACHE_PROTOCOL;
+
+///
+/// Counters maintained by the block cache of one Disk I/O instance.
+///
+typedef struct {
+  UINT64  ReadHits;         ///< Blocks read that were found in the cache.
+  UINT64  ReadMisses;       ///< Blocks read that had to be fetched from the device.
+  UINT64  WriteHits;        ///< Blocks written that were already in the cache.
+  UINT64  WriteMisses;      ///< Blocks written that were not in the cache.
+  UINT64  ReadAheadBlocks;  ///< Blocks fetched speculatively beyond the request.
+  UINT64  WriteBackBlocks;  ///< Dirty blocks written to the device.
+  UINT64  Evictions;        ///< Valid blocks replaced to make room for others.
+  UINT32  BlockNum;         ///< Capacity of the cache in blocks.
+  UINT32  ValidBlockNum;    ///< Blocks currently held by the cache.
+  UINT32  DirtyBlockNum;    ///< Blocks currently waiting to be written back.
+  UINT32  BlockSize;        ///< Size in bytes of one cached block.
+} EDKII_DISK_IO_CACHE_STATISTICS;
+
+/**
+  Retrieve the current statistics of the block cache.
+
+  @param[in]  This          The EDKII_DISK_IO_CACHE_PROTOCOL instance.
+  @param[out] Statistics    Receives a snapshot of the cache counters.
+
+  @retval EFI_SUCCESS           The statistics were returned.
+  @retval EFI_INVALID_PARAMETER Statistics is NULL.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_DISK_IO_CACHE_GET_STATISTICS) (
+  IN  EDKII_DISK_IO_CACHE_PROTOCOL    *This,
+  OUT EDKII_DISK_IO_CACHE_STATISTICS  *Statistics
+  );
+
+/**
+  Reset the hit, miss and traffic counters of the block cache.
+  The cached data itself is not affected.
+
+  @param[in]  This          The EDKII_DISK_IO_CACHE_PROTOCOL instance.
+
+  @retval EFI_SUCCESS       The counters were reset.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_DISK_IO_CACHE_RESET_STATISTICS) (
+  IN  EDKII_DISK_IO_CACHE_PROTOCOL    *This
+  );
+
+/**
+  Write all the dirty blocks held by the cache to the device.
+
+  @param[in]  This          The EDKII_DISK_IO_CACHE_PROTOCOL instance.
+
+  @retval EFI_SUCCESS       All the dirty blocks were written back.
+  @retval Others            The device reported an error while writing a block.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_DISK_IO_CACHE_FLUSH) (
+  IN  EDKII_DISK_IO_CACHE_PROTOCOL    *This
+  );
+
+///
+/// Disk I/O Cache Protocol exposes the block cache of a Disk I/O instance
+/// for diagnostics.
+///
+struct _EDKII_DISK_IO_CACHE_PROTOCOL {
+  EDKII_DISK_IO_CACHE_GET_STATISTICS    GetStatistics;
+  EDKII_DISK_IO_CACHE_RESET_STATISTICS  ResetStatistics;
+  EDKII_DISK_IO_CACHE_FLUSH             Flush;
+};
+
+extern EFI_GUID gEdkiiDiskIoCacheProtocolGuid;
+
+#endif
@@ -0,0 +1,103 @@
+/** @file
+  DPC Statistics Protocol is an EDK II-specific diagnostic interface produced by
+  DpcDxe. It reports the use of the DPC entry pool and, for every DPC procedure,
+  how long its DPCs waited in the queue and how long they ran, so that the
+  handlers delaying the others can be identified.
+
+  Copyright (c) 2014, Intel Corporation. All rights reserved.<BR>
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#ifndef __DPC_STATISTICS_H__
+#define __DPC_STATISTICS_H__
+
+#include <Protocol/Dpc.h>
+
+#define EDKII_DPC_STATISTICS_PROTOCOL_GUID \
+  { \
+    0x3bcfc62d, 0x671e, 0x4cc6, { 0xac, 0x51, 0x4e, 0x2b, 0x32, 0x2b, 0x0f, 0xef } \
+  }
+
+typedef struct _EDKII_DPC_STATISTICS_PROTOCOL  EDKII_DPC_STATISTICS_PROTOCOL;
+
+///
+/// Counters of the DPC queue and of its entry pool.
+///
+typedef struct {
+  UINT64  QueueCount;       ///< DPCs queued.
+  UINT64  DispatchCount;    ///< DPCs invoked.
+  UINT64  OverflowCount;    ///< DPCs queued while the entry pool was empty.
+  UINT32  EntryNum;         ///< DPC entries allocated, including those added to the pool on demand.
+  UINT32  QueueDepth;       ///< DPCs currently queued.
+  UINT32  MaxQueueDepth;    ///< Highest number of DPCs queued at once.
+  UINT32  ProcedureNum;     ///< DPC procedures tracked in the per procedure statistics.
+} EDKII_DPC_STATISTICS;
+
+///
+/// Counters of the DPCs of one DPC procedure. The times are in nanoseconds.
+///
+typedef struct {
+  EFI_DPC_PROCEDURE  DpcProcedure;    ///< The DPC procedure.
+  EFI_TPL            DpcTpl;          ///< The TPL of the last DPC of the procedure.
+  UINT64             DispatchCount;   ///< DPCs of the procedure invoked.
+  UINT64             MaxQueueTime;    ///< Longest time from QueueDpc to the invocation.
+  UINT64             MaxRunTime;      ///< Longest run time of one invocation.
+  UINT64             TotalRunTime;    ///< Sum of the run times of all the invocations.
+} EDKII_DPC_PROCEDURE_STATISTICS;
+
+/**
+  Retrieve the statistics of the DPC queue and of the DPC procedures.
+
+  @param[in]      This                 The EDKII_DPC_STATISTICS_PROTOCOL instance.
+  @param[out]     Statistics           Receives a snapshot of the queue counters.
+  @param[in, out] ProcedureNum         On input, the number of entries in
+                                       ProcedureStatistics. On output, the number
+                                       of DPC procedures tracked.
+  @param[out]     ProcedureStatistics  Receives the counters of the DPC procedures.
+
+  @retval EFI_SUCCESS           The statistics were returned.
+  @retval EFI_BUFFER_TOO_SMALL  ProcedureStatistics is too small, ProcedureNum is
+                                updated with the number of entries needed.
+  @retval EFI_INVALID_PARAMETER Statistics or ProcedureNum is NULL.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_DPC_STATISTICS_GET_STATISTICS) (
+  IN     EDKII_DPC_STATISTICS_PROTOCOL   *This,
+  OUT    EDKII_DPC_STATISTICS            *Statistics,
+  IN OUT UINTN                           *ProcedureNum,
+  OUT    EDKII_DPC_PROCEDURE_STATISTICS  *ProcedureStatistics OPTIONAL
+  );
+
+/**
+  Reset the counters of the DPC queue and forget the tracked DPC procedures.
+  The queued DPCs are not affected.
+
+  @param[in]  This          The EDKII_DPC_STATISTICS_PROTOCOL instance.
+
+  @retval EFI_SUCCESS       The counters were reset.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_DPC_STATISTICS_RESET_STATISTICS) (
+  IN  EDKII_DPC_STATISTICS_PROTOCOL  *This
+  );
+
+///
+/// DPC Statistics Protocol exposes the counters of the DPC queue for diagnostics.
+///
+struct _EDKII_DPC_STATISTICS_PROTOCOL {
+  EDKII_DPC_STATISTICS_GET_STATISTICS    GetStatistics;
+  EDKII_DPC_STATISTICS_RESET_STATISTICS  ResetStatistics;
+};
+
+extern EFI_GUID gEdkiiDpcStatisticsProtocolGuid;
+
+#endif
@@ -280,10 +280,11 @@ SerialPortWrite (
   Result = NumberOfBytes;
   while (NumberOfBytes != 0) {
     //
-    // Wait for the serial port to be ready, to make sure both the transmit FIFO
-    // and shift register empty.
+    // Wait for the transmit FIFO to be empty. The last byte of the previous
+    // burst may still be in the shift register, the next burst is sent right
+    // after it instead of waiting for the transmitter to be idle.
     //
-    while ((SerialPortReadRegister (R_UART_LSR) & B_UART_LSR_TEMT) == 0);
+    while ((SerialPortReadRegister (R_UART_LSR) & B_UART_LSR_TXRDY) == 0);
 
     //
     // Fill then entire Tx FIFO
@@ -1657,14 +1657,59 @@ NetblockChecksum (
   IN UINT32                 Len
   )
 {
-  register UINT32           Sum;
+  UINT64                    Sum;
+  UINT32                    Folded;
+  UINT32                    *Words;
+  UINT8                     FirstByte;
+  BOOLEAN                   Odd;
 
   Sum = 0;
 
-  while (Len > 1) {
-    Sum += *(UINT16 *) Bulk;
+  //
+  // The one's complement sum is byte order independent. If the data starts
+  // at an odd address, take the first byte aside, sum the rest from an even
+  // address, then swap the bytes of that sum before adding the first byte.
+  //
+  Odd       = FALSE;
+  FirstByte = 0;
+
+  if ((((UINTN) Bulk & 1) != 0) && (Len > 0)) {
+    Odd       = TRUE;
+    FirstByte = *Bulk;
+    Bulk++;
+    Len--;
+  }
+
+  if ((((UINTN) Bulk & 2) != 0) && (Len > 1)) {
+    Sum  += *(UINT16 *) Bulk;
+    Bulk += 2;
+    Len  -= 2;
+  }
+
+  //
+  // Sum 32 bits at a time into a 64-bit accumulator, which can't overflow
+  // for any 32-bit length, so the carries are only folded once at the end.
+  //
+  Words = (UINT32 *) Bulk;
+
+  while (Len >= 16) {
+    Sum += (UINT64) Words[0] + Words[1] + Words[2] + Words[3];
+    Words += 4;
+    Len   -= 16;
+  }
+
+  while (Len >= 4) {
+    Sum += *Words;
+    Words++;
+    Len -= 4;
+  }
+
+  Bulk = (UINT8 *) Words;
+
+  if (Len > 1) {
+    Sum  += *(UINT16 *) Bulk;
     Bulk += 2;
-    Len -= 2;
+    Len  -= 2;
   }
 
   //
@@ -1675,14 +1720,22 @@ NetblockChecksum (
   }
 
   //
-  // Fold 32-bit sum to 16 bits
+  // Fold 64-bit sum to 32 bits, then to 16 bits
   //
-  while ((Sum >> 16) != 0) {
-    Sum = (Sum & 0xffff) + (Sum >> 16);
+  Sum    = (Sum & 0xffffffff) + RShiftU64 (Sum, 32);
+  Sum    = (Sum & 0xffffffff) + RShiftU64 (Sum, 32);
+  Folded = (UINT32) Sum;
 
+  while ((Folded >> 16) != 0) {
+    Folded = (Folded & 0xffff) + (Folded >> 16);
   }
 
-  return (UINT16) Sum;
+  if (Odd) {
+    Folded = (((Folded & 0xff) << 8) | (Folded >> 8)) + FirstByte;
+    Folded = (Folded & 0xffff) + (Folded >> 16);
+  }
+
+  return (UINT16) Folded;
 }
 
 
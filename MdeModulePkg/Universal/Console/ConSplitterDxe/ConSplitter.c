@@ -239,6 +239,18 @@ GLOBAL_REMOVE_IF_UNREFERENCED TEXT_OUT_SPLITTER_PRIVATE_DATA mStdErr = {
   (INT32 *) NULL
 };
 
+//
+// Event signaled by ExitBootServices () to stop queuing the output, and the
+// state it sets.
+//
+EFI_EVENT  mTextOutExitBootServicesEvent = NULL;
+BOOLEAN    mTextOutQueueStopped          = FALSE;
+//
+// Count of the Simple Text Output calls in progress. The queues are not
+// written by the timer while the devices are called.
+//
+UINTN      mTextOutQueueBusy             = 0;
+
 //
 // Driver binding instance for Console Input Device
 //
@@ -455,6 +467,21 @@ ConSplitterDriverEntry(
       gST->StdErr               = &mStdErr.TextOut;
     }
   }
+
+  if (PcdGet32 (PcdConOutQueueSize) != 0) {
+    //
+    // The output queues can't be drained by the timer after ExitBootServices ().
+    //
+    Status = gBS->CreateEventEx (
+                    EVT_NOTIFY_SIGNAL,
+                    TPL_NOTIFY,
+                    ConSplitterTextOutExitBootServices,
+                    NULL,
+                    &gEfiEventExitBootServicesGuid,
+                    &mTextOutExitBootServicesEvent
+                    );
+    ASSERT_EFI_ERROR (Status);
+  }
   
   //
   // Update the CRC32 in the EFI System Table header
@@ -2989,6 +3016,12 @@ ConSplitterTextOutAddDevice (
   Status                = EFI_SUCCESS;
   CurrentNumOfConsoles  = Private->CurrentNumberOfConsoles;
 
+  //
+  // Keep the queue timer away from the Text Out List while it is reallocated
+  // and the new device is added.
+  //
+  mTextOutQueueBusy++;
+
   //
   // If the Text Out List is full, enlarge it by calling ConSplitterGrowBuffer().
   //
@@ -2999,6 +3032,7 @@ ConSplitterTextOutAddDevice (
               (VOID **) &Private->TextOutList
               );
     if (EFI_ERROR (Status)) {
+      mTextOutQueueBusy--;
       return EFI_OUT_OF_RESOURCES;
     }
     //
@@ -3006,6 +3040,7 @@ ConSplitterTextOutAddDevice (
     //
     Status = ConSplitterGrowMapTable (Private);
     if (EFI_ERROR (Status)) {
+      mTextOutQueueBusy--;
       return EFI_OUT_OF_RESOURCES;
     }
   }
@@ -3015,6 +3050,9 @@ ConSplitterTextOutAddDevice (
   TextAndGop->TextOut        = TextOut;
   TextAndGop->GraphicsOutput = GraphicsOutput;
   TextAndGop->UgaDraw        = UgaDraw;
+  TextAndGop->Queue          = NULL;
+
+  ConSplitterTextOutCreateQueue (Private, TextAndGop);
 
   if (CurrentNumOfConsoles == 0) {
     //
@@ -3026,6 +3064,7 @@ ConSplitterTextOutAddDevice (
   }
 
   Private->CurrentNumberOfConsoles++;
+  mTextOutQueueBusy--;
 
   //
   // Scan both TextOutList, for the intersection TextOut device
@@ -3167,8 +3206,14 @@ ConSplitterTextOutDeleteDevice (
   INT32                 Index;
   UINTN                 CurrentNumOfConsoles;
   TEXT_OUT_AND_GOP_DATA *TextOutList;
+  TEXT_OUT_QUEUE        *Queue;
   EFI_STATUS            Status;
 
+  //
+  // Keep the queue timer away from the Text Out List while it is rearranged.
+  //
+  mTextOutQueueBusy++;
+
   //
   // Remove the specified text-out device data structure from the Text out List,
   // and rearrange the remaining data structures in the Text out List.
@@ -3178,6 +3223,15 @@ ConSplitterTextOutDeleteDevice (
   TextOutList           = Private->TextOutList;
   while (Index >= 0) {
     if (TextOutList->TextOut == TextOut) {
+      if (TextOutList->Queue != NULL) {
+        //
+        // Write the queued output before the device is stopped.
+        //
+        ConSplitterTextOutDrainQueue (Private, TextOutList, (UINTN) -1);
+        Queue              = TextOutList->Queue;
+        TextOutList->Queue = NULL;
+        ConSplitterTextOutFreeQueue (Queue);
+      }
       if (TextOutList->UgaDraw != NULL) {
         Private->CurrentNumberOfUgaDraw--;
       }
@@ -3196,6 +3250,7 @@ ConSplitterTextOutDeleteDevice (
   // The specified TextOut is not managed by the ConSplitter driver
   //
   if (Index < 0) {
+    mTextOutQueueBusy--;
     return EFI_NOT_FOUND;
   }
 
@@ -3238,6 +3293,7 @@ ConSplitterTextOutDeleteDevice (
     Private->TextOutQueryData[0].Rows     = 25;
     TextOutSetMode (Private, 0);
 
+    mTextOutQueueBusy--;
     return EFI_SUCCESS;
   }
   //
@@ -3274,6 +3330,7 @@ ConSplitterTextOutDeleteDevice (
 
   ConSplitterGetIntersectionBetweenConOutAndStrErr ();
 
+  mTextOutQueueBusy--;
   return Status;
 }
 
@@ -4187,6 +4244,347 @@ ConSplitterAbsolutePointerWaitForInput (
 }
 
 
+/**
+  Timer handler writing a part of the queued output of every console device.
+
+  @param  Event                 Event whose notification function is being invoked.
+  @param  Context               Pointer to the TEXT_OUT_SPLITTER_PRIVATE_DATA.
+
+**/
+VOID
+EFIAPI
+ConSplitterTextOutQueueTimerHandler (
+  IN EFI_EVENT                Event,
+  IN VOID                     *Context
+  )
+{
+  TEXT_OUT_SPLITTER_PRIVATE_DATA  *Private;
+  UINTN                           Index;
+
+  Private = (TEXT_OUT_SPLITTER_PRIVATE_DATA *) Context;
+
+  if (mTextOutQueueBusy != 0) {
+    //
+    // The timer interrupted a call to the devices, the queues are written at
+    // the next tick.
+    //
+    return;
+  }
+
+  for (Index = 0; Index < Private->CurrentNumberOfConsoles; Index++) {
+    if (Private->TextOutList[Index].Queue != NULL) {
+      ConSplitterTextOutDrainQueue (Private, &Private->TextOutList[Index], TEXT_OUT_QUEUE_DRAIN_COUNT);
+    }
+  }
+}
+
+
+/**
+  Create the output queue of a text-only console device, if output queuing
+  is enabled by PcdConOutQueueSize.
+
+  @param  Private                  Text Out Splitter pointer.
+  @param  TextAndGop                The console device.
+
+**/
+VOID
+ConSplitterTextOutCreateQueue (
+  IN  TEXT_OUT_SPLITTER_PRIVATE_DATA     *Private,
+  IN  TEXT_OUT_AND_GOP_DATA              *TextAndGop
+  )
+{
+  EFI_STATUS                      Status;
+  TEXT_OUT_QUEUE                  *Queue;
+  UINTN                           Size;
+
+  Size = PcdGet32 (PcdConOutQueueSize);
+
+  //
+  // Only the text-only devices of Console Out are queued, the graphics consoles
+  // are fast and the Standard Error output must not be delayed.
+  //
+  if ((Size == 0) || (Private != &mConOut) || mTextOutQueueStopped ||
+      (TextAndGop->GraphicsOutput != NULL) || (TextAndGop->UgaDraw != NULL)) {
+    return;
+  }
+
+  if (Private->QueueTimerEvent == NULL) {
+    Status = gBS->CreateEvent (
+                    EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                    TPL_CALLBACK,
+                    ConSplitterTextOutQueueTimerHandler,
+                    Private,
+                    &Private->QueueTimerEvent
+                    );
+    if (EFI_ERROR (Status)) {
+      Private->QueueTimerEvent = NULL;
+      return;
+    }
+
+    Status = gBS->SetTimer (Private->QueueTimerEvent, TimerPeriodic, TEXT_OUT_QUEUE_TIMER_PERIOD);
+    if (EFI_ERROR (Status)) {
+      gBS->CloseEvent (Private->QueueTimerEvent);
+      Private->QueueTimerEvent = NULL;
+      return;
+    }
+  }
+
+  Queue = AllocateZeroPool (sizeof (TEXT_OUT_QUEUE));
+  if (Queue == NULL) {
+    return;
+  }
+
+  Queue->Buffer    = AllocatePool (Size * sizeof (CHAR16));
+  Queue->Attribute = AllocatePool (Size);
+  if ((Queue->Buffer == NULL) || (Queue->Attribute == NULL)) {
+    ConSplitterTextOutFreeQueue (Queue);
+    return;
+  }
+  Queue->Size = Size;
+
+  TextAndGop->Queue = Queue;
+}
+
+
+/**
+  Free the output queue of a console device.
+
+  @param  Queue                    The output queue.
+
+**/
+VOID
+ConSplitterTextOutFreeQueue (
+  IN  TEXT_OUT_QUEUE                     *Queue
+  )
+{
+  if (Queue->Buffer != NULL) {
+    FreePool (Queue->Buffer);
+  }
+  if (Queue->Attribute != NULL) {
+    FreePool (Queue->Attribute);
+  }
+  FreePool (Queue);
+}
+
+
+/**
+  Write the queued output of a console device to the device.
+
+  @param  Private                  Text Out Splitter pointer.
+  @param  TextAndGop               The console device.
+  @param  MaxCount                 The maximum number of characters to write.
+
+**/
+VOID
+ConSplitterTextOutDrainQueue (
+  IN  TEXT_OUT_SPLITTER_PRIVATE_DATA     *Private,
+  IN  TEXT_OUT_AND_GOP_DATA              *TextAndGop,
+  IN  UINTN                              MaxCount
+  )
+{
+  TEXT_OUT_QUEUE                  *Queue;
+  EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL *TextOut;
+  CHAR16                          String[TEXT_OUT_QUEUE_CHUNK_SIZE + 1];
+  UINTN                           Length;
+  UINT8                           Attribute;
+  UINTN                           Dropped;
+  EFI_TPL                         OldTpl;
+
+  Queue   = TextAndGop->Queue;
+  TextOut = TextAndGop->TextOut;
+
+  OldTpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+  if (Queue->Draining || (Queue->Count == 0)) {
+    //
+    // Nothing is queued, or the queue is being written by the code this
+    // call interrupted.
+    //
+    gBS->RestoreTPL (OldTpl);
+    return;
+  }
+  Queue->Draining = TRUE;
+
+  while ((MaxCount > 0) && (Queue->Count > 0)) {
+    //
+    // Take the next characters with the same attribute out of the queue.
+    //
+    Attribute = Queue->Attribute[Queue->Head];
+    Length    = 0;
+    while ((Length < TEXT_OUT_QUEUE_CHUNK_SIZE) && (Length < MaxCount) &&
+           (Queue->Count > 0) && (Queue->Attribute[Queue->Head] == Attribute)) {
+      String[Length++] = Queue->Buffer[Queue->Head];
+      Queue->Head      = (Queue->Head + 1) % Queue->Size;
+      Queue->Count--;
+    }
+    gBS->RestoreTPL (OldTpl);
+
+    String[Length] = CHAR_NULL;
+    MaxCount      -= Length;
+
+    if (TextOut->Mode->Attribute != (INT32) Attribute) {
+      TextOut->SetAttribute (TextOut, Attribute);
+    }
+    TextOut->OutputString (TextOut, String);
+
+    OldTpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+  }
+
+  Queue->Draining = FALSE;
+  Length          = Queue->Count;
+  Dropped         = Queue->Dropped;
+  Queue->Dropped  = 0;
+  gBS->RestoreTPL (OldTpl);
+
+  if (Dropped != 0) {
+    DEBUG ((EFI_D_WARN, "ConSplitter: %Lu characters of console output were dropped, the queue was full.\n", (UINT64) Dropped));
+  }
+
+  //
+  // SetAttribute () is not passed to a device while its output is queued.
+  //
+  if ((Length == 0) && (TextOut->Mode->Attribute != Private->TextOutMode.Attribute)) {
+    TextOut->SetAttribute (TextOut, (UINTN) Private->TextOutMode.Attribute);
+  }
+}
+
+
+/**
+  Queue a string for a console device.
+
+  @param  Private                  Text Out Splitter pointer.
+  @param  TextAndGop               The console device.
+  @param  WString                  The NULL-terminated Unicode string to queue.
+
+  @retval EFI_SUCCESS              The string was queued or written to the device.
+  @retval EFI_DEVICE_ERROR         The queue is full and is being written by the
+                                   code this call interrupted, the string was dropped.
+  @retval Others                   The device reported an error while writing
+                                   the string.
+
+**/
+EFI_STATUS
+ConSplitterTextOutEnqueue (
+  IN  TEXT_OUT_SPLITTER_PRIVATE_DATA     *Private,
+  IN  TEXT_OUT_AND_GOP_DATA              *TextAndGop,
+  IN  CHAR16                             *WString
+  )
+{
+  TEXT_OUT_QUEUE                  *Queue;
+  UINTN                           Length;
+  UINTN                           Index;
+  UINTN                           Tail;
+  UINT8                           Attribute;
+  EFI_TPL                         OldTpl;
+
+  Queue  = TextAndGop->Queue;
+  Length = StrLen (WString);
+
+  if (Length > Queue->Size - Queue->Count) {
+    //
+    // The device doesn't keep up with the output, write enough of the queued
+    // output to make room for the string.
+    //
+    ConSplitterTextOutDrainQueue (Private, TextAndGop, Length - (Queue->Size - Queue->Count));
+  }
+
+  if (Length > Queue->Size - Queue->Count) {
+    if (Queue->Draining) {
+      //
+      // The queue is full and is being written by the code this call
+      // interrupted, the string is dropped rather than written out of order
+      // into the middle of an OutputString () of the device. The drops are
+      // reported when the interrupted drain completes.
+      //
+      OldTpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+      Queue->Dropped += Length;
+      gBS->RestoreTPL (OldTpl);
+      return EFI_DEVICE_ERROR;
+    }
+
+    //
+    // The string is larger than the queue, which is empty now.
+    //
+    return TextAndGop->TextOut->OutputString (TextAndGop->TextOut, WString);
+  }
+
+  Attribute = (UINT8) Private->TextOutMode.Attribute;
+
+  OldTpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+  Tail   = (Queue->Head + Queue->Count) % Queue->Size;
+  for (Index = 0; Index < Length; Index++) {
+    Queue->Buffer[Tail]    = WString[Index];
+    Queue->Attribute[Tail] = Attribute;
+    Tail = (Tail + 1) % Queue->Size;
+  }
+  Queue->Count += Length;
+  gBS->RestoreTPL (OldTpl);
+
+  return EFI_SUCCESS;
+}
+
+
+/**
+  Write all the queued output of the Console Out devices to the devices.
+
+**/
+VOID
+ConSplitterTextOutFlushQueues (
+  VOID
+  )
+{
+  UINTN                           Index;
+
+  for (Index = 0; Index < mConOut.CurrentNumberOfConsoles; Index++) {
+    if (mConOut.TextOutList[Index].Queue != NULL) {
+      ConSplitterTextOutDrainQueue (&mConOut, &mConOut.TextOutList[Index], (UINTN) -1);
+    }
+  }
+}
+
+
+/**
+  Flush or discard the queued output of the Console Out devices when the OS
+  loader calls ExitBootServices (), and write the later output synchronously.
+
+  @param  Event                 Event whose notification function is being invoked.
+  @param  Context               Pointer to the notification function's context.
+
+**/
+VOID
+EFIAPI
+ConSplitterTextOutExitBootServices (
+  IN EFI_EVENT                Event,
+  IN VOID                     *Context
+  )
+{
+  UINTN                           Index;
+  TEXT_OUT_AND_GOP_DATA           *TextAndGop;
+
+  mTextOutQueueStopped = TRUE;
+
+  for (Index = 0; Index < mConOut.CurrentNumberOfConsoles; Index++) {
+    TextAndGop = &mConOut.TextOutList[Index];
+    if (TextAndGop->Queue == NULL) {
+      continue;
+    }
+
+    if (PcdGetBool (PcdConOutQueueFlushOnExitBootServices)) {
+      ConSplitterTextOutDrainQueue (&mConOut, TextAndGop, (UINTN) -1);
+    } else {
+      TextAndGop->Queue->Count = 0;
+      if (TextAndGop->TextOut->Mode->Attribute != mConOut.TextOutMode.Attribute) {
+        TextAndGop->TextOut->SetAttribute (TextAndGop->TextOut, (UINTN) mConOut.TextOutMode.Attribute);
+      }
+    }
+
+    //
+    // Memory can't be freed any more, the queue is only dropped.
+    //
+    TextAndGop->Queue = NULL;
+  }
+}
+
+
 /**
   Reset the text output device hardware and optionaly run diagnostics
 
@@ -4213,6 +4611,9 @@ ConSplitterTextOutReset (
 
   Private = TEXT_OUT_SPLITTER_PRIVATE_DATA_FROM_THIS (This);
 
+  mTextOutQueueBusy++;
+  ConSplitterTextOutFlushQueues ();
+
   //
   // return the worst status met
   //
@@ -4233,6 +4634,7 @@ ConSplitterTextOutReset (
   //
   TextOutSetMode (Private, 0);
 
+  mTextOutQueueBusy--;
   return ReturnStatus;
 }
 
@@ -4274,26 +4676,49 @@ ConSplitterTextOutOutputString (
 
   Private         = TEXT_OUT_SPLITTER_PRIVATE_DATA_FROM_THIS (This);
 
+  mTextOutQueueBusy++;
+
+  if (Private != &mConOut) {
+    //
+    // Standard Error may share devices with Console Out, write the output
+    // queued by Console Out first.
+    //
+    ConSplitterTextOutFlushQueues ();
+  }
+
   //
   // return the worst status met
   //
   for (Index = 0, ReturnStatus = EFI_SUCCESS; Index < Private->CurrentNumberOfConsoles; Index++) {
-    Status = Private->TextOutList[Index].TextOut->OutputString (
-                                                    Private->TextOutList[Index].TextOut,
-                                                    WString
-                                                    );
+    if (Private->TextOutList[Index].Queue != NULL) {
+      Status = ConSplitterTextOutEnqueue (Private, &Private->TextOutList[Index], WString);
+    } else {
+      Status = Private->TextOutList[Index].TextOut->OutputString (
+                                                      Private->TextOutList[Index].TextOut,
+                                                      WString
+                                                      );
+    }
     if (EFI_ERROR (Status)) {
       ReturnStatus = Status;
     }
   }
 
-  if (Private->CurrentNumberOfConsoles > 0) {
-    Private->TextOutMode.CursorColumn = Private->TextOutList[0].TextOut->Mode->CursorColumn;
-    Private->TextOutMode.CursorRow    = Private->TextOutList[0].TextOut->Mode->CursorRow;
+  //
+  // The cursor position is taken from the first device written synchronously.
+  //
+  for (Index = 0; Index < Private->CurrentNumberOfConsoles; Index++) {
+    if (Private->TextOutList[Index].Queue == NULL) {
+      break;
+    }
+  }
+
+  if (Index < Private->CurrentNumberOfConsoles) {
+    Private->TextOutMode.CursorColumn = Private->TextOutList[Index].TextOut->Mode->CursorColumn;
+    Private->TextOutMode.CursorRow    = Private->TextOutList[Index].TextOut->Mode->CursorRow;
   } else {
     //
-    // When there is no real console devices in system, 
-    // update cursor position for the virtual device in consplitter.
+    // When there is no real console devices in system, or all of them are
+    // queued, update cursor position for the virtual device in consplitter.
     //
     Private->TextOut.QueryMode (
                        &Private->TextOut,
@@ -4336,6 +4761,7 @@ ConSplitterTextOutOutputString (
     }
   }
 
+  mTextOutQueueBusy--;
   return ReturnStatus;
 }
 
@@ -4500,6 +4926,10 @@ ConSplitterTextOutSetMode (
   if (Private->TextOutMode.Mode == (INT32) ModeNumber) {
     return ConSplitterTextOutClearScreen (This);
   }
+
+  mTextOutQueueBusy++;
+  ConSplitterTextOutFlushQueues ();
+
   //
   // return the worst status met
   //
@@ -4519,6 +4949,7 @@ ConSplitterTextOutSetMode (
   //
   TextOutSetMode (Private, ModeNumber);
 
+  mTextOutQueueBusy--;
   return ReturnStatus;
 }
 
@@ -4561,10 +4992,19 @@ ConSplitterTextOutSetAttribute (
     return EFI_UNSUPPORTED;
   }
 
+  mTextOutQueueBusy++;
+
   //
   // return the worst status met
   //
   for (Index = 0, ReturnStatus = EFI_SUCCESS; Index < Private->CurrentNumberOfConsoles; Index++) {
+    if ((Private->TextOutList[Index].Queue != NULL) && (Private->TextOutList[Index].Queue->Count != 0)) {
+      //
+      // The attribute is queued with every character, it's set when the
+      // queue is written to the device.
+      //
+      continue;
+    }
     Status = Private->TextOutList[Index].TextOut->SetAttribute (
                                                     Private->TextOutList[Index].TextOut,
                                                     Attribute
@@ -4576,6 +5016,7 @@ ConSplitterTextOutSetAttribute (
 
   Private->TextOutMode.Attribute = (INT32) Attribute;
 
+  mTextOutQueueBusy--;
   return ReturnStatus;
 }
 
@@ -4605,6 +5046,9 @@ ConSplitterTextOutClearScreen (
 
   Private = TEXT_OUT_SPLITTER_PRIVATE_DATA_FROM_THIS (This);
 
+  mTextOutQueueBusy++;
+  ConSplitterTextOutFlushQueues ();
+
   //
   // return the worst status met
   //
@@ -4624,6 +5068,7 @@ ConSplitterTextOutClearScreen (
   Private->TextOutMode.CursorRow    = 0;
   Private->TextOutMode.CursorVisible = TRUE;
 
+  mTextOutQueueBusy--;
   return ReturnStatus;
 }
 
@@ -4685,6 +5130,10 @@ ConSplitterTextOutSetCursorPosition (
   if (Column >= MaxColumn || Row >= MaxRow) {
     return EFI_UNSUPPORTED;
   }
+
+  mTextOutQueueBusy++;
+  ConSplitterTextOutFlushQueues ();
+
   //
   // return the worst status met
   //
@@ -4707,6 +5156,7 @@ ConSplitterTextOutSetCursorPosition (
   Private->TextOutMode.CursorColumn = (INT32) Column;
   Private->TextOutMode.CursorRow    = (INT32) Row;
 
+  mTextOutQueueBusy--;
   return ReturnStatus;
 }
 
@@ -4739,6 +5189,9 @@ ConSplitterTextOutEnableCursor (
 
   Private = TEXT_OUT_SPLITTER_PRIVATE_DATA_FROM_THIS (This);
 
+  mTextOutQueueBusy++;
+  ConSplitterTextOutFlushQueues ();
+
   //
   // return the worst status met
   //
@@ -4754,6 +5207,7 @@ ConSplitterTextOutEnableCursor (
 
   Private->TextOutMode.CursorVisible = Visible;
 
+  mTextOutQueueBusy--;
   return ReturnStatus;
 }
 
@@ -33,6 +33,7 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #include <Guid/StandardErrorDevice.h>
 #include <Guid/ConsoleOutDevice.h>
 #include <Guid/ConnectConInEvent.h>
+#include <Guid/EventGroup.h>
 
 #include <Library/PcdLib.h>
 #include <Library/DebugLib.h>
@@ -178,10 +179,40 @@ typedef struct {
 
 #define TEXT_OUT_SPLITTER_PRIVATE_DATA_SIGNATURE  SIGNATURE_32 ('T', 'o', 'S', 'p')
 
+//
+// Period of the timer draining the output queues, in 100ns units (10ms).
+//
+#define TEXT_OUT_QUEUE_TIMER_PERIOD   100000
+//
+// Characters written to a queued console by one timer tick. 32 characters
+// take about 3ms on a 115200 baud serial port.
+//
+#define TEXT_OUT_QUEUE_DRAIN_COUNT    32
+//
+// Characters passed to one OutputString () call when a queue is drained.
+//
+#define TEXT_OUT_QUEUE_CHUNK_SIZE     32
+
+//
+// Output of a text-only console device (e.g. a serial terminal) queued by
+// OutputString () and written to the device from a timer event, so that the
+// other consoles and the caller don't wait for a slow device.
+//
+typedef struct {
+  CHAR16                           *Buffer;     // Ring of the queued characters
+  UINT8                            *Attribute;  // Attribute of every queued character
+  UINTN                            Size;        // Capacity of the ring
+  UINTN                            Head;        // Index of the oldest queued character
+  UINTN                            Count;       // Number of queued characters
+  BOOLEAN                          Draining;    // The queue is being written to the device
+  UINTN                            Dropped;     // Characters dropped since the last report
+} TEXT_OUT_QUEUE;
+
 typedef struct {
   EFI_GRAPHICS_OUTPUT_PROTOCOL     *GraphicsOutput;
   EFI_UGA_DRAW_PROTOCOL            *UgaDraw;
   EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL  *TextOut;
+  TEXT_OUT_QUEUE                   *Queue;      // NULL if the output is written synchronously
 } TEXT_OUT_AND_GOP_DATA;
 
 //
@@ -211,6 +242,8 @@ typedef struct {
   UINTN                                 TextOutQueryDataCount;
   INT32                                 *TextOutModeMap;
 
+  EFI_EVENT                             QueueTimerEvent;
+
 } TEXT_OUT_SPLITTER_PRIVATE_DATA;
 
 #define TEXT_OUT_SPLITTER_PRIVATE_DATA_FROM_THIS(a) \
@@ -1237,6 +1270,70 @@ ConSplitterTextOutDeleteDevice (
   IN  EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL    *TextOut
   );
 
+/**
+  Create the output queue of a text-only console device, if output queuing
+  is enabled by PcdConOutQueueSize.
+
+  @param  Private                  Text Out Splitter pointer.
+  @param  TextAndGop                The console device.
+
+**/
+VOID
+ConSplitterTextOutCreateQueue (
+  IN  TEXT_OUT_SPLITTER_PRIVATE_DATA     *Private,
+  IN  TEXT_OUT_AND_GOP_DATA              *TextAndGop
+  );
+
+/**
+  Free the output queue of a console device.
+
+  @param  Queue                    The output queue.
+
+**/
+VOID
+ConSplitterTextOutFreeQueue (
+  IN  TEXT_OUT_QUEUE                     *Queue
+  );
+
+/**
+  Write the queued output of a console device to the device.
+
+  @param  Private                  Text Out Splitter pointer.
+  @param  TextAndGop               The console device.
+  @param  MaxCount                 The maximum number of characters to write.
+
+**/
+VOID
+ConSplitterTextOutDrainQueue (
+  IN  TEXT_OUT_SPLITTER_PRIVATE_DATA     *Private,
+  IN  TEXT_OUT_AND_GOP_DATA              *TextAndGop,
+  IN  UINTN                              MaxCount
+  );
+
+/**
+  Write all the queued output of the Console Out devices to the devices.
+
+**/
+VOID
+ConSplitterTextOutFlushQueues (
+  VOID
+  );
+
+/**
+  Flush or discard the queued output of the Console Out devices when the OS
+  loader calls ExitBootServices (), and write the later output synchronously.
+
+  @param  Event                 Event whose notification function is being invoked.
+  @param  Context               Pointer to the notification function's context.
+
+**/
+VOID
+EFIAPI
+ConSplitterTextOutExitBootServices (
+  IN EFI_EVENT                Event,
+  IN VOID                     *Context
+  );
+
 //
 // TextIn I/O Functions
 //
@@ -42,7 +42,11 @@ GRAPHICS_CONSOLE_DEV    mGraphicsConsoleDevTemplate = {
     TRUE
   },
   (GRAPHICS_CONSOLE_MODE_DATA *) NULL,
-  (EFI_GRAPHICS_OUTPUT_BLT_PIXEL *) NULL
+  (EFI_GRAPHICS_OUTPUT_BLT_PIXEL *) NULL,
+  (GRAPHICS_CONSOLE_CELL *) NULL,
+  (GRAPHICS_CONSOLE_DIRTY_SPAN *) NULL,
+  FALSE,
+  (GRAPHICS_CONSOLE_GLYPH *) NULL
 };
 
 GRAPHICS_CONSOLE_MODE_DATA mGraphicsConsoleModeData[] = {
@@ -386,6 +390,8 @@ GraphicsConsoleControllerDriverStart (
   UINT32                               RefreshRate;
   UINT32                               ModeIndex;
   UINTN                                MaxMode;
+  UINTN                                MaxCells;
+  UINTN                                MaxRows;
   UINT32                               ModeNumber;
   EFI_GRAPHICS_OUTPUT_PROTOCOL_MODE    *Mode;
   UINTN                                SizeOfInfo;  
@@ -404,6 +410,12 @@ GraphicsConsoleControllerDriverStart (
     return EFI_OUT_OF_RESOURCES;
   }
 
+  Private->GlyphCache = AllocateZeroPool (sizeof (GRAPHICS_CONSOLE_GLYPH) * GRAPHICS_CONSOLE_GLYPH_CACHE_SIZE);
+  if (Private->GlyphCache == NULL) {
+    FreePool (Private);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
   Private->SimpleTextOutput.Mode = &(Private->SimpleTextOutputMode);
 
   Status = gBS->OpenProtocol (
@@ -571,6 +583,22 @@ GraphicsConsoleControllerDriverStart (
   //
   Private->SimpleTextOutputMode.MaxMode = (INT32) MaxMode;
 
+  //
+  // Allocate the shadow text buffer once, large enough for every text mode
+  //
+  MaxCells = 0;
+  MaxRows  = 0;
+  for (ModeIndex = 0; ModeIndex < MaxMode; ModeIndex++) {
+    MaxCells = MAX (MaxCells, Private->ModeData[ModeIndex].Columns * Private->ModeData[ModeIndex].Rows);
+    MaxRows  = MAX (MaxRows, Private->ModeData[ModeIndex].Rows);
+  }
+  Private->TextBuffer = AllocateZeroPool (sizeof (GRAPHICS_CONSOLE_CELL) * MaxCells);
+  Private->DirtySpan  = AllocateZeroPool (sizeof (GRAPHICS_CONSOLE_DIRTY_SPAN) * MaxRows);
+  if (Private->TextBuffer == NULL || Private->DirtySpan == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Error;
+  }
+
   DEBUG_CODE_BEGIN ();
     Status = GraphicsConsoleConOutSetMode (&Private->SimpleTextOutput, 0);
     if (EFI_ERROR (Status)) {
@@ -617,6 +645,18 @@ Error:
       FreePool (Private->LineBuffer);
     }
 
+    if (Private->TextBuffer != NULL) {
+      FreePool (Private->TextBuffer);
+    }
+
+    if (Private->DirtySpan != NULL) {
+      FreePool (Private->DirtySpan);
+    }
+
+    if (Private->GlyphCache != NULL) {
+      FreePool (Private->GlyphCache);
+    }
+
     if (Private->ModeData != NULL) {
       FreePool (Private->ModeData);
     }
@@ -705,6 +745,18 @@ GraphicsConsoleControllerDriverStop (
       FreePool (Private->LineBuffer);
     }
 
+    if (Private->TextBuffer != NULL) {
+      FreePool (Private->TextBuffer);
+    }
+
+    if (Private->DirtySpan != NULL) {
+      FreePool (Private->DirtySpan);
+    }
+
+    if (Private->GlyphCache != NULL) {
+      FreePool (Private->GlyphCache);
+    }
+
     if (Private->ModeData != NULL) {
       FreePool (Private->ModeData);
     }
@@ -979,6 +1031,22 @@ GraphicsConsoleConOutOutputString (
       // down one row.
       //
       if (This->Mode->CursorRow == (INT32) (MaxRow - 1)) {
+        //
+        // Draw the pending characters before they are moved up, and scroll
+        // the shadow text buffer with the screen.
+        //
+        FlushDirtyCells (This);
+        CopyMem (
+          Private->TextBuffer,
+          Private->TextBuffer + MaxColumn,
+          (MaxRow - 1) * MaxColumn * sizeof (GRAPHICS_CONSOLE_CELL)
+          );
+        FillTextCells (
+          Private->TextBuffer + (MaxRow - 1) * MaxColumn,
+          MaxColumn,
+          (UINT8) (OriginAttribute & 0x7F)
+          );
+
         if (GraphicsOutput != NULL) {
           //
           // Scroll Screen Up One Row
@@ -1354,6 +1422,13 @@ GraphicsConsoleConOutSetMode (
   //
   Private->LineBuffer = NewLineBuffer;
 
+  //
+  // The screen is cleared to black below, so reset the shadow text buffer
+  //
+  FillTextCells (Private->TextBuffer, ModeData->Columns * ModeData->Rows, 0);
+  ZeroMem (Private->DirtySpan, sizeof (GRAPHICS_CONSOLE_DIRTY_SPAN) * ModeData->Rows);
+  Private->HasDirtyCells = FALSE;
+
   if (GraphicsOutput != NULL) {
     if (ModeData->GopModeNumber != GraphicsOutput->Mode->Mode) {
       //
@@ -1571,6 +1646,10 @@ GraphicsConsoleConOutClearScreen (
     Status = EFI_UNSUPPORTED;
   }
 
+  FillTextCells (Private->TextBuffer, ModeData->Columns * ModeData->Rows, (UINT8) (This->Mode->Attribute & 0x7F));
+  ZeroMem (Private->DirtySpan, sizeof (GRAPHICS_CONSOLE_DIRTY_SPAN) * ModeData->Rows);
+  Private->HasDirtyCells = FALSE;
+
   This->Mode->CursorColumn  = 0;
   This->Mode->CursorRow     = 0;
 
@@ -1721,9 +1800,219 @@ GetTextColors (
   return EFI_SUCCESS;
 }
 
+/**
+  Fill cells of the shadow text buffer with blanks of a text attribute.
+
+  @param  Cell                  The first cell to fill.
+  @param  Count                 The number of cells to fill.
+  @param  Attribute             The text attribute of the blanks.
+
+**/
+VOID
+FillTextCells (
+  IN  GRAPHICS_CONSOLE_CELL            *Cell,
+  IN  UINTN                            Count,
+  IN  UINT8                            Attribute
+  )
+{
+  while (Count-- > 0) {
+    Cell->Char      = L' ';
+    Cell->Attribute = Attribute;
+    Cell++;
+  }
+}
+
+/**
+  Get the pixels of a narrow character drawn in a text attribute.
+
+  The character cell is taken from the glyph cache. On a miss it is rendered
+  by the HII Font protocol into the cache entry of the character, replacing
+  the character previously held by the entry.
+
+  @param  Private               The Graphics Console device.
+  @param  Char                  The character to draw.
+  @param  Attribute             The text attribute of the character.
+
+  @return The EFI_GLYPH_WIDTH x EFI_GLYPH_HEIGHT pixels of the character cell.
+          A character without glyph is drawn as a blank and is not cached, so
+          that a font registered later is used.
+
+**/
+EFI_GRAPHICS_OUTPUT_BLT_PIXEL *
+GetCachedGlyph (
+  IN  GRAPHICS_CONSOLE_DEV             *Private,
+  IN  CHAR16                           Char,
+  IN  UINT8                            Attribute
+  )
+{
+  EFI_STATUS                        Status;
+  GRAPHICS_CONSOLE_GLYPH            *Glyph;
+  EFI_IMAGE_OUTPUT                  Image;
+  EFI_IMAGE_OUTPUT                  *Blt;
+  EFI_FONT_DISPLAY_INFO             FontInfo;
+  CHAR16                            String[2];
+  EFI_HII_ROW_INFO                  *RowInfoArray;
+  UINTN                             RowInfoArraySize;
+  UINTN                             Index;
+
+  Glyph = &Private->GlyphCache[GRAPHICS_CONSOLE_GLYPH_HASH (Char, Attribute)];
+  if (Glyph->Valid && Glyph->Char == Char && Glyph->Attribute == Attribute) {
+    return Glyph->Bitmap;
+  }
+
+  ZeroMem (&FontInfo, sizeof (FontInfo));
+  FontInfo.ForegroundColor = mGraphicsEfiColors[Attribute & 0x0f];
+  FontInfo.BackgroundColor = mGraphicsEfiColors[Attribute >> 4];
+
+  for (Index = 0; Index < EFI_GLYPH_WIDTH * EFI_GLYPH_HEIGHT; Index++) {
+    Glyph->Bitmap[Index] = FontInfo.BackgroundColor;
+  }
+
+  Glyph->Char      = Char;
+  Glyph->Attribute = Attribute;
+  Glyph->Valid     = FALSE;
+
+  Image.Width        = EFI_GLYPH_WIDTH;
+  Image.Height       = EFI_GLYPH_HEIGHT;
+  Image.Image.Bitmap = Glyph->Bitmap;
+  Blt                = &Image;
+
+  String[0]    = Char;
+  String[1]    = L'\0';
+  RowInfoArray = NULL;
+
+  Status = mHiiFont->StringToImage (
+                       mHiiFont,
+                       EFI_HII_IGNORE_IF_NO_GLYPH | EFI_HII_IGNORE_LINE_BREAK,
+                       String,
+                       &FontInfo,
+                       &Blt,
+                       0,
+                       0,
+                       &RowInfoArray,
+                       &RowInfoArraySize,
+                       NULL
+                       );
+  if (!EFI_ERROR (Status) && RowInfoArraySize == 1 && RowInfoArray[0].LineWidth != 0) {
+    Glyph->Valid = TRUE;
+  }
+
+  if (RowInfoArray != NULL) {
+    FreePool (RowInfoArray);
+  }
+
+  return Glyph->Bitmap;
+}
+
+/**
+  Draw the characters written to the shadow text buffer since the last call,
+  with one Blt for every row that was written.
+
+  @param  This                  Protocol instance pointer.
+
+  @retval EFI_SUCCESS           The written characters are drawn.
+  @retval EFI_UNSUPPORTED       If no Graphics Output protocol and UGA Draw
+                                protocol exist.
+  @retval Others                The Blt failed.
+
+**/
+EFI_STATUS
+FlushDirtyCells (
+  IN  EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL  *This
+  )
+{
+  EFI_STATUS                        Status;
+  EFI_STATUS                        BltStatus;
+  GRAPHICS_CONSOLE_DEV              *Private;
+  GRAPHICS_CONSOLE_MODE_DATA        *ModeData;
+  GRAPHICS_CONSOLE_DIRTY_SPAN       *Span;
+  GRAPHICS_CONSOLE_CELL             *Cell;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL     *Glyph;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL     *Pixel;
+  UINTN                             Row;
+  UINTN                             Column;
+  UINTN                             GlyphY;
+  UINTN                             Width;
+
+  Private = GRAPHICS_CONSOLE_CON_OUT_DEV_FROM_THIS (This);
+  if (!Private->HasDirtyCells) {
+    return EFI_SUCCESS;
+  }
+  Private->HasDirtyCells = FALSE;
+
+  Status   = EFI_SUCCESS;
+  ModeData = &Private->ModeData[This->Mode->Mode];
+
+  for (Row = 0; Row < ModeData->Rows; Row++) {
+    Span = &Private->DirtySpan[Row];
+    if (Span->Start >= Span->End) {
+      continue;
+    }
+
+    //
+    // Compose the written part of the row in the line buffer
+    //
+    Width = (Span->End - Span->Start) * EFI_GLYPH_WIDTH;
+    Cell  = &Private->TextBuffer[Row * ModeData->Columns + Span->Start];
+    for (Column = 0; Column < Span->End - Span->Start; Column++, Cell++) {
+      Glyph = GetCachedGlyph (Private, Cell->Char, Cell->Attribute);
+      Pixel = Private->LineBuffer + Column * EFI_GLYPH_WIDTH;
+      for (GlyphY = 0; GlyphY < EFI_GLYPH_HEIGHT; GlyphY++) {
+        CopyMem (Pixel, Glyph, EFI_GLYPH_WIDTH * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL));
+        Pixel += Width;
+        Glyph += EFI_GLYPH_WIDTH;
+      }
+    }
+
+    if (Private->GraphicsOutput != NULL) {
+      BltStatus = Private->GraphicsOutput->Blt (
+                                             Private->GraphicsOutput,
+                                             Private->LineBuffer,
+                                             EfiBltBufferToVideo,
+                                             0,
+                                             0,
+                                             Span->Start * EFI_GLYPH_WIDTH + ModeData->DeltaX,
+                                             Row * EFI_GLYPH_HEIGHT + ModeData->DeltaY,
+                                             Width,
+                                             EFI_GLYPH_HEIGHT,
+                                             Width * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL)
+                                             );
+    } else if (FeaturePcdGet (PcdUgaConsumeSupport)) {
+      BltStatus = Private->UgaDraw->Blt (
+                                      Private->UgaDraw,
+                                      (EFI_UGA_PIXEL *) Private->LineBuffer,
+                                      EfiUgaBltBufferToVideo,
+                                      0,
+                                      0,
+                                      Span->Start * EFI_GLYPH_WIDTH + ModeData->DeltaX,
+                                      Row * EFI_GLYPH_HEIGHT + ModeData->DeltaY,
+                                      Width,
+                                      EFI_GLYPH_HEIGHT,
+                                      Width * sizeof (EFI_UGA_PIXEL)
+                                      );
+    } else {
+      BltStatus = EFI_UNSUPPORTED;
+    }
+
+    if (EFI_ERROR (BltStatus)) {
+      Status = BltStatus;
+    }
+
+    Span->Start = 0;
+    Span->End   = 0;
+  }
+
+  return Status;
+}
+
 /**
   Draw Unicode string on the Graphics Console device's screen.
 
+  Narrow characters are only written to the shadow text buffer, and drawn from
+  the glyph cache by FlushDirtyCells (), which is called before the cursor is
+  flushed or the screen is scrolled. Wide characters are drawn immediately by
+  the HII Font protocol.
+
   @param  This                  Protocol instance pointer.
   @param  UnicodeWeight         One Unicode string to be displayed.
   @param  Count                 The count of Unicode string.
@@ -1749,8 +2038,64 @@ DrawUnicodeWeightAtCursorN (
   EFI_UGA_DRAW_PROTOCOL             *UgaDraw;
   EFI_HII_ROW_INFO                  *RowInfoArray;
   UINTN                             RowInfoArraySize;
+  GRAPHICS_CONSOLE_MODE_DATA        *ModeData;
+  GRAPHICS_CONSOLE_DIRTY_SPAN       *Span;
+  GRAPHICS_CONSOLE_CELL             *Cell;
+  UINT8                             Attribute;
+  UINTN                             Column;
+  UINTN                             Index;
+
+  Private   = GRAPHICS_CONSOLE_CON_OUT_DEV_FROM_THIS (This);
+  ModeData  = &Private->ModeData[This->Mode->Mode];
+  Column    = (UINTN) This->Mode->CursorColumn;
+  Cell      = &Private->TextBuffer[This->Mode->CursorRow * ModeData->Columns + Column];
+  Attribute = (UINT8) This->Mode->Attribute;
+
+  if (Count == 0) {
+    return EFI_SUCCESS;
+  }
+
+  if ((Attribute & EFI_WIDE_ATTRIBUTE) == 0) {
+    //
+    // Write the characters to the shadow text buffer and extend the dirty span
+    // of the row. A span only covers written cells, so the pending characters
+    // are drawn first if the new ones are not adjacent to them.
+    //
+    Span = &Private->DirtySpan[This->Mode->CursorRow];
+    if (Span->Start < Span->End && (Column > Span->End || Column + Count < Span->Start)) {
+      FlushDirtyCells (This);
+    }
+
+    for (Index = 0; Index < Count; Index++) {
+      Cell[Index].Char      = UnicodeWeight[Index];
+      Cell[Index].Attribute = Attribute;
+    }
+
+    if (Span->Start >= Span->End) {
+      Span->Start = Column;
+      Span->End   = Column + Count;
+    } else {
+      Span->Start = MIN (Span->Start, Column);
+      Span->End   = MAX (Span->End, Column + Count);
+    }
+    Private->HasDirtyCells = TRUE;
+    return EFI_SUCCESS;
+  }
+
+  //
+  // Wide characters are drawn over the pending narrow ones, so draw those first.
+  // The second column of a wide character is recorded with a null character.
+  //
+  FlushDirtyCells (This);
+  for (Index = 0; Index < Count && Column + 2 * Index < ModeData->Columns; Index++) {
+    Cell[2 * Index].Char      = UnicodeWeight[Index];
+    Cell[2 * Index].Attribute = Attribute;
+    if (Column + 2 * Index + 1 < ModeData->Columns) {
+      Cell[2 * Index + 1].Char      = CHAR_NULL;
+      Cell[2 * Index + 1].Attribute = Attribute;
+    }
+  }
 
-  Private = GRAPHICS_CONSOLE_CON_OUT_DEV_FROM_THIS (This);
   Blt = (EFI_IMAGE_OUTPUT *) AllocateZeroPool (sizeof (EFI_IMAGE_OUTPUT));
   if (Blt == NULL) {
     return EFI_OUT_OF_RESOURCES;
@@ -1904,6 +2249,11 @@ FlushCursor (
 
   CurrentMode = This->Mode;
 
+  //
+  // Draw the pending characters first, the cursor is drawn over them
+  //
+  FlushDirtyCells (This);
+
   if (!CurrentMode->CursorVisible) {
     return EFI_SUCCESS;
   }
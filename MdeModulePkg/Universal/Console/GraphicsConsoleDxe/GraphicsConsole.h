@@ -63,6 +63,39 @@ typedef struct {
   UINT32  GopModeNumber;
 } GRAPHICS_CONSOLE_MODE_DATA;
 
+//
+// Narrow characters are drawn from a direct mapped cache of character cells
+// already rendered by the HII Font protocol in a given text attribute.
+//
+#define GRAPHICS_CONSOLE_GLYPH_CACHE_SIZE   512
+
+#define GRAPHICS_CONSOLE_GLYPH_HASH(Char, Attribute) \
+  (((UINTN) (Char) + (UINTN) (Attribute) * 97) % GRAPHICS_CONSOLE_GLYPH_CACHE_SIZE)
+
+typedef struct {
+  CHAR16                           Char;
+  UINT8                            Attribute;
+  BOOLEAN                          Valid;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL    Bitmap[EFI_GLYPH_HEIGHT * EFI_GLYPH_WIDTH];
+} GRAPHICS_CONSOLE_GLYPH;
+
+//
+// One character cell of the shadow text buffer.
+//
+typedef struct {
+  CHAR16                           Char;
+  UINT8                            Attribute;
+} GRAPHICS_CONSOLE_CELL;
+
+//
+// The columns [Start, End) of a row that were written to the shadow text
+// buffer but not yet drawn on the screen.
+//
+typedef struct {
+  UINTN                            Start;
+  UINTN                            End;
+} GRAPHICS_CONSOLE_DIRTY_SPAN;
+
 typedef struct {
   UINTN                            Signature;
   EFI_GRAPHICS_OUTPUT_PROTOCOL     *GraphicsOutput;
@@ -71,6 +104,10 @@ typedef struct {
   EFI_SIMPLE_TEXT_OUTPUT_MODE      SimpleTextOutputMode;
   GRAPHICS_CONSOLE_MODE_DATA       *ModeData;
   EFI_GRAPHICS_OUTPUT_BLT_PIXEL    *LineBuffer;
+  GRAPHICS_CONSOLE_CELL            *TextBuffer;
+  GRAPHICS_CONSOLE_DIRTY_SPAN      *DirtySpan;
+  BOOLEAN                          HasDirtyCells;
+  GRAPHICS_CONSOLE_GLYPH           *GlyphCache;
 } GRAPHICS_CONSOLE_DEV;
 
 #define GRAPHICS_CONSOLE_CON_OUT_DEV_FROM_THIS(a) \
@@ -552,6 +589,61 @@ DrawUnicodeWeightAtCursorN (
   IN  UINTN                            Count
   );
 
+/**
+  Fill cells of the shadow text buffer with blanks of a text attribute.
+
+  @param  Cell                  The first cell to fill.
+  @param  Count                 The number of cells to fill.
+  @param  Attribute             The text attribute of the blanks.
+
+**/
+VOID
+FillTextCells (
+  IN  GRAPHICS_CONSOLE_CELL            *Cell,
+  IN  UINTN                            Count,
+  IN  UINT8                            Attribute
+  );
+
+/**
+  Get the pixels of a narrow character drawn in a text attribute.
+
+  The character cell is taken from the glyph cache. On a miss it is rendered
+  by the HII Font protocol into the cache entry of the character, replacing
+  the character previously held by the entry.
+
+  @param  Private               The Graphics Console device.
+  @param  Char                  The character to draw.
+  @param  Attribute             The text attribute of the character.
+
+  @return The EFI_GLYPH_WIDTH x EFI_GLYPH_HEIGHT pixels of the character cell.
+          A character without glyph is drawn as a blank and is not cached, so
+          that a font registered later is used.
+
+**/
+EFI_GRAPHICS_OUTPUT_BLT_PIXEL *
+GetCachedGlyph (
+  IN  GRAPHICS_CONSOLE_DEV             *Private,
+  IN  CHAR16                           Char,
+  IN  UINT8                            Attribute
+  );
+
+/**
+  Draw the characters written to the shadow text buffer since the last call,
+  with one Blt for every row that was written.
+
+  @param  This                  Protocol instance pointer.
+
+  @retval EFI_SUCCESS           The written characters are drawn.
+  @retval EFI_UNSUPPORTED       If no Graphics Output protocol and UGA Draw
+                                protocol exist.
+  @retval Others                The Blt failed.
+
+**/
+EFI_STATUS
+FlushDirtyCells (
+  IN  EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL  *This
+  );
+
 /**
   Flush the cursor on the screen.
   
@@ -1218,6 +1218,10 @@ Error:
         FreePool (TerminalDevice->TerminalConsoleModeData);
       }
 
+      if (TerminalDevice->ShadowChar != NULL) {
+        FreePool (TerminalDevice->ShadowChar);
+      }
+
       FreePool (TerminalDevice);
     }
   }
@@ -1392,6 +1396,9 @@ TerminalDriverBindingStop (
         if (TerminalDevice->TerminalConsoleModeData != NULL) {
           FreePool (TerminalDevice->TerminalConsoleModeData);
         }
+        if (TerminalDevice->ShadowChar != NULL) {
+          FreePool (TerminalDevice->ShadowChar);
+        }
         FreePool (TerminalDevice);
       }
     }
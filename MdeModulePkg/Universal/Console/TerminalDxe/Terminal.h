@@ -69,6 +69,11 @@ typedef struct {
 
 #define KEYBOARD_TIMER_INTERVAL         200000  // 0.02s
 
+//
+// Bytes gathered before they are sent to the serial device in one write.
+//
+#define TERMINAL_OUTPUT_BUFFER_SIZE     64
+
 #define TERMINAL_DEV_SIGNATURE  SIGNATURE_32 ('t', 'm', 'n', 'l')
 
 #define TERMINAL_CONSOLE_IN_EX_NOTIFY_SIGNATURE SIGNATURE_32 ('t', 'm', 'e', 'n')
@@ -109,6 +114,26 @@ typedef struct {
   BOOLEAN                             OutputEscChar;
   EFI_SIMPLE_TEXT_INPUT_EX_PROTOCOL   SimpleInputEx;
   LIST_ENTRY                          NotifyList;
+
+  //
+  // Shadow of the screen of the remote terminal, one character and one
+  // attribute per cell of the current mode. A character of zero marks a cell
+  // whose content is unknown. Only the cells that differ from the shadow are
+  // sent, and the cursor and the attribute of the remote terminal, tracked
+  // separately from SimpleTextOutputMode, are changed only when a cell needs
+  // them. ShadowChar is NULL when PcdTerminalShadowScreen is FALSE.
+  //
+  CHAR16                              *ShadowChar;
+  UINT8                               *ShadowAttribute;
+  UINTN                               ShadowColumns;
+  UINTN                               ShadowRows;
+  INT32                               RemoteColumn;       // -1 if unknown
+  INT32                               RemoteRow;          // -1 if unknown
+  INT32                               RemoteAttribute;    // -1 if unknown
+  BOOLEAN                             RemoteWrapPending;  // The last column was written
+
+  UINTN                               OutputCount;
+  UINT8                               OutputBuffer[TERMINAL_OUTPUT_BUFFER_SIZE];
 } TERMINAL_DEV;
 
 #define INPUT_STATE_DEFAULT               0x00
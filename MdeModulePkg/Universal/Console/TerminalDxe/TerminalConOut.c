@@ -83,6 +83,682 @@ CHAR16 mSetAttributeString[]       = { ESC, '[', '0', 'm', ESC, '[', '4', '0', '
 CHAR16 mClearScreenString[]        = { ESC, '[', '2', 'J', 0 };
 CHAR16 mSetCursorPositionString[]  = { ESC, '[', '0', '0', ';', '0', '0', 'H', 0 };
 
+//
+// ANSI color of the EFI colors, the offset from 30 for the foreground
+// and from 40 for the background.
+//
+UINT8  mAnsiColor[] = { 0, 4, 2, 6, 1, 5, 3, 7 };
+
+/**
+  Send the bytes gathered in the output buffer to the serial device.
+
+  @param  TerminalDevice    The terminal device.
+
+  @retval EFI_SUCCESS       The bytes are sent.
+  @retval Others            The serial device failed to send the bytes.
+
+**/
+EFI_STATUS
+TerminalFlushOutput (
+  IN TERMINAL_DEV  *TerminalDevice
+  )
+{
+  UINTN  Length;
+
+  if (TerminalDevice->OutputCount == 0) {
+    return EFI_SUCCESS;
+  }
+
+  Length                      = TerminalDevice->OutputCount;
+  TerminalDevice->OutputCount = 0;
+
+  return TerminalDevice->SerialIo->Write (
+                                     TerminalDevice->SerialIo,
+                                     &Length,
+                                     TerminalDevice->OutputBuffer
+                                     );
+}
+
+/**
+  Append bytes to the output buffer, sending the buffer first if they do not fit.
+
+  @param  TerminalDevice    The terminal device.
+  @param  Buffer            The bytes to append.
+  @param  Length            The number of bytes, at most TERMINAL_OUTPUT_BUFFER_SIZE.
+
+  @retval EFI_SUCCESS       The bytes are appended.
+  @retval Others            The serial device failed to send the buffer.
+
+**/
+EFI_STATUS
+TerminalWriteOutput (
+  IN TERMINAL_DEV  *TerminalDevice,
+  IN UINT8         *Buffer,
+  IN UINTN         Length
+  )
+{
+  EFI_STATUS  Status;
+
+  ASSERT (Length <= TERMINAL_OUTPUT_BUFFER_SIZE);
+
+  if (TerminalDevice->OutputCount + Length > TERMINAL_OUTPUT_BUFFER_SIZE) {
+    Status = TerminalFlushOutput (TerminalDevice);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  CopyMem (&TerminalDevice->OutputBuffer[TerminalDevice->OutputCount], Buffer, Length);
+  TerminalDevice->OutputCount += Length;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Convert a Unicode character to the bytes expected by the terminal type.
+
+  @param  TerminalDevice    The terminal device.
+  @param  Unicode           The Unicode character.
+  @param  Buffer            Receives the bytes, at least sizeof (UTF8_CHAR) bytes.
+  @param  Warning           Set to TRUE if the character cannot be rendered and
+                            is replaced by '?'.
+
+  @return The number of bytes in Buffer.
+
+**/
+UINTN
+TerminalEncodeChar (
+  IN     TERMINAL_DEV  *TerminalDevice,
+  IN     CHAR16        Unicode,
+  OUT    UINT8         *Buffer,
+  IN OUT BOOLEAN       *Warning
+  )
+{
+  UTF8_CHAR  Utf8Char;
+  UINT8      ValidBytes;
+  CHAR8      GraphicChar;
+  CHAR8      AsciiChar;
+
+  if (TerminalDevice->TerminalType == VTUTF8TYPE) {
+    ValidBytes = 0;
+    UnicodeToUtf8 (Unicode, &Utf8Char, &ValidBytes);
+    CopyMem (Buffer, &Utf8Char, ValidBytes);
+    return ValidBytes;
+  }
+
+  AsciiChar = 0;
+  if (!TerminalIsValidTextGraphics (Unicode, &GraphicChar, &AsciiChar)) {
+    //
+    // If it's not a graphic character convert Unicode to ASCII.
+    //
+    GraphicChar = (CHAR8) Unicode;
+
+    if (!(TerminalIsValidAscii (GraphicChar) || TerminalIsValidEfiCntlChar (GraphicChar))) {
+      //
+      // when this driver use the OutputString to output control string,
+      // TerminalDevice->OutputEscChar is set to let the Esc char
+      // to be output to the terminal emulation software.
+      //
+      if ((GraphicChar == 27) && TerminalDevice->OutputEscChar) {
+        GraphicChar = 27;
+      } else {
+        GraphicChar = '?';
+        *Warning    = TRUE;
+      }
+    }
+
+    AsciiChar = GraphicChar;
+  }
+
+  if (TerminalDevice->TerminalType != PCANSITYPE) {
+    GraphicChar = AsciiChar;
+  }
+
+  *Buffer = (UINT8) GraphicChar;
+  return 1;
+}
+
+/**
+  Append the decimal digits of a number to a control sequence.
+
+  @param  Buffer            Receives the digits.
+  @param  Value             The number.
+
+  @return The number of digits.
+
+**/
+UINTN
+TerminalAppendDecimal (
+  OUT UINT8  *Buffer,
+  IN  UINTN  Value
+  )
+{
+  UINTN  Length;
+  UINTN  Divisor;
+
+  for (Divisor = 1; Value / Divisor >= 10; Divisor *= 10) {
+    ;
+  }
+
+  for (Length = 0; Divisor != 0; Divisor /= 10) {
+    Buffer[Length++] = (UINT8) ('0' + (Value / Divisor) % 10);
+  }
+
+  return Length;
+}
+
+/**
+  Forget the content, the cursor and the attribute of the remote terminal,
+  so that they are all sent again.
+
+  @param  TerminalDevice    The terminal device.
+
+**/
+VOID
+TerminalInvalidateShadowScreen (
+  IN TERMINAL_DEV  *TerminalDevice
+  )
+{
+  if (TerminalDevice->ShadowChar != NULL) {
+    ZeroMem (
+      TerminalDevice->ShadowChar,
+      TerminalDevice->ShadowColumns * TerminalDevice->ShadowRows * sizeof (CHAR16)
+      );
+  }
+
+  TerminalDevice->RemoteColumn      = -1;
+  TerminalDevice->RemoteRow         = -1;
+  TerminalDevice->RemoteAttribute   = -1;
+  TerminalDevice->RemoteWrapPending = FALSE;
+}
+
+/**
+  Scroll the shadow screen up by one line, as the remote terminal does on a
+  line feed on its last line. The new last line is unknown.
+
+  @param  TerminalDevice    The terminal device.
+
+**/
+VOID
+TerminalScrollShadowScreen (
+  IN TERMINAL_DEV  *TerminalDevice
+  )
+{
+  UINTN  Cells;
+
+  Cells = TerminalDevice->ShadowColumns * (TerminalDevice->ShadowRows - 1);
+
+  CopyMem (
+    TerminalDevice->ShadowChar,
+    TerminalDevice->ShadowChar + TerminalDevice->ShadowColumns,
+    Cells * sizeof (CHAR16)
+    );
+  CopyMem (
+    TerminalDevice->ShadowAttribute,
+    TerminalDevice->ShadowAttribute + TerminalDevice->ShadowColumns,
+    Cells
+    );
+  ZeroMem (TerminalDevice->ShadowChar + Cells, TerminalDevice->ShadowColumns * sizeof (CHAR16));
+}
+
+/**
+  Check whether a cell is where the remote terminal wraps by itself when it
+  receives the next character after writing its last column.
+
+  @param  TerminalDevice    The terminal device.
+  @param  Column            The column of the cell.
+  @param  Row               The row of the cell.
+
+  @retval TRUE              The next character goes to the cell without a cursor move.
+  @retval FALSE             The cursor must be moved to the cell.
+
+**/
+BOOLEAN
+TerminalIsWrapTarget (
+  IN TERMINAL_DEV  *TerminalDevice,
+  IN INT32         Column,
+  IN INT32         Row
+  )
+{
+  if (!TerminalDevice->RemoteWrapPending || Column != 0) {
+    return FALSE;
+  }
+
+  if (TerminalDevice->RemoteRow == (INT32) (TerminalDevice->ShadowRows - 1)) {
+    return (BOOLEAN) (Row == TerminalDevice->RemoteRow);
+  }
+
+  return (BOOLEAN) (Row == TerminalDevice->RemoteRow + 1);
+}
+
+/**
+  Move the cursor of the remote terminal with the shortest sequence: a carriage
+  return or line feed, the cells already shown with the current attribute, a
+  relative move or, when nothing shorter applies, an absolute position.
+
+  @param  TerminalDevice    The terminal device.
+  @param  Column            The column to move the cursor to.
+  @param  Row               The row to move the cursor to.
+
+  @retval EFI_SUCCESS       The cursor is moved.
+  @retval Others            The serial device failed to send the sequence.
+
+**/
+EFI_STATUS
+TerminalMoveRemoteCursor (
+  IN TERMINAL_DEV  *TerminalDevice,
+  IN INT32         Column,
+  IN INT32         Row
+  )
+{
+  UINT8   Sequence[16];
+  UINTN   Length;
+  UINTN   Distance;
+  UINTN   Index;
+  UINTN   Cell;
+  CHAR8   Final;
+
+  if (!TerminalDevice->RemoteWrapPending &&
+      TerminalDevice->RemoteColumn == Column &&
+      TerminalDevice->RemoteRow == Row) {
+    return EFI_SUCCESS;
+  }
+
+  Length   = 0;
+  Distance = 0;
+  Final    = 0;
+
+  if (TerminalDevice->RemoteWrapPending || TerminalDevice->RemoteColumn < 0 || TerminalDevice->RemoteRow < 0) {
+    //
+    // An absolute position also cancels the pending wrap of the remote terminal.
+    //
+  } else if (Row == TerminalDevice->RemoteRow && Column == 0) {
+    Sequence[Length++] = CHAR_CARRIAGE_RETURN;
+  } else if (Row == TerminalDevice->RemoteRow && Column > TerminalDevice->RemoteColumn) {
+    Distance = (UINTN) (Column - TerminalDevice->RemoteColumn);
+    Final    = 'C';
+
+    //
+    // Sending again a few cells already shown with the current attribute is
+    // shorter than the control sequence.
+    //
+    if (Distance <= 3) {
+      Cell = (UINTN) Row * TerminalDevice->ShadowColumns + (UINTN) TerminalDevice->RemoteColumn;
+      for (Index = 0; Index < Distance; Index++, Cell++) {
+        if (!TerminalIsValidAscii (TerminalDevice->ShadowChar[Cell]) ||
+            TerminalDevice->ShadowAttribute[Cell] != (UINT8) TerminalDevice->RemoteAttribute) {
+          break;
+        }
+        Sequence[Length++] = (UINT8) TerminalDevice->ShadowChar[Cell];
+      }
+
+      if (Index == Distance) {
+        Final = 0;
+      } else {
+        Length = 0;
+      }
+    }
+  } else if (Row == TerminalDevice->RemoteRow) {
+    Distance = (UINTN) (TerminalDevice->RemoteColumn - Column);
+    Final    = 'D';
+  } else if (Column == 0 && Row == TerminalDevice->RemoteRow + 1) {
+    Sequence[Length++] = CHAR_CARRIAGE_RETURN;
+    Sequence[Length++] = CHAR_LINEFEED;
+  } else if (Column == TerminalDevice->RemoteColumn && Row == TerminalDevice->RemoteRow + 1) {
+    Sequence[Length++] = CHAR_LINEFEED;
+  } else if (Column == TerminalDevice->RemoteColumn) {
+    if (Row > TerminalDevice->RemoteRow) {
+      Distance = (UINTN) (Row - TerminalDevice->RemoteRow);
+      Final    = 'B';
+    } else {
+      Distance = (UINTN) (TerminalDevice->RemoteRow - Row);
+      Final    = 'A';
+    }
+  }
+
+  if (Final != 0) {
+    //
+    // Relative move, the count is omitted when it is 1.
+    //
+    Sequence[Length++] = ESC;
+    Sequence[Length++] = LEFTOPENBRACKET;
+    if (Distance > 1) {
+      Length += TerminalAppendDecimal (&Sequence[Length], Distance);
+    }
+    Sequence[Length++] = Final;
+  } else if (Length == 0) {
+    //
+    // Absolute position, the column is omitted when it is the first one.
+    //
+    Sequence[Length++] = ESC;
+    Sequence[Length++] = LEFTOPENBRACKET;
+    Length += TerminalAppendDecimal (&Sequence[Length], (UINTN) Row + 1);
+    if (Column != 0) {
+      Sequence[Length++] = ';';
+      Length += TerminalAppendDecimal (&Sequence[Length], (UINTN) Column + 1);
+    }
+    Sequence[Length++] = 'H';
+  }
+
+  TerminalDevice->RemoteColumn      = Column;
+  TerminalDevice->RemoteRow         = Row;
+  TerminalDevice->RemoteWrapPending = FALSE;
+
+  return TerminalWriteOutput (TerminalDevice, Sequence, Length);
+}
+
+/**
+  Change the attribute of the remote terminal, sending only the parts that differ.
+
+  @param  TerminalDevice    The terminal device.
+  @param  Attribute         The attribute to set.
+
+  @retval EFI_SUCCESS       The attribute is set.
+  @retval Others            The serial device failed to send the sequence.
+
+**/
+EFI_STATUS
+TerminalSetRemoteAttribute (
+  IN TERMINAL_DEV  *TerminalDevice,
+  IN INT32         Attribute
+  )
+{
+  UINT8    Sequence[16];
+  UINTN    Length;
+  INT32    Remote;
+  BOOLEAN  Separator;
+
+  Remote = TerminalDevice->RemoteAttribute;
+  if (Remote == Attribute) {
+    return EFI_SUCCESS;
+  }
+
+  Length             = 0;
+  Separator          = FALSE;
+  Sequence[Length++] = ESC;
+  Sequence[Length++] = LEFTOPENBRACKET;
+
+  if (Remote < 0 || ((Remote & EFI_BRIGHT) != 0 && (Attribute & EFI_BRIGHT) == 0)) {
+    //
+    // Bright can only be turned off by resetting all the attributes, so the
+    // colors are sent again as well.
+    //
+    Sequence[Length++] = (UINT8) ('0' + ((Attribute >> 3) & 1));
+    Separator          = TRUE;
+    Remote             = -1;
+  } else if ((Remote & EFI_BRIGHT) == 0 && (Attribute & EFI_BRIGHT) != 0) {
+    Sequence[Length++] = '1';
+    Separator          = TRUE;
+  }
+
+  if (Remote < 0 || (Remote & 0x07) != (Attribute & 0x07)) {
+    if (Separator) {
+      Sequence[Length++] = ';';
+    }
+    Sequence[Length++] = '3';
+    Sequence[Length++] = (UINT8) ('0' + mAnsiColor[Attribute & 0x07]);
+    Separator          = TRUE;
+  }
+
+  if (Remote < 0 || (Remote & 0x70) != (Attribute & 0x70)) {
+    if (Separator) {
+      Sequence[Length++] = ';';
+    }
+    Sequence[Length++] = '4';
+    Sequence[Length++] = (UINT8) ('0' + mAnsiColor[(Attribute >> 4) & 0x07]);
+  }
+
+  Sequence[Length++] = 'm';
+
+  TerminalDevice->RemoteAttribute = Attribute;
+
+  return TerminalWriteOutput (TerminalDevice, Sequence, Length);
+}
+
+/**
+  Size the shadow screen for a text mode and mark its content unknown. The
+  terminal is used without a shadow screen if it cannot be allocated.
+
+  @param  TerminalDevice    The terminal device.
+  @param  ModeNumber        The text mode.
+
+**/
+VOID
+TerminalCreateShadowScreen (
+  IN TERMINAL_DEV  *TerminalDevice,
+  IN UINTN         ModeNumber
+  )
+{
+  UINTN  Columns;
+  UINTN  Rows;
+
+  Columns = TerminalDevice->TerminalConsoleModeData[ModeNumber].Columns;
+  Rows    = TerminalDevice->TerminalConsoleModeData[ModeNumber].Rows;
+
+  if (TerminalDevice->ShadowChar != NULL &&
+      (TerminalDevice->ShadowColumns != Columns || TerminalDevice->ShadowRows != Rows)) {
+    //
+    // Leave the attribute of the mode data on the remote terminal, the
+    // attributes are sent as requested again if the allocation fails.
+    //
+    TerminalSetRemoteAttribute (TerminalDevice, TerminalDevice->SimpleTextOutputMode.Attribute);
+    FreePool (TerminalDevice->ShadowChar);
+    TerminalDevice->ShadowChar      = NULL;
+    TerminalDevice->ShadowAttribute = NULL;
+  }
+
+  if (TerminalDevice->ShadowChar == NULL) {
+    TerminalDevice->ShadowChar = AllocatePool (Columns * Rows * (sizeof (CHAR16) + sizeof (UINT8)));
+    if (TerminalDevice->ShadowChar == NULL) {
+      return;
+    }
+
+    TerminalDevice->ShadowAttribute = (UINT8 *) (TerminalDevice->ShadowChar + Columns * Rows);
+    TerminalDevice->ShadowColumns   = Columns;
+    TerminalDevice->ShadowRows      = Rows;
+  }
+
+  TerminalInvalidateShadowScreen (TerminalDevice);
+}
+
+/**
+  Send a character to a cell of the shadow screen, with the cursor move and
+  the attribute change it needs, if any.
+
+  @param  TerminalDevice    The terminal device.
+  @param  Unicode           The character.
+  @param  Warning           Set to TRUE if the character cannot be rendered.
+
+  @retval EFI_SUCCESS       The character is sent.
+  @retval Others            The serial device failed to send the character.
+
+**/
+EFI_STATUS
+TerminalWriteShadowCell (
+  IN     TERMINAL_DEV  *TerminalDevice,
+  IN     CHAR16        Unicode,
+  IN OUT BOOLEAN       *Warning
+  )
+{
+  EFI_SIMPLE_TEXT_OUTPUT_MODE *Mode;
+  UINTN                       Cell;
+  UINTN                       Length;
+  UINT8                       Buffer[sizeof (UTF8_CHAR)];
+  EFI_STATUS                  Status;
+
+  Mode = &TerminalDevice->SimpleTextOutputMode;
+  Cell = (UINTN) Mode->CursorRow * TerminalDevice->ShadowColumns + (UINTN) Mode->CursorColumn;
+
+  if (TerminalIsWrapTarget (TerminalDevice, Mode->CursorColumn, Mode->CursorRow)) {
+    if (TerminalDevice->RemoteRow == (INT32) (TerminalDevice->ShadowRows - 1)) {
+      TerminalScrollShadowScreen (TerminalDevice);
+    }
+
+    TerminalDevice->RemoteColumn      = 0;
+    TerminalDevice->RemoteRow         = Mode->CursorRow;
+    TerminalDevice->RemoteWrapPending = FALSE;
+  } else {
+    Status = TerminalMoveRemoteCursor (TerminalDevice, Mode->CursorColumn, Mode->CursorRow);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  Status = TerminalSetRemoteAttribute (TerminalDevice, Mode->Attribute);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Length = TerminalEncodeChar (TerminalDevice, Unicode, Buffer, Warning);
+  Status = TerminalWriteOutput (TerminalDevice, Buffer, Length);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (TerminalIsValidEfiCntlChar (Unicode)) {
+    //
+    // A tab moves the remote cursor to a position this driver does not know.
+    //
+    TerminalDevice->ShadowChar[Cell] = CHAR_NULL;
+    TerminalDevice->RemoteColumn     = -1;
+  } else {
+    TerminalDevice->ShadowChar[Cell]      = Unicode;
+    TerminalDevice->ShadowAttribute[Cell] = (UINT8) Mode->Attribute;
+    if (TerminalDevice->RemoteColumn < (INT32) (TerminalDevice->ShadowColumns - 1)) {
+      TerminalDevice->RemoteColumn++;
+    } else {
+      TerminalDevice->RemoteWrapPending = TRUE;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Output a string through the shadow screen. The characters already shown in
+  their cell with the same attribute are skipped, the others are sent with
+  TerminalWriteShadowCell (). The cursor of the remote terminal is left at the
+  cursor position of the mode data.
+
+  @param  TerminalDevice    The terminal device.
+  @param  WString           The Null-terminated Unicode string to be displayed.
+  @param  Warning           Set to TRUE if some characters cannot be rendered.
+
+  @retval EFI_SUCCESS       The string is output.
+  @retval Others            The serial device failed to send the string.
+
+**/
+EFI_STATUS
+TerminalShadowOutputString (
+  IN     TERMINAL_DEV  *TerminalDevice,
+  IN     CHAR16        *WString,
+  IN OUT BOOLEAN       *Warning
+  )
+{
+  EFI_SIMPLE_TEXT_OUTPUT_MODE *Mode;
+  INT32                       MaxColumn;
+  INT32                       MaxRow;
+  INT32                       Column;
+  UINTN                       Cell;
+  UINT8                       LineFeed;
+  UINT8                       Skipped[sizeof (UTF8_CHAR)];
+  EFI_STATUS                  Status;
+
+  Mode      = &TerminalDevice->SimpleTextOutputMode;
+  MaxColumn = (INT32) TerminalDevice->ShadowColumns;
+  MaxRow    = (INT32) TerminalDevice->ShadowRows;
+
+  for (; *WString != CHAR_NULL; WString++) {
+    switch (*WString) {
+
+    case CHAR_BACKSPACE:
+      if (Mode->CursorColumn > 0) {
+        Mode->CursorColumn--;
+      }
+      break;
+
+    case CHAR_CARRIAGE_RETURN:
+      Mode->CursorColumn = 0;
+      break;
+
+    case CHAR_LINEFEED:
+      if (Mode->CursorRow < MaxRow - 1) {
+        Mode->CursorRow++;
+        break;
+      }
+
+      //
+      // A line feed on the last line scrolls the screen up, from any column.
+      //
+      Column = Mode->CursorColumn;
+      if (!TerminalDevice->RemoteWrapPending &&
+          TerminalDevice->RemoteRow == MaxRow - 1 &&
+          TerminalDevice->RemoteColumn >= 0) {
+        Column = TerminalDevice->RemoteColumn;
+      }
+
+      Status = TerminalMoveRemoteCursor (TerminalDevice, Column, Mode->CursorRow);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+
+      LineFeed = CHAR_LINEFEED;
+      Status   = TerminalWriteOutput (TerminalDevice, &LineFeed, 1);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+
+      TerminalScrollShadowScreen (TerminalDevice);
+      break;
+
+    default:
+      //
+      // A character wrapping from the last cell of the screen scrolls it up,
+      // so it is sent even if the cell already shows it.
+      //
+      Cell = (UINTN) Mode->CursorRow * TerminalDevice->ShadowColumns + (UINTN) Mode->CursorColumn;
+      if (TerminalDevice->ShadowChar[Cell] != *WString ||
+          TerminalDevice->ShadowAttribute[Cell] != (UINT8) Mode->Attribute ||
+          (TerminalIsWrapTarget (TerminalDevice, Mode->CursorColumn, Mode->CursorRow) &&
+           TerminalDevice->RemoteRow == MaxRow - 1)) {
+        Status = TerminalWriteShadowCell (TerminalDevice, *WString, Warning);
+        if (EFI_ERROR (Status)) {
+          return Status;
+        }
+      } else {
+        //
+        // The cell isn't sent again, but the caller is still told when the
+        // character can't be rendered.
+        //
+        TerminalEncodeChar (TerminalDevice, *WString, Skipped, Warning);
+      }
+
+      if (Mode->CursorColumn < MaxColumn - 1) {
+        Mode->CursorColumn++;
+      } else {
+        Mode->CursorColumn = 0;
+        if (Mode->CursorRow < MaxRow - 1) {
+          Mode->CursorRow++;
+        }
+      }
+      break;
+    }
+  }
+
+  //
+  // Leave the remote cursor where the next character goes, unless the remote
+  // terminal will wrap there by itself.
+  //
+  if (!TerminalIsWrapTarget (TerminalDevice, Mode->CursorColumn, Mode->CursorRow)) {
+    Status = TerminalMoveRemoteCursor (TerminalDevice, Mode->CursorColumn, Mode->CursorRow);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  return TerminalFlushOutput (TerminalDevice);
+}
+
 //
 // Body of the ConOut functions
 //
@@ -180,20 +856,15 @@ TerminalConOutOutputString (
   UINTN                       MaxColumn;
   UINTN                       MaxRow;
   UINTN                       Length;
-  UTF8_CHAR                   Utf8Char;
-  CHAR8                       GraphicChar;
-  CHAR8                       AsciiChar;
+  UINT8                       Buffer[sizeof (UTF8_CHAR)];
   EFI_STATUS                  Status;
-  UINT8                       ValidBytes;
   //
   //  flag used to indicate whether condition happens which will cause
   //  return EFI_WARN_UNKNOWN_GLYPH
   //
   BOOLEAN                     Warning;
 
-  ValidBytes  = 0;
   Warning     = FALSE;
-  AsciiChar   = 0;
 
   //
   //  get Terminal device data structure pointer.
@@ -216,69 +887,23 @@ TerminalConOutOutputString (
           &MaxRow
           );
 
-  for (; *WString != CHAR_NULL; WString++) {
-
-    switch (TerminalDevice->TerminalType) {
-
-    case PCANSITYPE:
-    case VT100TYPE:
-    case VT100PLUSTYPE:
-
-      if (!TerminalIsValidTextGraphics (*WString, &GraphicChar, &AsciiChar)) {
-        //
-        // If it's not a graphic character convert Unicode to ASCII.
-        //
-        GraphicChar = (CHAR8) *WString;
-
-        if (!(TerminalIsValidAscii (GraphicChar) || TerminalIsValidEfiCntlChar (GraphicChar))) {
-          //
-          // when this driver use the OutputString to output control string,
-          // TerminalDevice->OutputEscChar is set to let the Esc char
-          // to be output to the terminal emulation software.
-          //
-          if ((GraphicChar == 27) && TerminalDevice->OutputEscChar) {
-            GraphicChar = 27;
-          } else {
-            GraphicChar = '?';
-            Warning     = TRUE;
-          }
-        }
-
-        AsciiChar = GraphicChar;
-
-      }
-
-      if (TerminalDevice->TerminalType != PCANSITYPE) {
-        GraphicChar = AsciiChar;
-      }
-
-      Length = 1;
-
-      Status = TerminalDevice->SerialIo->Write (
-                                          TerminalDevice->SerialIo,
-                                          &Length,
-                                          &GraphicChar
-                                          );
+  if (TerminalDevice->ShadowChar != NULL && !TerminalDevice->OutputEscChar) {
+    Status = TerminalShadowOutputString (TerminalDevice, WString, &Warning);
+    if (EFI_ERROR (Status)) {
+      goto OutputError;
+    }
 
-      if (EFI_ERROR (Status)) {
-        goto OutputError;
-      }
+    return Warning ? EFI_WARN_UNKNOWN_GLYPH : EFI_SUCCESS;
+  }
 
-      break;
+  for (; *WString != CHAR_NULL; WString++) {
 
-    case VTUTF8TYPE:
-      UnicodeToUtf8 (*WString, &Utf8Char, &ValidBytes);
-      Length = ValidBytes;
-      Status = TerminalDevice->SerialIo->Write (
-                                          TerminalDevice->SerialIo,
-                                          &Length,
-                                          (UINT8 *) &Utf8Char
-                                          );
-      if (EFI_ERROR (Status)) {
-        goto OutputError;
-      }
-      break;
+    Length = TerminalEncodeChar (TerminalDevice, *WString, Buffer, &Warning);
+    Status = TerminalWriteOutput (TerminalDevice, Buffer, Length);
+    if (EFI_ERROR (Status)) {
+      goto OutputError;
     }
+
     //
     //  Update cursor position.
     //
@@ -319,6 +944,17 @@ TerminalConOutOutputString (
 
   }
 
+  Status = TerminalFlushOutput (TerminalDevice);
+  if (EFI_ERROR (Status)) {
+    goto OutputError;
+  }
+
+  //
+  // The control sequences sent by this driver may move the remote cursor.
+  //
+  TerminalDevice->RemoteColumn      = -1;
+  TerminalDevice->RemoteWrapPending = FALSE;
+
   if (Warning) {
     return EFI_WARN_UNKNOWN_GLYPH;
   }
@@ -326,6 +962,9 @@ TerminalConOutOutputString (
   return EFI_SUCCESS;
 
 OutputError:
+  TerminalDevice->OutputCount = 0;
+  TerminalInvalidateShadowScreen (TerminalDevice);
+
   REPORT_STATUS_CODE_WITH_DEVICE_PATH (
     EFI_ERROR_CODE | EFI_ERROR_MINOR,
     (EFI_PERIPHERAL_REMOTE_CONSOLE | EFI_P_EC_OUTPUT_ERROR),
@@ -467,6 +1106,10 @@ TerminalConOutSetMode (
   //
   This->Mode->Mode = (INT32) ModeNumber;
 
+  if (FeaturePcdGet (PcdTerminalShadowScreen)) {
+    TerminalCreateShadowScreen (TerminalDevice, ModeNumber);
+  }
+
   This->ClearScreen (This);
 
   TerminalDevice->OutputEscChar = TRUE;
@@ -539,6 +1182,15 @@ TerminalConOutSetAttribute (
     return EFI_SUCCESS;
   }
 
+  //
+  // With the shadow screen, the attribute is sent with the first character
+  // that needs it.
+  //
+  if (TerminalDevice->ShadowChar != NULL) {
+    This->Mode->Attribute = (INT32) Attribute;
+    return EFI_SUCCESS;
+  }
+
   //
   //  convert Attribute value to terminal emulator
   //  understandable foreground color
@@ -682,9 +1334,22 @@ TerminalConOutClearScreen (
 {
   EFI_STATUS    Status;
   TERMINAL_DEV  *TerminalDevice;
+  UINTN         Cell;
 
   TerminalDevice = TERMINAL_CON_OUT_DEV_FROM_THIS (This);
 
+  //
+  //  The screen is cleared to the background color of the current attribute.
+  //
+  if (TerminalDevice->ShadowChar != NULL) {
+    Status = TerminalSetRemoteAttribute (TerminalDevice, This->Mode->Attribute);
+    if (EFI_ERROR (Status)) {
+      TerminalDevice->OutputCount = 0;
+      TerminalInvalidateShadowScreen (TerminalDevice);
+      return EFI_DEVICE_ERROR;
+    }
+  }
+
   //
   //  control sequence for clear screen request
   //
@@ -696,6 +1361,13 @@ TerminalConOutClearScreen (
     return EFI_DEVICE_ERROR;
   }
 
+  if (TerminalDevice->ShadowChar != NULL) {
+    for (Cell = 0; Cell < TerminalDevice->ShadowColumns * TerminalDevice->ShadowRows; Cell++) {
+      TerminalDevice->ShadowChar[Cell]      = L' ';
+      TerminalDevice->ShadowAttribute[Cell] = (UINT8) This->Mode->Attribute;
+    }
+  }
+
   Status = This->SetCursorPosition (This, 0, 0);
 
   return Status;
@@ -752,6 +1424,29 @@ TerminalConOutSetCursorPosition (
   if (Column >= MaxColumn || Row >= MaxRow) {
     return EFI_UNSUPPORTED;
   }
+
+  if (TerminalDevice->ShadowChar != NULL) {
+    //
+    // The serial port may be shared with the debug output, which moves the
+    // remote cursor behind our back. An explicit request always sends an
+    // absolute position, only the moves inside OutputString () are relative.
+    //
+    TerminalDevice->RemoteColumn = -1;
+    Status = TerminalMoveRemoteCursor (TerminalDevice, (INT32) Column, (INT32) Row);
+    if (!EFI_ERROR (Status)) {
+      Status = TerminalFlushOutput (TerminalDevice);
+    }
+    if (EFI_ERROR (Status)) {
+      TerminalDevice->OutputCount = 0;
+      TerminalInvalidateShadowScreen (TerminalDevice);
+      return EFI_DEVICE_ERROR;
+    }
+
+    Mode->CursorColumn  = (INT32) Column;
+    Mode->CursorRow     = (INT32) Row;
+
+    return EFI_SUCCESS;
+  }
   //
   // control sequence to move the cursor
   //
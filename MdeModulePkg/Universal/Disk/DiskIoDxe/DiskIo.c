@@ -191,6 +191,11 @@ DiskIoDriverBindingStart (
     goto ErrorExit;
   }
 
+  Status = DiskIoCacheInitialize (Instance);
+  if (EFI_ERROR (Status)) {
+    goto ErrorExit;
+  }
+
   //
   // Install protocol interfaces for the Disk IO device.
   //
@@ -209,8 +214,24 @@ DiskIoDriverBindingStart (
                     );
   }
 
+  if (!EFI_ERROR (Status) && (Instance->Cache.BlockNum != 0)) {
+    //
+    // The cache statistics are for diagnostics only, so a failure is not fatal.
+    //
+    gBS->InstallProtocolInterface (
+           &ControllerHandle,
+           &gEdkiiDiskIoCacheProtocolGuid,
+           EFI_NATIVE_INTERFACE,
+           &Instance->DiskIoCache
+           );
+  }
+
 ErrorExit:
   if (EFI_ERROR (Status)) {
+    if (Instance != NULL) {
+      DiskIoCacheFree (Instance);
+    }
+
     if (Instance != NULL && Instance->SharedWorkingBuffer != NULL) {
       FreeAlignedPages (
         Instance->SharedWorkingBuffer,
@@ -292,6 +313,11 @@ DiskIoDriverBindingStop (
   
   Instance = DISK_IO_PRIVATE_DATA_FROM_DISK_IO (DiskIo);
 
+  //
+  // Write back the cached dirty blocks before the in-flight requests are terminated.
+  //
+  DiskIoCacheFlush (Instance);
+
   if (DiskIo2 != NULL) {
     //
     // Call BlockIo2::Reset() to terminate any in-flight non-blocking I/O requests
@@ -322,6 +348,15 @@ DiskIoDriverBindingStop (
       EfiReleaseLock (&Instance->TaskQueueLock);
     } while (!AllTaskDone);
 
+    if (Instance->Cache.BlockNum != 0) {
+      gBS->UninstallProtocolInterface (
+             ControllerHandle,
+             &gEdkiiDiskIoCacheProtocolGuid,
+             &Instance->DiskIoCache
+             );
+    }
+    DiskIoCacheFree (Instance);
+
     FreeAlignedPages (
       Instance->SharedWorkingBuffer,
       EFI_SIZE_TO_PAGES (PcdGet32 (PcdDiskIoDataBufferBlockNum) * Instance->BlockIo->Media->BlockSize)
@@ -788,6 +823,7 @@ DiskIo2ReadWriteDisk (
   EFI_TPL                OldTpl;
   BOOLEAN                Blocking;
   LIST_ENTRY             *SubtasksPtr;
+  BOOLEAN                Cached;
 
   Task      = NULL;
   BlockIo   = Instance->BlockIo;
@@ -803,6 +839,18 @@ DiskIo2ReadWriteDisk (
   if (Write && Media->ReadOnly) {
     return EFI_WRITE_PROTECTED;
   }
+
+  //
+  // Small blocking requests are served by the block cache. Other requests go to
+  // the device, which must see the dirty blocks and mustn't leave stale ones behind.
+  //
+  Cached = (BOOLEAN) (Blocking && DiskIoCacheIsCacheable (Instance, Write, Offset, BufferSize));
+  if (!Cached) {
+    Status = DiskIoCacheSyncRange (Instance, Write, Offset, BufferSize);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
   
   if (Blocking) {
     //
@@ -814,6 +862,10 @@ DiskIo2ReadWriteDisk (
       EfiReleaseLock (&Instance->TaskQueueLock);
     } while (!TaskQueueEmpty);
 
+    if (Cached) {
+      return DiskIoCacheReadWrite (Instance, Write, Offset, BufferSize, Buffer);
+    }
+
     SubtasksPtr = &Subtasks;
   } else {
     Task = AllocatePool (sizeof (DISK_IO2_TASK));
@@ -1093,6 +1145,14 @@ DiskIo2FlushDiskEx (
 
   Private = DISK_IO_PRIVATE_DATA_FROM_DISK_IO2 (This);
 
+  //
+  // The dirty blocks are written back synchronously before the device is flushed.
+  //
+  Status = DiskIoCacheFlush (Private);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
   if ((Token != NULL) && (Token->Event != NULL)) {
     Task = AllocatePool (sizeof (DISK_IO2_FLUSH_TASK));
     if (Task == NULL) {
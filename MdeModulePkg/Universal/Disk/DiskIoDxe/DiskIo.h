@@ -22,6 +22,7 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #include <Protocol/ComponentName.h>
 #include <Protocol/DriverBinding.h>
 #include <Protocol/DiskIo.h>
+#include <Protocol/DiskIoCache.h>
 #include <Library/DebugLib.h>
 #include <Library/UefiDriverEntryPoint.h>
 #include <Library/UefiLib.h>
@@ -30,6 +31,38 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #include <Library/MemoryAllocationLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 
+//
+// Number of hash buckets used to look up the cached blocks, must be a power of 2.
+//
+#define DISK_IO_CACHE_HASH_SIZE         256
+#define DISK_IO_CACHE_HASH(Lba)         ((UINTN) (Lba) & (DISK_IO_CACHE_HASH_SIZE - 1))
+#define DISK_IO_CACHE_INVALID_LBA       MAX_UINT64
+
+typedef struct {
+  LIST_ENTRY                      LruLink;  /// < link in the LRU list, most recently used first
+  LIST_ENTRY                      HashLink; /// < link in the hash bucket, empty when not valid
+  EFI_LBA                         Lba;
+  BOOLEAN                         Valid;
+  BOOLEAN                         Dirty;
+  UINT8                           *Data;
+} DISK_IO_CACHE_ENTRY;
+
+typedef struct {
+  UINT32                          BlockNum;          /// < 0 indicates the cache is disabled
+  UINT32                          ReadAheadBlockNum; /// < capacity of ReadAheadBuffer in blocks
+  UINT32                          MaxRequestBlockNum;/// < larger requests bypass the cache
+  BOOLEAN                         WriteBack;         /// < FALSE: writes go through to the device
+  UINT32                          MediaId;
+  EFI_LBA                         LastLba;           /// < last block of the previous request, or DISK_IO_CACHE_INVALID_LBA
+  DISK_IO_CACHE_ENTRY             *Entries;
+  UINT8                           *Data;
+  UINT8                           *ReadAheadBuffer;
+  LIST_ENTRY                      LruList;
+  LIST_ENTRY                      HashTable[DISK_IO_CACHE_HASH_SIZE];
+  EFI_EVENT                       ReadyToBootEvent;
+  EDKII_DISK_IO_CACHE_STATISTICS  Statistics;
+} DISK_IO_CACHE;
+
 #define DISK_IO_PRIVATE_DATA_SIGNATURE  SIGNATURE_32 ('d', 's', 'k', 'I')
 typedef struct {
   UINT32                          Signature;
@@ -43,9 +76,13 @@ typedef struct {
 
   EFI_LOCK                        TaskQueueLock;
   LIST_ENTRY                      TaskQueue;
+
+  EDKII_DISK_IO_CACHE_PROTOCOL    DiskIoCache;
+  DISK_IO_CACHE                   Cache;
 } DISK_IO_PRIVATE_DATA;
 #define DISK_IO_PRIVATE_DATA_FROM_DISK_IO(a)  CR (a, DISK_IO_PRIVATE_DATA, DiskIo,  DISK_IO_PRIVATE_DATA_SIGNATURE)
 #define DISK_IO_PRIVATE_DATA_FROM_DISK_IO2(a) CR (a, DISK_IO_PRIVATE_DATA, DiskIo2, DISK_IO_PRIVATE_DATA_SIGNATURE)
+#define DISK_IO_PRIVATE_DATA_FROM_DISK_IO_CACHE(a) CR (a, DISK_IO_PRIVATE_DATA, DiskIoCache, DISK_IO_PRIVATE_DATA_SIGNATURE)
 
 #define DISK_IO2_TASK_SIGNATURE   SIGNATURE_32 ('d', 'i', 'a', 't')
 typedef struct {
@@ -339,6 +376,108 @@ DiskIo2FlushDiskEx (
   IN OUT EFI_DISK_IO2_TOKEN       *Token
   );
 
+//
+// Disk I/O block cache
+//
+/**
+  Initialize the optional block cache of a Disk I/O instance.
+  The cache stays disabled when PcdDiskIoCacheBlockNum is 0.
+
+  @param Instance               Pointer to the DISK_IO_PRIVATE_DATA.
+
+  @retval EFI_SUCCESS           The cache is initialized or disabled.
+  @retval EFI_OUT_OF_RESOURCES  The cache buffers could not be allocated.
+**/
+EFI_STATUS
+DiskIoCacheInitialize (
+  IN DISK_IO_PRIVATE_DATA     *Instance
+  );
+
+/**
+  Write back the dirty blocks and release the resources of the block cache.
+
+  @param Instance               Pointer to the DISK_IO_PRIVATE_DATA.
+**/
+VOID
+DiskIoCacheFree (
+  IN DISK_IO_PRIVATE_DATA     *Instance
+  );
+
+/**
+  Write all the dirty blocks held by the block cache to the device.
+
+  @param Instance               Pointer to the DISK_IO_PRIVATE_DATA.
+
+  @retval EFI_SUCCESS           All the dirty blocks were written back.
+  @retval Others                The device reported an error while writing a block.
+**/
+EFI_STATUS
+DiskIoCacheFlush (
+  IN DISK_IO_PRIVATE_DATA     *Instance
+  );
+
+/**
+  Check whether a blocking request is served from the block cache.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+  @param Write       TRUE: Write operation; FALSE: Read operation.
+  @param Offset      The starting byte offset on the logical block I/O device to access.
+  @param BufferSize  The size in bytes of the request.
+
+  @retval TRUE       The request should be passed to DiskIoCacheReadWrite.
+  @retval FALSE      The request should bypass the cache.
+**/
+BOOLEAN
+DiskIoCacheIsCacheable (
+  IN DISK_IO_PRIVATE_DATA     *Instance,
+  IN BOOLEAN                  Write,
+  IN UINT64                   Offset,
+  IN UINTN                    BufferSize
+  );
+
+/**
+  Serve a blocking request from the block cache, filling the missing blocks
+  from the device.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+  @param Write       TRUE: Write operation; FALSE: Read operation.
+  @param Offset      The starting byte offset on the logical block I/O device to access.
+  @param BufferSize  The size in bytes of Buffer.
+  @param Buffer      A pointer to the data buffer.
+
+  @retval EFI_SUCCESS           The request was completed.
+  @retval Others                The device reported an error while filling or evicting a block.
+**/
+EFI_STATUS
+DiskIoCacheReadWrite (
+  IN DISK_IO_PRIVATE_DATA     *Instance,
+  IN BOOLEAN                  Write,
+  IN UINT64                   Offset,
+  IN UINTN                    BufferSize,
+  IN OUT UINT8                *Buffer
+  );
+
+/**
+  Make the device coherent with the block cache for a request which bypasses it.
+  The dirty blocks in the range are written back, and for a write request the
+  cached copies of the range are discarded.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+  @param Write       TRUE: Write operation; FALSE: Read operation.
+  @param Offset      The starting byte offset on the logical block I/O device to access.
+  @param BufferSize  The size in bytes of the request.
+
+  @retval EFI_SUCCESS           The range is coherent.
+  @retval Others                The device reported an error while writing a block.
+**/
+EFI_STATUS
+DiskIoCacheSyncRange (
+  IN DISK_IO_PRIVATE_DATA     *Instance,
+  IN BOOLEAN                  Write,
+  IN UINT64                   Offset,
+  IN UINTN                    BufferSize
+  );
+
 //
 // EFI Component Name Functions
 //
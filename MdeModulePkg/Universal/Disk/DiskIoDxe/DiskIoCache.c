@@ -0,0 +1,838 @@
+/** @file
+  Optional LRU block cache of the DiskIo driver.
+
+  File system drivers and the partition driver access the same small set of
+  sectors (partition tables, FAT tables, directory clusters) many times. When
+  PcdDiskIoCacheBlockNum is not 0, every Disk I/O instance of a non-removable
+  medium keeps that many blocks of the underlying Block I/O device in memory:
+    - Small blocking reads are served from the cache. A miss fetches all the
+      missing blocks of the request with one BlockIo read, and when the request
+      continues the previous one, the read is extended by up to
+      PcdDiskIoCacheReadAheadBlockNum blocks.
+    - Writes go straight to the device and discard the cached copies. Only when
+      PcdDiskIoCacheWriteBack is TRUE and Disk I/O 2 is produced, small blocking
+      writes only update the cache, and the dirty blocks are written back on
+      eviction, FlushDiskEx(), ReadyToBoot and driver stop. Nothing is written
+      back at ExitBootServices, and the dirty blocks are neither seen by the
+      consumers of the raw Block I/O nor written back by FlushBlocks().
+    - Large and non-blocking requests bypass the cache. The dirty blocks they
+      overlap are written back first, and a write discards the cached copies.
+
+Copyright (c) 2014, Intel Corporation. All rights reserved.<BR>
+This program and the accompanying materials
+are licensed and made available under the terms and conditions of the BSD License
+which accompanies this distribution.  The full text of the license may be found at
+http://opensource.org/licenses/bsd-license.php
+
+THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#include "DiskIo.h"
+
+/**
+  Find the cache entry holding a block.
+
+  @param Cache        Pointer to the DISK_IO_CACHE.
+  @param Lba          The block to look up.
+
+  @return The cache entry holding the block, or NULL if the block is not cached.
+**/
+DISK_IO_CACHE_ENTRY *
+DiskIoCacheLookup (
+  IN DISK_IO_CACHE            *Cache,
+  IN EFI_LBA                  Lba
+  )
+{
+  LIST_ENTRY                  *Bucket;
+  LIST_ENTRY                  *Link;
+  DISK_IO_CACHE_ENTRY         *Entry;
+
+  Bucket = &Cache->HashTable[DISK_IO_CACHE_HASH (Lba)];
+  for (Link = GetFirstNode (Bucket); !IsNull (Bucket, Link); Link = GetNextNode (Bucket, Link)) {
+    Entry = BASE_CR (Link, DISK_IO_CACHE_ENTRY, HashLink);
+    if (Entry->Lba == Lba) {
+      return Entry;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Mark a cache entry as the most recently used one.
+
+  @param Cache        Pointer to the DISK_IO_CACHE.
+  @param Entry        The cache entry.
+**/
+VOID
+DiskIoCacheTouch (
+  IN DISK_IO_CACHE            *Cache,
+  IN DISK_IO_CACHE_ENTRY      *Entry
+  )
+{
+  RemoveEntryList (&Entry->LruLink);
+  InsertHeadList (&Cache->LruList, &Entry->LruLink);
+}
+
+/**
+  Drop the content of a cache entry, dirty or not, and make it the first one
+  to be reused.
+
+  @param Cache        Pointer to the DISK_IO_CACHE.
+  @param Entry        The cache entry.
+**/
+VOID
+DiskIoCacheDiscardEntry (
+  IN DISK_IO_CACHE            *Cache,
+  IN DISK_IO_CACHE_ENTRY      *Entry
+  )
+{
+  if (!Entry->Valid) {
+    return;
+  }
+
+  if (Entry->Dirty) {
+    Entry->Dirty = FALSE;
+    Cache->Statistics.DirtyBlockNum--;
+  }
+  Entry->Valid = FALSE;
+  Cache->Statistics.ValidBlockNum--;
+  RemoveEntryList (&Entry->HashLink);
+  InitializeListHead (&Entry->HashLink);
+
+  RemoveEntryList (&Entry->LruLink);
+  InsertTailList (&Cache->LruList, &Entry->LruLink);
+}
+
+/**
+  Drop the content of all the cache entries.
+
+  @param Cache        Pointer to the DISK_IO_CACHE.
+**/
+VOID
+DiskIoCacheInvalidate (
+  IN DISK_IO_CACHE            *Cache
+  )
+{
+  UINT32                      Index;
+
+  for (Index = 0; Index < Cache->BlockNum; Index++) {
+    DiskIoCacheDiscardEntry (Cache, &Cache->Entries[Index]);
+  }
+}
+
+/**
+  Discard the cached blocks when the medium in the device was changed.
+
+  @param Instance     Pointer to the DISK_IO_PRIVATE_DATA.
+**/
+VOID
+DiskIoCacheCheckMedia (
+  IN DISK_IO_PRIVATE_DATA     *Instance
+  )
+{
+  DISK_IO_CACHE               *Cache;
+  EFI_BLOCK_IO_MEDIA          *Media;
+
+  Cache = &Instance->Cache;
+  Media = Instance->BlockIo->Media;
+
+  if (Cache->MediaId != Media->MediaId) {
+    if (Cache->Statistics.DirtyBlockNum != 0) {
+      DEBUG ((EFI_D_ERROR, "DiskIo: Media changed, %d dirty blocks are lost.\n", Cache->Statistics.DirtyBlockNum));
+    }
+    DiskIoCacheInvalidate (Cache);
+    Cache->MediaId = Media->MediaId;
+    Cache->LastLba = DISK_IO_CACHE_INVALID_LBA;
+  }
+}
+
+/**
+  Write a dirty cache entry to the device.
+
+  @param Instance     Pointer to the DISK_IO_PRIVATE_DATA.
+  @param Entry        The dirty cache entry.
+
+  @retval EFI_SUCCESS The block was written and the entry is clean.
+  @retval Others      The device reported an error while writing the block.
+**/
+EFI_STATUS
+DiskIoCacheWriteBackEntry (
+  IN DISK_IO_PRIVATE_DATA     *Instance,
+  IN DISK_IO_CACHE_ENTRY      *Entry
+  )
+{
+  EFI_STATUS                  Status;
+  DISK_IO_CACHE               *Cache;
+
+  Cache = &Instance->Cache;
+  ASSERT (Entry->Valid && Entry->Dirty);
+
+  Status = Instance->BlockIo->WriteBlocks (
+                                Instance->BlockIo,
+                                Cache->MediaId,
+                                Entry->Lba,
+                                Cache->Statistics.BlockSize,
+                                Entry->Data
+                                );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((EFI_D_ERROR, "DiskIo: Failed to write back cached block %lx - %r\n", Entry->Lba, Status));
+    return Status;
+  }
+
+  Entry->Dirty = FALSE;
+  Cache->Statistics.DirtyBlockNum--;
+  Cache->Statistics.WriteBackBlocks++;
+  return EFI_SUCCESS;
+}
+
+/**
+  Take the least recently used cache entry for a block, writing back its
+  previous content if it is dirty.
+
+  @param Instance     Pointer to the DISK_IO_PRIVATE_DATA.
+  @param Lba          The block the entry is taken for.
+  @param Entry        Return the cache entry, which is valid, clean and the most
+                      recently used one. Its data is undefined.
+
+  @retval EFI_SUCCESS The entry is returned.
+  @retval Others      The device reported an error while writing back the entry.
+**/
+EFI_STATUS
+DiskIoCacheAllocateEntry (
+  IN  DISK_IO_PRIVATE_DATA    *Instance,
+  IN  EFI_LBA                 Lba,
+  OUT DISK_IO_CACHE_ENTRY     **Entry
+  )
+{
+  EFI_STATUS                  Status;
+  DISK_IO_CACHE               *Cache;
+  DISK_IO_CACHE_ENTRY         *Victim;
+
+  Cache  = &Instance->Cache;
+  Victim = BASE_CR (GetPreviousNode (&Cache->LruList, &Cache->LruList), DISK_IO_CACHE_ENTRY, LruLink);
+
+  if (Victim->Valid) {
+    if (Victim->Dirty) {
+      Status = DiskIoCacheWriteBackEntry (Instance, Victim);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+    }
+    Cache->Statistics.Evictions++;
+    DiskIoCacheDiscardEntry (Cache, Victim);
+  }
+
+  Victim->Lba   = Lba;
+  Victim->Valid = TRUE;
+  Cache->Statistics.ValidBlockNum++;
+  InsertTailList (&Cache->HashTable[DISK_IO_CACHE_HASH (Lba)], &Victim->HashLink);
+  DiskIoCacheTouch (Cache, Victim);
+
+  *Entry = Victim;
+  return EFI_SUCCESS;
+}
+
+/**
+  Read the missing blocks starting at Lba into the cache.
+
+  @param Instance     Pointer to the DISK_IO_PRIVATE_DATA.
+  @param Lba          The first block which is not cached.
+  @param EndLba       The last block needed by the request.
+  @param ReadAhead    TRUE to fetch blocks beyond EndLba as well.
+  @param Missed       Return the number of blocks fetched for the request itself.
+
+  @retval EFI_SUCCESS At least the block Lba is cached.
+  @retval Others      The device reported an error.
+**/
+EFI_STATUS
+DiskIoCacheFill (
+  IN  DISK_IO_PRIVATE_DATA    *Instance,
+  IN  EFI_LBA                 Lba,
+  IN  EFI_LBA                 EndLba,
+  IN  BOOLEAN                 ReadAhead,
+  OUT UINTN                   *Missed
+  )
+{
+  EFI_STATUS                  Status;
+  DISK_IO_CACHE               *Cache;
+  DISK_IO_CACHE_ENTRY         *Entry;
+  UINT32                      BlockSize;
+  UINTN                       Count;
+  UINTN                       Needed;
+  UINTN                       Index;
+
+  Cache     = &Instance->Cache;
+  BlockSize = Cache->Statistics.BlockSize;
+
+  //
+  // Fetch the run of missing blocks with one read, extended past the request
+  // when it continues the previous one.
+  //
+  Count = 1;
+  while ((Count < Cache->ReadAheadBlockNum) && (Lba + Count <= EndLba) &&
+         (DiskIoCacheLookup (Cache, Lba + Count) == NULL)) {
+    Count++;
+  }
+  Needed = Count;
+
+  if (ReadAhead) {
+    while ((Count < Cache->ReadAheadBlockNum) && (Lba + Count <= Instance->BlockIo->Media->LastBlock) &&
+           (DiskIoCacheLookup (Cache, Lba + Count) == NULL)) {
+      Count++;
+    }
+  }
+
+  Status = Instance->BlockIo->ReadBlocks (
+                                Instance->BlockIo,
+                                Cache->MediaId,
+                                Lba,
+                                Count * BlockSize,
+                                Cache->ReadAheadBuffer
+                                );
+  if (EFI_ERROR (Status) && (Count > Needed)) {
+    //
+    // The speculative part shouldn't fail the request.
+    //
+    Count  = Needed;
+    Status = Instance->BlockIo->ReadBlocks (
+                                  Instance->BlockIo,
+                                  Cache->MediaId,
+                                  Lba,
+                                  Count * BlockSize,
+                                  Cache->ReadAheadBuffer
+                                  );
+  }
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  for (Index = 0; Index < Count; Index++) {
+    Status = DiskIoCacheAllocateEntry (Instance, Lba + Index, &Entry);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+    CopyMem (Entry->Data, Cache->ReadAheadBuffer + Index * BlockSize, BlockSize);
+  }
+
+  Cache->Statistics.ReadAheadBlocks += Count - Needed;
+  *Missed = Needed;
+  return EFI_SUCCESS;
+}
+
+/**
+  Check whether a blocking request is served from the block cache.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+  @param Write       TRUE: Write operation; FALSE: Read operation.
+  @param Offset      The starting byte offset on the logical block I/O device to access.
+  @param BufferSize  The size in bytes of the request.
+
+  @retval TRUE       The request should be passed to DiskIoCacheReadWrite.
+  @retval FALSE      The request should bypass the cache.
+**/
+BOOLEAN
+DiskIoCacheIsCacheable (
+  IN DISK_IO_PRIVATE_DATA     *Instance,
+  IN BOOLEAN                  Write,
+  IN UINT64                   Offset,
+  IN UINTN                    BufferSize
+  )
+{
+  DISK_IO_CACHE               *Cache;
+  EFI_BLOCK_IO_MEDIA          *Media;
+  EFI_LBA                     Lba;
+  EFI_LBA                     EndLba;
+
+  Cache = &Instance->Cache;
+  Media = Instance->BlockIo->Media;
+
+  if ((Cache->BlockNum == 0) || (BufferSize == 0) || (Write && !Cache->WriteBack)) {
+    return FALSE;
+  }
+
+  //
+  // Let the BlockIo report the absent media and the invalid requests.
+  //
+  if (!Media->MediaPresent || (Media->BlockSize != Cache->Statistics.BlockSize) ||
+      (Offset + BufferSize - 1 < Offset)) {
+    return FALSE;
+  }
+
+  Lba    = DivU64x32 (Offset, Media->BlockSize);
+  EndLba = DivU64x32 (Offset + BufferSize - 1, Media->BlockSize);
+
+  return (BOOLEAN) ((EndLba <= Media->LastBlock) && (EndLba - Lba < Cache->MaxRequestBlockNum));
+}
+
+/**
+  Serve a blocking request from the block cache, filling the missing blocks
+  from the device.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+  @param Write       TRUE: Write operation; FALSE: Read operation.
+  @param Offset      The starting byte offset on the logical block I/O device to access.
+  @param BufferSize  The size in bytes of Buffer.
+  @param Buffer      A pointer to the data buffer.
+
+  @retval EFI_SUCCESS           The request was completed.
+  @retval Others                The device reported an error while filling or evicting a block.
+**/
+EFI_STATUS
+DiskIoCacheReadWrite (
+  IN DISK_IO_PRIVATE_DATA     *Instance,
+  IN BOOLEAN                  Write,
+  IN UINT64                   Offset,
+  IN UINTN                    BufferSize,
+  IN OUT UINT8                *Buffer
+  )
+{
+  EFI_STATUS                  Status;
+  DISK_IO_CACHE               *Cache;
+  DISK_IO_CACHE_ENTRY         *Entry;
+  UINT32                      BlockSize;
+  UINT32                      BlockOffset;
+  UINTN                       Length;
+  EFI_LBA                     Lba;
+  EFI_LBA                     EndLba;
+  BOOLEAN                     Sequential;
+  UINTN                       Missed;
+  EFI_TPL                     OldTpl;
+
+  Cache     = &Instance->Cache;
+  BlockSize = Cache->Statistics.BlockSize;
+  Status    = EFI_SUCCESS;
+  Missed    = 0;
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  DiskIoCacheCheckMedia (Instance);
+
+  Lba        = DivU64x32Remainder (Offset, BlockSize, &BlockOffset);
+  EndLba     = DivU64x32 (Offset + BufferSize - 1, BlockSize);
+  Sequential = (BOOLEAN) ((Cache->LastLba != DISK_IO_CACHE_INVALID_LBA) &&
+                          ((Lba == Cache->LastLba) || (Lba == Cache->LastLba + 1)));
+
+  for (; Lba <= EndLba; Lba++) {
+    Length = MIN (BufferSize, BlockSize - BlockOffset);
+
+    Entry = DiskIoCacheLookup (Cache, Lba);
+    if (Entry == NULL) {
+      if (Write && (Length == BlockSize)) {
+        //
+        // The whole block is overwritten, no need to read it.
+        //
+        Status = DiskIoCacheAllocateEntry (Instance, Lba, &Entry);
+        Missed = 1;
+      } else {
+        Status = DiskIoCacheFill (Instance, Lba, Write ? Lba : EndLba, (BOOLEAN) (!Write && Sequential), &Missed);
+        Entry  = DiskIoCacheLookup (Cache, Lba);
+      }
+      if (EFI_ERROR (Status)) {
+        break;
+      }
+      ASSERT (Entry != NULL);
+    }
+
+    if (Missed != 0) {
+      Missed--;
+      if (Write) {
+        Cache->Statistics.WriteMisses++;
+      } else {
+        Cache->Statistics.ReadMisses++;
+      }
+    } else {
+      if (Write) {
+        Cache->Statistics.WriteHits++;
+      } else {
+        Cache->Statistics.ReadHits++;
+      }
+    }
+
+    if (Write) {
+      CopyMem (Entry->Data + BlockOffset, Buffer, Length);
+      if (!Entry->Dirty) {
+        Entry->Dirty = TRUE;
+        Cache->Statistics.DirtyBlockNum++;
+      }
+    } else {
+      CopyMem (Buffer, Entry->Data + BlockOffset, Length);
+    }
+    DiskIoCacheTouch (Cache, Entry);
+
+    Buffer      += Length;
+    BufferSize  -= Length;
+    BlockOffset  = 0;
+  }
+
+  Cache->LastLba = EndLba;
+
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
+
+/**
+  Make the device coherent with the block cache for a request which bypasses it.
+  The dirty blocks in the range are written back, and for a write request the
+  cached copies of the range are discarded.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+  @param Write       TRUE: Write operation; FALSE: Read operation.
+  @param Offset      The starting byte offset on the logical block I/O device to access.
+  @param BufferSize  The size in bytes of the request.
+
+  @retval EFI_SUCCESS           The range is coherent.
+  @retval Others                The device reported an error while writing a block.
+**/
+EFI_STATUS
+DiskIoCacheSyncRange (
+  IN DISK_IO_PRIVATE_DATA     *Instance,
+  IN BOOLEAN                  Write,
+  IN UINT64                   Offset,
+  IN UINTN                    BufferSize
+  )
+{
+  EFI_STATUS                  Status;
+  DISK_IO_CACHE               *Cache;
+  DISK_IO_CACHE_ENTRY         *Entry;
+  EFI_LBA                     Lba;
+  EFI_LBA                     EndLba;
+  UINT32                      Index;
+  EFI_TPL                     OldTpl;
+
+  Cache  = &Instance->Cache;
+  Status = EFI_SUCCESS;
+
+  if ((Cache->BlockNum == 0) || (BufferSize == 0)) {
+    return EFI_SUCCESS;
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  DiskIoCacheCheckMedia (Instance);
+
+  if (Cache->Statistics.ValidBlockNum != 0) {
+    Lba = DivU64x32 (Offset, Cache->Statistics.BlockSize);
+    if (Offset + BufferSize - 1 < Offset) {
+      EndLba = MAX_UINT64;
+    } else {
+      EndLba = DivU64x32 (Offset + BufferSize - 1, Cache->Statistics.BlockSize);
+    }
+
+    for (Index = 0; Index < Cache->BlockNum; Index++) {
+      Entry = &Cache->Entries[Index];
+      if (!Entry->Valid || (Entry->Lba < Lba) || (Entry->Lba > EndLba)) {
+        continue;
+      }
+
+      if (Entry->Dirty) {
+        Status = DiskIoCacheWriteBackEntry (Instance, Entry);
+        if (EFI_ERROR (Status)) {
+          break;
+        }
+      }
+      if (Write) {
+        DiskIoCacheDiscardEntry (Cache, Entry);
+      }
+    }
+  }
+
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
+
+/**
+  Write all the dirty blocks held by the block cache to the device.
+
+  @param Instance               Pointer to the DISK_IO_PRIVATE_DATA.
+
+  @retval EFI_SUCCESS           All the dirty blocks were written back.
+  @retval Others                The device reported an error while writing a block.
+**/
+EFI_STATUS
+DiskIoCacheFlush (
+  IN DISK_IO_PRIVATE_DATA     *Instance
+  )
+{
+  EFI_STATUS                  Status;
+  EFI_STATUS                  WriteStatus;
+  DISK_IO_CACHE               *Cache;
+  DISK_IO_CACHE_ENTRY         *Entry;
+  UINT32                      Index;
+  EFI_TPL                     OldTpl;
+
+  Cache  = &Instance->Cache;
+  Status = EFI_SUCCESS;
+
+  if (Cache->BlockNum == 0) {
+    return EFI_SUCCESS;
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  DiskIoCacheCheckMedia (Instance);
+
+  //
+  // Keep going on error so that a single bad block doesn't hold back the others.
+  //
+  for (Index = 0; (Index < Cache->BlockNum) && (Cache->Statistics.DirtyBlockNum != 0); Index++) {
+    Entry = &Cache->Entries[Index];
+    if (Entry->Valid && Entry->Dirty) {
+      WriteStatus = DiskIoCacheWriteBackEntry (Instance, Entry);
+      if (EFI_ERROR (WriteStatus)) {
+        Status = WriteStatus;
+      }
+    }
+  }
+
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
+
+/**
+  Write back the dirty blocks before the OS loader takes over the device.
+
+  @param  Event                 Event whose notification function is being invoked.
+  @param  Context               The pointer to the DISK_IO_PRIVATE_DATA.
+**/
+VOID
+EFIAPI
+DiskIoCacheOnBoot (
+  IN EFI_EVENT                Event,
+  IN VOID                     *Context
+  )
+{
+  DiskIoCacheFlush ((DISK_IO_PRIVATE_DATA *) Context);
+}
+
+/**
+  Retrieve the current statistics of the block cache.
+
+  @param[in]  This          The EDKII_DISK_IO_CACHE_PROTOCOL instance.
+  @param[out] Statistics    Receives a snapshot of the cache counters.
+
+  @retval EFI_SUCCESS           The statistics were returned.
+  @retval EFI_INVALID_PARAMETER Statistics is NULL.
+**/
+EFI_STATUS
+EFIAPI
+DiskIoCacheGetStatistics (
+  IN  EDKII_DISK_IO_CACHE_PROTOCOL    *This,
+  OUT EDKII_DISK_IO_CACHE_STATISTICS  *Statistics
+  )
+{
+  DISK_IO_PRIVATE_DATA        *Instance;
+  EFI_TPL                     OldTpl;
+
+  if (Statistics == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Instance = DISK_IO_PRIVATE_DATA_FROM_DISK_IO_CACHE (This);
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+  CopyMem (Statistics, &Instance->Cache.Statistics, sizeof (EDKII_DISK_IO_CACHE_STATISTICS));
+  gBS->RestoreTPL (OldTpl);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Reset the hit, miss and traffic counters of the block cache.
+  The cached data itself is not affected.
+
+  @param[in]  This          The EDKII_DISK_IO_CACHE_PROTOCOL instance.
+
+  @retval EFI_SUCCESS       The counters were reset.
+**/
+EFI_STATUS
+EFIAPI
+DiskIoCacheResetStatistics (
+  IN  EDKII_DISK_IO_CACHE_PROTOCOL    *This
+  )
+{
+  DISK_IO_PRIVATE_DATA            *Instance;
+  EDKII_DISK_IO_CACHE_STATISTICS  *Statistics;
+  EFI_TPL                         OldTpl;
+
+  Instance   = DISK_IO_PRIVATE_DATA_FROM_DISK_IO_CACHE (This);
+  Statistics = &Instance->Cache.Statistics;
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+  Statistics->ReadHits        = 0;
+  Statistics->ReadMisses      = 0;
+  Statistics->WriteHits       = 0;
+  Statistics->WriteMisses     = 0;
+  Statistics->ReadAheadBlocks = 0;
+  Statistics->WriteBackBlocks = 0;
+  Statistics->Evictions       = 0;
+  gBS->RestoreTPL (OldTpl);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Write all the dirty blocks held by the cache to the device.
+
+  @param[in]  This          The EDKII_DISK_IO_CACHE_PROTOCOL instance.
+
+  @retval EFI_SUCCESS       All the dirty blocks were written back.
+  @retval Others            The device reported an error while writing a block.
+**/
+EFI_STATUS
+EFIAPI
+DiskIoCacheProtocolFlush (
+  IN  EDKII_DISK_IO_CACHE_PROTOCOL    *This
+  )
+{
+  return DiskIoCacheFlush (DISK_IO_PRIVATE_DATA_FROM_DISK_IO_CACHE (This));
+}
+
+/**
+  Release the buffers of the block cache.
+
+  @param Cache        Pointer to the DISK_IO_CACHE.
+**/
+VOID
+DiskIoCacheFreeBuffers (
+  IN DISK_IO_CACHE            *Cache
+  )
+{
+  if (Cache->ReadAheadBuffer != NULL) {
+    FreeAlignedPages (
+      Cache->ReadAheadBuffer,
+      EFI_SIZE_TO_PAGES (Cache->ReadAheadBlockNum * Cache->Statistics.BlockSize)
+      );
+    Cache->ReadAheadBuffer = NULL;
+  }
+  if (Cache->Data != NULL) {
+    FreeAlignedPages (Cache->Data, EFI_SIZE_TO_PAGES (Cache->BlockNum * Cache->Statistics.BlockSize));
+    Cache->Data = NULL;
+  }
+  if (Cache->Entries != NULL) {
+    FreePool (Cache->Entries);
+    Cache->Entries = NULL;
+  }
+  Cache->BlockNum = 0;
+}
+
+/**
+  Initialize the optional block cache of a Disk I/O instance.
+  The cache stays disabled when PcdDiskIoCacheBlockNum is 0.
+
+  @param Instance               Pointer to the DISK_IO_PRIVATE_DATA.
+
+  @retval EFI_SUCCESS           The cache is initialized or disabled.
+  @retval EFI_OUT_OF_RESOURCES  The cache buffers could not be allocated.
+**/
+EFI_STATUS
+DiskIoCacheInitialize (
+  IN DISK_IO_PRIVATE_DATA     *Instance
+  )
+{
+  EFI_STATUS                  Status;
+  DISK_IO_CACHE               *Cache;
+  EFI_BLOCK_IO_MEDIA          *Media;
+  UINT32                      Index;
+
+  Cache = &Instance->Cache;
+  Media = Instance->BlockIo->Media;
+
+  ZeroMem (Cache, sizeof (DISK_IO_CACHE));
+  if ((PcdGet32 (PcdDiskIoCacheBlockNum) == 0) || (Media->BlockSize == 0)) {
+    return EFI_SUCCESS;
+  }
+
+  //
+  // The BlockIo driver of a removable medium only notices a media change, and
+  // updates the MediaId, when a request reaches it. A cache hit doesn't, so the
+  // blocks of the previous medium would be returned after a swap.
+  //
+  if (Media->RemovableMedia) {
+    DEBUG ((EFI_D_INFO, "DiskIo: Removable media, block cache is disabled.\n"));
+    return EFI_SUCCESS;
+  }
+
+  //
+  // Every cached block is handed to the BlockIo directly when it's written back.
+  //
+  if (Media->IoAlign > Media->BlockSize) {
+    DEBUG ((EFI_D_INFO, "DiskIo: IoAlign %d exceeds the block size, block cache is disabled.\n", Media->IoAlign));
+    return EFI_SUCCESS;
+  }
+
+  Cache->BlockNum             = PcdGet32 (PcdDiskIoCacheBlockNum);
+  Cache->ReadAheadBlockNum    = MIN (MAX (PcdGet32 (PcdDiskIoCacheReadAheadBlockNum), 1), MAX (Cache->BlockNum / 2, 1));
+  Cache->MaxRequestBlockNum   = MAX (Cache->BlockNum / 4, 1);
+  Cache->WriteBack            = (BOOLEAN) (FeaturePcdGet (PcdDiskIoCacheWriteBack) && (Instance->BlockIo2 != NULL));
+  Cache->MediaId              = Media->MediaId;
+  Cache->LastLba              = DISK_IO_CACHE_INVALID_LBA;
+  Cache->Statistics.BlockNum  = Cache->BlockNum;
+  Cache->Statistics.BlockSize = Media->BlockSize;
+
+  Cache->Entries         = AllocateZeroPool (Cache->BlockNum * sizeof (DISK_IO_CACHE_ENTRY));
+  Cache->Data            = AllocateAlignedPages (EFI_SIZE_TO_PAGES (Cache->BlockNum * Media->BlockSize), Media->IoAlign);
+  Cache->ReadAheadBuffer = AllocateAlignedPages (EFI_SIZE_TO_PAGES (Cache->ReadAheadBlockNum * Media->BlockSize), Media->IoAlign);
+  if ((Cache->Entries == NULL) || (Cache->Data == NULL) || (Cache->ReadAheadBuffer == NULL)) {
+    DiskIoCacheFreeBuffers (Cache);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  InitializeListHead (&Cache->LruList);
+  for (Index = 0; Index < DISK_IO_CACHE_HASH_SIZE; Index++) {
+    InitializeListHead (&Cache->HashTable[Index]);
+  }
+  for (Index = 0; Index < Cache->BlockNum; Index++) {
+    Cache->Entries[Index].Data = Cache->Data + Index * Media->BlockSize;
+    InitializeListHead (&Cache->Entries[Index].HashLink);
+    InsertTailList (&Cache->LruList, &Cache->Entries[Index].LruLink);
+  }
+
+  if (Cache->WriteBack) {
+    Status = EfiCreateEventReadyToBootEx (
+               TPL_CALLBACK,
+               DiskIoCacheOnBoot,
+               Instance,
+               &Cache->ReadyToBootEvent
+               );
+    if (EFI_ERROR (Status)) {
+      DiskIoCacheFreeBuffers (Cache);
+      return Status;
+    }
+  }
+
+  Instance->DiskIoCache.GetStatistics   = DiskIoCacheGetStatistics;
+  Instance->DiskIoCache.ResetStatistics = DiskIoCacheResetStatistics;
+  Instance->DiskIoCache.Flush           = DiskIoCacheProtocolFlush;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Write back the dirty blocks and release the resources of the block cache.
+
+  @param Instance               Pointer to the DISK_IO_PRIVATE_DATA.
+**/
+VOID
+DiskIoCacheFree (
+  IN DISK_IO_PRIVATE_DATA     *Instance
+  )
+{
+  DISK_IO_CACHE               *Cache;
+
+  Cache = &Instance->Cache;
+  if (Cache->BlockNum == 0) {
+    return;
+  }
+
+  DiskIoCacheFlush (Instance);
+
+  if (Cache->ReadyToBootEvent != NULL) {
+    gBS->CloseEvent (Cache->ReadyToBootEvent);
+    Cache->ReadyToBootEvent = NULL;
+  }
+
+  DiskIoCacheFreeBuffers (Cache);
+}
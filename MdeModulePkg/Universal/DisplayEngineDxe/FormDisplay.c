@@ -110,6 +110,14 @@ DISPLAY_HIGHLIGHT_MENU_INFO   gHighligthMenuInfo = {0};
 BOOLEAN                       mIsFirstForm = TRUE;
 FORM_ENTRY_INFO               gOldFormEntry = {0};
 
+//
+// What DisplayOneMenu last painted on each row of the statement area. It is
+// only trusted while nothing else has drawn over the statement area.
+//
+DISPLAY_MENU_ROW              *mMenuRows = NULL;
+UINTN                         mMenuRowCount = 0;
+BOOLEAN                       mMenuRowsKept = FALSE;
+
 //
 // Browser Global Strings
 //
@@ -1777,6 +1785,138 @@ HasOptionString (
 }
 
 
+/**
+  Invalidate what is remembered about the rows of the statement area, so that
+  they are painted again.
+
+  @param  StartRow                 The first row to invalidate.
+  @param  EndRow                   The last row to invalidate.
+
+**/
+VOID
+InvalidateMenuRows (
+  IN UINTN                           StartRow,
+  IN UINTN                           EndRow
+  )
+{
+  if (mMenuRows == NULL || StartRow >= mMenuRowCount || StartRow > EndRow) {
+    return;
+  }
+
+  if (EndRow >= mMenuRowCount) {
+    EndRow = mMenuRowCount - 1;
+  }
+  ZeroMem (&mMenuRows[StartRow], (EndRow - StartRow + 1) * sizeof (DISPLAY_MENU_ROW));
+}
+
+/**
+  Get what is remembered about a row of the statement area.
+
+  @param  Row                      The row.
+
+  @return The remembered row, or NULL if the system is out of resources.
+
+**/
+DISPLAY_MENU_ROW *
+GetMenuRow (
+  IN UINTN                           Row
+  )
+{
+  DISPLAY_MENU_ROW                *MenuRows;
+
+  if (Row >= mMenuRowCount) {
+    MenuRows = AllocateZeroPool ((Row + 1) * sizeof (DISPLAY_MENU_ROW));
+    if (MenuRows == NULL) {
+      return NULL;
+    }
+    if (mMenuRows != NULL) {
+      CopyMem (MenuRows, mMenuRows, mMenuRowCount * sizeof (DISPLAY_MENU_ROW));
+      FreePool (mMenuRows);
+    }
+    mMenuRows     = MenuRows;
+    mMenuRowCount = Row + 1;
+  }
+
+  return &mMenuRows[Row];
+}
+
+/**
+  Calculate the Crc32 of a string.
+
+  @param  String                   The string, may be NULL.
+
+  @return The Crc32 of the string, 0 for NULL.
+
+**/
+UINT32
+GetStringCrc (
+  IN CHAR16                          *String
+  )
+{
+  UINT32                          Crc;
+
+  Crc = 0;
+  if (String != NULL) {
+    gBS->CalculateCrc32 (String, StrSize (String), &Crc);
+  }
+
+  return Crc;
+}
+
+/**
+  Calculate the Crc32 of everything the painting of a menu option depends on.
+  Two paintings with the same Crc32 put the same characters on the screen.
+
+  @param  MenuOption               The menu option.
+  @param  OptionString             The option string of the menu option.
+  @param  TextTwo                  The secondary text of a text opcode.
+  @param  SkipWidth                The skip width between the left to the start of the prompt.
+  @param  BeginCol                 The begin column for one menu.
+  @param  SkipLine                 The skip line for this menu.
+  @param  BottomRow                The bottom row for this form.
+  @param  Highlight                Whether this menu will be highlight.
+
+  @return The Crc32 of the painting.
+
+**/
+UINT32
+GetMenuPaintCrc (
+  IN UI_MENU_OPTION                  *MenuOption,
+  IN CHAR16                          *OptionString,
+  IN CHAR16                          *TextTwo,
+  IN UINTN                           SkipWidth,
+  IN UINTN                           BeginCol,
+  IN UINTN                           SkipLine,
+  IN UINTN                           BottomRow,
+  IN BOOLEAN                         Highlight
+  )
+{
+  DISPLAY_MENU_PAINT              Paint;
+  UINT32                          Crc;
+
+  ZeroMem (&Paint, sizeof (Paint));
+  Paint.Col              = MenuOption->Col;
+  Paint.OptCol           = MenuOption->OptCol;
+  Paint.SkipWidth        = SkipWidth;
+  Paint.BeginCol         = BeginCol;
+  Paint.SkipLine         = SkipLine;
+  Paint.BottomRow        = BottomRow;
+  Paint.Skip             = MenuOption->Skip;
+  Paint.FormAttribute    = gFormData->Attribute;
+  Paint.PromptBlockWidth = gPromptBlockWidth;
+  Paint.OptionBlockWidth = gOptionBlockWidth;
+  Paint.OpCode           = MenuOption->ThisTag->OpCode->OpCode;
+  Paint.Highlight        = Highlight;
+  Paint.GrayOut          = MenuOption->GrayOut;
+  Paint.DescriptionCrc   = GetStringCrc (MenuOption->Description);
+  Paint.OptionCrc        = GetStringCrc (OptionString);
+  Paint.TextTwoCrc       = GetStringCrc (TextTwo);
+
+  Crc = 0;
+  gBS->CalculateCrc32 (&Paint, sizeof (Paint), &Crc);
+  return Crc;
+}
+
 /**
   Print string for this menu option.
 
@@ -1820,6 +1960,8 @@ DisplayOneMenu (
   UINTN                           OptionLineNum;
   CHAR16                          AdjustValue;
   UINTN                           MaxRow;
+  DISPLAY_MENU_ROW                *MenuRow;
+  UINT32                          Crc;
 
   Statement = MenuOption->ThisTag;
   Temp      = SkipLine;
@@ -1829,6 +1971,9 @@ DisplayOneMenu (
   PromptLineNum = 0;
   OptionLineNum = 0;
   MaxRow        = 0;
+  StringPtr     = NULL;
+  MenuRow       = NULL;
+  Crc           = 0;
 
   //
   // Set default color.
@@ -1843,6 +1988,31 @@ DisplayOneMenu (
     return Status;
   }
 
+  if ((Statement->OpCode->OpCode  == EFI_IFR_TEXT_OP) && (((EFI_IFR_TEXT*)Statement->OpCode)->TextTwo != 0)) {
+    StringPtr = GetToken (((EFI_IFR_TEXT*)Statement->OpCode)->TextTwo, gFormData->HiiHandle);
+  }
+
+  //
+  // Nothing to paint if the row still shows the same thing. The three menu
+  // options of a date or time share their row, they are always painted.
+  //
+  if (Statement->OpCode->OpCode != EFI_IFR_DATE_OP && Statement->OpCode->OpCode != EFI_IFR_TIME_OP) {
+    MenuRow = GetMenuRow (MenuOption->Row);
+  }
+  if (MenuRow != NULL) {
+    Crc = GetMenuPaintCrc (MenuOption, OptionString, StringPtr, SkipWidth, BeginCol, SkipLine, BottomRow, Highlight);
+    if (MenuRow->Valid && MenuRow->Crc == Crc) {
+      MenuOption->Skip = MenuRow->Skip;
+      if (OptionString != NULL) {
+        FreePool (OptionString);
+      }
+      if (StringPtr != NULL) {
+        FreePool (StringPtr);
+      }
+      return EFI_SUCCESS;
+    }
+  }
+
   if (OptionString != NULL) {
     if (Statement->OpCode->OpCode == EFI_IFR_DATE_OP || Statement->OpCode->OpCode == EFI_IFR_TIME_OP) {
       //
@@ -1967,9 +2137,7 @@ DisplayOneMenu (
   //
   // 3. If this is a text op with secondary text information
   //
-  if ((Statement->OpCode->OpCode  == EFI_IFR_TEXT_OP) && (((EFI_IFR_TEXT*)Statement->OpCode)->TextTwo != 0)) {
-    StringPtr   = GetToken (((EFI_IFR_TEXT*)Statement->OpCode)->TextTwo, gFormData->HiiHandle);
-  
+  if (StringPtr != NULL) {
     Width       = (UINT16) gOptionBlockWidth - 1;
     Row         = MenuOption->Row;
     GlyphWidth  = 1;
@@ -2019,6 +2187,16 @@ DisplayOneMenu (
     }
   }
 
+  //
+  // 5. Remember what the rows of this menu option show now.
+  //
+  InvalidateMenuRows (MenuOption->Row, MenuOption->Row + (MenuOption->Skip > 0 ? MenuOption->Skip - 1 : 0));
+  if (MenuRow != NULL) {
+    MenuRow->Valid = TRUE;
+    MenuRow->Crc   = Crc;
+    MenuRow->Skip  = MenuOption->Skip;
+  }
+
   return EFI_SUCCESS;
 }
 
@@ -2165,6 +2343,7 @@ UiDisplayMenu (
           BottomRow + SCROLL_ARROW_HEIGHT,
           GetFieldTextColor ()
           );
+        InvalidateMenuRows (0, MAX_UINTN);
 
       }
       ControlFlag = CfRepaint;
@@ -2275,6 +2454,7 @@ UiDisplayMenu (
         //
         // 3. Menus in this form may not cover all form, clean the remain field.
         //
+        InvalidateMenuRows (Row, BottomRow);
         while (Row <= BottomRow) {
           if ((FormData->Attribute & HII_DISPLAY_MODAL) != 0) {
             PrintStringAtWithWidth(gStatementDimensions.LeftColumn + gModalSkipColumn, Row++, L"", gStatementDimensions.RightColumn - gStatementDimensions.LeftColumn - 2 * gModalSkipColumn);
@@ -2598,6 +2778,11 @@ UiDisplayMenu (
       if (EventType == UIEventDriver) {
         gUserInput->Action = BROWSER_ACTION_NONE;
         ControlFlag = CfExit;
+        //
+        // The form is shown again as it is, only the rows which changed need
+        // to be painted.
+        //
+        mMenuRowsKept = TRUE;
         break;
       }
       
@@ -2645,6 +2830,7 @@ UiDisplayMenu (
             gDirection = SCAN_LEFT;
           }
           
+          InvalidateMenuRows (0, MAX_UINTN);
           Status = ProcessOptions (MenuOption, TRUE, &OptionString, TRUE);
           if (OptionString != NULL) {
             FreePool (OptionString);
@@ -2773,6 +2959,10 @@ UiDisplayMenu (
         // Editable Questions: oneof, ordered list, checkbox, numeric, string, password
         //
         RefreshKeyHelp (gFormData, Statement, TRUE);
+        //
+        // The value may be edited in a pop up over the menu.
+        //
+        InvalidateMenuRows (0, MAX_UINTN);
         Status = ProcessOptions (MenuOption, TRUE, &OptionString, TRUE);
         
         if (OptionString != NULL) {
@@ -3406,6 +3596,15 @@ FormDisplay (
   gUserInput = UserInputData;
   gFormData  = FormData;
 
+  //
+  // The rows of the statement area are only reused when the last form display
+  // ended on a driver event, nothing else has drawn over them since then.
+  //
+  if (!mMenuRowsKept) {
+    InvalidateMenuRows (0, MAX_UINTN);
+  }
+  mMenuRowsKept = FALSE;
+
   //
   // Process the status info first.
   //
@@ -3414,6 +3613,7 @@ FormDisplay (
     //
     // gFormData->BrowserStatus != BROWSER_SUCCESS, means only need to print the error info, return here.
     //
+    InvalidateMenuRows (0, MAX_UINTN);
     return EFI_SUCCESS;
   }
 
@@ -3436,6 +3636,10 @@ FormDisplay (
     mStatementLayoutIsChanged = FALSE;
   }
 
+  if (mStatementLayoutIsChanged || (FormData->Attribute & HII_DISPLAY_MODAL) != 0) {
+    InvalidateMenuRows (0, MAX_UINTN);
+  }
+
   Status = UiDisplayMenu(FormData);
   
   //
@@ -3580,5 +3784,9 @@ UnloadDisplayEngine (
     FreePool (gHighligthMenuInfo.OpCode);
   }
 
+  if (mMenuRows != NULL) {
+    FreePool (mMenuRows);
+  }
+
   return EFI_SUCCESS;
 }
@@ -209,6 +209,37 @@ typedef struct {
   CHAR16      *ErrorInfo;
 } WARNING_IF_CONTEXT;
 
+//
+// What DisplayOneMenu last painted from a row of the statement area.
+//
+typedef struct {
+  BOOLEAN     Valid;
+  UINT32      Crc;                // Crc of the DISPLAY_MENU_PAINT of the menu option.
+  UINTN       Skip;               // Skip of the menu option after it was painted.
+} DISPLAY_MENU_ROW;
+
+//
+// Everything the painting of a menu option depends on.
+//
+typedef struct {
+  UINTN       Col;
+  UINTN       OptCol;
+  UINTN       SkipWidth;
+  UINTN       BeginCol;
+  UINTN       SkipLine;
+  UINTN       BottomRow;
+  UINTN       Skip;
+  UINT32      FormAttribute;
+  UINT16      PromptBlockWidth;
+  UINT16      OptionBlockWidth;
+  UINT8       OpCode;
+  BOOLEAN     Highlight;
+  BOOLEAN     GrayOut;
+  UINT32      DescriptionCrc;
+  UINT32      OptionCrc;
+  UINT32      TextTwoCrc;
+} DISPLAY_MENU_PAINT;
+
 #define UI_MENU_OPTION_SIGNATURE  SIGNATURE_32 ('u', 'i', 'm', 'm')
 
 typedef struct {
@@ -1022,11 +1022,48 @@ BlockArrayCheck (
   return FALSE;
 }
 
+/**
+  Free what ConfigRouting cached from the form packages of a package list.
+  This is a internal function.
+
+  @param  PackageList            Pointer to a package list.
+
+**/
+VOID
+FreeConfigRoutingCache (
+  IN OUT HII_DATABASE_PACKAGE_LIST_INSTANCE *PackageList
+  )
+{
+  HII_CONFIG_ROUTING_CACHE     *Cache;
+
+  Cache = &PackageList->ConfigRoutingCache;
+  if (Cache->FormPackage != NULL) {
+    FreePool (Cache->FormPackage);
+  }
+  if (Cache->Request != NULL) {
+    FreePool (Cache->Request);
+  }
+  if (Cache->DevicePath != NULL) {
+    FreePool (Cache->DevicePath);
+  }
+  if (Cache->FullRequest != NULL) {
+    FreePool (Cache->FullRequest);
+  }
+  if (Cache->DefaultAltCfgResp != NULL) {
+    FreePool (Cache->DefaultAltCfgResp);
+  }
+  ZeroMem (Cache, sizeof (HII_CONFIG_ROUTING_CACHE));
+}
+
 /**
   Get form package data from data base.
 
+  The form packages are exported once and kept in the cache of the package list
+  until its form packages change.
+
   @param  DataBaseRecord         The DataBaseRecord instance contains the found Hii handle and package.
-  @param  HiiFormPackage         The buffer saves the package data.
+  @param  HiiFormPackage         The buffer saves the package data. It is owned by
+                                 the package list and must not be freed.
   @param  PackageSize            The buffer size of the package data.
 
 **/
@@ -1040,11 +1077,20 @@ GetFormPackageData (
   EFI_STATUS                   Status;
   UINTN                        Size;
   UINTN                        ResultSize;
+  UINT8                        *Buffer;
+  HII_CONFIG_ROUTING_CACHE     *Cache;
 
   if (DataBaseRecord == NULL || HiiFormPackage == NULL || PackageSize == NULL) {
     return EFI_INVALID_PARAMETER;
   }
 
+  Cache = &DataBaseRecord->PackageList->ConfigRoutingCache;
+  if (Cache->FormPackage != NULL) {
+    *HiiFormPackage = Cache->FormPackage;
+    *PackageSize    = Cache->FormPackageSize;
+    return EFI_SUCCESS;
+  }
+
   Size       = 0;
   ResultSize = 0;
   //
@@ -1056,15 +1102,15 @@ GetFormPackageData (
              DataBaseRecord->PackageList, 
              0, 
              Size, 
-             HiiFormPackage,
+             NULL,
              &ResultSize
            );
   if (EFI_ERROR (Status)) {
     return Status;
   }
  
-  (*HiiFormPackage) = AllocatePool (ResultSize);
-  if (*HiiFormPackage == NULL) {
+  Buffer = AllocatePool (ResultSize);
+  if (Buffer == NULL) {
     Status = EFI_OUT_OF_RESOURCES;
     return Status;
   }
@@ -1080,14 +1126,18 @@ GetFormPackageData (
              DataBaseRecord->PackageList, 
              0,
              Size, 
-             *HiiFormPackage,
+             Buffer,
              &ResultSize
            );
   if (EFI_ERROR (Status)) {
-    FreePool (*HiiFormPackage);
+    FreePool (Buffer);
+    return Status;
   }
-  
-  *PackageSize = Size;
+
+  Cache->FormPackage     = Buffer;
+  Cache->FormPackageSize = Size;
+  *HiiFormPackage        = Buffer;
+  *PackageSize           = Size;
 
   return Status;
 }
@@ -1221,10 +1271,6 @@ GetVarStoreType (
     }
   }
 Done:
-  if (HiiFormPackage != NULL) {
-    FreePool (HiiFormPackage);
-  }
-
   return Status;
 }
 
@@ -1438,10 +1484,6 @@ IsThisPackageList (
     }
   }
 Done:
-  if (HiiFormPackage != NULL) {
-    FreePool (HiiFormPackage);
-  }
-
   if (VarStoreName != NULL) {
     FreePool (VarStoreName);
   }
@@ -3000,6 +3042,106 @@ GenerateAltConfigResp (
   return EFI_SUCCESS;
 }
 
+/**
+  Check whether the full request and the default values of a request are cached
+  for the package list.
+
+  @param  Cache                  The ConfigRouting cache of the package list.
+  @param  Request                The request, or NULL for the first varstore.
+  @param  DevicePath             Device path of the request.
+
+  @retval TRUE                   The results of the request are cached.
+  @retval FALSE                  The request has to be parsed.
+
+**/
+BOOLEAN
+IsFullStringCached (
+  IN HII_CONFIG_ROUTING_CACHE       *Cache,
+  IN EFI_STRING                     Request,
+  IN EFI_DEVICE_PATH_PROTOCOL       *DevicePath
+  )
+{
+  UINTN                        DevicePathSize;
+
+  if (!Cache->FullStringValid) {
+    return FALSE;
+  }
+
+  if (Request == NULL || Cache->Request == NULL) {
+    if (Request != Cache->Request) {
+      return FALSE;
+    }
+  } else if (StrCmp (Request, Cache->Request) != 0) {
+    return FALSE;
+  }
+
+  DevicePathSize = GetDevicePathSize (DevicePath);
+  return (BOOLEAN) (DevicePathSize == GetDevicePathSize (Cache->DevicePath) &&
+                    CompareMem (DevicePath, Cache->DevicePath, DevicePathSize) == 0);
+}
+
+/**
+  Cache the full request and the default values of a request for the package
+  list. Nothing is cached if the system is out of resources.
+
+  @param  Cache                  The ConfigRouting cache of the package list.
+  @param  Request                The request, or NULL for the first varstore.
+  @param  DevicePath             Device path of the request.
+  @param  FullRequest            The request completed from the IFR.
+  @param  DefaultAltCfgResp      The default values from the IFR.
+
+**/
+VOID
+CacheFullString (
+  IN OUT HII_CONFIG_ROUTING_CACHE   *Cache,
+  IN     EFI_STRING                 Request,
+  IN     EFI_DEVICE_PATH_PROTOCOL   *DevicePath,
+  IN     EFI_STRING                 FullRequest,
+  IN     EFI_STRING                 DefaultAltCfgResp
+  )
+{
+  if (Cache->Request != NULL) {
+    FreePool (Cache->Request);
+  }
+  if (Cache->DevicePath != NULL) {
+    FreePool (Cache->DevicePath);
+  }
+  if (Cache->FullRequest != NULL) {
+    FreePool (Cache->FullRequest);
+  }
+  if (Cache->DefaultAltCfgResp != NULL) {
+    FreePool (Cache->DefaultAltCfgResp);
+  }
+  Cache->Request           = NULL;
+  Cache->FullRequest       = NULL;
+  Cache->DefaultAltCfgResp = NULL;
+  Cache->FullStringValid   = FALSE;
+
+  Cache->DevicePath = DuplicateDevicePath (DevicePath);
+  if (Cache->DevicePath == NULL) {
+    return;
+  }
+  if (Request != NULL) {
+    Cache->Request = AllocateCopyPool (StrSize (Request), Request);
+    if (Cache->Request == NULL) {
+      return;
+    }
+  }
+  if (FullRequest != NULL) {
+    Cache->FullRequest = AllocateCopyPool (StrSize (FullRequest), FullRequest);
+    if (Cache->FullRequest == NULL) {
+      return;
+    }
+  }
+  if (DefaultAltCfgResp != NULL) {
+    Cache->DefaultAltCfgResp = AllocateCopyPool (StrSize (DefaultAltCfgResp), DefaultAltCfgResp);
+    if (Cache->DefaultAltCfgResp == NULL) {
+      return;
+    }
+  }
+  Cache->FullStringValid = TRUE;
+}
+
 /**
   This function gets the full request string and full default value string by 
   parsing IFR data in HII form packages. 
@@ -3066,6 +3208,8 @@ GetFullStringFromHiiFormPackages (
   EFI_STRING                   ConfigHdr;
   EFI_STRING                   StringPtr;
   EFI_STRING                   Progress;
+  HII_CONFIG_ROUTING_CACHE     *Cache;
+  EFI_STRING                   OriginalRequest;
 
   if (DataBaseRecord == NULL || DevicePath == NULL || Request == NULL || AltCfgResp == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -3082,6 +3226,42 @@ GetFullStringFromHiiFormPackages (
   HiiFormPackage    = NULL;
   PackageSize       = 0;
   Progress          = *Request;
+  OriginalRequest   = NULL;
+  Cache             = &DataBaseRecord->PackageList->ConfigRoutingCache;
+
+  //
+  // The same request on an unchanged package list gives the same results.
+  //
+  if (IsFullStringCached (Cache, *Request, DevicePath)) {
+    if (Cache->FullRequest != NULL && (*Request == NULL || StrCmp (*Request, Cache->FullRequest) != 0)) {
+      StringPtr = AllocateCopyPool (StrSize (Cache->FullRequest), Cache->FullRequest);
+      if (StringPtr == NULL) {
+        Status = EFI_OUT_OF_RESOURCES;
+        goto Done;
+      }
+      if (*Request != NULL) {
+        FreePool (*Request);
+      }
+      *Request = StringPtr;
+    }
+    if (Cache->DefaultAltCfgResp != NULL) {
+      DefaultAltCfgResp = AllocateCopyPool (StrSize (Cache->DefaultAltCfgResp), Cache->DefaultAltCfgResp);
+      if (DefaultAltCfgResp == NULL) {
+        Status = EFI_OUT_OF_RESOURCES;
+        goto Done;
+      }
+    }
+    Status = EFI_SUCCESS;
+    goto MergeDefault;
+  }
+
+  if (*Request != NULL) {
+    OriginalRequest = AllocateCopyPool (StrSize (*Request), *Request);
+    if (OriginalRequest == NULL) {
+      Status = EFI_OUT_OF_RESOURCES;
+      goto Done;
+    }
+  }
 
   Status = GetFormPackageData (DataBaseRecord, &HiiFormPackage, &PackageSize);
   if (EFI_ERROR (Status)) {
@@ -3189,6 +3369,7 @@ GetFullStringFromHiiFormPackages (
   // No requested varstore in IFR data and directly return
   //
   if (VarStorageData->Type == 0 && VarStorageData->Name == NULL) {
+    CacheFullString (Cache, OriginalRequest, DevicePath, *Request, NULL);
     Status = EFI_SUCCESS;
     goto Done;
   }
@@ -3203,6 +3384,9 @@ GetFullStringFromHiiFormPackages (
 
   if (RequestBlockArray == NULL) {
     if (!GenerateConfigRequest(ConfigHdr, VarStorageData, &Status, Request)) {
+      if (!EFI_ERROR (Status)) {
+        CacheFullString (Cache, OriginalRequest, DevicePath, *Request, NULL);
+      }
       goto Done;
     }
   }
@@ -3217,6 +3401,15 @@ GetFullStringFromHiiFormPackages (
     goto Done;
   }
 
+  //
+  // The names of a name/value varstore are strings, which depend on the
+  // platform language. Only cache the results of the other varstores.
+  //
+  if (VarStorageData->Type != EFI_HII_VARSTORE_NAME_VALUE) {
+    CacheFullString (Cache, OriginalRequest, DevicePath, *Request, DefaultAltCfgResp);
+  }
+
+MergeDefault:
   //
   // 5. Merge string into the input AltCfgResp if the iput *AltCfgResp is not NULL.
   //
@@ -3286,11 +3479,8 @@ Done:
     FreePool (ConfigHdr);
   }
 
-  //
-  // Free Pacakge data
-  //
-  if (HiiFormPackage != NULL) {
-    FreePool (HiiFormPackage);
+  if (OriginalRequest != NULL) {
+    FreePool (OriginalRequest);
   }
 
   if (PointerProgress != NULL) {
@@ -594,6 +594,7 @@ InsertFormPackage (
 
   InsertTailList (&PackageList->FormPkgHdr, &FormPackage->IfrEntry);
   *Package = FormPackage;
+  FreeConfigRoutingCache (PackageList);
 
   if (NotifyType == EFI_HII_DATABASE_NOTIFY_ADD_PACK) {
     PackageList->PackageListHdr.PackageLength += FormPackage->FormPkgHdr.Length;
@@ -734,6 +735,7 @@ RemoveFormPackages (
     PackageList->PackageListHdr.PackageLength -= Package->FormPkgHdr.Length;
     FreePool (Package->IfrData);
     FreePool (Package);
+    FreeConfigRoutingCache (PackageList);
 
   }
 
@@ -951,6 +953,7 @@ AdjustStringPackage (
       *BlockPtr = EFI_HII_SIBT_END;
       FreePool (StringPackage->StringBlock);
       StringPackage->StringBlock = StringBlock;
+      FreeStringIndex (StringPackage);
       StringPackage->StringPkgHdr->Header.Length += Skip2BlockSize;
       PackageList->PackageListHdr.PackageLength += Skip2BlockSize;
       StringPackage->MaxStringId = MaxStringId;
@@ -1092,6 +1095,7 @@ RemoveStringPackages (
     PackageList->PackageListHdr.PackageLength -= Package->StringPkgHdr->Header.Length;
     FreePool (Package->StringBlock);
     FreePool (Package->StringPkgHdr);
+    FreeStringIndex (Package);
     //
     // Delete font information
     //
@@ -1255,6 +1259,7 @@ Error:
     if (FontPackage->GlyphBlock != NULL) {
       FreePool (FontPackage->GlyphBlock);
     }
+    FreeGlyphIndex (FontPackage->GlyphIndex);
     FreePool (FontPackage);
   }
   if (GlobalFont != NULL) {
@@ -1404,6 +1409,7 @@ RemoveFontPackages (
       FreePool (Package->GlyphBlock);
     }
     FreePool (Package->FontPkgHdr);
+    FreeGlyphIndex (Package->GlyphIndex);
     //
     // Delete default character cell information
     //
@@ -1424,6 +1430,9 @@ RemoveFontPackages (
     for (Link = Private->FontInfoList.ForwardLink; Link != &Private->FontInfoList; Link = Link->ForwardLink) {
       GlobalFont = CR (Link, HII_GLOBAL_FONT_INFO, Entry, HII_GLOBAL_FONT_INFO_SIGNATURE);
       if (GlobalFont->FontPackage == Package) {
+        if (Private->LastFontInfo == GlobalFont) {
+          Private->LastFontInfo = NULL;
+        }
         RemoveEntryList (&GlobalFont->Entry);
         FreePool (GlobalFont->FontInfo);
         FreePool (GlobalFont);
@@ -1914,6 +1923,12 @@ RemoveSimpleFontPackages (
     PackageList->PackageListHdr.PackageLength -= Package->SimpleFontPkgHdr->Header.Length;
     FreePool (Package->SimpleFontPkgHdr);
     FreePool (Package);
+
+    //
+    // The glyph index points into the removed package, rebuild it on next use.
+    //
+    FreeGlyphIndex (Private->SimpleGlyphIndex);
+    Private->SimpleGlyphIndexValid = FALSE;
   }
 
   return EFI_SUCCESS;
@@ -2568,6 +2583,7 @@ AddPackages (
       if (EFI_ERROR (Status)) {
         return Status;
       }
+      Private->SimpleGlyphIndexValid = FALSE;
       Status = InvokeRegisteredFunction (
                  Private,
                  NotifyType,
@@ -2969,6 +2985,7 @@ HiiRemovePackageList (
 
       HiiHandle->Signature = 0;
       FreePool (HiiHandle);
+      FreeConfigRoutingCache (Node->PackageList);
       FreePool (Node->PackageList);
       FreePool (Node);
 
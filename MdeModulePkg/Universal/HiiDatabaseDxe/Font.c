@@ -136,6 +136,185 @@ GetCell (
 }
 
 
+/**
+  Get the entry of a character in a glyph index.
+
+  This is a internal function.
+
+  @param  GlyphIndex              The glyph index.
+  @param  CharValue               Unicode character value.
+  @param  Create                  If TRUE, allocate the page of the entry when it
+                                  does not exist yet.
+
+  @return The entry of the character, or NULL if its page does not exist and
+          could not be created.
+
+**/
+HII_GLYPH_INDEX_ENTRY *
+GetGlyphIndexEntry (
+  IN  HII_GLYPH_INDEX_ENTRY          **GlyphIndex,
+  IN  CHAR16                         CharValue,
+  IN  BOOLEAN                        Create
+  )
+{
+  HII_GLYPH_INDEX_ENTRY              **Page;
+
+  Page = &GlyphIndex[CharValue / HII_GLYPH_INDEX_PAGE_SIZE];
+  if (*Page == NULL) {
+    if (!Create) {
+      return NULL;
+    }
+    *Page = (HII_GLYPH_INDEX_ENTRY *) AllocateZeroPool (HII_GLYPH_INDEX_PAGE_SIZE * sizeof (HII_GLYPH_INDEX_ENTRY));
+    if (*Page == NULL) {
+      return NULL;
+    }
+  }
+
+  return &(*Page)[CharValue % HII_GLYPH_INDEX_PAGE_SIZE];
+}
+
+
+/**
+  Record the glyph of a character in a glyph index. The first glyph recorded for
+  a character is kept, as the glyph blocks are searched in order.
+
+  This is a internal function.
+
+  @param  GlyphIndex              The glyph index.
+  @param  CharValue               Unicode character value.
+  @param  Glyph                   The glyph data, or NULL for a duplicate.
+  @param  Cell                    Cell information of the glyph, or NULL for a
+                                  duplicate.
+  @param  Duplicate               If not 0, the character whose glyph is used for
+                                  CharValue.
+
+  @retval EFI_SUCCESS             The glyph is recorded.
+  @retval EFI_OUT_OF_RESOURCES    The system is out of resources to accomplish the
+                                  task.
+
+**/
+EFI_STATUS
+AddGlyphIndexEntry (
+  IN OUT HII_GLYPH_INDEX_ENTRY       **GlyphIndex,
+  IN  CHAR16                         CharValue,
+  IN  UINT8                          *Glyph, OPTIONAL
+  IN  EFI_HII_GLYPH_INFO             *Cell, OPTIONAL
+  IN  CHAR16                         Duplicate
+  )
+{
+  HII_GLYPH_INDEX_ENTRY              *Entry;
+
+  Entry = GetGlyphIndexEntry (GlyphIndex, CharValue, TRUE);
+  if (Entry == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  if (Entry->Glyph == NULL && Entry->Duplicate == 0) {
+    Entry->Glyph     = Glyph;
+    Entry->Duplicate = Duplicate;
+    if (Cell != NULL) {
+      CopyMem (&Entry->Cell, Cell, sizeof (EFI_HII_GLYPH_INFO));
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+
+/**
+  Free all the pages of a glyph index.
+
+  @param  GlyphIndex              The glyph index to free.
+
+**/
+VOID
+FreeGlyphIndex (
+  IN OUT HII_GLYPH_INDEX_ENTRY       **GlyphIndex
+  )
+{
+  UINTN                              Index;
+
+  for (Index = 0; Index < HII_GLYPH_INDEX_PAGE_NUM; Index++) {
+    if (GlyphIndex[Index] != NULL) {
+      FreePool (GlyphIndex[Index]);
+      GlyphIndex[Index] = NULL;
+    }
+  }
+}
+
+
+/**
+  Build the glyph index of all the narrow and wide glyphs of the simple font
+  packages, in the order the package lists are registered.
+
+  This is a internal function.
+
+  @param  Private                 HII database driver private data.
+
+  @retval EFI_SUCCESS             The glyph index is built.
+  @retval EFI_OUT_OF_RESOURCES    The system is out of resources to accomplish the
+                                  task.
+
+**/
+EFI_STATUS
+BuildSimpleGlyphIndex (
+  IN  HII_DATABASE_PRIVATE_DATA      *Private
+  )
+{
+  EFI_STATUS                         Status;
+  HII_DATABASE_RECORD                *Node;
+  LIST_ENTRY                         *Link;
+  HII_SIMPLE_FONT_PACKAGE_INSTANCE   *SimpleFont;
+  LIST_ENTRY                         *Link1;
+  UINT16                             Index;
+  CHAR16                             UnicodeWeight;
+  EFI_HII_GLYPH_INFO                 Cell;
+  EFI_NARROW_GLYPH                   *NarrowPtr;
+  EFI_WIDE_GLYPH                     *WidePtr;
+
+  FreeGlyphIndex (Private->SimpleGlyphIndex);
+  ZeroMem (&Cell, sizeof (EFI_HII_GLYPH_INFO));
+  Cell.Height = EFI_GLYPH_HEIGHT;
+
+  for (Link = Private->DatabaseList.ForwardLink; Link != &Private->DatabaseList; Link = Link->ForwardLink) {
+    Node = CR (Link, HII_DATABASE_RECORD, DatabaseEntry, HII_DATABASE_RECORD_SIGNATURE);
+    for (Link1 = Node->PackageList->SimpleFontPkgHdr.ForwardLink;
+         Link1 != &Node->PackageList->SimpleFontPkgHdr;
+         Link1 = Link1->ForwardLink
+        ) {
+      SimpleFont = CR (Link1, HII_SIMPLE_FONT_PACKAGE_INSTANCE, SimpleFontEntry, HII_S_FONT_PACKAGE_SIGNATURE);
+      NarrowPtr  = (EFI_NARROW_GLYPH *) ((UINT8 *) (SimpleFont->SimpleFontPkgHdr) + sizeof (EFI_HII_SIMPLE_FONT_PACKAGE_HDR));
+      WidePtr    = (EFI_WIDE_GLYPH *) (NarrowPtr + SimpleFont->SimpleFontPkgHdr->NumberOfNarrowGlyphs);
+
+      Cell.Width    = EFI_GLYPH_WIDTH;
+      Cell.AdvanceX = Cell.Width;
+      for (Index = 0; Index < SimpleFont->SimpleFontPkgHdr->NumberOfNarrowGlyphs; Index++) {
+        CopyMem (&UnicodeWeight, &NarrowPtr[Index].UnicodeWeight, sizeof (CHAR16));
+        Status = AddGlyphIndexEntry (Private->SimpleGlyphIndex, UnicodeWeight, (UINT8 *) (NarrowPtr + Index), &Cell, 0);
+        if (EFI_ERROR (Status)) {
+          FreeGlyphIndex (Private->SimpleGlyphIndex);
+          return Status;
+        }
+      }
+
+      Cell.Width    = EFI_GLYPH_WIDTH * 2;
+      Cell.AdvanceX = Cell.Width;
+      for (Index = 0; Index < SimpleFont->SimpleFontPkgHdr->NumberOfWideGlyphs; Index++) {
+        CopyMem (&UnicodeWeight, &WidePtr[Index].UnicodeWeight, sizeof (CHAR16));
+        Status = AddGlyphIndexEntry (Private->SimpleGlyphIndex, UnicodeWeight, (UINT8 *) (WidePtr + Index), &Cell, 0);
+        if (EFI_ERROR (Status)) {
+          FreeGlyphIndex (Private->SimpleGlyphIndex);
+          return Status;
+        }
+      }
+    }
+  }
+
+  Private->SimpleGlyphIndexValid = TRUE;
+  return EFI_SUCCESS;
+}
+
+
 /**
   Convert the glyph for a single character into a bitmap.
 
@@ -166,17 +345,11 @@ GetGlyphBuffer (
   OUT UINT8                          *Attributes OPTIONAL
   )
 {
-  HII_DATABASE_RECORD                *Node;
-  LIST_ENTRY                         *Link;
-  HII_SIMPLE_FONT_PACKAGE_INSTANCE   *SimpleFont;
-  LIST_ENTRY                         *Link1;
-  UINT16                             Index;
+  EFI_STATUS                         Status;
   EFI_NARROW_GLYPH                   Narrow;
   EFI_WIDE_GLYPH                     Wide;
   HII_GLOBAL_FONT_INFO               *GlobalFont;
-  UINTN                              HeaderSize;
-  EFI_NARROW_GLYPH                   *NarrowPtr;
-  EFI_WIDE_GLYPH                     *WidePtr;
+  HII_GLYPH_INDEX_ENTRY              *Entry;
 
   if (GlyphBuffer == NULL || Cell == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -201,64 +374,45 @@ GetGlyphBuffer (
       *Attributes = PROPORTIONAL_GLYPH;
     }
     return FindGlyphBlock (GlobalFont->FontPackage, Char, GlyphBuffer, Cell, NULL);
+  }
+
+  if (!Private->SimpleGlyphIndexValid) {
+    Status = BuildSimpleGlyphIndex (Private);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  Entry = GetGlyphIndexEntry (Private->SimpleGlyphIndex, Char, FALSE);
+  if (Entry == NULL || Entry->Glyph == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  CopyMem (Cell, &Entry->Cell, sizeof (EFI_HII_GLYPH_INFO));
+  if (Entry->Cell.Width == EFI_GLYPH_WIDTH) {
+    CopyMem (&Narrow, Entry->Glyph, sizeof (EFI_NARROW_GLYPH));
+    *GlyphBuffer = (UINT8 *) AllocateZeroPool (EFI_GLYPH_HEIGHT);
+    if (*GlyphBuffer == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+    CopyMem (*GlyphBuffer, Narrow.GlyphCol1, EFI_GLYPH_HEIGHT);
+    if (Attributes != NULL) {
+      *Attributes = (UINT8) (Narrow.Attributes | NARROW_GLYPH);
+    }
   } else {
-    HeaderSize = sizeof (EFI_HII_SIMPLE_FONT_PACKAGE_HDR);
-
-    for (Link = Private->DatabaseList.ForwardLink; Link != &Private->DatabaseList; Link = Link->ForwardLink) {
-      Node = CR (Link, HII_DATABASE_RECORD, DatabaseEntry, HII_DATABASE_RECORD_SIGNATURE);
-      for (Link1 = Node->PackageList->SimpleFontPkgHdr.ForwardLink;
-           Link1 != &Node->PackageList->SimpleFontPkgHdr;
-           Link1 = Link1->ForwardLink
-          ) {
-        SimpleFont = CR (Link1, HII_SIMPLE_FONT_PACKAGE_INSTANCE, SimpleFontEntry, HII_S_FONT_PACKAGE_SIGNATURE);
-        //
-        // Search the narrow glyph array
-        //
-        NarrowPtr = (EFI_NARROW_GLYPH *) ((UINT8 *) (SimpleFont->SimpleFontPkgHdr) + HeaderSize);
-        for (Index = 0; Index < SimpleFont->SimpleFontPkgHdr->NumberOfNarrowGlyphs; Index++) {
-          CopyMem (&Narrow, NarrowPtr + Index,sizeof (EFI_NARROW_GLYPH));
-          if (Narrow.UnicodeWeight == Char) {
-            *GlyphBuffer = (UINT8 *) AllocateZeroPool (EFI_GLYPH_HEIGHT);
-            if (*GlyphBuffer == NULL) {
-              return EFI_OUT_OF_RESOURCES;
-            }
-            Cell->Width    = EFI_GLYPH_WIDTH;
-            Cell->Height   = EFI_GLYPH_HEIGHT;
-            Cell->AdvanceX = Cell->Width;
-            CopyMem (*GlyphBuffer, Narrow.GlyphCol1, Cell->Height);
-            if (Attributes != NULL) {
-              *Attributes = (UINT8) (Narrow.Attributes | NARROW_GLYPH);
-            }
-            return EFI_SUCCESS;
-          }
-        }
-        //
-        // Search the wide glyph array
-        //
-        WidePtr = (EFI_WIDE_GLYPH *) (NarrowPtr + SimpleFont->SimpleFontPkgHdr->NumberOfNarrowGlyphs);
-        for (Index = 0; Index < SimpleFont->SimpleFontPkgHdr->NumberOfWideGlyphs; Index++) {
-          CopyMem (&Wide, WidePtr + Index, sizeof (EFI_WIDE_GLYPH));
-          if (Wide.UnicodeWeight == Char) {
-            *GlyphBuffer    = (UINT8 *) AllocateZeroPool (EFI_GLYPH_HEIGHT * 2);
-            if (*GlyphBuffer == NULL) {
-              return EFI_OUT_OF_RESOURCES;
-            }
-            Cell->Width    = EFI_GLYPH_WIDTH * 2;
-            Cell->Height   = EFI_GLYPH_HEIGHT;
-            Cell->AdvanceX = Cell->Width;
-            CopyMem (*GlyphBuffer, Wide.GlyphCol1, EFI_GLYPH_HEIGHT);
-            CopyMem (*GlyphBuffer + EFI_GLYPH_HEIGHT, Wide.GlyphCol2, EFI_GLYPH_HEIGHT);
-            if (Attributes != NULL) {
-              *Attributes = (UINT8) (Wide.Attributes | EFI_GLYPH_WIDE);
-            }
-            return EFI_SUCCESS;
-          }
-        }
-      }
+    CopyMem (&Wide, Entry->Glyph, sizeof (EFI_WIDE_GLYPH));
+    *GlyphBuffer = (UINT8 *) AllocateZeroPool (EFI_GLYPH_HEIGHT * 2);
+    if (*GlyphBuffer == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+    CopyMem (*GlyphBuffer, Wide.GlyphCol1, EFI_GLYPH_HEIGHT);
+    CopyMem (*GlyphBuffer + EFI_GLYPH_HEIGHT, Wide.GlyphCol2, EFI_GLYPH_HEIGHT);
+    if (Attributes != NULL) {
+      *Attributes = (UINT8) (Wide.Attributes | EFI_GLYPH_WIDE);
     }
   }
 
-  return EFI_NOT_FOUND;
+  return EFI_SUCCESS;
 }
 
 /**
@@ -639,9 +793,10 @@ WriteOutputParam (
 
 
 /**
-  Parse all glyph blocks to find a glyph block specified by CharValue.
-  If CharValue = (CHAR16) (-1), collect all default character cell information
-  within this font package and backup its information.
+  Look up the glyph block specified by CharValue in the glyph index of the font
+  package. If CharValue = (CHAR16) (-1), parse all glyph blocks to collect all
+  default character cell information within this font package, backup its
+  information and build the glyph index.
 
   @param  FontPackage             Hii string package instance.
   @param  CharValue               Unicode character value, which identifies a glyph
@@ -680,34 +835,61 @@ FindGlyphBlock (
   EFI_HII_GLYPH_INFO                  LocalCell;
   INT16                               MinOffsetY;
   UINT16                              BaseLine;
+  CHAR16                              Duplicate;
+  HII_GLYPH_INDEX_ENTRY               *Entry;
 
   ASSERT (FontPackage != NULL);
   ASSERT (FontPackage->Signature == HII_FONT_PACKAGE_SIGNATURE);
-  BaseLine  = 0;
-  MinOffsetY = 0;
-  
-  if (CharValue == (CHAR16) (-1)) {
+
+  if (CharValue != (CHAR16) (-1)) {
     //
-    // Collect the cell information specified in font package fixed header.
-    // Use CharValue =0 to represent this particular cell.
+    // Follow the duplicated characters to the one owning the glyph. The depth
+    // is limited in case the duplicate blocks form a loop.
     //
-    Status = NewCell (
-               0,
-               &FontPackage->GlyphInfoList,
-               (EFI_HII_GLYPH_INFO *) ((UINT8 *) FontPackage->FontPkgHdr + 3 * sizeof (UINT32))
-               );
-    if (EFI_ERROR (Status)) {
-      return Status;
-    }
-    CopyMem (
-      &LocalCell,
-      (UINT8 *) FontPackage->FontPkgHdr + 3 * sizeof (UINT32),
-      sizeof (EFI_HII_GLYPH_INFO)
-      );
-    BaseLine = (UINT16) (LocalCell.Height + LocalCell.OffsetY);
-    if (MinOffsetY > LocalCell.OffsetY) {
-      MinOffsetY = LocalCell.OffsetY;
+    for (Index = 0; Index < HII_GLYPH_INDEX_MAX_DUPLICATE; Index++) {
+      Entry = GetGlyphIndexEntry (FontPackage->GlyphIndex, CharValue, FALSE);
+      if (Entry == NULL) {
+        return EFI_NOT_FOUND;
+      }
+      if (Entry->Glyph != NULL) {
+        return WriteOutputParam (
+                 Entry->Glyph,
+                 BITMAP_LEN_1_BIT (Entry->Cell.Width, Entry->Cell.Height),
+                 &Entry->Cell,
+                 GlyphBuffer,
+                 Cell,
+                 GlyphBufferLen
+                 );
+      }
+      if (Entry->Duplicate == 0) {
+        return EFI_NOT_FOUND;
+      }
+      CharValue = Entry->Duplicate;
     }
+    return EFI_NOT_FOUND;
+  }
+
+  //
+  // Collect the cell information specified in font package fixed header.
+  // Use CharValue =0 to represent this particular cell.
+  //
+  Status = NewCell (
+             0,
+             &FontPackage->GlyphInfoList,
+             (EFI_HII_GLYPH_INFO *) ((UINT8 *) FontPackage->FontPkgHdr + 3 * sizeof (UINT32))
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+  CopyMem (
+    &LocalCell,
+    (UINT8 *) FontPackage->FontPkgHdr + 3 * sizeof (UINT32),
+    sizeof (EFI_HII_GLYPH_INFO)
+    );
+  BaseLine   = (UINT16) (LocalCell.Height + LocalCell.OffsetY);
+  MinOffsetY = 0;
+  if (MinOffsetY > LocalCell.OffsetY) {
+    MinOffsetY = LocalCell.OffsetY;
   }
 
   BlockPtr    = FontPackage->GlyphBlock;
@@ -721,36 +903,33 @@ FindGlyphBlock (
       // Collect all default character cell information specified by
       // EFI_HII_GIBT_DEFAULTS.
       //
-      if (CharValue == (CHAR16) (-1)) {
-        Status = NewCell (
-                   CharCurrent,
-                   &FontPackage->GlyphInfoList,
-                   (EFI_HII_GLYPH_INFO *) (BlockPtr + sizeof (EFI_HII_GLYPH_BLOCK))
-                   );
-        if (EFI_ERROR (Status)) {
-          return Status;
-        }
-        CopyMem (
-          &LocalCell,
-          BlockPtr + sizeof (EFI_HII_GLYPH_BLOCK),
-          sizeof (EFI_HII_GLYPH_INFO)
-          );
-        if (BaseLine < LocalCell.Height + LocalCell.OffsetY) {
-          BaseLine = (UINT16) (LocalCell.Height + LocalCell.OffsetY);
-        }
-        if (MinOffsetY > LocalCell.OffsetY) {
-          MinOffsetY = LocalCell.OffsetY;
-        }
+      Status = NewCell (
+                 CharCurrent,
+                 &FontPackage->GlyphInfoList,
+                 (EFI_HII_GLYPH_INFO *) (BlockPtr + sizeof (EFI_HII_GLYPH_BLOCK))
+                 );
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+      CopyMem (
+        &LocalCell,
+        BlockPtr + sizeof (EFI_HII_GLYPH_BLOCK),
+        sizeof (EFI_HII_GLYPH_INFO)
+        );
+      if (BaseLine < LocalCell.Height + LocalCell.OffsetY) {
+        BaseLine = (UINT16) (LocalCell.Height + LocalCell.OffsetY);
+      }
+      if (MinOffsetY > LocalCell.OffsetY) {
+        MinOffsetY = LocalCell.OffsetY;
       }
       BlockPtr += sizeof (EFI_HII_GIBT_DEFAULTS_BLOCK);
       break;
 
     case EFI_HII_GIBT_DUPLICATE:
-      if (CharCurrent == CharValue) {
-        CopyMem (&CharValue, BlockPtr + sizeof (EFI_HII_GLYPH_BLOCK), sizeof (CHAR16));
-        CharCurrent = 1;
-        BlockPtr    = FontPackage->GlyphBlock;
-        continue;
+      CopyMem (&Duplicate, BlockPtr + sizeof (EFI_HII_GLYPH_BLOCK), sizeof (CHAR16));
+      Status = AddGlyphIndexEntry (FontPackage->GlyphIndex, CharCurrent, NULL, NULL, Duplicate);
+      if (EFI_ERROR (Status)) {
+        return Status;
       }
       CharCurrent++;
       BlockPtr += sizeof (EFI_HII_GIBT_DUPLICATE_BLOCK);
@@ -782,25 +961,23 @@ FindGlyphBlock (
         BlockPtr + sizeof (EFI_HII_GLYPH_BLOCK),
         sizeof (EFI_HII_GLYPH_INFO)
         );
-      if (CharValue == (CHAR16) (-1)) {
-        if (BaseLine < LocalCell.Height + LocalCell.OffsetY) {
-          BaseLine = (UINT16) (LocalCell.Height + LocalCell.OffsetY);
-        }
-        if (MinOffsetY > LocalCell.OffsetY) {
-          MinOffsetY = LocalCell.OffsetY;
-        }
+      if (BaseLine < LocalCell.Height + LocalCell.OffsetY) {
+        BaseLine = (UINT16) (LocalCell.Height + LocalCell.OffsetY);
       }
-      BufferLen = BITMAP_LEN_1_BIT (LocalCell.Width, LocalCell.Height);
-      if (CharCurrent == CharValue) {
-        return WriteOutputParam (
+      if (MinOffsetY > LocalCell.OffsetY) {
+        MinOffsetY = LocalCell.OffsetY;
+      }
+      Status = AddGlyphIndexEntry (
+                 FontPackage->GlyphIndex,
+                 CharCurrent,
                  BlockPtr + sizeof (EFI_HII_GIBT_GLYPH_BLOCK) - sizeof (UINT8),
-                 BufferLen,
                  &LocalCell,
-                 GlyphBuffer,
-                 Cell,
-                 GlyphBufferLen
+                 0
                  );
+      if (EFI_ERROR (Status)) {
+        return Status;
       }
+      BufferLen = BITMAP_LEN_1_BIT (LocalCell.Width, LocalCell.Height);
       CharCurrent++;
       BlockPtr += sizeof (EFI_HII_GIBT_GLYPH_BLOCK) - sizeof (UINT8) + BufferLen;
       break;
@@ -812,26 +989,24 @@ FindGlyphBlock (
       CopyMem (&Glyphs.Count, BlockPtr, sizeof (UINT16));
       BlockPtr += sizeof (UINT16);
 
-      if (CharValue == (CHAR16) (-1)) {
-        if (BaseLine < Glyphs.Cell.Height + Glyphs.Cell.OffsetY) {
-          BaseLine = (UINT16) (Glyphs.Cell.Height + Glyphs.Cell.OffsetY);
-        }
-        if (MinOffsetY > Glyphs.Cell.OffsetY) {
-          MinOffsetY = Glyphs.Cell.OffsetY;
-        }
+      if (BaseLine < Glyphs.Cell.Height + Glyphs.Cell.OffsetY) {
+        BaseLine = (UINT16) (Glyphs.Cell.Height + Glyphs.Cell.OffsetY);
+      }
+      if (MinOffsetY > Glyphs.Cell.OffsetY) {
+        MinOffsetY = Glyphs.Cell.OffsetY;
       }
 
       BufferLen = BITMAP_LEN_1_BIT (Glyphs.Cell.Width, Glyphs.Cell.Height);
       for (Index = 0; Index < Glyphs.Count; Index++) {
-        if (CharCurrent + Index == CharValue) {
-          return WriteOutputParam (
+        Status = AddGlyphIndexEntry (
+                   FontPackage->GlyphIndex,
+                   (CHAR16) (CharCurrent + Index),
                    BlockPtr,
-                   BufferLen,
                    &Glyphs.Cell,
-                   GlyphBuffer,
-                   Cell,
-                   GlyphBufferLen
+                   0
                    );
+        if (EFI_ERROR (Status)) {
+          return Status;
         }
         BlockPtr += BufferLen;
       }
@@ -843,18 +1018,17 @@ FindGlyphBlock (
       if (EFI_ERROR (Status)) {
         return Status;
       }
-      BufferLen = BITMAP_LEN_1_BIT (DefaultCell.Width, DefaultCell.Height);
-
-      if (CharCurrent == CharValue) {
-        return WriteOutputParam (
+      Status = AddGlyphIndexEntry (
+                 FontPackage->GlyphIndex,
+                 CharCurrent,
                  BlockPtr + sizeof (EFI_HII_GLYPH_BLOCK),
-                 BufferLen,
                  &DefaultCell,
-                 GlyphBuffer,
-                 Cell,
-                 GlyphBufferLen
+                 0
                  );
+      if (EFI_ERROR (Status)) {
+        return Status;
       }
+      BufferLen = BITMAP_LEN_1_BIT (DefaultCell.Width, DefaultCell.Height);
       CharCurrent++;
       BlockPtr += sizeof (EFI_HII_GLYPH_BLOCK) + BufferLen;
       break;
@@ -868,15 +1042,15 @@ FindGlyphBlock (
       BufferLen = BITMAP_LEN_1_BIT (DefaultCell.Width, DefaultCell.Height);
       BlockPtr += sizeof (EFI_HII_GIBT_GLYPHS_DEFAULT_BLOCK) - sizeof (UINT8);
       for (Index = 0; Index < Length16; Index++) {
-        if (CharCurrent + Index == CharValue) {
-          return WriteOutputParam (
+        Status = AddGlyphIndexEntry (
+                   FontPackage->GlyphIndex,
+                   (CHAR16) (CharCurrent + Index),
                    BlockPtr,
-                   BufferLen,
                    &DefaultCell,
-                   GlyphBuffer,
-                   Cell,
-                   GlyphBufferLen
+                   0
                    );
+        if (EFI_ERROR (Status)) {
+          return Status;
         }
         BlockPtr += BufferLen;
       }
@@ -896,19 +1070,11 @@ FindGlyphBlock (
       ASSERT (FALSE);
       break;
     }
-
-    if (CharValue < CharCurrent) {
-      return EFI_NOT_FOUND;
-    }
   }
 
-  if (CharValue == (CHAR16) (-1)) {
-    FontPackage->BaseLine = BaseLine;
-    FontPackage->Height   = (UINT16) (BaseLine - MinOffsetY);
-    return EFI_SUCCESS;
-  }
-
-  return EFI_NOT_FOUND;
+  FontPackage->BaseLine = BaseLine;
+  FontPackage->Height   = (UINT16) (BaseLine - MinOffsetY);
+  return EFI_SUCCESS;
 }
 
 
@@ -1174,6 +1340,19 @@ IsFontInfoExisted (
     Mask = *FontInfoMask & (~SYS_FONT_INFO_MASK);
   }
 
+  //
+  // Strings are mostly drawn in the font matched last, check it first.
+  //
+  if (FontInfoMask == NULL && FontHandle == NULL && Private->LastFontInfo != NULL) {
+    GlobalFont = Private->LastFontInfo;
+    if (CompareMem (GlobalFont->FontInfo, FontInfo, GlobalFont->FontInfoSize) == 0) {
+      if (GlobalFontInfo != NULL) {
+        *GlobalFontInfo = GlobalFont;
+      }
+      return TRUE;
+    }
+  }
+
   //
   // If not NULL, FontHandle points to the next node of the last searched font
   // node by previous call.
@@ -1191,6 +1370,7 @@ IsFontInfoExisted (
         if (GlobalFontInfo != NULL) {
           *GlobalFontInfo = GlobalFont;
         }
+        Private->LastFontInfo = GlobalFont;
         return TRUE;
       }
     } else {
@@ -126,6 +126,20 @@ typedef struct {
 //
 // String Package definitions
 //
+#define HII_STRING_INDEX_MAX_DUPLICATE  16
+
+//
+// The string index of a string package locates the string block of every
+// string id. It is built on the first lookup and dropped whenever the string
+// blocks are reallocated.
+//
+typedef struct _HII_STRING_INDEX_ENTRY {
+  UINT32                                BlockOffset;    // offset of the string block from StringBlock
+  UINT32                                TextOffset;     // offset of the string text from the string block
+  EFI_STRING_ID                         StartStringId;  // first string id of the string block
+  UINT8                                 BlockType;      // EFI_HII_SIBT_END if no block holds the string id
+} HII_STRING_INDEX_ENTRY;
+
 #define HII_STRING_PACKAGE_SIGNATURE    SIGNATURE_32 ('h','i','s','p')
 typedef struct _HII_STRING_PACKAGE_INSTANCE {
   UINTN                                 Signature;
@@ -135,6 +149,8 @@ typedef struct _HII_STRING_PACKAGE_INSTANCE {
   LIST_ENTRY                            FontInfoList;  // local font info list
   UINT8                                 FontId;
   EFI_STRING_ID                         MaxStringId;   // record StringId
+  HII_STRING_INDEX_ENTRY                *StringIndex;  // indexed by string id
+  UINTN                                 StringIndexCount;
 } HII_STRING_PACKAGE_INSTANCE;
 
 //
@@ -161,6 +177,22 @@ typedef struct _HII_SIMPLE_FONT_PACKAGE_INSTANCE {
 //
 // Font Package definitions
 //
+
+//
+// A glyph index maps a character to its glyph in two levels. The high byte of
+// the character selects a page of HII_GLYPH_INDEX_PAGE_SIZE entries, which is
+// only allocated when the font has a glyph in that range.
+//
+#define HII_GLYPH_INDEX_PAGE_NUM        256
+#define HII_GLYPH_INDEX_PAGE_SIZE       256
+#define HII_GLYPH_INDEX_MAX_DUPLICATE   16
+
+typedef struct _HII_GLYPH_INDEX_ENTRY {
+  UINT8                                 *Glyph;     // bitmap in the glyph blocks, or EFI_NARROW_GLYPH/EFI_WIDE_GLYPH of a simple font
+  EFI_HII_GLYPH_INFO                    Cell;
+  CHAR16                                Duplicate;  // if not 0, the character whose glyph is used
+} HII_GLYPH_INDEX_ENTRY;
+
 #define HII_FONT_PACKAGE_SIGNATURE      SIGNATURE_32 ('h','i','f','p')
 typedef struct _HII_FONT_PACKAGE_INSTANCE {
   UINTN                                 Signature;
@@ -170,6 +202,7 @@ typedef struct _HII_FONT_PACKAGE_INSTANCE {
   UINT8                                 *GlyphBlock;
   LIST_ENTRY                            FontEntry;
   LIST_ENTRY                            GlyphInfoList;
+  HII_GLYPH_INDEX_ENTRY                 *GlyphIndex[HII_GLYPH_INDEX_PAGE_NUM];
 } HII_FONT_PACKAGE_INSTANCE;
 
 #define HII_GLYPH_INFO_SIGNATURE        SIGNATURE_32 ('h','g','i','s')
@@ -235,6 +268,20 @@ typedef struct _HII_GUID_PACKAGE_INSTANCE {
 // A package list can contain only one or less than one device path package.
 // This rule also applies to image package since ImageId can not be duplicate.
 //
+//
+// What ConfigRouting got from the IFR of a package list. It is dropped whenever
+// a form package of the package list is added or removed.
+//
+typedef struct _HII_CONFIG_ROUTING_CACHE {
+  UINT8                                 *FormPackage;        // form packages exported from the package list
+  UINTN                                 FormPackageSize;
+  BOOLEAN                               FullStringValid;     // the fields below are valid
+  EFI_STRING                            Request;             // request parsed last, NULL for the first varstore
+  EFI_DEVICE_PATH_PROTOCOL              *DevicePath;         // device path of the request parsed last
+  EFI_STRING                            FullRequest;         // request completed from the IFR
+  EFI_STRING                            DefaultAltCfgResp;   // default values from the IFR
+} HII_CONFIG_ROUTING_CACHE;
+
 typedef struct _HII_DATABASE_PACKAGE_LIST_INSTANCE {
   EFI_HII_PACKAGE_LIST_HEADER           PackageListHdr;
   LIST_ENTRY                            GuidPkgHdr;
@@ -245,6 +292,7 @@ typedef struct _HII_DATABASE_PACKAGE_LIST_INSTANCE {
   HII_IMAGE_PACKAGE_INSTANCE            *ImagePkg;
   LIST_ENTRY                            SimpleFontPkgHdr;
   UINT8                                 *DevicePathPkg;
+  HII_CONFIG_ROUTING_CACHE              ConfigRoutingCache;
 } HII_DATABASE_PACKAGE_LIST_INSTANCE;
 
 #define HII_HANDLE_SIGNATURE            SIGNATURE_32 ('h','i','h','l')
@@ -294,6 +342,9 @@ typedef struct _HII_DATABASE_PRIVATE_DATA {
   UINTN                                 Attribute;     // default system color
   EFI_GUID                              CurrentLayoutGuid;
   EFI_HII_KEYBOARD_LAYOUT               *CurrentLayout;
+  BOOLEAN                               SimpleGlyphIndexValid;
+  HII_GLYPH_INDEX_ENTRY                 *SimpleGlyphIndex[HII_GLYPH_INDEX_PAGE_NUM];  // glyphs of all simple fonts
+  HII_GLOBAL_FONT_INFO                  *LastFontInfo;  // last global font info matched exactly
 } HII_DATABASE_PRIVATE_DATA;
 
 #define HII_FONT_DATABASE_PRIVATE_DATA_FROM_THIS(a) \
@@ -429,6 +480,19 @@ GetSystemFont (
   );
 
 
+/**
+  Free the string index of a string package. It must be called whenever the
+  string blocks of the package are reallocated.
+
+  @param  StringPackage           Hii string package instance.
+
+**/
+VOID
+FreeStringIndex (
+  IN OUT HII_STRING_PACKAGE_INSTANCE  *StringPackage
+  );
+
+
 /**
   Parse all string blocks to find a String block specified by StringId.
   If StringId = (EFI_STRING_ID) (-1), find out all EFI_HII_SIBT_FONT blocks
@@ -469,9 +533,10 @@ FindStringBlock (
 
 
 /**
-  Parse all glyph blocks to find a glyph block specified by CharValue.
-  If CharValue = (CHAR16) (-1), collect all default character cell information
-  within this font package and backup its information.
+  Look up the glyph block specified by CharValue in the glyph index of the font
+  package. If CharValue = (CHAR16) (-1), parse all glyph blocks to collect all
+  default character cell information within this font package, backup its
+  information and build the glyph index.
 
   @param  FontPackage             Hii string package instance.
   @param  CharValue               Unicode character value, which identifies a glyph
@@ -498,6 +563,18 @@ FindGlyphBlock (
   OUT UINTN                          *GlyphBufferLen OPTIONAL
   );
 
+
+/**
+  Free all the pages of a glyph index.
+
+  @param  GlyphIndex              The glyph index to free.
+
+**/
+VOID
+FreeGlyphIndex (
+  IN OUT HII_GLYPH_INDEX_ENTRY       **GlyphIndex
+  );
+
 /**
   This function exports Form packages to a buffer.
   This is a internal function.
@@ -526,6 +603,18 @@ ExportFormPackages (
   IN OUT UINTN                          *ResultSize
   );
 
+/**
+  Free what ConfigRouting cached from the form packages of a package list.
+  This is a internal function.
+
+  @param  PackageList            Pointer to a package list.
+
+**/
+VOID
+FreeConfigRoutingCache (
+  IN OUT HII_DATABASE_PACKAGE_LIST_INSTANCE *PackageList
+  );
+
 //
 // EFI_HII_FONT_PROTOCOL protocol interfaces
 //
@@ -232,6 +232,288 @@ GetStringFontInfo (
 }
 
 
+/**
+  Free the string index of a string package. It must be called whenever the
+  string blocks of the package are reallocated.
+
+  @param  StringPackage           Hii string package instance.
+
+**/
+VOID
+FreeStringIndex (
+  IN OUT HII_STRING_PACKAGE_INSTANCE  *StringPackage
+  )
+{
+  if (StringPackage->StringIndex != NULL) {
+    FreePool (StringPackage->StringIndex);
+    StringPackage->StringIndex = NULL;
+  }
+  StringPackage->StringIndexCount = 0;
+}
+
+
+/**
+  Record in the string index the string block of a range of string ids.
+
+  This is a internal function.
+
+  @param  StringPackage           Hii string package instance.
+  @param  StartStringId           The first string id of the string block.
+  @param  Count                   The number of string ids in the string block.
+  @param  BlockHdr                The string block.
+  @param  TextOffset              Offset of the string text of the first string id,
+                                  relative to the string block, or 0 if the block
+                                  holds no string text.
+
+**/
+VOID
+AddStringIndexEntries (
+  IN OUT HII_STRING_PACKAGE_INSTANCE  *StringPackage,
+  IN     EFI_STRING_ID                StartStringId,
+  IN     UINTN                        Count,
+  IN     UINT8                        *BlockHdr,
+  IN     UINTN                        TextOffset
+  )
+{
+  HII_STRING_INDEX_ENTRY              *Entry;
+  UINTN                               StringId;
+  UINTN                               StringSize;
+
+  for (StringId = StartStringId;
+       StringId < StartStringId + Count && StringId < StringPackage->StringIndexCount;
+       StringId++
+      ) {
+    Entry                = &StringPackage->StringIndex[StringId];
+    Entry->BlockOffset   = (UINT32) (BlockHdr - StringPackage->StringBlock);
+    Entry->TextOffset    = (UINT32) TextOffset;
+    Entry->StartStringId = StartStringId;
+    Entry->BlockType     = *BlockHdr;
+
+    //
+    // Move to the string text of the next string id of a STRINGS block.
+    //
+    switch (*BlockHdr) {
+    case EFI_HII_SIBT_STRINGS_SCSU:
+    case EFI_HII_SIBT_STRINGS_SCSU_FONT:
+      TextOffset += AsciiStrSize ((CHAR8 *) (BlockHdr + TextOffset));
+      break;
+    case EFI_HII_SIBT_STRINGS_UCS2:
+    case EFI_HII_SIBT_STRINGS_UCS2_FONT:
+      GetUnicodeStringTextOrSize (NULL, BlockHdr + TextOffset, &StringSize);
+      TextOffset += StringSize;
+      break;
+    default:
+      break;
+    }
+  }
+}
+
+
+/**
+  Parse all string blocks of a string package to build its string index.
+
+  This is a internal function.
+
+  @param  StringPackage           Hii string package instance.
+
+  @retval EFI_SUCCESS             The string index is built.
+  @retval EFI_UNSUPPORTED         The string blocks contain an unknown block.
+  @retval EFI_OUT_OF_RESOURCES    The system is out of resources to accomplish the
+                                  task.
+
+**/
+EFI_STATUS
+BuildStringIndex (
+  IN OUT HII_STRING_PACKAGE_INSTANCE  *StringPackage
+  )
+{
+  UINT8                                *BlockHdr;
+  EFI_STRING_ID                        CurrentStringId;
+  UINTN                                BlockSize;
+  UINTN                                Index;
+  UINTN                                TextOffset;
+  UINTN                                StringSize;
+  UINT16                               StringCount;
+  UINT16                               SkipCount;
+  UINT8                                Length8;
+  EFI_HII_SIBT_EXT2_BLOCK              Ext2;
+  UINT32                               Length32;
+
+  FreeStringIndex (StringPackage);
+  StringPackage->StringIndex = (HII_STRING_INDEX_ENTRY *) AllocateZeroPool (
+                                                            (StringPackage->MaxStringId + 1) * sizeof (HII_STRING_INDEX_ENTRY)
+                                                            );
+  if (StringPackage->StringIndex == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  StringPackage->StringIndexCount = StringPackage->MaxStringId + 1;
+
+  BlockHdr        = StringPackage->StringBlock;
+  CurrentStringId = 1;
+  while (*BlockHdr != EFI_HII_SIBT_END) {
+    switch (*BlockHdr) {
+    case EFI_HII_SIBT_STRING_SCSU:
+    case EFI_HII_SIBT_STRING_SCSU_FONT:
+      if (*BlockHdr == EFI_HII_SIBT_STRING_SCSU) {
+        TextOffset = sizeof (EFI_HII_STRING_BLOCK);
+      } else {
+        TextOffset = sizeof (EFI_HII_SIBT_STRING_SCSU_FONT_BLOCK) - sizeof (UINT8);
+      }
+      AddStringIndexEntries (StringPackage, CurrentStringId, 1, BlockHdr, TextOffset);
+      BlockSize = TextOffset + AsciiStrSize ((CHAR8 *) (BlockHdr + TextOffset));
+      CurrentStringId++;
+      break;
+
+    case EFI_HII_SIBT_STRINGS_SCSU:
+    case EFI_HII_SIBT_STRINGS_SCSU_FONT:
+      if (*BlockHdr == EFI_HII_SIBT_STRINGS_SCSU) {
+        CopyMem (&StringCount, BlockHdr + sizeof (EFI_HII_STRING_BLOCK), sizeof (UINT16));
+        TextOffset = sizeof (EFI_HII_SIBT_STRINGS_SCSU_BLOCK) - sizeof (UINT8);
+      } else {
+        CopyMem (&StringCount, BlockHdr + sizeof (EFI_HII_STRING_BLOCK) + sizeof (UINT8), sizeof (UINT16));
+        TextOffset = sizeof (EFI_HII_SIBT_STRINGS_SCSU_FONT_BLOCK) - sizeof (UINT8);
+      }
+      AddStringIndexEntries (StringPackage, CurrentStringId, StringCount, BlockHdr, TextOffset);
+      BlockSize = TextOffset;
+      for (Index = 0; Index < StringCount; Index++) {
+        BlockSize += AsciiStrSize ((CHAR8 *) (BlockHdr + BlockSize));
+      }
+      CurrentStringId = (EFI_STRING_ID) (CurrentStringId + StringCount);
+      break;
+
+    case EFI_HII_SIBT_STRING_UCS2:
+    case EFI_HII_SIBT_STRING_UCS2_FONT:
+      if (*BlockHdr == EFI_HII_SIBT_STRING_UCS2) {
+        TextOffset = sizeof (EFI_HII_STRING_BLOCK);
+      } else {
+        TextOffset = sizeof (EFI_HII_SIBT_STRING_UCS2_FONT_BLOCK) - sizeof (CHAR16);
+      }
+      AddStringIndexEntries (StringPackage, CurrentStringId, 1, BlockHdr, TextOffset);
+      GetUnicodeStringTextOrSize (NULL, BlockHdr + TextOffset, &StringSize);
+      BlockSize = TextOffset + StringSize;
+      CurrentStringId++;
+      break;
+
+    case EFI_HII_SIBT_STRINGS_UCS2:
+    case EFI_HII_SIBT_STRINGS_UCS2_FONT:
+      if (*BlockHdr == EFI_HII_SIBT_STRINGS_UCS2) {
+        CopyMem (&StringCount, BlockHdr + sizeof (EFI_HII_STRING_BLOCK), sizeof (UINT16));
+        TextOffset = sizeof (EFI_HII_SIBT_STRINGS_UCS2_BLOCK) - sizeof (CHAR16);
+      } else {
+        CopyMem (&StringCount, BlockHdr + sizeof (EFI_HII_STRING_BLOCK) + sizeof (UINT8), sizeof (UINT16));
+        TextOffset = sizeof (EFI_HII_SIBT_STRINGS_UCS2_FONT_BLOCK) - sizeof (CHAR16);
+      }
+      AddStringIndexEntries (StringPackage, CurrentStringId, StringCount, BlockHdr, TextOffset);
+      BlockSize = TextOffset;
+      for (Index = 0; Index < StringCount; Index++) {
+        GetUnicodeStringTextOrSize (NULL, BlockHdr + BlockSize, &StringSize);
+        BlockSize += StringSize;
+      }
+      CurrentStringId = (EFI_STRING_ID) (CurrentStringId + StringCount);
+      break;
+
+    case EFI_HII_SIBT_DUPLICATE:
+      AddStringIndexEntries (StringPackage, CurrentStringId, 1, BlockHdr, 0);
+      BlockSize = sizeof (EFI_HII_SIBT_DUPLICATE_BLOCK);
+      CurrentStringId++;
+      break;
+
+    case EFI_HII_SIBT_SKIP1:
+    case EFI_HII_SIBT_SKIP2:
+      if (*BlockHdr == EFI_HII_SIBT_SKIP1) {
+        SkipCount = (UINT16) (*(BlockHdr + sizeof (EFI_HII_STRING_BLOCK)));
+        BlockSize = sizeof (EFI_HII_SIBT_SKIP1_BLOCK);
+      } else {
+        CopyMem (&SkipCount, BlockHdr + sizeof (EFI_HII_STRING_BLOCK), sizeof (UINT16));
+        BlockSize = sizeof (EFI_HII_SIBT_SKIP2_BLOCK);
+      }
+      AddStringIndexEntries (StringPackage, CurrentStringId, SkipCount, BlockHdr, 0);
+      CurrentStringId = (EFI_STRING_ID) (CurrentStringId + SkipCount);
+      break;
+
+    case EFI_HII_SIBT_EXT1:
+      CopyMem (&Length8, BlockHdr + sizeof (EFI_HII_STRING_BLOCK) + sizeof (UINT8), sizeof (UINT8));
+      BlockSize = Length8;
+      break;
+
+    case EFI_HII_SIBT_EXT2:
+      CopyMem (&Ext2, BlockHdr, sizeof (EFI_HII_SIBT_EXT2_BLOCK));
+      BlockSize = Ext2.Length;
+      break;
+
+    case EFI_HII_SIBT_EXT4:
+      CopyMem (&Length32, BlockHdr + sizeof (EFI_HII_STRING_BLOCK) + sizeof (UINT8), sizeof (UINT32));
+      BlockSize = Length32;
+      break;
+
+    default:
+      BlockSize = 0;
+      break;
+    }
+
+    if (BlockSize == 0) {
+      FreeStringIndex (StringPackage);
+      return EFI_UNSUPPORTED;
+    }
+    BlockHdr += BlockSize;
+  }
+
+  return EFI_SUCCESS;
+}
+
+
+/**
+  Look up a string id in the string index of a string package, building the
+  index first if the package has none.
+
+  This is a internal function.
+
+  @param  StringPackage           Hii string package instance.
+  @param  StringId                The string's id, which is unique within
+                                  PackageList.
+
+  @return The index entry of the string block holding StringId, after following
+          the duplicate string blocks, or NULL if the string blocks have to be
+          parsed to find it.
+
+**/
+HII_STRING_INDEX_ENTRY *
+GetStringIndexEntry (
+  IN OUT HII_STRING_PACKAGE_INSTANCE  *StringPackage,
+  IN     EFI_STRING_ID                StringId
+  )
+{
+  HII_STRING_INDEX_ENTRY              *Entry;
+  UINTN                               Index;
+
+  if (StringPackage->StringIndex == NULL) {
+    if (EFI_ERROR (BuildStringIndex (StringPackage))) {
+      return NULL;
+    }
+  }
+
+  for (Index = 0; Index < HII_STRING_INDEX_MAX_DUPLICATE; Index++) {
+    if (StringId >= StringPackage->StringIndexCount) {
+      return NULL;
+    }
+    Entry = &StringPackage->StringIndex[StringId];
+    if (Entry->BlockType == EFI_HII_SIBT_END) {
+      return NULL;
+    }
+    if (Entry->BlockType != EFI_HII_SIBT_DUPLICATE) {
+      return Entry;
+    }
+    CopyMem (
+      &StringId,
+      StringPackage->StringBlock + Entry->BlockOffset + sizeof (EFI_HII_STRING_BLOCK),
+      sizeof (EFI_STRING_ID)
+      );
+  }
+
+  return NULL;
+}
+
+
 /**
   Parse all string blocks to find a String block specified by StringId.
   If StringId = (EFI_STRING_ID) (-1), find out all EFI_HII_SIBT_FONT blocks
@@ -290,6 +572,7 @@ FindStringBlock (
   UINT32                               Length32;
   UINTN                                StringSize;
   CHAR16                               Zero;
+  HII_STRING_INDEX_ENTRY               *Entry;
 
   ASSERT (StringPackage != NULL);
   ASSERT (StringPackage->Signature == HII_STRING_PACKAGE_SIGNATURE);
@@ -301,6 +584,24 @@ FindStringBlock (
     if (StringId > StringPackage->MaxStringId) {
       return EFI_NOT_FOUND;
     }
+
+    //
+    // Use the string index when it knows the string id. A string id in a skip
+    // block is not found, but the skip block is still output for SetString.
+    //
+    Entry = GetStringIndexEntry (StringPackage, StringId);
+    if (Entry != NULL) {
+      *BlockType        = Entry->BlockType;
+      *StringBlockAddr  = StringPackage->StringBlock + Entry->BlockOffset;
+      *StringTextOffset = Entry->TextOffset;
+      if (StartStringId != NULL) {
+        *StartStringId  = Entry->StartStringId;
+      }
+      if (Entry->BlockType == EFI_HII_SIBT_SKIP1 || Entry->BlockType == EFI_HII_SIBT_SKIP2) {
+        return EFI_NOT_FOUND;
+      }
+      return EFI_SUCCESS;
+    }
   } else {
     ASSERT (Private != NULL && Private->Signature == HII_DATABASE_PRIVATE_DATA_SIGNATURE);
     if (StringId == 0 && LastStringId != NULL) {
@@ -845,6 +1146,7 @@ InsertLackStringBlock (
   }
   FreePool (StringPackage->StringBlock);
   StringPackage->StringBlock = StringBlock;
+  FreeStringIndex (StringPackage);
   StringPackage->StringPkgHdr->Header.Length += NewBlockSize - OldBlockSize;
 
   return EFI_SUCCESS;
@@ -1012,6 +1314,7 @@ SetStringWorker (
 
     FreePool (StringPackage->StringBlock);
     StringPackage->StringBlock = Block;
+    FreeStringIndex (StringPackage);
     StringPackage->StringPkgHdr->Header.Length += (UINT32) (BlockSize - OldBlockSize);
     break;
 
@@ -1045,6 +1348,7 @@ SetStringWorker (
 
     FreePool (StringPackage->StringBlock);
     StringPackage->StringBlock = Block;
+    FreeStringIndex (StringPackage);
     StringPackage->StringPkgHdr->Header.Length += (UINT32) (BlockSize - OldBlockSize);
     break;
 
@@ -1096,6 +1400,7 @@ SetStringWorker (
 
   FreePool (StringPackage->StringBlock);
   StringPackage->StringBlock = Block;
+  FreeStringIndex (StringPackage);
   StringPackage->StringPkgHdr->Header.Length += Ext2.Length;
 
   return EFI_SUCCESS;
@@ -1279,6 +1584,7 @@ HiiNewString (
       *BlockPtr = EFI_HII_SIBT_END;
       FreePool (StringPackage->StringBlock);
       StringPackage->StringBlock = StringBlock;
+      FreeStringIndex (StringPackage);
       StringPackage->StringPkgHdr->Header.Length += Ucs2BlockSize;
       PackageListNode->PackageListHdr.PackageLength += Ucs2BlockSize;
     }
@@ -1410,6 +1716,7 @@ HiiNewString (
     *BlockPtr = EFI_HII_SIBT_END;
     FreePool (StringPackage->StringBlock);
     StringPackage->StringBlock = StringBlock;
+    FreeStringIndex (StringPackage);
     StringPackage->StringPkgHdr->Header.Length += Ucs2BlockSize;
     PackageListNode->PackageListHdr.PackageLength += Ucs2BlockSize;
 
@@ -1452,6 +1759,7 @@ HiiNewString (
       *BlockPtr = EFI_HII_SIBT_END;
       FreePool (StringPackage->StringBlock);
       StringPackage->StringBlock = StringBlock;
+      FreeStringIndex (StringPackage);
       StringPackage->StringPkgHdr->Header.Length += Ucs2FontBlockSize;
       PackageListNode->PackageListHdr.PackageLength += Ucs2FontBlockSize;
 
@@ -1513,6 +1821,7 @@ HiiNewString (
       *BlockPtr = EFI_HII_SIBT_END;
       FreePool (StringPackage->StringBlock);
       StringPackage->StringBlock = StringBlock;
+      FreeStringIndex (StringPackage);
       StringPackage->StringPkgHdr->Header.Length += FontBlockSize + Ucs2FontBlockSize;
       PackageListNode->PackageListHdr.PackageLength += FontBlockSize + Ucs2FontBlockSize;
 
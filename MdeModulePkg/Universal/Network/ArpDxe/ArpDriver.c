@@ -49,6 +49,7 @@ ArpCreateService (
   )
 {
   EFI_STATUS  Status;
+  UINTN       Index;
 
   ASSERT (ArpService != NULL);
 
@@ -62,6 +63,14 @@ ArpCreateService (
   InitializeListHead (&ArpService->DeniedCacheTable);
   InitializeListHead (&ArpService->ResolvedCacheTable);
 
+  for (Index = 0; Index < ARP_CACHE_HASH_SIZE; Index++) {
+    InitializeListHead (&ArpService->CacheHash[Index]);
+  }
+
+  for (Index = 0; Index < ARP_TIMER_WHEEL_SIZE; Index++) {
+    InitializeListHead (&ArpService->TimerWheel[Index]);
+  }
+
   //
   // Init the servicebinding protocol members.
   //
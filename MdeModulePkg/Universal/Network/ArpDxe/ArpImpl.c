@@ -206,9 +206,9 @@ ArpOnFrameRcvdDpc (
   // Check whether the sender's address information is already in the cache.
   //
   MergeFlag  = FALSE;
-  CacheEntry = ArpFindNextCacheEntryInTable (
+  CacheEntry = ArpFindCacheEntryInHash (
+                 ArpService,
                  &ArpService->ResolvedCacheTable,
-                 NULL,
                  ByProtoAddress,
                  &SenderAddress[Protocol],
                  NULL
@@ -218,7 +218,7 @@ ArpOnFrameRcvdDpc (
     // Update the entry with the new information.
     //
     ArpFillAddressInCacheEntry (CacheEntry, &SenderAddress[Hardware], NULL);
-    CacheEntry->DecayTime = CacheEntry->DefaultDecayTime;
+    ArpRefreshCacheEntry (ArpService, CacheEntry);
     MergeFlag = TRUE;
   }
 
@@ -234,9 +234,9 @@ ArpOnFrameRcvdDpc (
     // Add the triplet <protocol type, sender protocol address, sender hardware address>
     // to the translation table.
     //
-    CacheEntry = ArpFindNextCacheEntryInTable (
+    CacheEntry = ArpFindCacheEntryInHash (
+                   ArpService,
                    &ArpService->PendingRequestTable,
-                   NULL,
                    ByProtoAddress,
                    &SenderAddress[Protocol],
                    NULL
@@ -251,9 +251,7 @@ ArpOnFrameRcvdDpc (
       }
     }
 
-    if (!IsListEmpty (&CacheEntry->List)) {
-      RemoveEntryList (&CacheEntry->List);
-    }
+    ArpRemoveCacheEntry (CacheEntry);
 
     //
     // Fill the addresses into the CacheEntry.
@@ -272,7 +270,7 @@ ArpOnFrameRcvdDpc (
     //
     // Add this entry into the ResolvedCacheTable
     //
-    InsertHeadList (&ArpService->ResolvedCacheTable, &CacheEntry->List);
+    ArpInsertCacheEntry (ArpService, &ArpService->ResolvedCacheTable, CacheEntry);
   }
 
   if (Head->OpCode == ARP_OPCODE_REQUEST) {
@@ -413,6 +411,7 @@ ArpTimerHandler (
   LIST_ENTRY            *ContextEntry;
   ARP_CACHE_ENTRY       *CacheEntry;
   USER_REQUEST_CONTEXT  *RequestContext;
+  UINT32                Slot;
 
   ASSERT (Context != NULL);
   ArpService = (ARP_SERVICE_DATA *)Context;
@@ -436,7 +435,7 @@ ArpTimerHandler (
         ArpAddressResolved (CacheEntry, NULL, NULL);
         ASSERT (IsListEmpty (&CacheEntry->UserRequestList));
 
-        RemoveEntryList (&CacheEntry->List);
+        ArpRemoveCacheEntry (CacheEntry);
         FreePool (CacheEntry);
       } else {
         //
@@ -461,60 +460,167 @@ ArpTimerHandler (
   }
 
   //
-  // Check the timeouts for the DeniedCacheTable.
+  // Check the timeouts of the DeniedCacheTable and ResolvedCacheTable entries
+  // in the current slot of the timing wheel. The static entries are never in
+  // the wheel.
   //
-  NET_LIST_FOR_EACH_SAFE (Entry, NextEntry, &ArpService->DeniedCacheTable) {
-    CacheEntry = NET_LIST_USER_STRUCT (Entry, ARP_CACHE_ENTRY, List);
-    ASSERT (IsListEmpty (&CacheEntry->UserRequestList));
+  ArpService->TimerTick++;
+  Slot = ArpService->TimerTick % ARP_TIMER_WHEEL_SIZE;
 
-    if (CacheEntry->DefaultDecayTime == 0) {
-      //
-      // It's a static entry, skip it.
-      //
-      continue;
-    }
+  NET_LIST_FOR_EACH_SAFE (Entry, NextEntry, &ArpService->TimerWheel[Slot]) {
+    CacheEntry = NET_LIST_USER_STRUCT (Entry, ARP_CACHE_ENTRY, TimerLink);
+    ASSERT (IsListEmpty (&CacheEntry->UserRequestList));
 
-    if (CacheEntry->DecayTime <= ARP_PERIODIC_TIMER_INTERVAL) {
+    if ((INT32) (CacheEntry->ExpireTick - ArpService->TimerTick) <= 0) {
       //
       // Time out, remove it.
       //
-      RemoveEntryList (&CacheEntry->List);
+      ArpRemoveCacheEntry (CacheEntry);
       FreePool (CacheEntry);
-    } else {
+    } else if (CacheEntry->ExpireTick % ARP_TIMER_WHEEL_SIZE != Slot) {
       //
-      // Update the DecayTime.
+      // The entry is refreshed since it was put in this slot, move it
+      // to the slot of its new expire tick.
       //
-      CacheEntry->DecayTime -= ARP_PERIODIC_TIMER_INTERVAL;
+      RemoveEntryList (&CacheEntry->TimerLink);
+      InsertTailList (
+        &ArpService->TimerWheel[CacheEntry->ExpireTick % ARP_TIMER_WHEEL_SIZE],
+        &CacheEntry->TimerLink
+        );
     }
   }
+}
 
-  //
-  // Check the timeouts for the ResolvedCacheTable.
-  //
-  NET_LIST_FOR_EACH_SAFE (Entry, NextEntry, &ArpService->ResolvedCacheTable) {
-    CacheEntry = NET_LIST_USER_STRUCT (Entry, ARP_CACHE_ENTRY, List);
-    ASSERT (IsListEmpty (&CacheEntry->UserRequestList));
 
-    if (CacheEntry->DefaultDecayTime == 0) {
-      //
-      // It's a static entry, skip it.
-      //
-      continue;
-    }
+/**
+  Hash the protocol address to the index of the cache entry hash table.
 
-    if (CacheEntry->DecayTime <= ARP_PERIODIC_TIMER_INTERVAL) {
-      //
-      // Time out, remove it.
-      //
-      RemoveEntryList (&CacheEntry->List);
-      FreePool (CacheEntry);
-    } else {
-      //
-      // Update the DecayTime.
-      //
-      CacheEntry->DecayTime -= ARP_PERIODIC_TIMER_INTERVAL;
-    }
+  @param[in]  ProtocolAddress        Pointer to the protocol address.
+
+  @return The index of the hash bucket.
+
+**/
+UINT32
+ArpHashAddress (
+  IN NET_ARP_ADDRESS  *ProtocolAddress
+  )
+{
+  UINT32  Hash;
+  UINT8   Index;
+
+  Hash = 0;
+  for (Index = 0; Index < ProtocolAddress->Length; Index++) {
+    Hash = Hash * 31 + ProtocolAddress->AddressPtr[Index];
+  }
+
+  return Hash % ARP_CACHE_HASH_SIZE;
+}
+
+
+/**
+  Insert the CacheEntry into the CacheTable, the hash index and, if it is
+  aged, the timing wheel.
+
+  @param[in]  ArpService             Pointer to the arp service context data.
+  @param[in]  CacheTable             Pointer to the arp cache table.
+  @param[in]  CacheEntry             Pointer to the cache entry to insert.
+
+  @return None.
+
+**/
+VOID
+ArpInsertCacheEntry (
+  IN ARP_SERVICE_DATA  *ArpService,
+  IN LIST_ENTRY        *CacheTable,
+  IN ARP_CACHE_ENTRY   *CacheEntry
+  )
+{
+  ASSERT (CacheEntry->CacheTable == NULL);
+
+  CacheEntry->CacheTable = CacheTable;
+
+  if (CacheTable == &ArpService->PendingRequestTable) {
+    //
+    // The pending requests are aged by their retries in ArpTimerHandler.
+    //
+    InsertTailList (CacheTable, &CacheEntry->List);
+  } else {
+    InsertHeadList (CacheTable, &CacheEntry->List);
+  }
+
+  InsertHeadList (
+    &ArpService->CacheHash[ArpHashAddress (&CacheEntry->Addresses[Protocol])],
+    &CacheEntry->HashLink
+    );
+
+  if ((CacheTable != &ArpService->PendingRequestTable) && (CacheEntry->DefaultDecayTime != 0)) {
+    ArpRefreshCacheEntry (ArpService, CacheEntry);
+    InsertTailList (
+      &ArpService->TimerWheel[CacheEntry->ExpireTick % ARP_TIMER_WHEEL_SIZE],
+      &CacheEntry->TimerLink
+      );
+  }
+}
+
+
+/**
+  Remove the CacheEntry from its cache table, the hash index and the timing wheel.
+
+  @param[in]  CacheEntry             Pointer to the cache entry to remove.
+
+  @return None.
+
+**/
+VOID
+ArpRemoveCacheEntry (
+  IN ARP_CACHE_ENTRY   *CacheEntry
+  )
+{
+  if (CacheEntry->CacheTable == NULL) {
+    return;
+  }
+
+  RemoveEntryList (&CacheEntry->List);
+  RemoveEntryList (&CacheEntry->HashLink);
+  InitializeListHead (&CacheEntry->List);
+  InitializeListHead (&CacheEntry->HashLink);
+
+  if (!IsListEmpty (&CacheEntry->TimerLink)) {
+    RemoveEntryList (&CacheEntry->TimerLink);
+    InitializeListHead (&CacheEntry->TimerLink);
   }
+
+  CacheEntry->CacheTable = NULL;
+}
+
+
+/**
+  Restart the aging of the CacheEntry from its DefaultDecayTime.
+
+  The entry is not moved in the timing wheel here, ArpTimerHandler moves it
+  when the slot it is in comes around before it expires.
+
+  @param[in]  ArpService             Pointer to the arp service context data.
+  @param[in]  CacheEntry             Pointer to the cache entry to refresh.
+
+  @return None.
+
+**/
+VOID
+ArpRefreshCacheEntry (
+  IN ARP_SERVICE_DATA  *ArpService,
+  IN ARP_CACHE_ENTRY   *CacheEntry
+  )
+{
+  if (CacheEntry->DefaultDecayTime == 0) {
+    //
+    // It's a static entry.
+    //
+    return;
+  }
+
+  CacheEntry->ExpireTick = ArpService->TimerTick +
+                           (CacheEntry->DefaultDecayTime - 1) / ARP_PERIODIC_TIMER_INTERVAL + 1;
 }
 
 
@@ -631,6 +737,66 @@ ArpFindNextCacheEntryInTable (
 }
 
 
+/**
+  Find the CacheEntry in the specified CacheTable by the protocol address, using
+  the hash index of the cache entries.
+
+  @param[in]  ArpService             Pointer to the arp service context data.
+  @param[in]  CacheTable             Pointer to the arp cache table.
+  @param[in]  FindOpType             The search type, it must include MATCH_SW_ADDRESS.
+  @param[in]  ProtocolAddress        Pointer to the protocol address to match.
+  @param[in]  HardwareAddress        Pointer to the hardware address to match.
+
+  @return Pointer to the matched arp cache entry, if NULL, no match is found.
+
+**/
+ARP_CACHE_ENTRY *
+ArpFindCacheEntryInHash (
+  IN ARP_SERVICE_DATA  *ArpService,
+  IN LIST_ENTRY        *CacheTable,
+  IN FIND_OPTYPE       FindOpType,
+  IN NET_ARP_ADDRESS   *ProtocolAddress,
+  IN NET_ARP_ADDRESS   *HardwareAddress OPTIONAL
+  )
+{
+  LIST_ENTRY       *Entry;
+  ARP_CACHE_ENTRY  *CacheEntry;
+
+  ASSERT ((FindOpType & MATCH_SW_ADDRESS) != 0);
+
+  if (ProtocolAddress->AddressPtr == NULL) {
+    //
+    // Any protocol address matches, the hash index doesn't help.
+    //
+    return ArpFindNextCacheEntryInTable (
+             CacheTable,
+             NULL,
+             FindOpType,
+             ProtocolAddress,
+             HardwareAddress
+             );
+  }
+
+  NET_LIST_FOR_EACH (Entry, &ArpService->CacheHash[ArpHashAddress (ProtocolAddress)]) {
+    CacheEntry = NET_LIST_USER_STRUCT (Entry, ARP_CACHE_ENTRY, HashLink);
+
+    if ((CacheEntry->CacheTable != CacheTable) ||
+      !ArpMatchAddress (ProtocolAddress, &CacheEntry->Addresses[Protocol])) {
+      continue;
+    }
+
+    if (((FindOpType & MATCH_HW_ADDRESS) != 0) &&
+      !ArpMatchAddress (HardwareAddress, &CacheEntry->Addresses[Hardware])) {
+      continue;
+    }
+
+    return CacheEntry;
+  }
+
+  return NULL;
+}
+
+
 /**
   Find the CacheEntry, using ProtocolAddress or HardwareAddress or both, as the keyword,
   in the DeniedCacheTable.
@@ -660,9 +826,9 @@ ArpFindDeniedCacheEntry (
     //
     // Find the cache entry in the DeniedCacheTable by the protocol address.
     //
-    CacheEntry = ArpFindNextCacheEntryInTable (
+    CacheEntry = ArpFindCacheEntryInHash (
+                   ArpService,
                    &ArpService->DeniedCacheTable,
-                   NULL,
                    ByProtoAddress,
                    ProtocolAddress,
                    NULL
@@ -721,8 +887,13 @@ ArpAllocCacheEntry (
   // Init the lists.
   //
   InitializeListHead (&CacheEntry->List);
+  InitializeListHead (&CacheEntry->HashLink);
+  InitializeListHead (&CacheEntry->TimerLink);
   InitializeListHead (&CacheEntry->UserRequestList);
 
+  CacheEntry->CacheTable = NULL;
+  CacheEntry->ExpireTick = 0;
+
   for (Index = 0; Index < 2; Index++) {
     //
     // Init the address pointers to point to the concrete buffer.
@@ -743,7 +914,6 @@ ArpAllocCacheEntry (
     CacheEntry->RetryCount       = Instance->ConfigData.RetryCount;
     CacheEntry->NextRetryTime    = Instance->ConfigData.RetryTimeOut;
     CacheEntry->DefaultDecayTime = Instance->ConfigData.EntryTimeOut;
-    CacheEntry->DecayTime        = Instance->ConfigData.EntryTimeOut;
   } else {
     //
     // Use the default parameters if this cache entry isn't allocate in a
@@ -752,7 +922,6 @@ ArpAllocCacheEntry (
     CacheEntry->RetryCount       = ARP_DEFAULT_RETRY_COUNT;
     CacheEntry->NextRetryTime    = ARP_DEFAULT_RETRY_INTERVAL;
     CacheEntry->DefaultDecayTime = ARP_DEFAULT_TIMEOUT_VALUE;
-    CacheEntry->DecayTime        = ARP_DEFAULT_TIMEOUT_VALUE;
   }
 
   return CacheEntry;
@@ -1286,7 +1455,7 @@ MATCHED:
     //
     // Delete this entry.
     //
-    RemoveEntryList (&CacheEntry->List);
+    ArpRemoveCacheEntry (CacheEntry);
     ASSERT (IsListEmpty (&CacheEntry->UserRequestList));
     FreePool (CacheEntry);
 
@@ -1400,7 +1569,7 @@ ArpCancelRequest (
         //
         // No user requests any more, remove this request cache entry.
         //
-        RemoveEntryList (&CacheEntry->List);
+        ArpRemoveCacheEntry (CacheEntry);
         FreePool (CacheEntry);
       }
     }
@@ -1518,7 +1687,7 @@ ArpFindCacheEntry (
       //
       // Refresh the DecayTime if needed.
       //
-      CacheEntry->DecayTime = CacheEntry->DefaultDecayTime;
+      ArpRefreshCacheEntry (ArpService, CacheEntry);
     }
   }
 
@@ -1559,7 +1728,7 @@ ArpFindCacheEntry (
       //
       // Refresh the DecayTime if needed.
       //
-      CacheEntry->DecayTime = CacheEntry->DefaultDecayTime;
+      ArpRefreshCacheEntry (ArpService, CacheEntry);
     }
   }
 
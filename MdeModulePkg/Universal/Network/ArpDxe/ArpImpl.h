@@ -53,6 +53,14 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #define ARP_DEFAULT_RETRY_INTERVAL   (5   * TICKS_PER_MS)
 #define ARP_PERIODIC_TIMER_INTERVAL  (500 * TICKS_PER_MS)
 
+//
+// All the cache entries are indexed by their protocol address in a hash table.
+// The resolved and denied entries are aged by a timing wheel, one slot of which
+// is visited by each periodic timer.
+//
+#define ARP_CACHE_HASH_SIZE          128
+#define ARP_TIMER_WHEEL_SIZE         64
+
 //
 // ARP packet head definition.
 //
@@ -170,6 +178,10 @@ struct _ARP_SERVICE_DATA {
   LIST_ENTRY                       DeniedCacheTable;
   LIST_ENTRY                       ResolvedCacheTable;
 
+  LIST_ENTRY                       CacheHash[ARP_CACHE_HASH_SIZE];
+  LIST_ENTRY                       TimerWheel[ARP_TIMER_WHEEL_SIZE];
+  UINT32                           TimerTick;
+
   EFI_EVENT                        PeriodicTimer;
 };
 
@@ -214,10 +226,13 @@ typedef enum {
 //
 typedef struct {
   LIST_ENTRY      List;
+  LIST_ENTRY      HashLink;
+  LIST_ENTRY      TimerLink;
+  LIST_ENTRY      *CacheTable;
 
   UINT32          RetryCount;
   UINT32          DefaultDecayTime;
-  UINT32          DecayTime;
+  UINT32          ExpireTick;
   UINT32          NextRetryTime;
 
   NET_ARP_ADDRESS  Addresses[2];
@@ -535,6 +550,74 @@ ArpFindNextCacheEntryInTable (
   IN NET_ARP_ADDRESS   *HardwareAddress OPTIONAL
   );
 
+/**
+  Find the CacheEntry in the specified CacheTable by the protocol address, using
+  the hash index of the cache entries.
+
+  @param[in]  ArpService             Pointer to the arp service context data.
+  @param[in]  CacheTable             Pointer to the arp cache table.
+  @param[in]  FindOpType             The search type, it must include MATCH_SW_ADDRESS.
+  @param[in]  ProtocolAddress        Pointer to the protocol address to match.
+  @param[in]  HardwareAddress        Pointer to the hardware address to match.
+
+  @return Pointer to the matched arp cache entry, if NULL, no match is found.
+
+**/
+ARP_CACHE_ENTRY *
+ArpFindCacheEntryInHash (
+  IN ARP_SERVICE_DATA  *ArpService,
+  IN LIST_ENTRY        *CacheTable,
+  IN FIND_OPTYPE       FindOpType,
+  IN NET_ARP_ADDRESS   *ProtocolAddress,
+  IN NET_ARP_ADDRESS   *HardwareAddress OPTIONAL
+  );
+
+/**
+  Insert the CacheEntry into the CacheTable, the hash index and, if it is
+  aged, the timing wheel.
+
+  @param[in]  ArpService             Pointer to the arp service context data.
+  @param[in]  CacheTable             Pointer to the arp cache table.
+  @param[in]  CacheEntry             Pointer to the cache entry to insert.
+
+  @return None.
+
+**/
+VOID
+ArpInsertCacheEntry (
+  IN ARP_SERVICE_DATA  *ArpService,
+  IN LIST_ENTRY        *CacheTable,
+  IN ARP_CACHE_ENTRY   *CacheEntry
+  );
+
+/**
+  Remove the CacheEntry from its cache table, the hash index and the timing wheel.
+
+  @param[in]  CacheEntry             Pointer to the cache entry to remove.
+
+  @return None.
+
+**/
+VOID
+ArpRemoveCacheEntry (
+  IN ARP_CACHE_ENTRY   *CacheEntry
+  );
+
+/**
+  Restart the aging of the CacheEntry from its DefaultDecayTime.
+
+  @param[in]  ArpService             Pointer to the arp service context data.
+  @param[in]  CacheEntry             Pointer to the cache entry to refresh.
+
+  @return None.
+
+**/
+VOID
+ArpRefreshCacheEntry (
+  IN ARP_SERVICE_DATA  *ArpService,
+  IN ARP_CACHE_ENTRY   *CacheEntry
+  );
+
 /**
   Allocate a cache entry and initialize it.
 
@@ -193,9 +193,9 @@ ArpAdd (
     //
     // Check the ResolvedCacheTable
     //
-    CacheEntry = ArpFindNextCacheEntryInTable (
+    CacheEntry = ArpFindCacheEntryInHash (
+                   ArpService,
                    &ArpService->ResolvedCacheTable,
-                   NULL,
                    ByBoth,
                    &MatchAddress[Protocol],
                    &MatchAddress[Hardware]
@@ -214,9 +214,9 @@ ArpAdd (
     //
     // Check whether there are pending requests matching the entry to be added.
     //
-    CacheEntry = ArpFindNextCacheEntryInTable (
+    CacheEntry = ArpFindCacheEntryInHash (
+                   ArpService,
                    &ArpService->PendingRequestTable,
-                   NULL,
                    ByProtoAddress,
                    &MatchAddress[Protocol],
                    NULL
@@ -227,7 +227,7 @@ ArpAdd (
     //
     // Remove it from the Table.
     //
-    RemoveEntryList (&CacheEntry->List);
+    ArpRemoveCacheEntry (CacheEntry);
   } else {
     //
     // It's a new entry, allocate memory for the entry.
@@ -245,7 +245,6 @@ ArpAdd (
   // Overwrite these parameters.
   //
   CacheEntry->DefaultDecayTime = TimeoutValue;
-  CacheEntry->DecayTime        = TimeoutValue;
 
   //
   // Fill in the addresses.
@@ -265,9 +264,9 @@ ArpAdd (
   // Add this CacheEntry to the corresponding CacheTable.
   //
   if (DenyFlag) {
-    InsertHeadList (&ArpService->DeniedCacheTable, &CacheEntry->List);
+    ArpInsertCacheEntry (ArpService, &ArpService->DeniedCacheTable, CacheEntry);
   } else {
-    InsertHeadList (&ArpService->ResolvedCacheTable, &CacheEntry->List);
+    ArpInsertCacheEntry (ArpService, &ArpService->ResolvedCacheTable, CacheEntry);
   }
 
 UNLOCK_EXIT:
@@ -566,9 +565,9 @@ ArpRequest (
   //
   // Check whether the software address is already resolved.
   //
-  CacheEntry = ArpFindNextCacheEntryInTable (
+  CacheEntry = ArpFindCacheEntryInHash (
+                 ArpService,
                  &ArpService->ResolvedCacheTable,
-                 NULL,
                  ByProtoAddress,
                  &ProtocolAddress,
                  NULL
@@ -610,9 +609,9 @@ ArpRequest (
   //
   // Check whether there is a same request.
   //
-  CacheEntry = ArpFindNextCacheEntryInTable (
+  CacheEntry = ArpFindCacheEntryInHash (
+                 ArpService,
                  &ArpService->PendingRequestTable,
-                 NULL,
                  ByProtoAddress,
                  &ProtocolAddress,
                  NULL
@@ -642,7 +641,7 @@ ArpRequest (
     //
     // Add this entry into the PendingRequestTable.
     //
-    InsertTailList (&ArpService->PendingRequestTable, &CacheEntry->List);
+    ArpInsertCacheEntry (ArpService, &ArpService->PendingRequestTable, CacheEntry);
   }
 
   //
@@ -34,16 +34,33 @@ EFI_DPC_PROTOCOL mDpc = {
 };
 
 //
-// Global variables used to meaasure the DPC Queue Depths
+// The EDKII_DPC_STATISTICS_PROTOCOL instance that is installed onto mDpcHandle
 //
-UINTN  mDpcQueueDepth = 0;
-UINTN  mMaxDpcQueueDepth = 0;
+EDKII_DPC_STATISTICS_PROTOCOL mDpcStatisticsProtocol = {
+  DpcGetStatistics,
+  DpcResetStatistics
+};
+
+//
+// Counters of the DPC queue, including the DPC queue depths, and of the DPC
+// procedures that have been invoked.
+//
+EDKII_DPC_STATISTICS            mDpcStatistics;
+EDKII_DPC_PROCEDURE_STATISTICS  mDpcProcedureStatistics[DPC_MAX_PROCEDURE_NUM];
+
+//
+// The start and end values of the performance counter, used to convert the
+// measured DPC times when PcdDpcMeasureTime is TRUE.
+//
+UINT64  mDpcCounterStart = 0;
+UINT64  mDpcCounterEnd   = 0;
 
 //
 // Free list of DPC entries.  As DPCs are queued, entries are removed from this
 // free list.  As DPC entries are dispatched, DPC entries are added to the free list.
-// If the free list is empty and a DPC is queued, the free list is grown by allocating
-// an additional set of DPC entries.
+// PcdDpcEntryNum DPC entries are allocated at once when the driver starts, so
+// that queuing a DPC usually does not allocate memory. If the free list is empty
+// when a DPC is queued, one more entry is allocated.
 //
 LIST_ENTRY      mDpcEntryFreeList = INITIALIZE_LIST_HEAD_VARIABLE(mDpcEntryFreeList);
 
@@ -54,6 +71,103 @@ LIST_ENTRY      mDpcEntryFreeList = INITIALIZE_LIST_HEAD_VARIABLE(mDpcEntryFreeL
 //
 LIST_ENTRY      mDpcQueue[TPL_HIGH_LEVEL + 1];
 
+/**
+  Return the time in nanoseconds between two values of the performance counter.
+
+  @param  Begin  The value of the performance counter at the beginning.
+  @param  End    The value of the performance counter at the end.
+
+  @return The elapsed time in nanoseconds.
+
+**/
+UINT64
+DpcGetElapsedTime (
+  IN UINT64  Begin,
+  IN UINT64  End
+  )
+{
+  UINT64  Ticks;
+
+  if (mDpcCounterEnd >= mDpcCounterStart) {
+    //
+    // The counter counts up, and may have wrapped around to the start value.
+    //
+    if (End >= Begin) {
+      Ticks = End - Begin;
+    } else {
+      Ticks = (mDpcCounterEnd - Begin) + (End - mDpcCounterStart);
+    }
+  } else {
+    //
+    // The counter counts down, and may have wrapped around to the start value.
+    //
+    if (Begin >= End) {
+      Ticks = Begin - End;
+    } else {
+      Ticks = (Begin - mDpcCounterEnd) + (mDpcCounterStart - End);
+    }
+  }
+
+  return GetTimeInNanoSecond (Ticks);
+}
+
+/**
+  Add an invoked DPC to the statistics of its DPC procedure. The DPC procedure
+  is not tracked if DPC_MAX_PROCEDURE_NUM procedures are tracked already.
+
+  This function must be called at TPL_HIGH_LEVEL.
+
+  @param  DpcEntry  The DPC entry of the invoked DPC.
+
+**/
+VOID
+DpcUpdateStatistics (
+  IN DPC_ENTRY  *DpcEntry
+  )
+{
+  EDKII_DPC_PROCEDURE_STATISTICS  *Procedure;
+  UINT64                          QueueTime;
+  UINT64                          RunTime;
+  UINTN                           Index;
+
+  mDpcStatistics.DispatchCount++;
+
+  for (Index = 0; Index < mDpcStatistics.ProcedureNum; Index++) {
+    if (mDpcProcedureStatistics[Index].DpcProcedure == DpcEntry->DpcProcedure) {
+      break;
+    }
+  }
+
+  if (Index == mDpcStatistics.ProcedureNum) {
+    if (Index == DPC_MAX_PROCEDURE_NUM) {
+      return;
+    }
+
+    ZeroMem (&mDpcProcedureStatistics[Index], sizeof (EDKII_DPC_PROCEDURE_STATISTICS));
+    mDpcProcedureStatistics[Index].DpcProcedure = DpcEntry->DpcProcedure;
+    mDpcStatistics.ProcedureNum++;
+  }
+
+  Procedure         = &mDpcProcedureStatistics[Index];
+  Procedure->DpcTpl = DpcEntry->DpcTpl;
+  Procedure->DispatchCount++;
+
+  if (FeaturePcdGet (PcdDpcMeasureTime)) {
+    QueueTime = DpcGetElapsedTime (DpcEntry->QueueTime, DpcEntry->StartTime);
+    RunTime   = DpcGetElapsedTime (DpcEntry->StartTime, DpcEntry->EndTime);
+
+    if (QueueTime > Procedure->MaxQueueTime) {
+      Procedure->MaxQueueTime = QueueTime;
+    }
+
+    if (RunTime > Procedure->MaxRunTime) {
+      Procedure->MaxRunTime = RunTime;
+    }
+
+    Procedure->TotalRunTime += RunTime;
+  }
+}
+
 /**
   Add a Deferred Procedure Call to the end of the DPC queue.
 
@@ -82,7 +196,8 @@ DpcQueueDpc (
   EFI_STATUS  ReturnStatus;
   EFI_TPL     OriginalTpl;
   DPC_ENTRY   *DpcEntry;
-  UINTN       Index;
+
+  DpcEntry = NULL;
 
   //
   // Make sure DpcTpl is valid
@@ -113,6 +228,12 @@ DpcQueueDpc (
   // Check to see if there are any entries in the DPC free list
   //
   if (IsListEmpty (&mDpcEntryFreeList)) {
+    //
+    // The pool of DPC entries is exhausted. Count the overflow so that
+    // PcdDpcEntryNum can be tuned.
+    //
+    mDpcStatistics.OverflowCount++;
+
     //
     // If the current TPL is greater than TPL_NOTIFY, then memory allocations
     // can not be performed, so the free list can not be expanded.  In this case
@@ -124,57 +245,42 @@ DpcQueueDpc (
     }
 
     //
-    // Add 64 DPC entries to the free list
+    // Lower the TPL level to allocate a new DPC entry, and raise it back to
+    // TPL_HIGH_LEVEL for DPC list operations
     //
-    for (Index = 0; Index < 64; Index++) {
-      //
-      // Lower the TPL level to perform a memory allocation
-      //
-      gBS->RestoreTPL (OriginalTpl);
-
-      //
-      // Allocate a new DPC entry
-      //
-      DpcEntry = AllocatePool (sizeof (DPC_ENTRY));
-
-      //
-      // Raise the TPL level back to TPL_HIGH_LEVEL for DPC list operations
-      //
-      gBS->RaiseTPL (TPL_HIGH_LEVEL);
-
-      //
-      // If the allocation of a DPC entry fails, and the free list is empty,
-      // then return EFI_OUT_OF_RESOURCES.
-      //
-      if (DpcEntry == NULL) {
-        if (IsListEmpty (&mDpcEntryFreeList)) {
-          ReturnStatus = EFI_OUT_OF_RESOURCES;
-          goto Done;
-        }
-      }
+    gBS->RestoreTPL (OriginalTpl);
+    DpcEntry = AllocatePool (sizeof (DPC_ENTRY));
+    gBS->RaiseTPL (TPL_HIGH_LEVEL);
 
-      //
-      // Add the newly allocated DPC entry to the DPC free list
-      //
-      InsertTailList (&mDpcEntryFreeList, &DpcEntry->ListEntry);
+    if (DpcEntry != NULL) {
+      mDpcStatistics.EntryNum++;
+    } else if (IsListEmpty (&mDpcEntryFreeList)) {
+      ReturnStatus = EFI_OUT_OF_RESOURCES;
+      goto Done;
     }
   }
 
-  //
-  // Retrieve the first node from the free list of DPCs
-  //
-  DpcEntry = (DPC_ENTRY *)(GetFirstNode (&mDpcEntryFreeList));
+  if (DpcEntry == NULL) {
+    //
+    // Retrieve the first node from the free list of DPCs
+    //
+    DpcEntry = (DPC_ENTRY *)(GetFirstNode (&mDpcEntryFreeList));
 
-  //
-  // Remove the first node from the free list of DPCs
-  //
-  RemoveEntryList (&DpcEntry->ListEntry);
+    //
+    // Remove the first node from the free list of DPCs
+    //
+    RemoveEntryList (&DpcEntry->ListEntry);
+  }
 
   //
   // Fill in the DPC entry with the DpcProcedure and DpcContext
   //
   DpcEntry->DpcProcedure = DpcProcedure;
   DpcEntry->DpcContext   = DpcContext;
+  DpcEntry->DpcTpl       = DpcTpl;
+  if (FeaturePcdGet (PcdDpcMeasureTime)) {
+    DpcEntry->QueueTime = GetPerformanceCounter ();
+  }
 
   //
   // Add the DPC entry to the end of the list for the specified DplTpl.
@@ -184,13 +290,14 @@ DpcQueueDpc (
   //
   // Increment the measured DPC queue depth across all TPLs
   //
-  mDpcQueueDepth++;
+  mDpcStatistics.QueueCount++;
+  mDpcStatistics.QueueDepth++;
 
   //
   // Measure the maximum DPC queue depth across all TPLs
   //
-  if (mDpcQueueDepth > mMaxDpcQueueDepth) {
-    mMaxDpcQueueDepth = mDpcQueueDepth;
+  if (mDpcStatistics.QueueDepth > mDpcStatistics.MaxQueueDepth) {
+    mDpcStatistics.MaxQueueDepth = mDpcStatistics.QueueDepth;
   }
 
 Done:
@@ -239,7 +346,7 @@ DpcDispatchDpc (
   //
   // Check to see if there are 1 or more DPCs currently queued
   //
-  if (mDpcQueueDepth > 0) {
+  if (mDpcStatistics.QueueDepth > 0) {
     //
     // Loop from TPL_HIGH_LEVEL down to the current TPL value
     //
@@ -261,7 +368,7 @@ DpcDispatchDpc (
         //
         // Decrement the measured DPC Queue Depth across all TPLs
         //
-        mDpcQueueDepth--;
+        mDpcStatistics.QueueDepth--;
 
         //
         // Lower the TPL to TPL value of the current DPC queue
@@ -271,8 +378,16 @@ DpcDispatchDpc (
         //
         // Invoke the DPC passing in its context
         //
+        if (FeaturePcdGet (PcdDpcMeasureTime)) {
+          DpcEntry->StartTime = GetPerformanceCounter ();
+        }
+
         (DpcEntry->DpcProcedure) (DpcEntry->DpcContext);
 
+        if (FeaturePcdGet (PcdDpcMeasureTime)) {
+          DpcEntry->EndTime = GetPerformanceCounter ();
+        }
+
         //
         // At least one DPC has been invoked, so set the return status to EFI_SUCCESS
         //
@@ -284,8 +399,9 @@ DpcDispatchDpc (
         gBS->RaiseTPL (TPL_HIGH_LEVEL);
 
         //
-        // Add the invoked DPC entry to the DPC free list
+        // Account the invoked DPC and add its entry to the DPC free list
         //
+        DpcUpdateStatistics (DpcEntry);
         InsertTailList (&mDpcEntryFreeList, &DpcEntry->ListEntry);
       }
     }
@@ -299,6 +415,95 @@ DpcDispatchDpc (
   return ReturnStatus;
 }
 
+/**
+  Retrieve the statistics of the DPC queue and of the DPC procedures.
+
+  @param  This                 Protocol instance pointer.
+  @param  Statistics           Receives a snapshot of the queue counters.
+  @param  ProcedureNum         On input, the number of entries in ProcedureStatistics.
+                               On output, the number of DPC procedures tracked.
+  @param  ProcedureStatistics  Receives the counters of the DPC procedures.
+
+  @retval EFI_SUCCESS            The statistics were returned.
+  @retval EFI_BUFFER_TOO_SMALL   ProcedureStatistics is too small.
+  @retval EFI_INVALID_PARAMETER  Statistics or ProcedureNum is NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+DpcGetStatistics (
+  IN     EDKII_DPC_STATISTICS_PROTOCOL   *This,
+  OUT    EDKII_DPC_STATISTICS            *Statistics,
+  IN OUT UINTN                           *ProcedureNum,
+  OUT    EDKII_DPC_PROCEDURE_STATISTICS  *ProcedureStatistics OPTIONAL
+  )
+{
+  EFI_STATUS  Status;
+  EFI_TPL     OriginalTpl;
+
+  if (Statistics == NULL || ProcedureNum == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (*ProcedureNum != 0 && ProcedureStatistics == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Status      = EFI_SUCCESS;
+  OriginalTpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+
+  CopyMem (Statistics, &mDpcStatistics, sizeof (EDKII_DPC_STATISTICS));
+
+  if (*ProcedureNum < mDpcStatistics.ProcedureNum) {
+    Status = EFI_BUFFER_TOO_SMALL;
+  } else if (mDpcStatistics.ProcedureNum != 0) {
+    CopyMem (
+      ProcedureStatistics,
+      mDpcProcedureStatistics,
+      mDpcStatistics.ProcedureNum * sizeof (EDKII_DPC_PROCEDURE_STATISTICS)
+      );
+  }
+
+  *ProcedureNum = mDpcStatistics.ProcedureNum;
+
+  gBS->RestoreTPL (OriginalTpl);
+
+  return Status;
+}
+
+/**
+  Reset the counters of the DPC queue and forget the tracked DPC procedures.
+
+  @param  This  Protocol instance pointer.
+
+  @retval EFI_SUCCESS    The counters were reset.
+
+**/
+EFI_STATUS
+EFIAPI
+DpcResetStatistics (
+  IN EDKII_DPC_STATISTICS_PROTOCOL  *This
+  )
+{
+  EFI_TPL     OriginalTpl;
+
+  OriginalTpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+
+  //
+  // Keep the entry pool size and the current queue depth, which describe the
+  // state of the queue rather than its history.
+  //
+  mDpcStatistics.QueueCount    = 0;
+  mDpcStatistics.DispatchCount = 0;
+  mDpcStatistics.OverflowCount = 0;
+  mDpcStatistics.MaxQueueDepth = mDpcStatistics.QueueDepth;
+  mDpcStatistics.ProcedureNum  = 0;
+
+  gBS->RestoreTPL (OriginalTpl);
+
+  return EFI_SUCCESS;
+}
+
 /**
   The entry point for DPC driver which installs the EFI_DPC_PROTOCOL onto a new handle.
 
@@ -307,6 +512,7 @@ DpcDispatchDpc (
 
   @retval EFI_SUCCES             The DPC queues were initialized and the EFI_DPC_PROTOCOL was
                                  installed onto a new handle.
+  @retval EFI_OUT_OF_RESOURCES   Failed to allocate the DPC entries.
   @retval Others                 Failed to install EFI_DPC_PROTOCOL.
 
 **/
@@ -319,6 +525,8 @@ DpcDriverEntryPoint (
 {
   EFI_STATUS  Status;
   UINTN       Index;
+  UINT32      EntryNum;
+  DPC_ENTRY   *DpcEntries;
 
   //
   // ASSERT() if the EFI_DPC_PROTOCOL is already present in the handle database
@@ -333,15 +541,41 @@ DpcDriverEntryPoint (
   }
 
   //
-  // Install the EFI_DPC_PROTOCOL instance onto a new handle
+  // Allocate the pool of DPC entries and add all of them to the free list
+  //
+  EntryNum = PcdGet32 (PcdDpcEntryNum);
+  ASSERT (EntryNum != 0);
+  DpcEntries = AllocatePool (EntryNum * sizeof (DPC_ENTRY));
+  if (DpcEntries == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  for (Index = 0; Index < EntryNum; Index++) {
+    InsertTailList (&mDpcEntryFreeList, &DpcEntries[Index].ListEntry);
+  }
+
+  mDpcStatistics.EntryNum = EntryNum;
+
+  if (FeaturePcdGet (PcdDpcMeasureTime)) {
+    GetPerformanceCounterProperties (&mDpcCounterStart, &mDpcCounterEnd);
+  }
+
+  //
+  // Install the EFI_DPC_PROTOCOL and EDKII_DPC_STATISTICS_PROTOCOL instances
+  // onto a new handle
   //
   Status = gBS->InstallMultipleProtocolInterfaces (
                   &mDpcHandle,
                   &gEfiDpcProtocolGuid, 
                   &mDpc,
+                  &gEdkiiDpcStatisticsProtocolGuid,
+                  &mDpcStatisticsProtocol,
                   NULL
                   );
   ASSERT_EFI_ERROR (Status);
+  if (EFI_ERROR (Status)) {
+    FreePool (DpcEntries);
+  }
 
   return Status;
 }
@@ -27,7 +27,16 @@ Abstract:
 #include <Library/UefiDriverEntryPoint.h>
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/MemoryAllocationLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/TimerLib.h>
+#include <Library/PcdLib.h>
 #include <Protocol/Dpc.h>
+#include <Protocol/DpcStatistics.h>
+
+//
+// The maximum number of DPC procedures tracked in the per procedure statistics.
+//
+#define DPC_MAX_PROCEDURE_NUM    64
 
 //
 // Internal data struture for managing DPCs.  A DPC entry is either on the free
@@ -37,6 +46,14 @@ typedef struct {
   LIST_ENTRY             ListEntry;
   EFI_DPC_PROCEDURE  DpcProcedure;
   VOID               *DpcContext;
+  EFI_TPL            DpcTpl;
+  //
+  // Performance counter values taken when the DPC is queued, and before and
+  // after it is invoked. They are only recorded if PcdDpcMeasureTime is TRUE.
+  //
+  UINT64             QueueTime;
+  UINT64             StartTime;
+  UINT64             EndTime;
 } DPC_ENTRY;
 
 /**
@@ -82,5 +99,42 @@ DpcDispatchDpc (
   IN EFI_DPC_PROTOCOL  *This
   );
 
+/**
+  Retrieve the statistics of the DPC queue and of the DPC procedures.
+
+  @param  This                 Protocol instance pointer.
+  @param  Statistics           Receives a snapshot of the queue counters.
+  @param  ProcedureNum         On input, the number of entries in ProcedureStatistics.
+                               On output, the number of DPC procedures tracked.
+  @param  ProcedureStatistics  Receives the counters of the DPC procedures.
+
+  @retval EFI_SUCCESS            The statistics were returned.
+  @retval EFI_BUFFER_TOO_SMALL   ProcedureStatistics is too small.
+  @retval EFI_INVALID_PARAMETER  Statistics or ProcedureNum is NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+DpcGetStatistics (
+  IN     EDKII_DPC_STATISTICS_PROTOCOL   *This,
+  OUT    EDKII_DPC_STATISTICS            *Statistics,
+  IN OUT UINTN                           *ProcedureNum,
+  OUT    EDKII_DPC_PROCEDURE_STATISTICS  *ProcedureStatistics OPTIONAL
+  );
+
+/**
+  Reset the counters of the DPC queue and forget the tracked DPC procedures.
+
+  @param  This  Protocol instance pointer.
+
+  @retval EFI_SUCCESS    The counters were reset.
+
+**/
+EFI_STATUS
+EFIAPI
+DpcResetStatistics (
+  IN EDKII_DPC_STATISTICS_PROTOCOL  *This
+  );
+
 #endif
 
@@ -36,8 +36,10 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #define ISCSI_MAX_CONNS_PER_SESSION             1
 
 #define DEFAULT_MAX_RECV_DATA_SEG_LEN           8192
-#define MAX_RECV_DATA_SEG_LEN_IN_FFP            65536
-#define DEFAULT_MAX_OUTSTANDING_R2T             1
+#define MAX_RECV_DATA_SEG_LEN_IN_FFP            262144
+#define DEFAULT_MAX_OUTSTANDING_R2T             4
+#define DEFAULT_MAX_BURST_LENGTH                0xFFFFFF
+#define DEFAULT_FIRST_BURST_LENGTH              262144
 
 #define ISCSI_VERSION_MAX                       0x00
 #define ISCSI_VERSION_MIN                       0x00
@@ -107,7 +107,7 @@ Tcp4IoCreateSocket (
   ControlOption.EnableNagle             = FALSE;
   ControlOption.EnableTimeStamp         = FALSE;
   ControlOption.EnableWindowScaling     = TRUE;
-  ControlOption.EnableSelectiveAck      = FALSE;
+  ControlOption.EnableSelectiveAck      = TRUE;
   ControlOption.EnablePathMtuDiscovery  = FALSE;
 
   Tcp4ConfigData.TypeOfService          = 8;
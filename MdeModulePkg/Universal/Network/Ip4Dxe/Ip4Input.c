@@ -1229,9 +1229,11 @@ Ip4WrapRxData (
 
 /**
   Deliver the received packets to upper layer if there are both received
-  requests and enqueued packets. If the enqueued packet is shared, it will
-  duplicate it to a non-shared packet, release the shared packet, then
-  deliver the non-shared packet up.
+  requests and enqueued packets. If the enqueued packet is shared, a
+  non-shared packet is built that references the same payload but owns a
+  private copy of the IP head, because the head is converted to network byte
+  order in place when delivered. The shared packet is then released and the
+  non-shared packet is delivered up.
 
   @param[in]  IpInstance         The IP child to deliver the packet up.
 
@@ -1251,7 +1253,6 @@ Ip4InstanceDeliverPacket (
   NET_BUF                   *Packet;
   NET_BUF                   *Dup;
   UINT8                     *Head;
-  UINT32                    HeadLen;
 
   //
   // Deliver a packet if there are both a packet and a receive token.
@@ -1275,33 +1276,33 @@ Ip4InstanceDeliverPacket (
 
     } else {
       //
-      // Create a duplicated packet if this packet is shared
+      // Create a non-shared packet if this packet is shared. The payload
+      // is referenced rather than copied, only the head space is private.
+      // NetbufGetFragment can't represent an empty packet, duplicate it.
       //
-      if (IpInstance->ConfigData.RawData) {
-        HeadLen = 0;
+      if (Packet->TotalSize != 0) {
+        Dup = NetbufGetFragment (Packet, 0, Packet->TotalSize, IP4_MAX_HEADLEN);
       } else {
-        HeadLen = IP4_MAX_HEADLEN;
+        Dup = NetbufDuplicate (Packet, NULL, IP4_MAX_HEADLEN);
       }
 
-      Dup = NetbufDuplicate (Packet, NULL, HeadLen);
-
       if (Dup == NULL) {
         return EFI_OUT_OF_RESOURCES;
       }
 
       if (!IpInstance->ConfigData.RawData) {
         //
-        // Copy the IP head over. The packet to deliver up is
-        // headless. Trim the head off after copy. The IP head
-        // may be not continuous before the data.
+        // Copy the IP head over into the private head space. The packet
+        // to deliver up is headless. Don't allocate the head through
+        // NetbufAllocSpace, it may return the head room of the shared
+        // block, which still holds the IP head of the other instances.
         //
-        Head = NetbufAllocSpace (Dup, IP4_MAX_HEADLEN, NET_BUF_HEAD);
-        ASSERT (Head != NULL);
-        
+        Head = Dup->BlockOp[0].BlockHead;
+        ASSERT (NET_HEADSPACE (&Dup->BlockOp[0]) >= IP4_MAX_HEADLEN);
+
         Dup->Ip.Ip4 = (IP4_HEAD *) Head;
 
         CopyMem (Head, Packet->Ip.Ip4, Packet->Ip.Ip4->HeadLen << 2);
-        NetbufTrim (Dup, IP4_MAX_HEADLEN, TRUE);
       }
 
       Wrap = Ip4WrapRxData (IpInstance, Dup);
@@ -137,17 +137,31 @@ Ip4FreeRouteCacheEntry (
 
   @param[in, out]  RtCache               The rotue cache table to initialize.
 
+  @retval EFI_SUCCESS           The route cache is initialized.
+  @retval EFI_OUT_OF_RESOURCES  Failed to allocate the hash buckets.
+
 **/
-VOID
+EFI_STATUS
 Ip4InitRouteCache (
   IN OUT IP4_ROUTE_CACHE        *RtCache
   )
 {
   UINT32                    Index;
 
-  for (Index = 0; Index < IP4_ROUTE_CACHE_HASH_VALUE; Index++) {
+  RtCache->BucketNum   = MAX (PcdGet32 (PcdIp4RouteCacheBuckets), 1);
+  RtCache->Hit         = 0;
+  RtCache->Miss        = 0;
+  RtCache->CacheBucket = AllocatePool (RtCache->BucketNum * sizeof (LIST_ENTRY));
+
+  if (RtCache->CacheBucket == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  for (Index = 0; Index < RtCache->BucketNum; Index++) {
     InitializeListHead (&(RtCache->CacheBucket[Index]));
   }
+
+  return EFI_SUCCESS;
 }
 
 
@@ -168,7 +182,7 @@ Ip4CleanRouteCache (
   IP4_ROUTE_CACHE_ENTRY     *RtCacheEntry;
   UINT32                    Index;
 
-  for (Index = 0; Index < IP4_ROUTE_CACHE_HASH_VALUE; Index++) {
+  for (Index = 0; Index < RtCache->BucketNum; Index++) {
     NET_LIST_FOR_EACH_SAFE (Entry, Next, &(RtCache->CacheBucket[Index])) {
       RtCacheEntry = NET_LIST_USER_STRUCT (Entry, IP4_ROUTE_CACHE_ENTRY, Link);
 
@@ -176,6 +190,17 @@ Ip4CleanRouteCache (
       Ip4FreeRouteCacheEntry (RtCacheEntry);
     }
   }
+
+  DEBUG ((
+    EFI_D_NET,
+    "Ip4CleanRouteCache: %ld hits, %ld misses in %d buckets\n",
+    RtCache->Hit,
+    RtCache->Miss,
+    RtCache->BucketNum
+    ));
+
+  FreePool (RtCache->CacheBucket);
+  RtCache->CacheBucket = NULL;
 }
 
 
@@ -210,7 +235,11 @@ Ip4CreateRouteTable (
 
   RtTable->Next = NULL;
 
-  Ip4InitRouteCache (&RtTable->Cache);
+  if (EFI_ERROR (Ip4InitRouteCache (&RtTable->Cache))) {
+    FreePool (RtTable);
+    return NULL;
+  }
+
   return RtTable;
 }
 
@@ -278,7 +307,7 @@ Ip4PurgeRouteCache (
   IP4_ROUTE_CACHE_ENTRY     *RtCacheEntry;
   UINT32                    Index;
 
-  for (Index = 0; Index < IP4_ROUTE_CACHE_HASH_VALUE; Index++) {
+  for (Index = 0; Index < RtCache->BucketNum; Index++) {
     NET_LIST_FOR_EACH_SAFE (Entry, Next, &RtCache->CacheBucket[Index]) {
 
       RtCacheEntry = NET_LIST_USER_STRUCT (Entry, IP4_ROUTE_CACHE_ENTRY, Link);
@@ -425,7 +454,7 @@ Ip4FindRouteCache (
   IP4_ROUTE_CACHE_ENTRY     *RtCacheEntry;
   UINT32                    Index;
 
-  Index = IP4_ROUTE_CACHE_HASH (Dest, Src);
+  Index = IP4_ROUTE_CACHE_HASH (&RtTable->Cache, Dest, Src);
 
   NET_LIST_FOR_EACH (Entry, &RtTable->Cache.CacheBucket[Index]) {
     RtCacheEntry = NET_LIST_USER_STRUCT (Entry, IP4_ROUTE_CACHE_ENTRY, Link);
@@ -517,18 +546,21 @@ Ip4Route (
 
   ASSERT (RtTable != NULL);
 
-  Head          = &RtTable->Cache.CacheBucket[IP4_ROUTE_CACHE_HASH (Dest, Src)];
+  Head          = &RtTable->Cache.CacheBucket[IP4_ROUTE_CACHE_HASH (&RtTable->Cache, Dest, Src)];
   RtCacheEntry  = Ip4FindRouteCache (RtTable, Dest, Src);
 
   //
   // If found, promote the cache entry to the head of the hash bucket. LRU
   //
   if (RtCacheEntry != NULL) {
+    RtTable->Cache.Hit++;
     RemoveEntryList (&RtCacheEntry->Link);
     InsertHeadList (Head, &RtCacheEntry->Link);
     return RtCacheEntry;
   }
 
+  RtTable->Cache.Miss++;
+
   //
   // Search the route table for the most specific route
   //
@@ -565,7 +597,7 @@ Ip4Route (
   NET_GET_REF (RtCacheEntry);
 
   //
-  // Each bucket of route cache can contain at most 64 entries.
+  // Each bucket of route cache can contain at most IP4_ROUTE_CACHE_MAX entries.
   // Remove the entries at the tail of the bucket. These entries
   // are likely to be used least.
   //
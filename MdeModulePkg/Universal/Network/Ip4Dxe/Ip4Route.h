@@ -19,10 +19,16 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 
 #define IP4_DIRECT_ROUTE       0x00000001
 
-#define IP4_ROUTE_CACHE_HASH_VALUE 31
 #define IP4_ROUTE_CACHE_MAX        64  // Max NO. of cache entry per hash bucket
 
-#define IP4_ROUTE_CACHE_HASH(Dst, Src)  (((Dst) ^ (Src)) % IP4_ROUTE_CACHE_HASH_VALUE)
+//
+// Fold all the bytes of the addresses into the low byte before the modulo,
+// otherwise a power-of-2 bucket number only looks at the low byte.
+//
+#define IP4_ROUTE_CACHE_FOLD(Key)  ((Key) ^ ((Key) >> 8) ^ ((Key) >> 16) ^ ((Key) >> 24))
+
+#define IP4_ROUTE_CACHE_HASH(Cache, Dst, Src)  \
+          (IP4_ROUTE_CACHE_FOLD ((UINT32) ((Dst) ^ (Src))) % (Cache)->BucketNum)
 
 ///
 /// The route entry in the route table. Dest/Netmask is the destion
@@ -66,8 +72,14 @@ typedef struct {
 /// the route cache a seperated structure in case we want to
 /// detach them later.
 ///
+/// The number of hash buckets is set by PcdIp4RouteCacheBuckets.
+/// Hit and Miss count the lookups of Ip4Route to tune it.
+///
 typedef struct {
-  LIST_ENTRY                CacheBucket[IP4_ROUTE_CACHE_HASH_VALUE];
+  UINT32                    BucketNum;
+  LIST_ENTRY                *CacheBucket;
+  UINT64                    Hit;
+  UINT64                    Miss;
 } IP4_ROUTE_CACHE;
 
 ///
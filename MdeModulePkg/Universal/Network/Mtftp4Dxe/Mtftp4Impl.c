@@ -80,6 +80,9 @@ Mtftp4CleanOperation (
 
   Instance->BlkSize       = MTFTP4_DEFAULT_BLKSIZE;
   Instance->LastBlock     = 0;
+  Instance->WindowSize    = MTFTP4_DEFAULT_WINDOWSIZE;
+  Instance->WindowBlocks  = 0;
+  Instance->WindowAcked   = FALSE;
   Instance->ServerIp      = 0;
   Instance->ListeningPort = 0;
   Instance->ConnectedPort = 0;
@@ -431,6 +434,15 @@ Mtftp4Start (
     if (EFI_ERROR (Status)) {
       goto ON_ERROR;
     }
+
+    //
+    // Only the download is able to work with a window of blocks.
+    //
+    if ((Operation == EFI_MTFTP4_OPCODE_WRQ) &&
+        ((Instance->RequestOption.Exist & MTFTP4_WINDOWSIZE_EXIST) != 0)) {
+      Status = EFI_UNSUPPORTED;
+      goto ON_ERROR;
+    }
   }
 
   //
@@ -439,6 +451,9 @@ Mtftp4Start (
   Config                  = &Instance->Config;
   Instance->Token         = Token;
   Instance->BlkSize       = MTFTP4_DEFAULT_BLKSIZE;
+  Instance->WindowSize    = MTFTP4_DEFAULT_WINDOWSIZE;
+  Instance->WindowBlocks  = 0;
+  Instance->WindowAcked   = FALSE;
 
   CopyMem (&Instance->ServerIp, &Config->ServerIp, sizeof (IP4_ADDR));
   Instance->ServerIp      = NTOHL (Instance->ServerIp);
@@ -56,6 +56,7 @@ typedef struct _MTFTP4_PROTOCOL MTFTP4_PROTOCOL;
 #define MTFTP4_DEFAULT_TIMEOUT      3
 #define MTFTP4_DEFAULT_RETRY        5
 #define MTFTP4_DEFAULT_BLKSIZE      512
+#define MTFTP4_DEFAULT_WINDOWSIZE   1
 #define MTFTP4_TIME_TO_GETMAP       5
 
 #define MTFTP4_STATE_UNCONFIGED     0
@@ -120,6 +121,15 @@ struct _MTFTP4_PROTOCOL {
   UINT16                        LastBlock;
   LIST_ENTRY                    Blocks;
 
+  //
+  // Number of blocks the server sends before waiting for an ACK (RFC 7440),
+  // the blocks received since the last ACK, and whether an ACK has already
+  // been sent for the out-of-order block that broke the current window.
+  //
+  UINT16                        WindowSize;
+  UINT16                        WindowBlocks;
+  BOOLEAN                       WindowAcked;
+
   //
   // The server's communication end point: IP and two ports. one for
   // initial request, one for its selected port.
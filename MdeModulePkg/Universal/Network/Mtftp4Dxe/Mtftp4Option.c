@@ -18,7 +18,8 @@ CHAR8 *mMtftp4SupportedOptions[MTFTP4_SUPPORTED_OPTIONS] = {
   "blksize",
   "timeout",
   "tsize",
-  "multicast"
+  "multicast",
+  "windowsize"
 };
 
 
@@ -481,6 +482,19 @@ Mtftp4ParseOption (
 
       MtftpOption->Exist |= MTFTP4_MCAST_EXIST;
 
+    } else if (NetStringEqualNoCase (This->OptionStr, (UINT8 *) "windowsize")) {
+      //
+      // windowsize option (RFC 7440), valid value is between [1, 65535]
+      //
+      Value = NetStringToU32 (This->ValueStr);
+
+      if ((Value < 1) || (Value > 65535)) {
+        return EFI_INVALID_PARAMETER;
+      }
+
+      MtftpOption->WindowSize = (UINT16) Value;
+      MtftpOption->Exist |= MTFTP4_WINDOWSIZE_EXIST;
+
     } else if (Request) {
       //
       // Ignore the unsupported option if it is a reply, and return
@@ -114,6 +114,11 @@ Mtftp4RrqSendAck (
   Ack->Ack.OpCode   = HTONS (EFI_MTFTP4_OPCODE_ACK);
   Ack->Ack.Block[0] = HTONS (BlkNo);
 
+  //
+  // The ACK opens a new window of blocks on the server.
+  //
+  Instance->WindowBlocks = 0;
+
   return Mtftp4SendPacket (Instance, Packet);
 }
 
@@ -266,8 +271,19 @@ Mtftp4RrqHandleData (
   // the last ACK then restart receiving. If we are passive, save
   // the block.
   //
+  // With a window larger than one block, the server keeps sending the
+  // rest of the window after a block is lost. ACK the last block received
+  // in order once, so that the server restarts the window from there,
+  // and ignore the remaining out-of-order blocks of that window.
+  //
   if (Instance->Master && (Expected != BlockNum)) {
-    Mtftp4Retransmit (Instance);
+    if (Instance->WindowSize == 1) {
+      Mtftp4Retransmit (Instance);
+    } else if (!Instance->WindowAcked) {
+      Instance->WindowAcked = TRUE;
+      Mtftp4RrqSendAck (Instance, (UINT16) (Expected - 1));
+    }
+
     return EFI_SUCCESS;
   }
 
@@ -277,11 +293,15 @@ Mtftp4RrqHandleData (
     return Status;
   }
 
+  Instance->WindowAcked = FALSE;
+  Instance->WindowBlocks++;
+
   //
   // Reset the passive client's timer whenever it received a
-  // valid data packet.
+  // valid data packet. So does the active client within a window,
+  // as it doesn't send an ACK for each block.
   //
-  if (!Instance->Master) {
+  if (!Instance->Master || (Instance->WindowBlocks < Instance->WindowSize)) {
     Mtftp4SetTimeout (Instance);
   }
 
@@ -306,6 +326,13 @@ Mtftp4RrqHandleData (
 
     } else {
       BlockNum = (UINT16) (Expected - 1);
+
+      //
+      // Only the last block of a window is acknowledged.
+      //
+      if (Instance->WindowBlocks < Instance->WindowSize) {
+        return EFI_SUCCESS;
+      }
     }
 
     Mtftp4RrqSendAck (Instance, BlockNum);
@@ -323,6 +350,7 @@ Mtftp4RrqHandleData (
   2. The server can only use smaller blksize than that is requested
   3. The server can only use the same timeout as requested
   4. The server doesn't change its multicast channel.
+  5. The server can only use smaller windowsize than that is requested
 
   @param  This                  The downloading Mtftp session
   @param  Reply                 The options in the OACK packet
@@ -356,6 +384,10 @@ Mtftp4RrqOackValid (
     return FALSE;
   }
 
+  if (((Reply->Exist & MTFTP4_WINDOWSIZE_EXIST) != 0) && (Reply->WindowSize > Request->WindowSize)) {
+    return FALSE;
+  }
+
   //
   // The server can send ",,master" to client to change its master
   // setting. But if it use the specific multicast channel, it can't
@@ -610,6 +642,14 @@ Mtftp4RrqHandleOack (
       Instance->BlkSize = Reply.BlkSize;
     }
 
+    //
+    // The window is only used for unicast download. Without the option
+    // in the OACK, the server falls back to one block per ACK.
+    //
+    if (Reply.WindowSize != 0) {
+      Instance->WindowSize = Reply.WindowSize;
+    }
+
     if (Reply.Timeout != 0) {
       Instance->Timeout = Reply.Timeout;
     }
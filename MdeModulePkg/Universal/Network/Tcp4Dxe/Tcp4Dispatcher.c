@@ -126,7 +126,7 @@ Tcp4GetMode (
       Option->EnableTimeStamp     = (BOOLEAN) (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_TS));
       Option->EnableWindowScaling = (BOOLEAN) (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_WS));
 
-      Option->EnableSelectiveAck      = FALSE;
+      Option->EnableSelectiveAck      = (BOOLEAN) (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK));
       Option->EnablePathMtuDiscovery  = FALSE;
     }
   }
@@ -427,6 +427,7 @@ Tcp4ConfigurePcb (
     IsListEmpty (&Tcb->RcvQue));
 
   TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_NO_KEEPALIVE);
+  TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_NO_SACK);
   Tcb->State            = TCP_CLOSED;
 
   Tcb->SndMss           = 536;
@@ -439,6 +440,10 @@ Tcp4ConfigurePcb (
   Tcb->Ssthresh         = 0xffffffff;
 
   Tcb->CongestState     = TCP_CONGEST_OPEN;
+  Tcb->CongestCtrl      = PcdGet8 (PcdTcpCongestionControl);
+  Tcb->CubicEpochOn     = FALSE;
+  Tcb->CubicWMax        = 0;
+  Tcb->SackNum          = 0;
 
   Tcb->KeepAliveIdle    = TCP_KEEPALIVE_IDLE_MIN;
   Tcb->KeepAlivePeriod  = TCP_KEEPALIVE_PERIOD;
@@ -568,6 +573,10 @@ Tcp4ConfigurePcb (
     if (!Option->EnableWindowScaling) {
       TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_NO_WS);
     }
+
+    if (Option->EnableSelectiveAck) {
+      TCP_CLEAR_FLG (Tcb->CtrlFlag, TCP_CTRL_NO_SACK);
+    }
   }
 
   //
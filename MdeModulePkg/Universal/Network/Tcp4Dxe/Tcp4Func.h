@@ -308,6 +308,23 @@ TcpRetransmit (
   IN TCP_SEQNO Seq
   );
 
+/**
+  Retransmit the first hole in the SACK scoreboard from sequence Seq that
+  has not been retransmitted in the current recovery.
+
+  @param  Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param  Seq     The sequence number to start the search from.
+
+  @retval TRUE    A hole is retransmitted.
+  @retval FALSE   There is no hole to retransmit, or error condition occurred.
+
+**/
+BOOLEAN
+TcpSackRetransmit (
+  IN OUT TCP_CB    *Tcb,
+  IN     TCP_SEQNO Seq
+  );
+
 /**
   Compute how much data to send.
 
@@ -513,6 +530,46 @@ TcpComputeRtt (
   IN     UINT32 Measure
   );
 
+/**
+  Compute the slow start threshold when a loss is detected.
+
+  @param  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+  @return The new slow start threshold.
+
+**/
+UINT32
+TcpComputeSsthresh (
+  IN OUT TCP_CB *Tcb
+  );
+
+/**
+  Open the congestion window for an ACK of new data received in slow
+  start or congestion avoidance.
+
+  @param  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpOpenCongestWindow (
+  IN OUT TCP_CB *Tcb
+  );
+
+/**
+  Update the SACK scoreboard with the SACK option received and the ACK.
+
+  @param  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param  Option   Pointer to the options of the received segment.
+  @param  Ack      The acknowledge sequence number of the received segment.
+
+**/
+VOID
+TcpSackUpdate (
+  IN OUT TCP_CB     *Tcb,
+  IN     TCP_OPTION *Option,
+  IN     TCP_SEQNO  Ack
+  );
+
 /**
   Trim off the data outside the tcb's receive window.
 
@@ -15,16 +15,28 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #ifndef _TCP4_OPTION_H_
 #define _TCP4_OPTION_H_
 
+#define TCP_OPTION_MAX_SACK_BLOCK  4  ///< Max SACK blocks in one option
+
+///
+/// A block of contiguous sequence space reported by a SACK option, RFC2018.
+///
+typedef struct _TCP_SACK_BLOCK {
+  TCP_SEQNO Left;   ///< The first sequence number of the block
+  TCP_SEQNO Right;  ///< The sequence number immediately following the block
+} TCP_SACK_BLOCK;
+
 ///
 /// The structure to store the parse option value.
 /// ParseOption only parse the options, don't process them.
 ///
 typedef struct _TCP_OPTION {
-  UINT8   Flag;     ///< Flag such as TCP_OPTION_RCVD_MSS
-  UINT8   WndScale; ///< The WndScale received
-  UINT16  Mss;      ///< The Mss received
-  UINT32  TSVal;    ///< The TSVal field in a timestamp option
-  UINT32  TSEcr;    ///< The TSEcr field in a timestamp option
+  UINT8           Flag;     ///< Flag such as TCP_OPTION_RCVD_MSS
+  UINT8           WndScale; ///< The WndScale received
+  UINT16          Mss;      ///< The Mss received
+  UINT32          TSVal;    ///< The TSVal field in a timestamp option
+  UINT32          TSEcr;    ///< The TSEcr field in a timestamp option
+  UINT8           SackNum;  ///< The number of blocks in a SACK option
+  TCP_SACK_BLOCK  SackBlock[TCP_OPTION_MAX_SACK_BLOCK]; ///< The SACK blocks received
 } TCP_OPTION;
 
 //
@@ -34,12 +46,19 @@ typedef struct _TCP_OPTION {
 #define TCP_OPTION_NOP             1  ///< No-Option.
 #define TCP_OPTION_MSS             2  ///< Maximum Segment Size
 #define TCP_OPTION_WS              3  ///< Window scale
+#define TCP_OPTION_SACK_PERM       4  ///< SACK permitted
+#define TCP_OPTION_SACK            5  ///< Selective acknowledgment
 #define TCP_OPTION_TS              8  ///< Timestamp
 #define TCP_OPTION_MSS_LEN         4  ///< Length of MSS option
 #define TCP_OPTION_WS_LEN          3  ///< Length of window scale option
+#define TCP_OPTION_SACK_PERM_LEN   2  ///< Length of SACK permitted option
+#define TCP_OPTION_SACK_BLOCK_LEN  8  ///< Length of each block in SACK option
 #define TCP_OPTION_TS_LEN          10 ///< Length of timestamp option
 #define TCP_OPTION_WS_ALIGNED_LEN  4  ///< Length of window scale option, aligned
+#define TCP_OPTION_SACK_PERM_ALIGNED_LEN  4  ///< Length of SACK permitted option, aligned
+#define TCP_OPTION_SACK_ALIGNED_LEN       4  ///< Length of SACK option without blocks, aligned
 #define TCP_OPTION_TS_ALIGNED_LEN  12 ///< Length of timestamp option, aligned
+#define TCP_OPTION_MAX_LEN         40 ///< Max length of all the options
 
 //
 // recommend format of timestamp window scale
@@ -56,12 +75,23 @@ typedef struct _TCP_OPTION {
 
 #define TCP_OPTION_MSS_FAST  ((TCP_OPTION_MSS << 24) | (TCP_OPTION_MSS_LEN << 16))
 
+#define TCP_OPTION_SACK_PERM_FAST ((TCP_OPTION_NOP << 24) | \
+                                   (TCP_OPTION_NOP << 16) | \
+                                   (TCP_OPTION_SACK_PERM << 8) | \
+                                   (TCP_OPTION_SACK_PERM_LEN))
+
+#define TCP_OPTION_SACK_FAST ((TCP_OPTION_NOP << 24) | \
+                              (TCP_OPTION_NOP << 16) | \
+                              (TCP_OPTION_SACK << 8))
+
 //
 // Other misc definations
 //
 #define TCP_OPTION_RCVD_MSS        0x01
 #define TCP_OPTION_RCVD_WS         0x02
 #define TCP_OPTION_RCVD_TS         0x04
+#define TCP_OPTION_RCVD_SACK_PERM  0x08
+#define TCP_OPTION_RCVD_SACK       0x10
 #define TCP_OPTION_MAX_WS          14      ///< Maxium window scale value
 #define TCP_OPTION_MAX_WIN         0xffff  ///< Max window size in TCP header
 
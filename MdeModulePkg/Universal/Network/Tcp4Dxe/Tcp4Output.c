@@ -701,6 +701,10 @@ TcpRetransmit (
   NetbufTrim (Nbuf, (Nbuf->Tcp->HeadLen << 2), NET_BUF_HEAD);
   Nbuf->Tcp = NULL;
 
+  if (TCP_SEQ_GT (TCPSEG_NETBUF (Nbuf)->End, Tcb->SackRexmit)) {
+    Tcb->SackRexmit = TCPSEG_NETBUF (Nbuf)->End;
+  }
+
   NetbufFree (Nbuf);
   return 0;
 
@@ -713,6 +717,54 @@ OnError:
 }
 
 
+/**
+  Retransmit the first hole in the SACK scoreboard from sequence Seq that
+  has not been retransmitted in the current recovery. Only the data below
+  the highest SACKed sequence are considered lost, RFC6675.
+
+  @param  Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param  Seq     The sequence number to start the search from.
+
+  @retval TRUE    A hole is retransmitted.
+  @retval FALSE   There is no hole to retransmit, or error condition occurred.
+
+**/
+BOOLEAN
+TcpSackRetransmit (
+  IN OUT TCP_CB    *Tcb,
+  IN     TCP_SEQNO Seq
+  )
+{
+  UINT32  Index;
+
+  if (TCP_SEQ_LT (Seq, Tcb->SackRexmit)) {
+    Seq = Tcb->SackRexmit;
+  }
+
+  //
+  // Skip the data SACKed by the peer. The scoreboard is sorted.
+  //
+  for (Index = 0; Index < Tcb->SackNum; Index++) {
+    if (TCP_SEQ_LT (Seq, Tcb->SackBlock[Index].Left)) {
+      break;
+    }
+
+    if (TCP_SEQ_LT (Seq, Tcb->SackBlock[Index].Right)) {
+      Seq = Tcb->SackBlock[Index].Right;
+    }
+  }
+
+  if ((Index == Tcb->SackNum) || TCP_SEQ_GEQ (Seq, Tcb->SndNxt)) {
+    return FALSE;
+  }
+
+  DEBUG ((EFI_D_INFO, "TcpSackRetransmit: retransmit the hole at"
+    " %d for TCB %p\n", Seq, Tcb));
+
+  return (BOOLEAN) (TcpRetransmit (Tcb, Seq) == 0);
+}
+
+
 /**
   Check whether to send data/SYN/FIN and piggy back an ACK.
 
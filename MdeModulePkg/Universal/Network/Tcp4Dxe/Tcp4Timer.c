@@ -152,22 +152,28 @@ TcpRexmitTimeout (
   IN OUT TCP_CB *Tcb
   )
 {
-  UINT32  FlightSize;
-
   DEBUG ((EFI_D_WARN, "TcpRexmitTimeout: transmission "
     "timeout for TCB %p\n", Tcb));
 
   //
-  // Set the congestion window. FlightSize is the
-  // amount of data that has been sent but not
-  // yet ACKed.
+  // Set the congestion window. RFC5681 requires to hold
+  // the Ssthresh constant if the same data is retransmitted
+  // by the timer again.
   //
-  FlightSize        = TCP_SUB_SEQ (Tcb->SndNxt, Tcb->SndUna);
-  Tcb->Ssthresh     = MAX ((UINT32) (2 * Tcb->SndMss), FlightSize / 2);
+  if (Tcb->CongestState != TCP_CONGEST_LOSS) {
+    Tcb->Ssthresh   = TcpComputeSsthresh (Tcb);
+  }
 
   Tcb->CWnd         = Tcb->SndMss;
   Tcb->LossRecover  = Tcb->SndNxt;
 
+  //
+  // The peer may discard the data it has SACKed, RFC2018
+  // requires to ignore the SACK information after timeout.
+  //
+  Tcb->SackNum      = 0;
+  Tcb->SackRexmit   = Tcb->SndUna;
+
   Tcb->LossTimes++;
   if ((Tcb->LossTimes > Tcb->MaxRexmit) &&
       !TCP_TIMER_ON (Tcb->EnabledTimer, TCP_TIMER_CONNECT)) {
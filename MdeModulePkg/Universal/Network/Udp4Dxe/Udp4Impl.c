@@ -189,14 +189,17 @@ Udp4EnqueueDgram (
   );
 
 /**
-  This function delivers the datagrams enqueued in the instances.
+  This function delivers the datagrams enqueued in the instances that may
+  accept a datagram to the specified destination port.
 
   @param[in]  Udp4Service            Pointer to the udp service context data.
+  @param[in]  DestinationPort        The destination port of the enqueued datagram.
 
 **/
 VOID
 Udp4DeliverDgram (
-  IN UDP4_SERVICE_DATA  *Udp4Service
+  IN UDP4_SERVICE_DATA  *Udp4Service,
+  IN UINT16             DestinationPort
   );
 
 /**
@@ -276,6 +279,7 @@ Udp4CreateService (
   EFI_STATUS          Status;
   IP_IO_OPEN_DATA     OpenData;
   EFI_IP4_CONFIG_DATA *Ip4ConfigData;
+  UINTN               Index;
 
   ZeroMem (Udp4Service, sizeof (UDP4_SERVICE_DATA));
 
@@ -286,6 +290,10 @@ Udp4CreateService (
   Udp4Service->ChildrenNumber   = 0;
 
   InitializeListHead (&Udp4Service->ChildrenList);
+  InitializeListHead (&Udp4Service->WildcardList);
+  for (Index = 0; Index < UDP4_PORT_HASH_SIZE; Index++) {
+    InitializeListHead (&Udp4Service->PortHash[Index]);
+  }
 
   //
   // Create the IpIo for this service context.
@@ -379,6 +387,15 @@ Udp4CleanService (
   // Destroy the IpIo.
   //
   IpIoDestroy (Udp4Service->IpIo);
+
+  DEBUG ((
+    EFI_D_NET,
+    "Udp4CleanService: %ld datagrams received, %ld enqueued, %ld to no port, %ld instances matched\n",
+    Udp4Service->RcvdDgramNum,
+    Udp4Service->EnqueuedDgramNum,
+    Udp4Service->NoPortDgramNum,
+    Udp4Service->MatchNum
+    ));
 }
 
 
@@ -466,6 +483,7 @@ Udp4InitInstance (
   // Init the lists.
   //
   InitializeListHead (&Instance->Link);
+  InitializeListHead (&Instance->DemuxLink);
   InitializeListHead (&Instance->RcvdDgramQue);
   InitializeListHead (&Instance->DeliveredDgramQue);
 
@@ -641,6 +659,50 @@ Udp4Bind (
 }
 
 
+/**
+  This function links a configured udp instance into the demultiplexing lists
+  of the service, so that it receives the datagrams it accepts.
+
+  @param[in]  Udp4Service        Pointer to the udp service context data.
+  @param[in]  Instance           Pointer to the configured udp instance.
+
+**/
+VOID
+Udp4InsertDemuxInstance (
+  IN UDP4_SERVICE_DATA   *Udp4Service,
+  IN UDP4_INSTANCE_DATA  *Instance
+  )
+{
+  if (Instance->ConfigData.AcceptAnyPort || Instance->ConfigData.AcceptPromiscuous) {
+    //
+    // The instance may accept a datagram to any destination port.
+    //
+    InsertTailList (&Udp4Service->WildcardList, &Instance->DemuxLink);
+  } else {
+    InsertTailList (
+      &Udp4Service->PortHash[UDP4_PORT_HASH (Instance->ConfigData.StationPort)],
+      &Instance->DemuxLink
+      );
+  }
+}
+
+/**
+  This function unlinks a udp instance from the demultiplexing lists of the
+  service when the instance is reset.
+
+  @param[in]  Instance           Pointer to the udp instance.
+
+**/
+VOID
+Udp4RemoveDemuxInstance (
+  IN UDP4_INSTANCE_DATA  *Instance
+  )
+{
+  RemoveEntryList (&Instance->DemuxLink);
+  InitializeListHead (&Instance->DemuxLink);
+}
+
+
 /**
   This function is used to check whether the NewConfigData has any un-reconfigurable
   parameters changed compared to the OldConfigData.
@@ -1451,40 +1513,52 @@ Udp4EnqueueDgram (
   IN EFI_UDP4_RECEIVE_DATA  *RxData
   )
 {
+  LIST_ENTRY          *DemuxList[2];
   LIST_ENTRY          *Entry;
   UDP4_INSTANCE_DATA  *Instance;
   UDP4_RXDATA_WRAP    *Wrap;
   UINTN               Enqueued;
+  UINTN               Index;
 
   Enqueued = 0;
 
-  NET_LIST_FOR_EACH (Entry, &Udp4Service->ChildrenList) {
-    //
-    // Iterate the instances.
-    //
-    Instance = NET_LIST_USER_STRUCT (Entry, UDP4_INSTANCE_DATA, Link);
-
-    if (!Instance->Configured) {
-      continue;
-    }
+  //
+  // Only the instances bound to the destination port and those accepting
+  // any port can accept this datagram.
+  //
+  DemuxList[0] = &Udp4Service->PortHash[UDP4_PORT_HASH (RxData->UdpSession.DestinationPort)];
+  DemuxList[1] = &Udp4Service->WildcardList;
 
-    if (Udp4MatchDgram (Instance, &RxData->UdpSession)) {
+  for (Index = 0; Index < 2; Index++) {
+    NET_LIST_FOR_EACH (Entry, DemuxList[Index]) {
       //
-      // Wrap the RxData and put this Wrap into the instances RcvdDgramQue.
+      // Iterate the instances.
       //
-      Wrap = Udp4WrapRxData (Instance, Packet, RxData);
-      if (Wrap == NULL) {
-        continue;
-      }
+      Instance = NET_LIST_USER_STRUCT (Entry, UDP4_INSTANCE_DATA, DemuxLink);
+      ASSERT (Instance->Configured);
+
+      Udp4Service->MatchNum++;
 
-      NET_GET_REF (Packet);
+      if (Udp4MatchDgram (Instance, &RxData->UdpSession)) {
+        //
+        // Wrap the RxData and put this Wrap into the instances RcvdDgramQue.
+        //
+        Wrap = Udp4WrapRxData (Instance, Packet, RxData);
+        if (Wrap == NULL) {
+          continue;
+        }
 
-      InsertTailList (&Instance->RcvdDgramQue, &Wrap->Link);
+        NET_GET_REF (Packet);
 
-      Enqueued++;
+        InsertTailList (&Instance->RcvdDgramQue, &Wrap->Link);
+
+        Enqueued++;
+      }
     }
   }
 
+  Udp4Service->EnqueuedDgramNum += Enqueued;
+
   return Enqueued;
 }
 
@@ -1554,33 +1628,39 @@ Udp4InstanceDeliverDgram (
 
 
 /**
-  This function delivers the datagrams enqueued in the instances.
+  This function delivers the datagrams enqueued in the instances that may
+  accept a datagram to the specified destination port.
 
   @param[in]  Udp4Service            Pointer to the udp service context data.
+  @param[in]  DestinationPort        The destination port of the enqueued datagram.
 
 **/
 VOID
 Udp4DeliverDgram (
-  IN UDP4_SERVICE_DATA  *Udp4Service
+  IN UDP4_SERVICE_DATA  *Udp4Service,
+  IN UINT16             DestinationPort
   )
 {
+  LIST_ENTRY          *DemuxList[2];
   LIST_ENTRY          *Entry;
   UDP4_INSTANCE_DATA  *Instance;
+  UINTN               Index;
 
-  NET_LIST_FOR_EACH (Entry, &Udp4Service->ChildrenList) {
-    //
-    // Iterate the instances.
-    //
-    Instance = NET_LIST_USER_STRUCT (Entry, UDP4_INSTANCE_DATA, Link);
+  DemuxList[0] = &Udp4Service->PortHash[UDP4_PORT_HASH (DestinationPort)];
+  DemuxList[1] = &Udp4Service->WildcardList;
 
-    if (!Instance->Configured) {
-      continue;
-    }
+  for (Index = 0; Index < 2; Index++) {
+    NET_LIST_FOR_EACH (Entry, DemuxList[Index]) {
+      //
+      // Iterate the instances.
+      //
+      Instance = NET_LIST_USER_STRUCT (Entry, UDP4_INSTANCE_DATA, DemuxLink);
 
-    //
-    // Deliver the datagrams of this instance.
-    //
-    Udp4InstanceDeliverDgram (Instance);
+      //
+      // Deliver the datagrams of this instance.
+      //
+      Udp4InstanceDeliverDgram (Instance);
+    }
   }
 }
 
@@ -1633,6 +1713,8 @@ Udp4Demultiplex (
     }
   }
 
+  Udp4Service->RcvdDgramNum++;
+
   Udp4Session                  = &RxData.UdpSession;
   Udp4Session->SourcePort      = NTOHS (Udp4Header->SrcPort);
   Udp4Session->DestinationPort = NTOHS (Udp4Header->DstPort);
@@ -1653,6 +1735,8 @@ Udp4Demultiplex (
   Enqueued = Udp4EnqueueDgram (Udp4Service, Packet, &RxData);
 
   if (Enqueued == 0) {
+    Udp4Service->NoPortDgramNum++;
+
     //
     // Send the port unreachable ICMP packet before we free this NET_BUF
     //
@@ -1668,7 +1752,7 @@ Udp4Demultiplex (
     //
     // Deliver the datagram.
     //
-    Udp4DeliverDgram (Udp4Service);
+    Udp4DeliverDgram (Udp4Service, Udp4Session->DestinationPort);
   }
 }
 
@@ -1794,8 +1878,10 @@ Udp4IcmpHandler (
 {
   EFI_UDP_HEADER        *Udp4Header;
   EFI_UDP4_SESSION_DATA  Udp4Session;
+  LIST_ENTRY             *DemuxList[2];
   LIST_ENTRY             *Entry;
   UDP4_INSTANCE_DATA     *Instance;
+  UINTN                  Index;
 
   Udp4Header = (EFI_UDP_HEADER *) NetbufGetByte (Packet, 0, NULL);
   ASSERT (Udp4Header != NULL);
@@ -1806,35 +1892,38 @@ Udp4IcmpHandler (
   Udp4Session.SourcePort      = NTOHS (Udp4Header->DstPort);
   Udp4Session.DestinationPort = NTOHS (Udp4Header->SrcPort);
 
-  NET_LIST_FOR_EACH (Entry, &Udp4Service->ChildrenList) {
-    //
-    // Iterate all the instances.
-    //
-    Instance = NET_LIST_USER_STRUCT (Entry, UDP4_INSTANCE_DATA, Link);
-
-    if (!Instance->Configured) {
-      continue;
-    }
+  DemuxList[0] = &Udp4Service->PortHash[UDP4_PORT_HASH (Udp4Session.DestinationPort)];
+  DemuxList[1] = &Udp4Service->WildcardList;
 
-    if (Udp4MatchDgram (Instance, &Udp4Session)) {
+  for (Index = 0; Index < 2; Index++) {
+    NET_LIST_FOR_EACH (Entry, DemuxList[Index]) {
       //
-      // Translate the Icmp Error code according to the udp spec.
+      // Iterate the instances that may own the datagram.
       //
-      Instance->IcmpError = IpIoGetIcmpErrStatus (IcmpError, IP_VERSION_4, NULL, NULL);
+      Instance = NET_LIST_USER_STRUCT (Entry, UDP4_INSTANCE_DATA, DemuxLink);
 
-      if (IcmpError > ICMP_ERR_UNREACH_PORT) {
-        Instance->IcmpError = EFI_ICMP_ERROR;
-      }
+      if (Udp4MatchDgram (Instance, &Udp4Session)) {
+        //
+        // Translate the Icmp Error code according to the udp spec.
+        //
+        Instance->IcmpError = IpIoGetIcmpErrStatus (IcmpError, IP_VERSION_4, NULL, NULL);
 
-      //
-      // Notify the instance with the received Icmp Error.
-      //
-      Udp4ReportIcmpError (Instance);
+        if (IcmpError > ICMP_ERR_UNREACH_PORT) {
+          Instance->IcmpError = EFI_ICMP_ERROR;
+        }
 
-      break;
+        //
+        // Notify the instance with the received Icmp Error.
+        //
+        Udp4ReportIcmpError (Instance);
+
+        goto ON_EXIT;
+      }
     }
   }
 
+ON_EXIT:
+
   NetbufFree (Packet);
 }
 
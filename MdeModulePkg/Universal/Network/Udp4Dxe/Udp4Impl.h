@@ -52,6 +52,14 @@ extern UINT16                          mUdp4RandomPort;
 
 #define UDP4_PORT_KNOWN       1024
 
+//
+// The configured instances bound to a station port are hashed by the port,
+// so that a received datagram is only matched against the instances of its
+// destination port and the instances accepting any port.
+//
+#define UDP4_PORT_HASH_SIZE   64
+#define UDP4_PORT_HASH(Port)  ((Port) & (UDP4_PORT_HASH_SIZE - 1))
+
 #define UDP4_SERVICE_DATA_SIGNATURE  SIGNATURE_32('U', 'd', 'p', '4')
 
 #define UDP4_SERVICE_DATA_FROM_THIS(a) \
@@ -72,6 +80,22 @@ typedef struct _UDP4_SERVICE_DATA_ {
   IP_IO                         *IpIo;
 
   EFI_EVENT                     TimeoutEvent;
+
+  //
+  // Configured instances, linked by their DemuxLink. The instances accepting
+  // any port or in promiscuous mode are on the WildcardList, the others are
+  // in the PortHash bucket of their station port.
+  //
+  LIST_ENTRY                    PortHash[UDP4_PORT_HASH_SIZE];
+  LIST_ENTRY                    WildcardList;
+
+  //
+  // Delivery statistics, reported when the service is cleaned.
+  //
+  UINT64                        RcvdDgramNum;       // Datagrams with a valid checksum
+  UINT64                        EnqueuedDgramNum;   // Copies queued to the instances
+  UINT64                        NoPortDgramNum;     // Datagrams no instance accepted
+  UINT64                        MatchNum;           // Instances checked by Udp4MatchDgram
 } UDP4_SERVICE_DATA;
 
 #define UDP4_INSTANCE_DATA_SIGNATURE  SIGNATURE_32('U', 'd', 'p', 'I')
@@ -87,6 +111,7 @@ typedef struct _UDP4_SERVICE_DATA_ {
 typedef struct _UDP4_INSTANCE_DATA_ {
   UINT32                Signature;
   LIST_ENTRY            Link;
+  LIST_ENTRY            DemuxLink;
 
   UDP4_SERVICE_DATA     *Udp4Service;
   EFI_UDP4_PROTOCOL     Udp4Proto;
@@ -491,6 +516,32 @@ Udp4Bind (
   IN OUT EFI_UDP4_CONFIG_DATA  *ConfigData
   );
 
+/**
+  This function links a configured udp instance into the demultiplexing lists
+  of the service, so that it receives the datagrams it accepts.
+
+  @param[in]  Udp4Service        Pointer to the udp service context data.
+  @param[in]  Instance           Pointer to the configured udp instance.
+
+**/
+VOID
+Udp4InsertDemuxInstance (
+  IN UDP4_SERVICE_DATA   *Udp4Service,
+  IN UDP4_INSTANCE_DATA  *Instance
+  );
+
+/**
+  This function unlinks a udp instance from the demultiplexing lists of the
+  service when the instance is reset.
+
+  @param[in]  Instance           Pointer to the udp instance.
+
+**/
+VOID
+Udp4RemoveDemuxInstance (
+  IN UDP4_INSTANCE_DATA  *Instance
+  );
+
 /**
   This function is used to check whether the NewConfigData has any un-reconfigurable
   parameters changed compared to the OldConfigData.
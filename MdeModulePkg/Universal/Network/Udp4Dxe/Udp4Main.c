@@ -255,11 +255,20 @@ Udp4Configure (
                             );
 
       Instance->Configured = TRUE;
+
+      //
+      // Start to demultiplex the received datagrams to this instance.
+      //
+      Udp4InsertDemuxInstance (Udp4Service, Instance);
     }
   } else {
     //
     // UdpConfigData is NULL, reset the instance.
     //
+    if (Instance->Configured) {
+      Udp4RemoveDemuxInstance (Instance);
+    }
+
     Instance->Configured  = FALSE;
     Instance->IsNoMapping = FALSE;
 
@@ -139,6 +139,7 @@ PxeBcParseCachedDhcpPacket (
   UINT8                   *Ptr8;
 
   CachedPacket->IsPxeOffer = FALSE;
+  CachedPacket->IsHttpOffer = FALSE;
   ZeroMem (CachedPacket->Dhcp4Option, sizeof (CachedPacket->Dhcp4Option));
   ZeroMem (&CachedPacket->PxeVendorOption, sizeof (CachedPacket->PxeVendorOption));
 
@@ -233,6 +234,13 @@ PxeBcParseCachedDhcpPacket (
 
   }
 
+  //
+  // A boot file name of the form http://server/path is downloaded by HTTP instead of TFTP.
+  //
+  if (Options[PXEBC_DHCP4_TAG_INDEX_BOOTFILE] != NULL) {
+    CachedPacket->IsHttpOffer = PxeBcIsHttpUri ((CHAR8 *) Options[PXEBC_DHCP4_TAG_INDEX_BOOTFILE]->Data);
+  }
+
   //
   // Determine offer type of the dhcp packet.
   //
@@ -278,6 +278,7 @@ typedef union {
 typedef struct {
   PXEBC_DHCP4_PACKET      Packet;
   BOOLEAN                 IsPxeOffer;
+  BOOLEAN                 IsHttpOffer;
   UINT8                   OfferType;
   EFI_DHCP4_PACKET_OPTION *Dhcp4Option[PXEBC_DHCP4_TAG_INDEX_MAX];
   PXEBC_VENDOR_OPTION    PxeVendorOption;
@@ -0,0 +1,919 @@
+/** @file
+  PxeBc HTTP functions.
+
+Copyright (c) 2014, Intel Corporation. All rights reserved.<BR>
+This program and the accompanying materials
+are licensed and made available under the terms and conditions of the BSD License
+which accompanies this distribution.  The full text of the license may be found at
+http://opensource.org/licenses/bsd-license.php
+
+THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#include "PxeBcImpl.h"
+
+
+/**
+  Check whether a string starts with a token, ignoring the case.
+
+  @param  Str            Pointer to the string.
+  @param  Token          Pointer to the token in lower case.
+
+  @retval TRUE           The string starts with the token.
+  @retval FALSE          The string does not start with the token.
+
+**/
+BOOLEAN
+PxeBcHttpMatchToken (
+  IN CHAR8                      *Str,
+  IN CHAR8                      *Token
+  )
+{
+  CHAR8 Char;
+
+  while (*Token != '\0') {
+    Char = *Str;
+    if ((Char >= 'A') && (Char <= 'Z')) {
+      Char = (CHAR8) (Char - 'A' + 'a');
+    }
+
+    if (Char != *Token) {
+      return FALSE;
+    }
+
+    Str++;
+    Token++;
+  }
+
+  return TRUE;
+}
+
+
+/**
+  Get the value of a header field if the line holds the field.
+
+  @param  Line           Pointer to the header line.
+  @param  Name           Pointer to the field name in lower case, with the colon.
+
+  @return Pointer to the value of the field, or NULL if it is another field.
+
+**/
+CHAR8 *
+PxeBcHttpGetField (
+  IN CHAR8                      *Line,
+  IN CHAR8                      *Name
+  )
+{
+  if (!PxeBcHttpMatchToken (Line, Name)) {
+    return NULL;
+  }
+
+  Line += AsciiStrLen (Name);
+  while ((*Line == ' ') || (*Line == '\t')) {
+    Line++;
+  }
+
+  return Line;
+}
+
+
+/**
+  Convert the decimal digits at the beginning of a string to a value.
+
+  @param  Str            On input, pointer to the string. On output, pointer
+                         to the first character after the digits.
+  @param  Value          Pointer to the value of the digits.
+
+  @retval TRUE           The digits are converted.
+  @retval FALSE          There are no digits at the beginning of the string.
+
+**/
+BOOLEAN
+PxeBcHttpGetNumber (
+  IN OUT CHAR8                  **Str,
+  OUT UINT64                    *Value
+  )
+{
+  CHAR8 *Ptr;
+
+  *Value = 0;
+
+  for (Ptr = *Str; (*Ptr >= '0') && (*Ptr <= '9'); Ptr++) {
+    *Value = MultU64x32 (*Value, 10) + (*Ptr - '0');
+  }
+
+  if (Ptr == *Str) {
+    return FALSE;
+  }
+
+  *Str = Ptr;
+  return TRUE;
+}
+
+
+/**
+  Check whether the boot file name is an HTTP URI.
+
+  @param  Name           Pointer to the boot file name.
+
+  @retval TRUE           The boot file name is an HTTP URI.
+  @retval FALSE          The boot file name is not an HTTP URI.
+
+**/
+BOOLEAN
+PxeBcIsHttpUri (
+  IN CHAR8                      *Name
+  )
+{
+  return PxeBcHttpMatchToken (Name, PXEBC_HTTP_URI_PREFIX);
+}
+
+
+/**
+  Parse an HTTP URI of the form http://host[:port]/path.
+
+  The host must be an IPv4 address in dotted decimal, the host names are
+  not supported as there is no name resolution here.
+
+  @param  Uri            Pointer to the HTTP URI.
+  @param  HttpUri        Pointer to the parsed URI.
+
+  @retval EFI_SUCCESS            The URI is parsed.
+  @retval EFI_INVALID_PARAMETER  The URI is malformed.
+  @retval EFI_UNSUPPORTED        The URI is not an HTTP URI with an IPv4 address.
+
+**/
+EFI_STATUS
+PxeBcHttpParseUri (
+  IN CHAR8                      *Uri,
+  OUT PXEBC_HTTP_URI            *HttpUri
+  )
+{
+  CHAR8   *Authority;
+  CHAR8   *Path;
+  CHAR8   *Port;
+  UINTN   Len;
+  UINT64  Value;
+  CHAR8   Name[PXEBC_HTTP_MAX_HOST_LEN];
+
+  if (!PxeBcIsHttpUri (Uri)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Authority = Uri + AsciiStrLen (PXEBC_HTTP_URI_PREFIX);
+  Path      = AsciiStrStr (Authority, "/");
+  Len       = (Path == NULL) ? AsciiStrLen (Authority) : (UINTN) (Path - Authority);
+
+  if ((Len == 0) || (Len >= PXEBC_HTTP_MAX_HOST_LEN)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  CopyMem (HttpUri->Host, Authority, Len);
+  HttpUri->Host[Len] = '\0';
+  HttpUri->Path      = (Path == NULL) ? "/" : Path;
+  HttpUri->Port      = PXEBC_HTTP_DEFAULT_PORT;
+
+  AsciiStrCpy (Name, HttpUri->Host);
+
+  Port = AsciiStrStr (Name, ":");
+  if (Port != NULL) {
+    *Port++ = '\0';
+
+    if (!PxeBcHttpGetNumber (&Port, &Value) || (*Port != '\0') ||
+        (Value == 0) || (Value > 0xFFFF)) {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    HttpUri->Port = (UINT16) Value;
+  }
+
+  if (EFI_ERROR (NetLibAsciiStrToIp4 (Name, &HttpUri->ServerIp))) {
+    return EFI_UNSUPPORTED;
+  }
+
+  return EFI_SUCCESS;
+}
+
+
+/**
+  Parse the status line and the header fields of the HTTP response.
+
+  @param  Conn           Pointer to the HTTP connection.
+
+  @retval EFI_SUCCESS            The response is valid for the request.
+  @retval EFI_NOT_FOUND          The server does not have the file.
+  @retval EFI_ACCESS_DENIED      The server refuses to send the file.
+  @retval EFI_UNSUPPORTED        The server ignored the range, or the response
+                                 uses a transfer coding not supported.
+  @retval EFI_PROTOCOL_ERROR     The response is malformed or unexpected.
+
+**/
+EFI_STATUS
+PxeBcHttpParseHeader (
+  IN PXEBC_HTTP_CONNECTION      *Conn
+  )
+{
+  CHAR8   *Line;
+  CHAR8   *Value;
+  UINT64  Code;
+  UINT64  RangeStart;
+  BOOLEAN GotLength;
+  BOOLEAN GotRange;
+
+  //
+  // Status line: HTTP/1.x SP Status-Code SP Reason-Phrase
+  //
+  Line = Conn->Header;
+  if (!PxeBcHttpMatchToken (Line, "http/1.") || (Line[8] != ' ')) {
+    return EFI_PROTOCOL_ERROR;
+  }
+
+  Line += 9;
+  if (!PxeBcHttpGetNumber (&Line, &Code)) {
+    return EFI_PROTOCOL_ERROR;
+  }
+
+  if ((Code == 404) || (Code == 410)) {
+    return EFI_NOT_FOUND;
+  } else if ((Code == 401) || (Code == 403)) {
+    return EFI_ACCESS_DENIED;
+  } else if ((Code != 200) && (Code != 206)) {
+    return EFI_PROTOCOL_ERROR;
+  }
+
+  GotLength  = FALSE;
+  GotRange   = FALSE;
+  RangeStart = 0;
+
+  //
+  // The header is terminated by an empty line.
+  //
+  for (Line = AsciiStrStr (Line, "\r\n") + 2; *Line != '\r'; Line = AsciiStrStr (Line, "\r\n") + 2) {
+
+    if ((Value = PxeBcHttpGetField (Line, "content-length:")) != NULL) {
+      GotLength = PxeBcHttpGetNumber (&Value, &Conn->ContentLength);
+
+    } else if ((Value = PxeBcHttpGetField (Line, "content-range:")) != NULL) {
+      //
+      // Content-Range: bytes first-last/total
+      //
+      if (PxeBcHttpMatchToken (Value, "bytes ")) {
+        Value += 6;
+        GotRange = PxeBcHttpGetNumber (&Value, &RangeStart);
+      }
+
+    } else if ((Value = PxeBcHttpGetField (Line, "accept-ranges:")) != NULL) {
+      Conn->AcceptRanges = PxeBcHttpMatchToken (Value, "bytes");
+
+    } else if ((Value = PxeBcHttpGetField (Line, "transfer-encoding:")) != NULL) {
+      if (!PxeBcHttpMatchToken (Value, "identity")) {
+        return EFI_UNSUPPORTED;
+      }
+    }
+  }
+
+  if (Conn->IsHead) {
+    //
+    // The file size is required to allocate the buffer.
+    //
+    return GotLength ? EFI_SUCCESS : EFI_UNSUPPORTED;
+  }
+
+  if (Code == 200) {
+    //
+    // The server ignored the range and sends the whole file.
+    //
+    if (Conn->IsRange) {
+      return EFI_UNSUPPORTED;
+    }
+  } else if (!Conn->IsRange || !GotRange || (RangeStart != Conn->Offset)) {
+    return EFI_PROTOCOL_ERROR;
+  }
+
+  if (GotLength && (Conn->ContentLength != Conn->Length)) {
+    return EFI_PROTOCOL_ERROR;
+  }
+
+  return EFI_SUCCESS;
+}
+
+
+/**
+  Post a receive token for the header or the body of the HTTP response.
+
+  The body is received directly into its place in the caller's buffer.
+
+  @param  Conn           Pointer to the HTTP connection.
+
+  @retval EFI_SUCCESS    The receive token is posted.
+  @retval Others         Failed to post the receive token.
+
+**/
+EFI_STATUS
+PxeBcHttpReceive (
+  IN PXEBC_HTTP_CONNECTION      *Conn
+  )
+{
+  EFI_TCP4_FRAGMENT_DATA  *Fragment;
+
+  Conn->RxData.UrgentFlag    = FALSE;
+  Conn->RxData.FragmentCount = 1;
+  Fragment                   = &Conn->RxData.FragmentTable[0];
+
+  if (Conn->State == PXEBC_HTTP_STATE_HEADER) {
+    Conn->RxData.DataLength  = (UINT32) (PXEBC_HTTP_HEADER_SIZE - Conn->HeaderLen);
+    Fragment->FragmentBuffer = Conn->Header + Conn->HeaderLen;
+  } else {
+    Conn->RxData.DataLength  = (UINT32) MIN (Conn->Length - Conn->Received, PXEBC_HTTP_RX_SIZE);
+    Fragment->FragmentBuffer = Conn->Buffer + Conn->Received;
+  }
+
+  Fragment->FragmentLength   = Conn->RxData.DataLength;
+
+  return Conn->Tcp4->Receive (Conn->Tcp4, &Conn->RxToken);
+}
+
+
+/**
+  Send the HTTP request of the connection.
+
+  @param  Conn           Pointer to the HTTP connection.
+  @param  HttpUri        Pointer to the parsed URI of the file.
+
+  @retval EFI_SUCCESS            The request is being sent.
+  @retval EFI_BUFFER_TOO_SMALL   The request is too long.
+  @retval Others                 Failed to send the request.
+
+**/
+EFI_STATUS
+PxeBcHttpSendRequest (
+  IN PXEBC_HTTP_CONNECTION      *Conn,
+  IN PXEBC_HTTP_URI             *HttpUri
+  )
+{
+  UINTN Len;
+
+  if (Conn->IsHead) {
+    Len = AsciiSPrint (
+            Conn->Request,
+            sizeof (Conn->Request),
+            "HEAD %a HTTP/1.1\r\nHost: %a\r\nConnection: close\r\n\r\n",
+            HttpUri->Path,
+            HttpUri->Host
+            );
+  } else if (Conn->IsRange) {
+    Len = AsciiSPrint (
+            Conn->Request,
+            sizeof (Conn->Request),
+            "GET %a HTTP/1.1\r\nHost: %a\r\nRange: bytes=%ld-%ld\r\nConnection: close\r\n\r\n",
+            HttpUri->Path,
+            HttpUri->Host,
+            Conn->Offset,
+            Conn->Offset + Conn->Length - 1
+            );
+  } else {
+    Len = AsciiSPrint (
+            Conn->Request,
+            sizeof (Conn->Request),
+            "GET %a HTTP/1.1\r\nHost: %a\r\nConnection: close\r\n\r\n",
+            HttpUri->Path,
+            HttpUri->Host
+            );
+  }
+
+  if (Len + 1 >= sizeof (Conn->Request)) {
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  Conn->TxData.Push                        = TRUE;
+  Conn->TxData.Urgent                      = FALSE;
+  Conn->TxData.DataLength                  = (UINT32) Len;
+  Conn->TxData.FragmentCount               = 1;
+  Conn->TxData.FragmentTable[0].FragmentLength = (UINT32) Len;
+  Conn->TxData.FragmentTable[0].FragmentBuffer = Conn->Request;
+
+  Conn->State = PXEBC_HTTP_STATE_REQUEST;
+
+  return Conn->Tcp4->Transmit (Conn->Tcp4, &Conn->TxToken);
+}
+
+
+/**
+  Advance the connection when its pending token is completed.
+
+  @param  Conn           Pointer to the HTTP connection.
+  @param  HttpUri        Pointer to the parsed URI of the file.
+
+  @retval EFI_SUCCESS    The connection is progressing or done.
+  @retval Others         The connection failed.
+
+**/
+EFI_STATUS
+PxeBcHttpProcess (
+  IN PXEBC_HTTP_CONNECTION      *Conn,
+  IN PXEBC_HTTP_URI             *HttpUri
+  )
+{
+  EFI_STATUS  Status;
+  CHAR8       *End;
+  UINTN       BodyLen;
+
+  switch (Conn->State) {
+  case PXEBC_HTTP_STATE_CONNECT:
+    if (!Conn->IsConnDone) {
+      return EFI_SUCCESS;
+    }
+
+    Conn->IsConnDone = FALSE;
+    if (EFI_ERROR (Conn->ConnToken.CompletionToken.Status)) {
+      return Conn->ConnToken.CompletionToken.Status;
+    }
+
+    return PxeBcHttpSendRequest (Conn, HttpUri);
+
+  case PXEBC_HTTP_STATE_REQUEST:
+    if (!Conn->IsTxDone) {
+      return EFI_SUCCESS;
+    }
+
+    Conn->IsTxDone = FALSE;
+    if (EFI_ERROR (Conn->TxToken.CompletionToken.Status)) {
+      return Conn->TxToken.CompletionToken.Status;
+    }
+
+    Conn->State = PXEBC_HTTP_STATE_HEADER;
+    return PxeBcHttpReceive (Conn);
+
+  case PXEBC_HTTP_STATE_HEADER:
+    if (!Conn->IsRxDone) {
+      return EFI_SUCCESS;
+    }
+
+    Conn->IsRxDone = FALSE;
+    Status         = Conn->RxToken.CompletionToken.Status;
+    if (EFI_ERROR (Status)) {
+      return (Status == EFI_CONNECTION_FIN) ? EFI_PROTOCOL_ERROR : Status;
+    }
+
+    Conn->HeaderLen += Conn->RxData.DataLength;
+    Conn->Header[Conn->HeaderLen] = '\0';
+
+    End = AsciiStrStr (Conn->Header, "\r\n\r\n");
+    if (End == NULL) {
+      if (Conn->HeaderLen == PXEBC_HTTP_HEADER_SIZE) {
+        return EFI_PROTOCOL_ERROR;
+      }
+
+      return PxeBcHttpReceive (Conn);
+    }
+
+    Status = PxeBcHttpParseHeader (Conn);
+    if (EFI_ERROR (Status) || Conn->IsHead) {
+      Conn->State = PXEBC_HTTP_STATE_DONE;
+      return Status;
+    }
+
+    //
+    // Move the beginning of the body received with the header.
+    //
+    End    += 4;
+    BodyLen = Conn->HeaderLen - (UINTN) (End - Conn->Header);
+    BodyLen = (UINTN) MIN (BodyLen, Conn->Length);
+
+    CopyMem (Conn->Buffer, End, BodyLen);
+    Conn->Received = BodyLen;
+
+    if (Conn->Received == Conn->Length) {
+      Conn->State = PXEBC_HTTP_STATE_DONE;
+      return EFI_SUCCESS;
+    }
+
+    Conn->State = PXEBC_HTTP_STATE_BODY;
+    return PxeBcHttpReceive (Conn);
+
+  case PXEBC_HTTP_STATE_BODY:
+    if (!Conn->IsRxDone) {
+      return EFI_SUCCESS;
+    }
+
+    Conn->IsRxDone = FALSE;
+    Status         = Conn->RxToken.CompletionToken.Status;
+    if (EFI_ERROR (Status)) {
+      return (Status == EFI_CONNECTION_FIN) ? EFI_PROTOCOL_ERROR : Status;
+    }
+
+    Conn->Received += Conn->RxData.DataLength;
+
+    if (Conn->Received >= Conn->Length) {
+      Conn->State = PXEBC_HTTP_STATE_DONE;
+      return EFI_SUCCESS;
+    }
+
+    return PxeBcHttpReceive (Conn);
+
+  default:
+    return EFI_SUCCESS;
+  }
+}
+
+
+/**
+  Create a TCP child, connect it to the HTTP server and start the request.
+
+  @param  Private        Pointer to PxeBc private data.
+  @param  HttpUri        Pointer to the parsed URI of the file.
+  @param  Conn           Pointer to the HTTP connection.
+
+  @retval EFI_SUCCESS    The connection is being established.
+  @retval Others         Failed to create or connect the TCP child.
+
+**/
+EFI_STATUS
+PxeBcHttpOpenConnection (
+  IN PXEBC_PRIVATE_DATA         *Private,
+  IN PXEBC_HTTP_URI             *HttpUri,
+  IN PXEBC_HTTP_CONNECTION      *Conn
+  )
+{
+  EFI_STATUS            Status;
+  EFI_TCP4_CONFIG_DATA  Tcp4CfgData;
+  EFI_TCP4_OPTION       ControlOption;
+
+  Status = NetLibCreateServiceChild (
+             Private->Controller,
+             Private->Image,
+             &gEfiTcp4ServiceBindingProtocolGuid,
+             &Conn->Handle
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = gBS->OpenProtocol (
+                  Conn->Handle,
+                  &gEfiTcp4ProtocolGuid,
+                  (VOID **) &Conn->Tcp4,
+                  Private->Image,
+                  Private->Controller,
+                  EFI_OPEN_PROTOCOL_BY_DRIVER
+                  );
+  if (EFI_ERROR (Status)) {
+    Conn->Tcp4 = NULL;
+    return Status;
+  }
+
+  ZeroMem (&ControlOption, sizeof (ControlOption));
+  ControlOption.ReceiveBufferSize   = PXEBC_HTTP_TCP_BUFFER_SIZE;
+  ControlOption.DataRetries         = 6;
+  ControlOption.KeepAliveProbes     = 4;
+  ControlOption.EnableWindowScaling = TRUE;
+  ControlOption.EnableSelectiveAck  = TRUE;
+
+  ZeroMem (&Tcp4CfgData, sizeof (Tcp4CfgData));
+  Tcp4CfgData.TypeOfService             = Private->Mode.ToS;
+  Tcp4CfgData.TimeToLive                = Private->Mode.TTL;
+  Tcp4CfgData.AccessPoint.RemotePort    = HttpUri->Port;
+  Tcp4CfgData.AccessPoint.ActiveFlag    = TRUE;
+  Tcp4CfgData.ControlOption             = &ControlOption;
+  CopyMem (&Tcp4CfgData.AccessPoint.StationAddress, &Private->StationIp, sizeof (EFI_IPv4_ADDRESS));
+  CopyMem (&Tcp4CfgData.AccessPoint.SubnetMask, &Private->SubnetMask, sizeof (EFI_IPv4_ADDRESS));
+  CopyMem (&Tcp4CfgData.AccessPoint.RemoteAddress, &HttpUri->ServerIp, sizeof (EFI_IPv4_ADDRESS));
+
+  Status = Conn->Tcp4->Configure (Conn->Tcp4, &Tcp4CfgData);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (!EFI_IP4_EQUAL (&Private->GatewayIp, &mZeroIp4Addr)) {
+    Status = Conn->Tcp4->Routes (
+                           Conn->Tcp4,
+                           FALSE,
+                           &mZeroIp4Addr,
+                           &mZeroIp4Addr,
+                           &Private->GatewayIp.v4
+                           );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  Status = gBS->CreateEvent (
+                  EVT_NOTIFY_SIGNAL,
+                  TPL_NOTIFY,
+                  PxeBcCommonNotify,
+                  &Conn->IsConnDone,
+                  &Conn->ConnToken.CompletionToken.Event
+                  );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = gBS->CreateEvent (
+                  EVT_NOTIFY_SIGNAL,
+                  TPL_NOTIFY,
+                  PxeBcCommonNotify,
+                  &Conn->IsTxDone,
+                  &Conn->TxToken.CompletionToken.Event
+                  );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = gBS->CreateEvent (
+                  EVT_NOTIFY_SIGNAL,
+                  TPL_NOTIFY,
+                  PxeBcCommonNotify,
+                  &Conn->IsRxDone,
+                  &Conn->RxToken.CompletionToken.Event
+                  );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Conn->TxToken.Packet.TxData = &Conn->TxData;
+  Conn->RxToken.Packet.RxData = &Conn->RxData;
+  Conn->State                 = PXEBC_HTTP_STATE_CONNECT;
+
+  return Conn->Tcp4->Connect (Conn->Tcp4, &Conn->ConnToken);
+}
+
+
+/**
+  Reset the connection and destroy its TCP child.
+
+  @param  Private        Pointer to PxeBc private data.
+  @param  Conn           Pointer to the HTTP connection.
+
+**/
+VOID
+PxeBcHttpCloseConnection (
+  IN PXEBC_PRIVATE_DATA         *Private,
+  IN PXEBC_HTTP_CONNECTION      *Conn
+  )
+{
+  if (Conn->Tcp4 != NULL) {
+    //
+    // Reset the connection, this also cancels the pending tokens.
+    //
+    Conn->Tcp4->Configure (Conn->Tcp4, NULL);
+
+    gBS->CloseProtocol (
+           Conn->Handle,
+           &gEfiTcp4ProtocolGuid,
+           Private->Image,
+           Private->Controller
+           );
+    Conn->Tcp4 = NULL;
+  }
+
+  if (Conn->ConnToken.CompletionToken.Event != NULL) {
+    gBS->CloseEvent (Conn->ConnToken.CompletionToken.Event);
+  }
+
+  if (Conn->TxToken.CompletionToken.Event != NULL) {
+    gBS->CloseEvent (Conn->TxToken.CompletionToken.Event);
+  }
+
+  if (Conn->RxToken.CompletionToken.Event != NULL) {
+    gBS->CloseEvent (Conn->RxToken.CompletionToken.Event);
+  }
+
+  if (Conn->Handle != NULL) {
+    NetLibDestroyServiceChild (
+      Private->Controller,
+      Private->Image,
+      &gEfiTcp4ServiceBindingProtocolGuid,
+      Conn->Handle
+      );
+    Conn->Handle = NULL;
+  }
+}
+
+
+/**
+  Run the HTTP requests of several connections at the same time until all
+  of them are done.
+
+  @param  Private        Pointer to PxeBc private data.
+  @param  HttpUri        Pointer to the parsed URI of the file.
+  @param  Conns          Pointer to the array of HTTP connections.
+  @param  Count          The number of HTTP connections.
+
+  @retval EFI_SUCCESS    All the connections are done.
+  @retval EFI_TIMEOUT    No connection has progressed in PXEBC_HTTP_TIMEOUT.
+  @retval Others         One of the connections failed.
+
+**/
+EFI_STATUS
+PxeBcHttpTransfer (
+  IN PXEBC_PRIVATE_DATA         *Private,
+  IN PXEBC_HTTP_URI             *HttpUri,
+  IN PXEBC_HTTP_CONNECTION      *Conns,
+  IN UINTN                      Count
+  )
+{
+  EFI_STATUS            Status;
+  EFI_EVENT             TimeoutEvent;
+  PXEBC_HTTP_CONNECTION *Conn;
+  UINTN                 Index;
+  BOOLEAN               Active;
+  BOOLEAN               Progress;
+  UINT8                 State;
+  UINT64                Received;
+
+  Status = gBS->CreateEvent (EVT_TIMER, TPL_CALLBACK, NULL, NULL, &TimeoutEvent);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  for (Index = 0; Index < Count; Index++) {
+    Status = PxeBcHttpOpenConnection (Private, HttpUri, &Conns[Index]);
+    if (EFI_ERROR (Status)) {
+      goto ON_EXIT;
+    }
+  }
+
+  gBS->SetTimer (TimeoutEvent, TimerRelative, PXEBC_HTTP_TIMEOUT);
+
+  do {
+    Active   = FALSE;
+    Progress = FALSE;
+
+    for (Index = 0; Index < Count; Index++) {
+      Conn = &Conns[Index];
+      if (Conn->State == PXEBC_HTTP_STATE_DONE) {
+        continue;
+      }
+
+      Active   = TRUE;
+      State    = Conn->State;
+      Received = Conn->Received + Conn->HeaderLen;
+
+      Conn->Tcp4->Poll (Conn->Tcp4);
+
+      Status = PxeBcHttpProcess (Conn, HttpUri);
+      if (EFI_ERROR (Status)) {
+        goto ON_EXIT;
+      }
+
+      if ((Conn->State != State) || (Conn->Received + Conn->HeaderLen != Received)) {
+        Progress = TRUE;
+      }
+    }
+
+    //
+    // The timeout is for the whole group to stall, a slow
+    // connection doesn't fail while the others are receiving.
+    //
+    if (Progress) {
+      gBS->SetTimer (TimeoutEvent, TimerRelative, PXEBC_HTTP_TIMEOUT);
+    } else if (Active && !EFI_ERROR (gBS->CheckEvent (TimeoutEvent))) {
+      Status = EFI_TIMEOUT;
+      goto ON_EXIT;
+    }
+  } while (Active);
+
+  Status = EFI_SUCCESS;
+
+ON_EXIT:
+  for (Index = 0; Index < Count; Index++) {
+    PxeBcHttpCloseConnection (Private, &Conns[Index]);
+  }
+
+  gBS->CloseEvent (TimeoutEvent);
+
+  return Status;
+}
+
+
+/**
+  This function is to get size of a file by HTTP.
+
+  @param  Private        Pointer to PxeBc private data
+  @param  Uri            Pointer to the HTTP URI of the file
+  @param  FileSize       Pointer to the size of the file
+  @param  AcceptRanges   Pointer to whether the server accepts range requests
+
+  @retval EFI_SUCCESS        Get the size of the file success.
+  @retval EFI_UNSUPPORTED    The URI or the response is not supported.
+  @retval EFI_NOT_FOUND      The server does not have the file.
+  @retval EFI_TIMEOUT        The server does not respond.
+  @retval Other              Has not get the size of the file.
+
+**/
+EFI_STATUS
+PxeBcHttpGetFileSize (
+  IN PXEBC_PRIVATE_DATA         *Private,
+  IN CHAR8                      *Uri,
+  OUT UINT64                    *FileSize,
+  OUT BOOLEAN                   *AcceptRanges
+  )
+{
+  PXEBC_HTTP_URI        HttpUri;
+  PXEBC_HTTP_CONNECTION *Conn;
+  EFI_STATUS            Status;
+
+  Status = PxeBcHttpParseUri (Uri, &HttpUri);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Conn = AllocateZeroPool (sizeof (PXEBC_HTTP_CONNECTION));
+  if (Conn == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Conn->IsHead = TRUE;
+
+  Status = PxeBcHttpTransfer (Private, &HttpUri, Conn, 1);
+  if (!EFI_ERROR (Status)) {
+    *FileSize     = Conn->ContentLength;
+    *AcceptRanges = Conn->AcceptRanges;
+  }
+
+  FreePool (Conn);
+
+  return Status;
+}
+
+
+/**
+  This function is to get data of a file by HTTP.
+
+  If the server accepts range requests, the file is split into ranges
+  downloaded on several connections at the same time.
+
+  @param  Private        Pointer to PxeBc private data
+  @param  Uri            Pointer to the HTTP URI of the file
+  @param  FileSize       The size of the file
+  @param  AcceptRanges   Whether the server accepts range requests
+  @param  BufferPtr      Pointer to the buffer of at least FileSize bytes
+
+  @retval EFI_SUCCESS        Read the data success from the file.
+  @retval EFI_TIMEOUT        The server does not respond.
+  @retval other              Read data from file failed.
+
+**/
+EFI_STATUS
+PxeBcHttpReadFile (
+  IN PXEBC_PRIVATE_DATA         *Private,
+  IN CHAR8                      *Uri,
+  IN UINT64                     FileSize,
+  IN BOOLEAN                    AcceptRanges,
+  IN UINT8                      *BufferPtr
+  )
+{
+  PXEBC_HTTP_URI        HttpUri;
+  PXEBC_HTTP_CONNECTION *Conns;
+  EFI_STATUS            Status;
+  UINTN                 Count;
+  UINTN                 Index;
+  UINT64                RangeSize;
+
+  Status = PxeBcHttpParseUri (Uri, &HttpUri);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Don't split small files, the ranges wouldn't get
+  // enough time to open their congestion windows.
+  //
+  Count = 1;
+  if (AcceptRanges) {
+    Count = (UINTN) MIN (
+                      DivU64x32 (FileSize, PXEBC_HTTP_MIN_RANGE_SIZE),
+                      MIN (PcdGet8 (PcdHttpBootConnections), PXEBC_HTTP_MAX_CONNECTION)
+                      );
+    Count = MAX (Count, 1);
+  }
+
+  Conns = AllocateZeroPool (Count * sizeof (PXEBC_HTTP_CONNECTION));
+  if (Conns == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  RangeSize = DivU64x32 (FileSize, (UINT32) Count);
+
+  for (Index = 0; Index < Count; Index++) {
+    Conns[Index].IsRange = (BOOLEAN) (Count > 1);
+    Conns[Index].Offset  = MultU64x32 (RangeSize, (UINT32) Index);
+    Conns[Index].Length  = (Index == Count - 1) ? (FileSize - Conns[Index].Offset) : RangeSize;
+    Conns[Index].Buffer  = BufferPtr + Conns[Index].Offset;
+  }
+
+  Status = PxeBcHttpTransfer (Private, &HttpUri, Conns, Count);
+
+  FreePool (Conns);
+
+  if ((Status == EFI_UNSUPPORTED) && (Count > 1)) {
+    //
+    // The server ignored the ranges, download the file on one connection.
+    //
+    Status = PxeBcHttpReadFile (Private, Uri, FileSize, FALSE, BufferPtr);
+  }
+
+  return Status;
+}
@@ -0,0 +1,144 @@
+/** @file
+  HTTP routines for PxeBc to download the boot file from an HTTP server.
+
+Copyright (c) 2014, Intel Corporation. All rights reserved.<BR>
+This program and the accompanying materials
+are licensed and made available under the terms and conditions of the BSD License
+which accompanies this distribution.  The full text of the license may be found at
+http://opensource.org/licenses/bsd-license.php
+
+THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#ifndef __EFI_PXEBC_HTTP_H__
+#define __EFI_PXEBC_HTTP_H__
+
+#define PXEBC_HTTP_URI_PREFIX           "http://"
+#define PXEBC_HTTP_DEFAULT_PORT         80
+#define PXEBC_HTTP_MAX_HOST_LEN         64
+#define PXEBC_HTTP_MAX_CONNECTION       8
+#define PXEBC_HTTP_MIN_RANGE_SIZE       SIZE_1MB
+#define PXEBC_HTTP_REQUEST_SIZE         512
+#define PXEBC_HTTP_HEADER_SIZE          2048
+#define PXEBC_HTTP_RX_SIZE              SIZE_1MB
+#define PXEBC_HTTP_TCP_BUFFER_SIZE      0x200000
+#define PXEBC_HTTP_TIMEOUT              (10 * TICKS_PER_SECOND)
+
+//
+// The states of an HTTP connection.
+//
+#define PXEBC_HTTP_STATE_CONNECT        0
+#define PXEBC_HTTP_STATE_REQUEST        1
+#define PXEBC_HTTP_STATE_HEADER         2
+#define PXEBC_HTTP_STATE_BODY           3
+#define PXEBC_HTTP_STATE_DONE           4
+
+typedef struct {
+  EFI_IPv4_ADDRESS            ServerIp;
+  UINT16                      Port;
+  CHAR8                       Host[PXEBC_HTTP_MAX_HOST_LEN];
+  CHAR8                       *Path;
+} PXEBC_HTTP_URI;
+
+//
+// One TCP connection to the HTTP server. A download may use several of
+// them at the same time, each requesting a range of the file and
+// receiving it directly into its place in the caller's buffer.
+//
+typedef struct {
+  EFI_HANDLE                  Handle;
+  EFI_TCP4_PROTOCOL           *Tcp4;
+  UINT8                       State;
+  BOOLEAN                     IsHead;
+  BOOLEAN                     IsRange;
+  BOOLEAN                     AcceptRanges;
+  UINT64                      Offset;
+  UINT64                      Length;
+  UINT64                      Received;
+  UINT64                      ContentLength;
+  UINT8                       *Buffer;
+
+  EFI_TCP4_CONNECTION_TOKEN   ConnToken;
+  EFI_TCP4_IO_TOKEN           TxToken;
+  EFI_TCP4_TRANSMIT_DATA      TxData;
+  EFI_TCP4_IO_TOKEN           RxToken;
+  EFI_TCP4_RECEIVE_DATA       RxData;
+  BOOLEAN                     IsConnDone;
+  BOOLEAN                     IsTxDone;
+  BOOLEAN                     IsRxDone;
+
+  CHAR8                       Request[PXEBC_HTTP_REQUEST_SIZE];
+  UINTN                       HeaderLen;
+  CHAR8                       Header[PXEBC_HTTP_HEADER_SIZE + 1];
+} PXEBC_HTTP_CONNECTION;
+
+
+/**
+  Check whether the boot file name is an HTTP URI.
+
+  @param  Name           Pointer to the boot file name.
+
+  @retval TRUE           The boot file name is an HTTP URI.
+  @retval FALSE          The boot file name is not an HTTP URI.
+
+**/
+BOOLEAN
+PxeBcIsHttpUri (
+  IN CHAR8                      *Name
+  );
+
+
+/**
+  This function is to get size of a file by HTTP.
+
+  @param  Private        Pointer to PxeBc private data
+  @param  Uri            Pointer to the HTTP URI of the file
+  @param  FileSize       Pointer to the size of the file
+  @param  AcceptRanges   Pointer to whether the server accepts range requests
+
+  @retval EFI_SUCCESS        Get the size of the file success.
+  @retval EFI_UNSUPPORTED    The URI or the response is not supported.
+  @retval EFI_NOT_FOUND      The server does not have the file.
+  @retval EFI_TIMEOUT        The server does not respond.
+  @retval Other              Has not get the size of the file.
+
+**/
+EFI_STATUS
+PxeBcHttpGetFileSize (
+  IN PXEBC_PRIVATE_DATA         *Private,
+  IN CHAR8                      *Uri,
+  OUT UINT64                    *FileSize,
+  OUT BOOLEAN                   *AcceptRanges
+  );
+
+
+/**
+  This function is to get data of a file by HTTP.
+
+  If the server accepts range requests, the file is split into ranges
+  downloaded on several connections at the same time.
+
+  @param  Private        Pointer to PxeBc private data
+  @param  Uri            Pointer to the HTTP URI of the file
+  @param  FileSize       The size of the file
+  @param  AcceptRanges   Whether the server accepts range requests
+  @param  BufferPtr      Pointer to the buffer of at least FileSize bytes
+
+  @retval EFI_SUCCESS        Read the data success from the file.
+  @retval EFI_TIMEOUT        The server does not respond.
+  @retval other              Read data from file failed.
+
+**/
+EFI_STATUS
+PxeBcHttpReadFile (
+  IN PXEBC_PRIVATE_DATA         *Private,
+  IN CHAR8                      *Uri,
+  IN UINT64                     FileSize,
+  IN BOOLEAN                    AcceptRanges,
+  IN UINT8                      *BufferPtr
+  );
+
+#endif
+
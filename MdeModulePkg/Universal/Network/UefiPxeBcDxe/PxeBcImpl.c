@@ -2585,7 +2585,7 @@ EFI_PXE_BASE_CODE_CALLBACK_PROTOCOL mPxeBcCallBackTemplate = {
   @param  Buffer       Pointer to buffer.
 
   @retval EFI_SUCCESS          Discover the boot file successfully.
-  @retval EFI_TIMEOUT          The TFTP/MTFTP operation timed out.
+  @retval EFI_TIMEOUT          The TFTP/MTFTP/HTTP operation timed out.
   @retval EFI_ABORTED          PXE bootstrap server, so local boot need abort.
   @retval EFI_BUFFER_TOO_SMALL The buffer is too small to load the boot file.
 
@@ -2687,8 +2687,20 @@ DiscoverBootFile (
   // bootlfile name
   //
   Private->BootFileName = (CHAR8 *) (Packet->Dhcp4Option[PXEBC_DHCP4_TAG_INDEX_BOOTFILE]->Data);
+  Private->IsHttpBoot   = Packet->IsHttpOffer;
 
-  if (Packet->Dhcp4Option[PXEBC_DHCP4_TAG_INDEX_BOOTFILE_LEN] != NULL) {
+  if (Private->IsHttpBoot) {
+    //
+    // Get the bootfile size from the HTTP server, the file size is needed even
+    // with the bootfile length option to split the file into ranges.
+    //
+    Status = PxeBcHttpGetFileSize (
+               Private,
+               Private->BootFileName,
+               BufferSize,
+               &Private->HttpAcceptRanges
+               );
+  } else if (Packet->Dhcp4Option[PXEBC_DHCP4_TAG_INDEX_BOOTFILE_LEN] != NULL) {
     //
     // Already have the bootfile length option, compute the file size
     //
@@ -2719,6 +2731,62 @@ DiscoverBootFile (
   return Status;
 }
 
+
+/**
+  Download the boot file by HTTP or TFTP into the buffer.
+
+  @param  Private      Pointer to PxeBc private data.
+  @param  BufferSize   On input the size of Buffer, on output the size of the
+                       data transferred to Buffer.
+  @param  Buffer       Pointer to buffer.
+
+  @retval EFI_SUCCESS          The boot file is downloaded.
+  @retval EFI_BUFFER_TOO_SMALL The buffer is too small to load the boot file.
+  @retval Others               Failed to download the boot file.
+
+**/
+EFI_STATUS
+PxeBcReadBootFile (
+  IN     PXEBC_PRIVATE_DATA  *Private,
+  IN OUT UINT64              *BufferSize,
+  IN     VOID                *Buffer
+  )
+{
+  EFI_PXE_BASE_CODE_PROTOCOL  *PxeBc;
+
+  PxeBc = &Private->PxeBc;
+
+  if (Private->IsHttpBoot) {
+    if (*BufferSize < Private->FileSize) {
+      *BufferSize = Private->FileSize;
+      return EFI_BUFFER_TOO_SMALL;
+    }
+
+    *BufferSize = Private->FileSize;
+
+    return PxeBcHttpReadFile (
+             Private,
+             Private->BootFileName,
+             Private->FileSize,
+             Private->HttpAcceptRanges,
+             Buffer
+             );
+  }
+
+  return PxeBc->Mtftp (
+                  PxeBc,
+                  EFI_PXE_BASE_CODE_TFTP_READ_FILE,
+                  Buffer,
+                  FALSE,
+                  BufferSize,
+                  &Private->BlockSize,
+                  &Private->ServerIp,
+                  (UINT8 *) Private->BootFileName,
+                  NULL,
+                  FALSE
+                  );
+}
+
 /**
   Causes the driver to load a specified file.
 
@@ -2828,18 +2896,7 @@ EfiPxeLoadFile (
       Status = EFI_DEVICE_ERROR;
     } else if (TmpBufSize > 0 && *BufferSize >= (UINTN) TmpBufSize && Buffer != NULL) {
       *BufferSize = (UINTN) TmpBufSize;
-      Status = PxeBc->Mtftp (
-                        PxeBc,
-                        EFI_PXE_BASE_CODE_TFTP_READ_FILE,
-                        Buffer,
-                        FALSE,
-                        &TmpBufSize,
-                        &Private->BlockSize,
-                        &Private->ServerIp,
-                        (UINT8 *) Private->BootFileName,
-                        NULL,
-                        FALSE
-                        );
+      Status = PxeBcReadBootFile (Private, &TmpBufSize, Buffer);
     } else if (TmpBufSize > 0) {
       *BufferSize = (UINTN) TmpBufSize;
       Status      = EFI_BUFFER_TOO_SMALL;
@@ -2852,18 +2909,7 @@ EfiPxeLoadFile (
     // Download the file.
     //
     TmpBufSize = (UINT64) (*BufferSize);
-    Status = PxeBc->Mtftp (
-                      PxeBc,
-                      EFI_PXE_BASE_CODE_TFTP_READ_FILE,
-                      Buffer,
-                      FALSE,
-                      &TmpBufSize,
-                      &Private->BlockSize,
-                      &Private->ServerIp,
-                      (UINT8 *) Private->BootFileName,
-                      NULL,
-                      FALSE
-                      );
+    Status = PxeBcReadBootFile (Private, &TmpBufSize, Buffer);
   }
   //
   // If we added a callback protocol, now is the time to remove it.
@@ -30,6 +30,7 @@ typedef struct _PXEBC_PRIVATE_DATA  PXEBC_PRIVATE_DATA;
 #include <Protocol/PxeBaseCodeCallBack.h>
 #include <Protocol/Arp.h>
 #include <Protocol/Ip4.h>
+#include <Protocol/Tcp4.h>
 
 #include <Library/DebugLib.h>
 #include <Library/BaseMemoryLib.h>
@@ -41,10 +42,12 @@ typedef struct _PXEBC_PRIVATE_DATA  PXEBC_PRIVATE_DATA;
 #include <Library/NetLib.h>
 #include <Library/DpcLib.h>
 #include <Library/PcdLib.h>
+#include <Library/PrintLib.h>
 
 #include "PxeBcDriver.h"
 #include "PxeBcDhcp.h"
 #include "PxeBcMtftp.h"
+#include "PxeBcHttp.h"
 #include "PxeBcSupport.h"
 
 #define PXEBC_PRIVATE_DATA_SIGNATURE  SIGNATURE_32 ('P', 'X', 'E', 'P')
@@ -96,6 +99,8 @@ struct _PXEBC_PRIVATE_DATA {
   UINT32                                    Ip4MaxPacketSize;
   UINTN                                     BlockSize;
   UINTN                                     FileSize;
+  BOOLEAN                                   IsHttpBoot;
+  BOOLEAN                                   HttpAcceptRanges;
 
   UINT8                                     OptionBuffer[PXEBC_DHCP4_MAX_OPTION_SIZE];
   EFI_DHCP4_PACKET                          SeedPacket;
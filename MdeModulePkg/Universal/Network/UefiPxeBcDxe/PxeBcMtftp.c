@@ -18,7 +18,8 @@ CHAR8 *mMtftpOptions[PXE_MTFTP_OPTION_MAXIMUM_INDEX] = {
   "blksize",
   "timeout",
   "tsize",
-  "multicast"
+  "multicast",
+  "windowsize"
 };
 
 
@@ -239,7 +240,7 @@ PxeBcTftpReadFile (
 {
   EFI_MTFTP4_PROTOCOL *Mtftp4;
   EFI_MTFTP4_TOKEN    Token;
-  EFI_MTFTP4_OPTION   ReqOpt[1];
+  EFI_MTFTP4_OPTION   ReqOpt[2];
   UINT32              OptCnt;
   UINT8               OptBuf[128];
   EFI_STATUS          Status;
@@ -263,6 +264,16 @@ PxeBcTftpReadFile (
     OptCnt++;
   }
 
+  //
+  // Ask the server to send a window of blocks for each ACK.
+  //
+  if (PcdGet64 (PcdTftpWindowSize) > 1) {
+    ReqOpt[OptCnt].OptionStr = (UINT8*) mMtftpOptions[PXE_MTFTP_OPTION_WINDOWSIZE_INDEX];
+    ReqOpt[OptCnt].ValueStr  = (OptCnt == 0) ? OptBuf : (ReqOpt[0].ValueStr + AsciiStrLen ((CHAR8 *) ReqOpt[0].ValueStr) + 1);
+    UtoA10 ((UINTN) PcdGet64 (PcdTftpWindowSize), (CHAR8 *) ReqOpt[OptCnt].ValueStr);
+    OptCnt++;
+  }
+
   Token.Event         = NULL;
   Token.OverrideData  = NULL;
   Token.Filename      = Filename;
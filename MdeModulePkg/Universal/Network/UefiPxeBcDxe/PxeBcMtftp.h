@@ -15,11 +15,12 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #ifndef __EFI_PXEBC_MTFTP_H__
 #define __EFI_PXEBC_MTFTP_H__
 
-#define PXE_MTFTP_OPTION_BLKSIZE_INDEX   0
-#define PXE_MTFTP_OPTION_TIMEOUT_INDEX   1
-#define PXE_MTFTP_OPTION_TSIZE_INDEX     2
-#define PXE_MTFTP_OPTION_MULTICAST_INDEX 3
-#define PXE_MTFTP_OPTION_MAXIMUM_INDEX   4
+#define PXE_MTFTP_OPTION_BLKSIZE_INDEX    0
+#define PXE_MTFTP_OPTION_TIMEOUT_INDEX    1
+#define PXE_MTFTP_OPTION_TSIZE_INDEX      2
+#define PXE_MTFTP_OPTION_MULTICAST_INDEX  3
+#define PXE_MTFTP_OPTION_WINDOWSIZE_INDEX 4
+#define PXE_MTFTP_OPTION_MAXIMUM_INDEX    5
 
 
 /**
@@ -2326,6 +2326,308 @@ Done:
   return GetTheVal;
 }
 
+/**
+  Search a Question in Formset scope using its QuestionId, without reloading
+  its value.
+
+  @param  FormSet                The formset which contains this form.
+  @param  Form                   The form which contains this Question.
+  @param  QuestionId             Id of this Question.
+
+  @retval Pointer                The Question.
+  @retval NULL                   Specified Question not found in the formset.
+
+**/
+FORM_BROWSER_STATEMENT *
+LookupExpressionQuestion (
+  IN FORM_BROWSER_FORMSET  *FormSet,
+  IN FORM_BROWSER_FORM     *Form,
+  IN UINT16                QuestionId
+  )
+{
+  LIST_ENTRY              *Link;
+  FORM_BROWSER_STATEMENT  *Question;
+
+  Question = IdToQuestion2 (Form, QuestionId);
+  if (Question != NULL) {
+    return Question;
+  }
+
+  Link = GetFirstNode (&FormSet->FormListHead);
+  while (!IsNull (&FormSet->FormListHead, Link)) {
+    Question = IdToQuestion2 (FORM_BROWSER_FORM_FROM_LINK (Link), QuestionId);
+    if (Question != NULL) {
+      return Question;
+    }
+
+    Link = GetNextNode (&FormSet->FormListHead, Link);
+  }
+
+  return NULL;
+}
+
+/**
+  Add the value of a Question to the inputs of a cacheable expression.
+
+  @param  FormSet                FormSet associated with this expression.
+  @param  Form                   Form associated with this expression.
+  @param  Expression             Expression being compiled.
+  @param  QuestionId             Id of the Question read by the expression.
+
+  @retval TRUE                   The Question value was added to the inputs.
+  @retval FALSE                  The Question is not found, or its value may change
+                                 without its HiiValue changing, so the expression
+                                 can't be cached.
+
+**/
+BOOLEAN
+AddExpressionInput (
+  IN     FORM_BROWSER_FORMSET  *FormSet,
+  IN     FORM_BROWSER_FORM     *Form,
+  IN OUT FORM_EXPRESSION       *Expression,
+  IN     UINT16                QuestionId
+  )
+{
+  FORM_BROWSER_STATEMENT  *Question;
+
+  Question = LookupExpressionQuestion (FormSet, Form, QuestionId);
+  if (Question == NULL) {
+    return FALSE;
+  }
+
+  //
+  // EFI variable storage may be updated by Callback() asynchronous, so its
+  // Questions are reloaded on every evaluation. String and buffer values are
+  // only referenced by HiiValue and may change in place.
+  //
+  if (Question->Storage != NULL && Question->Storage->Type == EFI_HII_VARSTORE_EFI_VARIABLE) {
+    return FALSE;
+  }
+  if (Question->HiiValue.Type == EFI_IFR_TYPE_STRING || Question->HiiValue.Type == EFI_IFR_TYPE_BUFFER) {
+    return FALSE;
+  }
+
+  Expression->Input[Expression->InputCount++].QuestionValue = &Question->HiiValue;
+  return TRUE;
+}
+
+/**
+  Compile an expression before its first evaluation.
+
+  The OpCodes of the expression are scanned once. When all of them only compute
+  on constants and on the values of Questions, the Questions are resolved and
+  kept in the inputs of the expression, and its result is reused for as long as
+  the values of these Questions don't change. Otherwise the expression is
+  evaluated every time.
+
+  @param  FormSet                FormSet associated with this expression.
+  @param  Form                   Form associated with this expression.
+  @param  Expression             Expression to be compiled.
+
+**/
+VOID
+CompileExpression (
+  IN     FORM_BROWSER_FORMSET  *FormSet,
+  IN     FORM_BROWSER_FORM     *Form,
+  IN OUT FORM_EXPRESSION       *Expression
+  )
+{
+  LIST_ENTRY              *Link;
+  EXPRESSION_OPCODE       *OpCode;
+  UINTN                   InputNum;
+  BOOLEAN                 Cacheable;
+
+  if (Expression->Input != NULL) {
+    FreePool (Expression->Input);
+    Expression->Input = NULL;
+  }
+  Expression->InputCount      = 0;
+  Expression->ResultValid     = FALSE;
+  Expression->CompiledFormSet = FormSet;
+  Expression->CompiledForm    = Form;
+  Expression->CompileState    = EXPRESSION_NOT_CACHEABLE;
+
+  //
+  // Check the OpCodes and count the Question values they read.
+  //
+  InputNum  = 0;
+  Cacheable = TRUE;
+  Link = GetFirstNode (&Expression->OpCodeListHead);
+  while (Cacheable && !IsNull (&Expression->OpCodeListHead, Link)) {
+    OpCode = EXPRESSION_OPCODE_FROM_LINK (Link);
+    Link = GetNextNode (&Expression->OpCodeListHead, Link);
+
+    switch (OpCode->Operand) {
+    case EFI_IFR_EQ_ID_VAL_OP:
+    case EFI_IFR_EQ_ID_VAL_LIST_OP:
+    case EFI_IFR_QUESTION_REF1_OP:
+    case EFI_IFR_THIS_OP:
+      InputNum++;
+      break;
+
+    case EFI_IFR_EQ_ID_ID_OP:
+      InputNum += 2;
+      break;
+
+    case EFI_IFR_DUP_OP:
+    case EFI_IFR_TRUE_OP:
+    case EFI_IFR_FALSE_OP:
+    case EFI_IFR_ONE_OP:
+    case EFI_IFR_ONES_OP:
+    case EFI_IFR_UINT8_OP:
+    case EFI_IFR_UINT16_OP:
+    case EFI_IFR_UINT32_OP:
+    case EFI_IFR_UINT64_OP:
+    case EFI_IFR_UNDEFINED_OP:
+    case EFI_IFR_VERSION_OP:
+    case EFI_IFR_ZERO_OP:
+    case EFI_IFR_NOT_OP:
+    case EFI_IFR_TO_BOOLEAN_OP:
+    case EFI_IFR_TO_UINT_OP:
+    case EFI_IFR_BITWISE_NOT_OP:
+    case EFI_IFR_ADD_OP:
+    case EFI_IFR_SUBTRACT_OP:
+    case EFI_IFR_MULTIPLY_OP:
+    case EFI_IFR_DIVIDE_OP:
+    case EFI_IFR_MODULO_OP:
+    case EFI_IFR_BITWISE_AND_OP:
+    case EFI_IFR_BITWISE_OR_OP:
+    case EFI_IFR_SHIFT_LEFT_OP:
+    case EFI_IFR_SHIFT_RIGHT_OP:
+    case EFI_IFR_AND_OP:
+    case EFI_IFR_OR_OP:
+    case EFI_IFR_EQUAL_OP:
+    case EFI_IFR_NOT_EQUAL_OP:
+    case EFI_IFR_GREATER_EQUAL_OP:
+    case EFI_IFR_GREATER_THAN_OP:
+    case EFI_IFR_LESS_EQUAL_OP:
+    case EFI_IFR_LESS_THAN_OP:
+    case EFI_IFR_CONDITIONAL_OP:
+      break;
+
+    default:
+      //
+      // Storage access, string, security, rule and map OpCodes depend on more
+      // than the Question values.
+      //
+      Cacheable = FALSE;
+      break;
+    }
+  }
+
+  if (!Cacheable || InputNum == 0) {
+    //
+    // An expression of constants is cheap to evaluate, and it's not worth to
+    // keep an input list for it.
+    //
+    return;
+  }
+
+  Expression->Input = AllocateZeroPool (InputNum * sizeof (EXPRESSION_INPUT));
+  if (Expression->Input == NULL) {
+    return;
+  }
+
+  //
+  // Resolve the Questions read by the OpCodes.
+  //
+  Link = GetFirstNode (&Expression->OpCodeListHead);
+  while (!IsNull (&Expression->OpCodeListHead, Link)) {
+    OpCode = EXPRESSION_OPCODE_FROM_LINK (Link);
+    Link = GetNextNode (&Expression->OpCodeListHead, Link);
+
+    switch (OpCode->Operand) {
+    case EFI_IFR_EQ_ID_ID_OP:
+      if (!AddExpressionInput (FormSet, Form, Expression, OpCode->QuestionId2)) {
+        Cacheable = FALSE;
+      }
+      //
+      // Fall through to add the first Question.
+      //
+    case EFI_IFR_EQ_ID_VAL_OP:
+    case EFI_IFR_EQ_ID_VAL_LIST_OP:
+    case EFI_IFR_QUESTION_REF1_OP:
+    case EFI_IFR_THIS_OP:
+      if (!AddExpressionInput (FormSet, Form, Expression, OpCode->QuestionId)) {
+        Cacheable = FALSE;
+      }
+      break;
+
+    default:
+      break;
+    }
+
+    if (!Cacheable) {
+      FreePool (Expression->Input);
+      Expression->Input      = NULL;
+      Expression->InputCount = 0;
+      return;
+    }
+  }
+
+  Expression->CompileState = EXPRESSION_CACHEABLE;
+}
+
+/**
+  Check whether the values of the Questions read by a cacheable expression are
+  the same as when its result was evaluated.
+
+  @param  Expression             The compiled expression.
+
+  @retval TRUE                   The Question values didn't change.
+  @retval FALSE                  At least one Question value changed.
+
+**/
+BOOLEAN
+IsExpressionInputUnchanged (
+  IN FORM_EXPRESSION  *Expression
+  )
+{
+  UINTN             Index;
+  EXPRESSION_INPUT  *Input;
+
+  for (Index = 0; Index < Expression->InputCount; Index++) {
+    Input = &Expression->Input[Index];
+    if (Input->QuestionValue->Type != Input->Value.Type ||
+        CompareMem (&Input->QuestionValue->Value, &Input->Value.Value, sizeof (EFI_IFR_TYPE_VALUE)) != 0) {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+  Save the values of the Questions read by a cacheable expression, so that its
+  result may be reused until one of them changes.
+
+  @param  Expression             The compiled expression.
+
+  @retval TRUE                   The Question values were saved.
+  @retval FALSE                  A Question holds a string or buffer value now,
+                                 and the result can't be reused.
+
+**/
+BOOLEAN
+SaveExpressionInput (
+  IN OUT FORM_EXPRESSION  *Expression
+  )
+{
+  UINTN             Index;
+  EXPRESSION_INPUT  *Input;
+
+  for (Index = 0; Index < Expression->InputCount; Index++) {
+    Input = &Expression->Input[Index];
+    if (Input->QuestionValue->Type == EFI_IFR_TYPE_STRING || Input->QuestionValue->Type == EFI_IFR_TYPE_BUFFER) {
+      return FALSE;
+    }
+
+    CopyMem (&Input->Value, Input->QuestionValue, sizeof (EFI_HII_VALUE));
+  }
+
+  return TRUE;
+}
+
 /**
   Evaluate the result of a HII expression.
 
@@ -2379,12 +2681,26 @@ EvaluateExpression (
 
   StrPtr = NULL;
 
+  ASSERT (Expression != NULL);
+
+  if (Expression->CompileState == EXPRESSION_NOT_COMPILED ||
+      Expression->CompiledFormSet != FormSet || Expression->CompiledForm != Form) {
+    CompileExpression (FormSet, Form, Expression);
+  }
+
+  //
+  // Reuse the result while none of the Questions it was computed from changed.
+  //
+  if (Expression->ResultValid && IsExpressionInputUnchanged (Expression)) {
+    return EFI_SUCCESS;
+  }
+
   //
   // Save current stack offset.
   //
   StackOffset = SaveExpressionEvaluationStackOffset ();
 
-  ASSERT (Expression != NULL);
+  Expression->ResultValid = FALSE;
   Expression->Result.Type = EFI_IFR_TYPE_OTHER;
 
   Link = GetFirstNode (&Expression->OpCodeListHead);
@@ -2955,6 +3271,7 @@ EvaluateExpression (
         case EFI_HII_VARSTORE_BUFFER:
         case EFI_HII_VARSTORE_EFI_VARIABLE_BUFFER:
           CopyMem (OpCode->VarStorage->EditBuffer + OpCode->VarStoreInfo.VarOffset, &Value->Value, OpCode->ValueWidth);
+          gStorageUpdateCount++;
           Data1.Value.b = TRUE;
           break;
         case EFI_HII_VARSTORE_NAME_VALUE:
@@ -3430,6 +3747,12 @@ Done:
   RestoreExpressionEvaluationStackOffset (StackOffset);
   if (!EFI_ERROR (Status)) {
     CopyMem (&Expression->Result, Value, sizeof (EFI_HII_VALUE));
+
+    if (Expression->CompileState == EXPRESSION_CACHEABLE &&
+        Expression->Result.Type != EFI_IFR_TYPE_BUFFER &&
+        Expression->Result.Type != EFI_IFR_TYPE_STRING) {
+      Expression->ResultValid = SaveExpressionInput (Expression);
+    }
   }
 
   return Status;
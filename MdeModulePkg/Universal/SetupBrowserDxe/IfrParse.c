@@ -733,6 +733,10 @@ DestroyExpression (
     }
   }
 
+  if (Expression->Input != NULL) {
+    FreePool (Expression->Input);
+  }
+
   //
   // Free this Expression
   //
@@ -2245,8 +2245,10 @@ SetupBrowser (
   EFI_HANDLE                      NotifyHandle;
   FORM_BROWSER_STATEMENT          *Statement;
   EFI_HII_CONFIG_ACCESS_PROTOCOL  *ConfigAccess;
+  BOOLEAN                         FormEntryPending;
 
-  ConfigAccess = Selection->FormSet->ConfigAccess;
+  ConfigAccess     = Selection->FormSet->ConfigAccess;
+  FormEntryPending = FALSE;
 
   //
   // Register notify for Form package update
@@ -2347,6 +2349,12 @@ SetupBrowser (
       CopyGuid (&mCurrentFormSetGuid, &Selection->FormSetGuid);
       mCurrentFormId      = Selection->FormId;
 
+      //
+      // Measure the form entry, from the FORM_OPEN callback to the first display.
+      //
+      PERF_START (Selection->Handle, "FormEntry", "SetupBrowser", 0);
+      FormEntryPending = TRUE;
+
       if (ConfigAccess != NULL) {
         Status = ProcessCallBackFunction (Selection, Selection->FormSet, Selection->Form, NULL, EFI_BROWSER_ACTION_FORM_OPEN, FALSE);
         if (EFI_ERROR (Status)) {
@@ -2395,6 +2403,11 @@ SetupBrowser (
       }
     }
 
+    if (FormEntryPending) {
+      PERF_END (Selection->Handle, "FormEntry", "SetupBrowser", 0);
+      FormEntryPending = FALSE;
+    }
+
     //
     // Display form
     //
@@ -2521,6 +2534,10 @@ SetupBrowser (
   } while (Selection->Action == UI_ACTION_REFRESH_FORM);
 
 Done:
+  if (FormEntryPending) {
+    PERF_END (Selection->Handle, "FormEntry", "SetupBrowser", 0);
+  }
+
   //
   // Reset current form information to the initial setting when error happens or form exit.
   //
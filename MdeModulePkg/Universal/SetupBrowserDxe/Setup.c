@@ -55,6 +55,11 @@ LIST_ENTRY      gBrowserSaveFailFormSetList = INITIALIZE_LIST_HEAD_VARIABLE (gBr
 BOOLEAN               mSystemSubmit = FALSE;
 BOOLEAN               gResetRequired;
 BOOLEAN               gExitRequired;
+//
+// Incremented whenever the edit copy of a storage may change. It starts at 1,
+// so that a form which never loaded its question values has a different count.
+//
+UINTN                 gStorageUpdateCount = 1;
 BROWSER_SETTING_SCOPE gBrowserSettingScope = FormSetLevel;
 BOOLEAN               mBrowserScopeFirstSet = TRUE;
 EXIT_HANDLER          ExitHandlerFunction = NULL;
@@ -1159,6 +1164,10 @@ SetValueByName (
     return EFI_INVALID_PARAMETER;
   }
 
+  if (SetValueTo == GetSetValueWithEditBuffer) {
+    gStorageUpdateCount++;
+  }
+
   Link = GetFirstNode (&Storage->NameValueListHead);
   while (!IsNull (&Storage->NameValueListHead, Link)) {
     Node = NAME_VALUE_NODE_FROM_LINK (Link);
@@ -1292,6 +1301,7 @@ ConfigRespToStorage (
   CHAR16      *Value;
 
   Status = EFI_SUCCESS;
+  gStorageUpdateCount++;
 
   switch (Storage->Type) {
   case EFI_HII_VARSTORE_BUFFER:
@@ -1719,6 +1729,7 @@ GetQuestionValue (
     //
     // Synchronize Edit Buffer
     //
+    gStorageUpdateCount++;
     if (IsBufferStorage) {
       CopyMem (Storage->EditBuffer + Question->VarStoreInfo.VarOffset, Dst, StorageWidth);
     } else {
@@ -1781,6 +1792,8 @@ SetQuestionValue (
     return EFI_INVALID_PARAMETER;
   }
 
+  gStorageUpdateCount++;
+
   //
   // If Question value is provided by an Expression, then it is read only
   //
@@ -2265,6 +2278,10 @@ SynchronizeStorage (
   Status = EFI_SUCCESS;
   Result = NULL;
 
+  if (!SyncOrRestore) {
+    gStorageUpdateCount++;
+  }
+
   if (Storage->Type == EFI_HII_VARSTORE_BUFFER || 
       (Storage->Type == EFI_HII_VARSTORE_EFI_VARIABLE_BUFFER)) {
     BufferSize = Storage->Size;
@@ -4264,6 +4281,51 @@ IsQuestionValueChanged (
   return ValueChanged;
 }
 
+/**
+  Check whether the value of a question comes from somewhere else than the
+  edit copy of the browser storage, so that it has to be reloaded every time.
+
+  @param  Form                   Form data structure.
+  @param  Question               The question to check.
+
+  @retval TRUE                   The question value has to be reloaded.
+  @retval FALSE                  The question value only changes with the storage.
+
+**/
+BOOLEAN
+IsQuestionValueVolatile (
+  IN FORM_BROWSER_FORM        *Form,
+  IN FORM_BROWSER_STATEMENT   *Question
+  )
+{
+  if (Question->ValueExpression != NULL) {
+    return TRUE;
+  }
+
+  if (Question->ReadExpression != NULL && Form->FormType == STANDARD_MAP_FORM_TYPE) {
+    return TRUE;
+  }
+
+  if (Question->Storage == NULL) {
+    //
+    // RTC date and time.
+    //
+    if (Question->Operand == EFI_IFR_DATE_OP || Question->Operand == EFI_IFR_TIME_OP) {
+      return (BOOLEAN) ((Question->Flags & EFI_QF_DATE_STORAGE) != QF_DATE_STORAGE_NORMAL);
+    }
+    return FALSE;
+  }
+
+  if (Question->Storage->Type == EFI_HII_VARSTORE_EFI_VARIABLE) {
+    return TRUE;
+  }
+
+  //
+  // Password without callback is read from the HII driver.
+  //
+  return (BOOLEAN) (Question->Operand == EFI_IFR_PASSWORD_OP && (Question->QuestionFlags & EFI_IFR_FLAG_CALLBACK) == 0);
+}
+
 /**
   Initialize Question's Edit copy from Storage.
 
@@ -4287,11 +4349,25 @@ LoadFormConfig (
   EFI_STATUS                  Status;
   LIST_ENTRY                  *Link;
   FORM_BROWSER_STATEMENT      *Question;
-  
+  BOOLEAN                     LoadAll;
+
+  //
+  // The form being displayed is always reloaded. The other forms are only
+  // reloaded when the edit copy of a storage may have changed since their
+  // question values were loaded.
+  //
+  LoadAll = (BOOLEAN) ((Selection != NULL && Selection->Form == Form) ||
+                       Form->StorageUpdateCount != gStorageUpdateCount);
+
   Link = GetFirstNode (&Form->StatementListHead);
   while (!IsNull (&Form->StatementListHead, Link)) {
     Question = FORM_BROWSER_STATEMENT_FROM_LINK (Link);
 
+    if (!LoadAll && !IsQuestionValueVolatile (Form, Question)) {
+      Link = GetNextNode (&Form->StatementListHead, Link);
+      continue;
+    }
+
     //
     // Initialize local copy of Value for each Question
     //
@@ -4311,6 +4387,10 @@ LoadFormConfig (
     Link = GetNextNode (&Form->StatementListHead, Link);
   }
 
+  if (LoadAll) {
+    Form->StorageUpdateCount = gStorageUpdateCount;
+  }
+
   return EFI_SUCCESS;
 }
 
@@ -4773,6 +4853,7 @@ GetDefaultForFormset (
   //
   // Update the question value based on the input ConfigRequest.
   //
+  gStorageUpdateCount++;
   if (Storage->Type == EFI_HII_VARSTORE_BUFFER || 
       (Storage->Type == EFI_HII_VARSTORE_EFI_VARIABLE_BUFFER)) {
     ASSERT (BackUpBuf != NULL);
@@ -49,6 +49,7 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #include <Library/PcdLib.h>
 #include <Library/DevicePathLib.h>
 #include <Library/UefiLib.h>
+#include <Library/PerformanceLib.h>
 
 
 //
@@ -218,6 +219,18 @@ typedef struct {
 
 #define FORM_EXPRESSION_SIGNATURE  SIGNATURE_32 ('F', 'E', 'X', 'P')
 
+//
+// Compile states of an expression.
+//
+#define EXPRESSION_NOT_COMPILED    0
+#define EXPRESSION_CACHEABLE       1  // Result only depends on the values of the Questions in Input
+#define EXPRESSION_NOT_CACHEABLE   2  // Result must be evaluated every time
+
+typedef struct {
+  EFI_HII_VALUE     *QuestionValue;  // HiiValue of a Question read by the expression
+  EFI_HII_VALUE     Value;           // QuestionValue when the expression Result was evaluated
+} EXPRESSION_INPUT;
+
 typedef struct {
   UINTN             Signature;
   LIST_ENTRY        Link;
@@ -233,6 +246,13 @@ typedef struct {
   EFI_IFR_OP_HEADER *OpCode;         // Save the opcode buffer.
 
   LIST_ENTRY        OpCodeListHead;  // OpCodes consist of this expression (EXPRESSION_OPCODE)
+
+  UINT8             CompileState;    // EXPRESSION_NOT_COMPILED, EXPRESSION_CACHEABLE or EXPRESSION_NOT_CACHEABLE
+  BOOLEAN           ResultValid;     // Result is up to date with the values saved in Input
+  VOID              *CompiledFormSet;// FORM_BROWSER_FORMSET the Input was resolved in
+  VOID              *CompiledForm;   // FORM_BROWSER_FORM the Input was resolved in
+  UINTN             InputCount;
+  EXPRESSION_INPUT  *Input;          // Question values read by a cacheable expression
 } FORM_EXPRESSION;
 
 #define FORM_EXPRESSION_FROM_LINK(a)  CR (a, FORM_EXPRESSION, Link, FORM_EXPRESSION_SIGNATURE)
@@ -408,6 +428,8 @@ typedef struct {
   LIST_ENTRY           StatementListHead;    // List of Statements and Questions (FORM_BROWSER_STATEMENT)
   LIST_ENTRY           ConfigRequestHead;    // List of configreques for all storage.
   FORM_EXPRESSION_LIST *SuppressExpression;  // nesting inside of SuppressIf
+
+  UINTN                StorageUpdateCount;   // gStorageUpdateCount when the question values were loaded, 0 if never.
 } FORM_BROWSER_FORM;
 
 #define FORM_BROWSER_FORM_FROM_LINK(a)  CR (a, FORM_BROWSER_FORM, Link, FORM_BROWSER_FORM_SIGNATURE)
@@ -562,6 +584,7 @@ extern EDKII_FORM_DISPLAY_ENGINE_PROTOCOL *mFormDisplay;
 
 extern BOOLEAN               gResetRequired;
 extern BOOLEAN               gExitRequired;
+extern UINTN                 gStorageUpdateCount;
 extern LIST_ENTRY            gBrowserFormSetList;
 extern LIST_ENTRY            gBrowserHotKeyList;
 extern BROWSER_SETTING_SCOPE gBrowserSettingScope;
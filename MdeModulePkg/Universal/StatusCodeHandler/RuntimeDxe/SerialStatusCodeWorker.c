@@ -14,6 +14,329 @@
 
 #include "StatusCodeHandlerRuntimeDxe.h"
 
+//
+// Ring buffer of the status codes queued for the serial port before
+// ExitBootServices (), when PcdStatusCodeSerialBufferSize is not 0.
+//
+UINT8      *mSerialBuffer           = NULL;
+UINTN      mSerialBufferSize        = 0;
+UINTN      mSerialBufferHead        = 0;
+UINTN      mSerialBufferCount       = 0;
+BOOLEAN    mSerialBufferDraining    = FALSE;
+EFI_EVENT  mSerialBufferTimerEvent  = NULL;
+
+//
+// Statistics of the serial output, reported at ExitBootServices ().
+//
+UINT64     mSerialWriteBytes        = 0;
+UINT64     mSerialWriteTime         = 0;
+UINTN      mSerialBufferMaxCount    = 0;
+
+//
+// The start and end values of the performance counter, used to convert the
+// measured write times when PcdStatusCodeSerialMeasureTime is TRUE.
+//
+UINT64     mSerialCounterStart      = 0;
+UINT64     mSerialCounterEnd        = 0;
+
+/**
+  Return the time in nanoseconds between two values of the performance counter.
+
+  @param  Begin  The value of the performance counter at the beginning.
+  @param  End    The value of the performance counter at the end.
+
+  @return The elapsed time in nanoseconds.
+
+**/
+UINT64
+SerialStatusCodeGetElapsedTime (
+  IN UINT64  Begin,
+  IN UINT64  End
+  )
+{
+  UINT64  Ticks;
+
+  if (mSerialCounterEnd >= mSerialCounterStart) {
+    //
+    // The counter counts up, and may have wrapped around to the start value.
+    //
+    if (End >= Begin) {
+      Ticks = End - Begin;
+    } else {
+      Ticks = (mSerialCounterEnd - Begin) + (End - mSerialCounterStart);
+    }
+  } else {
+    //
+    // The counter counts down, and may have wrapped around to the start value.
+    //
+    if (Begin >= End) {
+      Ticks = Begin - End;
+    } else {
+      Ticks = (Begin - mSerialCounterEnd) + (mSerialCounterStart - End);
+    }
+  }
+
+  return GetTimeInNanoSecond (Ticks);
+}
+
+/**
+  Write data to the serial port and account for it in the statistics.
+
+  @param  Buffer           Pointer to the data to write.
+  @param  Count            Number of bytes to write.
+
+**/
+VOID
+SerialStatusCodeWriteDevice (
+  IN UINT8                    *Buffer,
+  IN UINTN                    Count
+  )
+{
+  UINT64                      Begin;
+
+  Begin = 0;
+  if (FeaturePcdGet (PcdStatusCodeSerialMeasureTime)) {
+    Begin = GetPerformanceCounter ();
+  }
+
+  SerialPortWrite (Buffer, Count);
+
+  if (FeaturePcdGet (PcdStatusCodeSerialMeasureTime)) {
+    mSerialWriteTime += SerialStatusCodeGetElapsedTime (Begin, GetPerformanceCounter ());
+  }
+  mSerialWriteBytes += Count;
+}
+
+/**
+  Write the oldest bytes of the buffer to the serial port.
+
+  @param  MaxCount         The maximum number of bytes to write.
+
+**/
+VOID
+SerialStatusCodeDrainBuffer (
+  IN UINTN                    MaxCount
+  )
+{
+  EFI_TPL                     OldTpl;
+  UINT8                       *Data;
+  UINTN                       Length;
+
+  OldTpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+  if (mSerialBufferDraining || (mSerialBufferCount == 0)) {
+    //
+    // Nothing is buffered, or the buffer is being written by the code this
+    // call interrupted.
+    //
+    gBS->RestoreTPL (OldTpl);
+    return;
+  }
+  mSerialBufferDraining = TRUE;
+
+  while ((MaxCount > 0) && (mSerialBufferCount > 0)) {
+    //
+    // Write the bytes up to the end of the ring. The bytes stay in the buffer
+    // until they are written, so they are not overwritten by new status codes.
+    //
+    Data   = &mSerialBuffer[mSerialBufferHead];
+    Length = MIN (mSerialBufferCount, mSerialBufferSize - mSerialBufferHead);
+    Length = MIN (Length, MaxCount);
+    gBS->RestoreTPL (OldTpl);
+
+    SerialStatusCodeWriteDevice (Data, Length);
+
+    OldTpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+    mSerialBufferHead   = (mSerialBufferHead + Length) % mSerialBufferSize;
+    mSerialBufferCount -= Length;
+    MaxCount           -= Length;
+  }
+
+  mSerialBufferDraining = FALSE;
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+  Timer handler writing a part of the buffer to the serial port.
+
+  @param  Event         Event whose notification function is being invoked.
+  @param  Context       Pointer to the notification function's context.
+
+**/
+VOID
+EFIAPI
+SerialStatusCodeBufferTimerHandler (
+  IN EFI_EVENT        Event,
+  IN VOID             *Context
+  )
+{
+  SerialStatusCodeDrainBuffer (SERIAL_STATUS_CODE_DRAIN_SIZE);
+}
+
+/**
+  Write a status code string to the serial port, or queue it in the buffer.
+
+  @param  Buffer           Pointer to the string to write.
+  @param  Count            Number of bytes to write.
+  @param  Flush            TRUE to write the buffer and the string before returning,
+                           such as for an error that may stop the system.
+
+**/
+VOID
+SerialStatusCodeWrite (
+  IN UINT8                    *Buffer,
+  IN UINTN                    Count,
+  IN BOOLEAN                  Flush
+  )
+{
+  EFI_TPL                     OldTpl;
+  UINTN                       Tail;
+  UINTN                       Length;
+
+  if (mSerialBuffer == NULL) {
+    SerialStatusCodeWriteDevice (Buffer, Count);
+    return;
+  }
+
+  if (Flush) {
+    SerialStatusCodeDrainBuffer ((UINTN) -1);
+  } else if (Count > mSerialBufferSize - mSerialBufferCount) {
+    //
+    // The serial port doesn't keep up, write enough of the buffer to make room.
+    //
+    SerialStatusCodeDrainBuffer (Count - (mSerialBufferSize - mSerialBufferCount));
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+  if (Flush || (Count > mSerialBufferSize - mSerialBufferCount)) {
+    //
+    // The string is written directly when it's larger than the buffer, or
+    // when the buffer is full and being written by the code this call
+    // interrupted.
+    //
+    gBS->RestoreTPL (OldTpl);
+    SerialStatusCodeWriteDevice (Buffer, Count);
+    return;
+  }
+
+  Tail   = (mSerialBufferHead + mSerialBufferCount) % mSerialBufferSize;
+  Length = MIN (Count, mSerialBufferSize - Tail);
+  CopyMem (&mSerialBuffer[Tail], Buffer, Length);
+  CopyMem (mSerialBuffer, Buffer + Length, Count - Length);
+  mSerialBufferCount += Count;
+  if (mSerialBufferCount > mSerialBufferMaxCount) {
+    mSerialBufferMaxCount = mSerialBufferCount;
+  }
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+  Allocate the buffer of the serial status codes, if it's enabled by
+  PcdStatusCodeSerialBufferSize.
+
+**/
+VOID
+SerialStatusCodeInitializeBuffer (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UINTN                       Size;
+
+  if (FeaturePcdGet (PcdStatusCodeSerialMeasureTime)) {
+    GetPerformanceCounterProperties (&mSerialCounterStart, &mSerialCounterEnd);
+  }
+
+  Size = PcdGet32 (PcdStatusCodeSerialBufferSize);
+  if (Size == 0) {
+    return;
+  }
+
+  mSerialBuffer = AllocatePool (Size);
+  if (mSerialBuffer == NULL) {
+    return;
+  }
+
+  Status = gBS->CreateEvent (
+                  EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                  TPL_CALLBACK,
+                  SerialStatusCodeBufferTimerHandler,
+                  NULL,
+                  &mSerialBufferTimerEvent
+                  );
+  if (!EFI_ERROR (Status)) {
+    Status = gBS->SetTimer (mSerialBufferTimerEvent, TimerPeriodic, SERIAL_STATUS_CODE_TIMER_PERIOD);
+    if (EFI_ERROR (Status)) {
+      gBS->CloseEvent (mSerialBufferTimerEvent);
+      mSerialBufferTimerEvent = NULL;
+    }
+  }
+  if (EFI_ERROR (Status)) {
+    FreePool (mSerialBuffer);
+    mSerialBuffer = NULL;
+    return;
+  }
+
+  mSerialBufferSize = Size;
+}
+
+/**
+  Write the buffered serial status codes and the statistics of the serial
+  output when exiting boot services.
+
+**/
+VOID
+SerialStatusCodeExitBootServices (
+  VOID
+  )
+{
+  CHAR8                       Buffer[MAX_DEBUG_MESSAGE_LENGTH];
+  UINTN                       CharCount;
+
+  //
+  // Stop the timer first, so that no notify function runs after the handoff.
+  //
+  if (mSerialBufferTimerEvent != NULL) {
+    gBS->SetTimer (mSerialBufferTimerEvent, TimerCancel, 0);
+    gBS->CloseEvent (mSerialBufferTimerEvent);
+    mSerialBufferTimerEvent = NULL;
+  }
+
+  if (mSerialBuffer != NULL) {
+    SerialStatusCodeDrainBuffer ((UINTN) -1);
+    //
+    // Memory can't be freed any more, the buffer is only dropped.
+    //
+    mSerialBuffer = NULL;
+  }
+
+  if ((mSerialBufferSize == 0) && !FeaturePcdGet (PcdStatusCodeSerialMeasureTime)) {
+    return;
+  }
+
+  CharCount = AsciiSPrint (
+                Buffer,
+                sizeof (Buffer),
+                "Serial status code: %ld bytes written, %ld bytes buffered at most",
+                mSerialWriteBytes,
+                (UINT64) mSerialBufferMaxCount
+                );
+  if (FeaturePcdGet (PcdStatusCodeSerialMeasureTime)) {
+    CharCount += AsciiSPrint (
+                   &Buffer[CharCount],
+                   (sizeof (Buffer) - (sizeof (Buffer[0]) * CharCount)),
+                   ", %ld us waiting for the serial port",
+                   DivU64x32 (mSerialWriteTime, 1000)
+                   );
+  }
+  CharCount += AsciiSPrint (
+                 &Buffer[CharCount],
+                 (sizeof (Buffer) - (sizeof (Buffer[0]) * CharCount)),
+                 "\n\r"
+                 );
+
+  SerialPortWrite ((UINT8 *) Buffer, CharCount);
+}
+
 /**
   Convert status code value and extended data to readable ASCII string, send string to serial I/O device.
  
@@ -153,9 +476,14 @@ SerialStatusCodeReportWorker (
   }
 
   //
-  // Call SerialPort Lib function to do print.
+  // Call SerialPort Lib function to do print. Errors are written at once, as
+  // the system may stop after them.
   //
-  SerialPortWrite ((UINT8 *) Buffer, CharCount);
+  SerialStatusCodeWrite (
+    (UINT8 *) Buffer,
+    CharCount,
+    (BOOLEAN) ((CodeType & EFI_STATUS_CODE_TYPE_MASK) == EFI_ERROR_CODE)
+    );
 
   return EFI_SUCCESS;
 }
@@ -37,6 +37,7 @@ UnregisterBootTimeHandlers (
 {
   if (FeaturePcdGet (PcdStatusCodeUseSerial)) {
     mRscHandlerProtocol->Unregister (SerialStatusCodeReportWorker);
+    SerialStatusCodeExitBootServices ();
   }
 }
 
@@ -92,6 +93,8 @@ InitializationDispatcherWorker (
     //
     Status = SerialPortInitialize ();
     ASSERT_EFI_ERROR (Status);
+
+    SerialStatusCodeInitializeBuffer ();
   }
   if (FeaturePcdGet (PcdStatusCodeUseMemory)) {
     Status = RtMemoryStatusCodeInitializeWorker ();
@@ -23,6 +23,7 @@
 #include <Guid/EventGroup.h>
 
 #include <Library/SynchronizationLib.h>
+#include <Library/BaseLib.h>
 #include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
 #include <Library/ReportStatusCodeLib.h>
@@ -34,12 +35,21 @@
 #include <Library/MemoryAllocationLib.h>
 #include <Library/UefiRuntimeLib.h>
 #include <Library/SerialPortLib.h>
+#include <Library/TimerLib.h>
 
 //
 // Define the maximum message length
 //
 #define MAX_DEBUG_MESSAGE_LENGTH 0x100
 
+//
+// Period of the timer writing the buffered serial status codes, in 100ns
+// units (10ms), and the number of bytes it writes per tick (about 6ms at
+// 115200 baud).
+//
+#define SERIAL_STATUS_CODE_TIMER_PERIOD  100000
+#define SERIAL_STATUS_CODE_DRAIN_SIZE    64
+
 //
 // Runtime memory status code worker definition
 //
@@ -92,6 +102,26 @@ SerialStatusCodeReportWorker (
   IN EFI_STATUS_CODE_DATA     *Data OPTIONAL
   );
 
+/**
+  Allocate the buffer of the serial status codes, if it's enabled by
+  PcdStatusCodeSerialBufferSize.
+
+**/
+VOID
+SerialStatusCodeInitializeBuffer (
+  VOID
+  );
+
+/**
+  Write the buffered serial status codes and the statistics of the serial
+  output when exiting boot services.
+
+**/
+VOID
+SerialStatusCodeExitBootServices (
+  VOID
+  );
+
 /**
   Initialize runtime memory status code table as initialization for runtime memory status code worker
  
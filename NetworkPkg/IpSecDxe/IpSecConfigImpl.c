@@ -15,6 +15,7 @@
 
 #include "IpSecConfigImpl.h"
 #include "IpSecDebug.h"
+#include "IpSecCryptIo.h"
 
 LIST_ENTRY                mConfigData[IPsecConfigDataTypeMaximum];
 BOOLEAN                   mSetBySelf = FALSE;
@@ -1256,6 +1257,7 @@ SetSadEntry (
   EFI_IPSEC_SA_ID   *InsertBefore;
   LIST_ENTRY        *EntryInsertBefore;
   UINTN             SadEntrySize;
+  EFI_STATUS        Status;
   
   SaId          = (Selector == NULL) ? NULL : &Selector->SaId;
   SaData        = (Data == NULL) ? NULL : (EFI_IPSEC_SA_DATA2 *) Data;
@@ -1292,6 +1294,7 @@ SetSadEntry (
       }
 
       RemoveEntryList (&SadEntry->List);
+      IpSecCryptoIoFreeEspContext (SadEntry->Data->EspContext);
       FreePool (SadEntry);
     }
   }
@@ -1420,6 +1423,28 @@ SetSadEntry (
       sizeof (EFI_IP_ADDRESS)
       );
   }
+
+  //
+  // Initialize the cipher and HMAC contexts of the ESP SA with its keys once,
+  // rather than for every packet. An SA with an unsupported algorithm is kept
+  // without contexts, and its packets are rejected.
+  //
+  if (SaId->Proto == EfiIPsecESP) {
+    Status = IpSecCryptoIoCreateEspContext (
+               SadEntry->Data->AlgoInfo.EspAlgoInfo.EncAlgoId,
+               SadEntry->Data->AlgoInfo.EspAlgoInfo.EncKey,
+               SadEntry->Data->AlgoInfo.EspAlgoInfo.EncKeyLength << 3,
+               SadEntry->Data->AlgoInfo.EspAlgoInfo.AuthAlgoId,
+               SadEntry->Data->AlgoInfo.EspAlgoInfo.AuthKey,
+               SadEntry->Data->AlgoInfo.EspAlgoInfo.AuthKeyLength,
+               &SadEntry->Data->EspContext
+               );
+    if (EFI_ERROR (Status) && Status != EFI_UNSUPPORTED) {
+      FreePool (SadEntry);
+      return Status;
+    }
+  }
+
   //
   // Update the spd.sas list of the spd entry specified by SAD selector
   //
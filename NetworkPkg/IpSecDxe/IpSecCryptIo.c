@@ -37,9 +37,9 @@ GLOBAL_REMOVE_IF_UNREFERENCED AUTH_ALGORITHM mIpsecAuthAlgorithmList[IPSEC_AUTH_
 // The information for the supported Hash aglorithm
 //
 GLOBAL_REMOVE_IF_UNREFERENCED HASH_ALGORITHM mIpsecHashAlgorithmList[IPSEC_HASH_ALGORITHM_LIST_SIZE] = {
-  {IKE_AALG_NONE, 0, 0, 0, NULL, NULL, NULL, NULL},
-  {IKE_AALG_NULL, 0, 0, 0, NULL, NULL, NULL, NULL},
-  {IKE_AALG_SHA1HMAC, 20, 12, 64, Sha1GetContextSize, Sha1Init, Sha1Update, Sha1Final}
+  {IKE_AALG_NONE, 0, 0, 0, NULL, NULL, NULL, NULL, NULL},
+  {IKE_AALG_NULL, 0, 0, 0, NULL, NULL, NULL, NULL, NULL},
+  {IKE_AALG_SHA1HMAC, 20, 12, 64, Sha1GetContextSize, Sha1Init, Sha1Update, Sha1Final, Sha1Duplicate}
 };
 
 BOOLEAN  mInitialRandomSeed = FALSE;
@@ -653,6 +653,402 @@ Exit:
   return Status;
 }
 
+/**
+  Create the cipher and HMAC contexts of an ESP SA.
+
+  The cipher key schedule and the hash states after the HMAC inner and outer
+  pads are computed once here, so that the packets of the SA are processed by
+  IpSecCryptoIoEncryptWithContext(), IpSecCryptoIoDecryptWithContext() and
+  IpSecCryptoIoHmacWithContext() without initializing any context.
+
+  @param[in]   EncAlgorithmId   The encryption algorithm ID.
+  @param[in]   EncKey           Pointer to the encryption key.
+  @param[in]   EncKeyBits       The length of the encryption key in bits.
+  @param[in]   AuthAlgorithmId  The authentication algorithm ID.
+  @param[in]   AuthKey          Pointer to the authentication key.
+  @param[in]   AuthKeyLength    The length of the authentication key in bytes.
+  @param[out]  Context          Pointer to the created context on return.
+
+  @retval EFI_SUCCESS           The context was created.
+  @retval EFI_UNSUPPORTED       An algorithm is not supported.
+  @retval EFI_OUT_OF_RESOURCES  The required resource can't be allocated.
+  @retval EFI_DEVICE_ERROR      The crypto library failed to initialize a context.
+
+**/
+EFI_STATUS
+IpSecCryptoIoCreateEspContext (
+  IN     UINT8              EncAlgorithmId,
+  IN     CONST UINT8        *EncKey,       OPTIONAL
+  IN     UINTN              EncKeyBits,
+  IN     UINT8              AuthAlgorithmId,
+  IN     CONST UINT8        *AuthKey,      OPTIONAL
+  IN     UINTN              AuthKeyLength,
+     OUT IPSEC_ESP_CONTEXT  **Context
+  )
+{
+  UINTN               EncIndex;
+  UINTN               AuthIndex;
+  UINTN               CipherContextSize;
+  UINTN               HashContextSize;
+  UINTN               Size;
+  UINTN               Index;
+  IPSEC_ESP_CONTEXT   *EspContext;
+  HASH_ALGORITHM      *Hash;
+  UINT8               Pad[IPSEC_HASH_MAX_BLOCK_SIZE];
+
+  *Context          = NULL;
+  EncIndex          = (UINTN) -1;
+  AuthIndex         = (UINTN) -1;
+  CipherContextSize = 0;
+  HashContextSize   = 0;
+
+  switch (EncAlgorithmId) {
+
+  case IKE_EALG_NULL:
+  case IKE_EALG_NONE:
+    break;
+
+  case IKE_EALG_3DESCBC:
+  case IKE_EALG_AESCBC:
+    EncIndex = IpSecGetIndexFromEncList (EncAlgorithmId);
+    if (EncIndex == -1) {
+      return EFI_UNSUPPORTED;
+    }
+    if (EncKey != NULL) {
+      CipherContextSize = mIpsecEncryptAlgorithmList[EncIndex].CipherGetContextSize ();
+    }
+    break;
+
+  default:
+    return EFI_UNSUPPORTED;
+  }
+
+  switch (AuthAlgorithmId) {
+
+  case IKE_AALG_NONE:
+  case IKE_AALG_NULL:
+    break;
+
+  case IKE_AALG_SHA1HMAC:
+    AuthIndex = IpSecGetIndexFromAuthList (AuthAlgorithmId);
+    if (AuthIndex == -1) {
+      return EFI_UNSUPPORTED;
+    }
+    ASSERT (mIpsecHashAlgorithmList[AuthIndex].BlockSize <= IPSEC_HASH_MAX_BLOCK_SIZE);
+    ASSERT (mIpsecHashAlgorithmList[AuthIndex].DigestLength <= IPSEC_HASH_MAX_DIGEST_SIZE);
+    if (AuthKey != NULL) {
+      HashContextSize = mIpsecHashAlgorithmList[AuthIndex].HashGetContextSize ();
+    }
+    break;
+
+  default:
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // Allocate the context and all the crypto contexts in one buffer.
+  //
+  Size        = ALIGN_VARIABLE (sizeof (IPSEC_ESP_CONTEXT));
+  Size       += ALIGN_VARIABLE (CipherContextSize);
+  Size       += ALIGN_VARIABLE (HashContextSize) * 3;
+  EspContext  = AllocateZeroPool (Size);
+  if (EspContext == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  if (CipherContextSize != 0) {
+    EspContext->CipherContext = (UINT8 *) EspContext + ALIGN_VARIABLE (sizeof (IPSEC_ESP_CONTEXT));
+    if (!mIpsecEncryptAlgorithmList[EncIndex].CipherInitiate (EspContext->CipherContext, EncKey, EncKeyBits)) {
+      FreePool (EspContext);
+      return EFI_DEVICE_ERROR;
+    }
+  }
+
+  if (HashContextSize != 0) {
+    Hash                         = &mIpsecHashAlgorithmList[AuthIndex];
+    EspContext->HmacInnerContext = (UINT8 *) EspContext + ALIGN_VARIABLE (sizeof (IPSEC_ESP_CONTEXT)) +
+                                   ALIGN_VARIABLE (CipherContextSize);
+    EspContext->HmacOuterContext = (UINT8 *) EspContext->HmacInnerContext + ALIGN_VARIABLE (HashContextSize);
+    EspContext->HashContext      = (UINT8 *) EspContext->HmacOuterContext + ALIGN_VARIABLE (HashContextSize);
+
+    //
+    // Per RFC 2104, a key longer than the block size is replaced by its hash,
+    // and a shorter key is padded with zeros to the block size.
+    //
+    ZeroMem (Pad, sizeof (Pad));
+    if (AuthKeyLength > Hash->BlockSize) {
+      if (!Hash->HashInitiate (EspContext->HashContext) ||
+          !Hash->HashUpdate (EspContext->HashContext, AuthKey, AuthKeyLength) ||
+          !Hash->HashFinal (EspContext->HashContext, Pad)
+          ) {
+        FreePool (EspContext);
+        return EFI_DEVICE_ERROR;
+      }
+    } else {
+      CopyMem (Pad, AuthKey, AuthKeyLength);
+    }
+
+    //
+    // Hash the key XORed with the inner pad and with the outer pad. These two
+    // states are the starting points of the inner and outer hashes of every HMAC.
+    //
+    for (Index = 0; Index < Hash->BlockSize; Index++) {
+      Pad[Index] ^= 0x36;
+    }
+    if (!Hash->HashInitiate (EspContext->HmacInnerContext) ||
+        !Hash->HashUpdate (EspContext->HmacInnerContext, Pad, Hash->BlockSize)
+        ) {
+      ZeroMem (Pad, sizeof (Pad));
+      FreePool (EspContext);
+      return EFI_DEVICE_ERROR;
+    }
+
+    for (Index = 0; Index < Hash->BlockSize; Index++) {
+      Pad[Index] ^= 0x36 ^ 0x5c;
+    }
+    if (!Hash->HashInitiate (EspContext->HmacOuterContext) ||
+        !Hash->HashUpdate (EspContext->HmacOuterContext, Pad, Hash->BlockSize)
+        ) {
+      ZeroMem (Pad, sizeof (Pad));
+      FreePool (EspContext);
+      return EFI_DEVICE_ERROR;
+    }
+
+    ZeroMem (Pad, sizeof (Pad));
+  }
+
+  *Context = EspContext;
+  return EFI_SUCCESS;
+}
+
+/**
+  Free the context created by IpSecCryptoIoCreateEspContext().
+
+  @param[in]  Context    Pointer to the context to be freed. It can be NULL.
+
+**/
+VOID
+IpSecCryptoIoFreeEspContext (
+  IN IPSEC_ESP_CONTEXT     *Context
+  )
+{
+  if (Context != NULL) {
+    FreePool (Context);
+  }
+}
+
+/**
+  Encrypt the buffer with the cipher context of an ESP SA.
+
+  InData and OutData may point to the same buffer. The InData should be multiple
+  of block size. This function doesn't perform the padding.
+
+  @param[in]       AlgorithmId    The Alogrithem identification defined in RFC.
+  @param[in]       Context        The ESP context of the SA.
+  @param[in]       Ivec           Point to the buffer containning the Initializeion
+                                  Vector (IV) data.
+  @param[in]       InData         Point to the buffer containing the data to be
+                                  encrypted.
+  @param[in]       InDataLength   The length of InData in Bytes.
+  @param[out]      OutData        Point to the buffer that receives the encryption
+                                  output.
+
+  @retval EFI_UNSUPPORTED       The input Algorithm is not supported.
+  @retval EFI_SUCCESS           The operation completed successfully.
+
+**/
+EFI_STATUS
+IpSecCryptoIoEncryptWithContext (
+  IN CONST UINT8              AlgorithmId,
+  IN       IPSEC_ESP_CONTEXT  *Context,
+  IN CONST UINT8              *Ivec, OPTIONAL
+  IN       UINT8              *InData,
+  IN       UINTN              InDataLength,
+     OUT   UINT8              *OutData
+  )
+{
+  UINTN         Index;
+
+  switch (AlgorithmId) {
+
+  case IKE_EALG_NULL:
+  case IKE_EALG_NONE:
+    CopyMem (OutData, InData, InDataLength);
+    return EFI_SUCCESS;
+
+  case IKE_EALG_3DESCBC:
+  case IKE_EALG_AESCBC:
+    Index = IpSecGetIndexFromEncList (AlgorithmId);
+    if (Index == -1 || Context == NULL || Context->CipherContext == NULL) {
+      return EFI_UNSUPPORTED;
+    }
+
+    if (mIpsecEncryptAlgorithmList[Index].CipherEncrypt (Context->CipherContext, InData, InDataLength, Ivec, OutData)) {
+      return EFI_SUCCESS;
+    }
+    break;
+
+  default:
+    break;
+  }
+
+  return EFI_UNSUPPORTED;
+}
+
+/**
+  Decrypt the buffer with the cipher context of an ESP SA.
+
+  InData and OutData may point to the same buffer. The InData should be multiple
+  of block size.
+
+  @param[in]       AlgorithmId    The Alogrithem identification defined in RFC.
+  @param[in]       Context        The ESP context of the SA.
+  @param[in]       Ivec           Point to the buffer containning the Initializeion
+                                  Vector (IV) data.
+  @param[in]       InData         Point to the buffer containing the data to be
+                                  decrypted.
+  @param[in]       InDataLength   The length of InData in Bytes.
+  @param[out]      OutData        Pointer to the buffer that receives the decryption
+                                  output.
+
+  @retval EFI_UNSUPPORTED       The input Algorithm is not supported.
+  @retval EFI_SUCCESS           The operation completed successfully.
+
+**/
+EFI_STATUS
+IpSecCryptoIoDecryptWithContext (
+  IN CONST UINT8              AlgorithmId,
+  IN       IPSEC_ESP_CONTEXT  *Context,
+  IN CONST UINT8              *Ivec, OPTIONAL
+  IN       UINT8              *InData,
+  IN       UINTN              InDataLength,
+     OUT   UINT8              *OutData
+  )
+{
+  UINTN         Index;
+
+  switch (AlgorithmId) {
+
+  case IKE_EALG_NULL:
+  case IKE_EALG_NONE:
+    CopyMem (OutData, InData, InDataLength);
+    return EFI_SUCCESS;
+
+  case IKE_EALG_3DESCBC:
+  case IKE_EALG_AESCBC:
+    Index = IpSecGetIndexFromEncList (AlgorithmId);
+    if (Index == -1 || Context == NULL || Context->CipherContext == NULL) {
+      return EFI_UNSUPPORTED;
+    }
+
+    if (mIpsecEncryptAlgorithmList[Index].CipherDecrypt (Context->CipherContext, InData, InDataLength, Ivec, OutData)) {
+      return EFI_SUCCESS;
+    }
+    break;
+
+  default:
+    break;
+  }
+
+  return EFI_UNSUPPORTED;
+}
+
+/**
+  Digests the Payload with the HMAC context of an ESP SA and store the result
+  into the OutData.
+
+  The inner and outer hashes start from copies of the states precomputed by
+  IpSecCryptoIoCreateEspContext(), so the key is not processed again. The hash
+  context of the SA is reused for every packet. This is safe because the IPsec
+  processing of the packets is serialized at TPL_CALLBACK by the IP drivers.
+
+  @param[in]      AlgorithmId     The authentication Identification.
+  @param[in]      Context         The ESP context of the SA.
+  @param[in]      InDataFragment  The list contains all data to be authenticated.
+  @param[in]      FragmentCount   The size of the InDataFragment.
+  @param[out]     OutData         For in, the buffer to receive the output data.
+                                  For out, the buffer contains the authenticated data.
+  @param[in]      OutDataSize     The size of the buffer of OutData.
+
+  @retval EFI_UNSUPPORTED       If the AuthAlg is not in the support list.
+  @retval EFI_INVALID_PARAMETER The OutData buffer size is larger than algorithm digest size.
+  @retval EFI_SUCCESS           Authenticate the payload successfully.
+  @retval otherwise             Authentication of the payload fails.
+
+**/
+EFI_STATUS
+IpSecCryptoIoHmacWithContext (
+  IN     CONST UINT8              AlgorithmId,
+  IN           IPSEC_ESP_CONTEXT  *Context,
+  IN           HASH_DATA_FRAGMENT *InDataFragment,
+  IN           UINTN              FragmentCount,
+     OUT       UINT8              *OutData,
+  IN           UINTN              OutDataSize
+  )
+{
+  UINTN           Index;
+  UINTN           FragmentIndex;
+  HASH_ALGORITHM  *Hash;
+  UINT8           Digest[IPSEC_HASH_MAX_DIGEST_SIZE];
+
+  switch (AlgorithmId) {
+
+  case IKE_AALG_NONE:
+  case IKE_AALG_NULL:
+    return EFI_SUCCESS;
+
+  case IKE_AALG_SHA1HMAC:
+    Index = IpSecGetIndexFromAuthList (AlgorithmId);
+    if (Index == -1 || Context == NULL || Context->HmacInnerContext == NULL) {
+      return EFI_UNSUPPORTED;
+    }
+
+    Hash = &mIpsecHashAlgorithmList[Index];
+    if (OutDataSize > Hash->DigestLength) {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    //
+    // Inner hash over the data, started from the hash of the inner pad.
+    //
+    if (!Hash->HashDuplicate (Context->HmacInnerContext, Context->HashContext)) {
+      return EFI_DEVICE_ERROR;
+    }
+    for (FragmentIndex = 0; FragmentIndex < FragmentCount; FragmentIndex++) {
+      if (!Hash->HashUpdate (
+                   Context->HashContext,
+                   InDataFragment[FragmentIndex].Data,
+                   InDataFragment[FragmentIndex].DataSize
+                   )) {
+        return EFI_DEVICE_ERROR;
+      }
+    }
+    if (!Hash->HashFinal (Context->HashContext, Digest)) {
+      return EFI_DEVICE_ERROR;
+    }
+
+    //
+    // Outer hash over the inner digest, started from the hash of the outer pad.
+    //
+    if (!Hash->HashDuplicate (Context->HmacOuterContext, Context->HashContext) ||
+        !Hash->HashUpdate (Context->HashContext, Digest, Hash->DigestLength) ||
+        !Hash->HashFinal (Context->HashContext, Digest)
+        ) {
+      return EFI_DEVICE_ERROR;
+    }
+
+    //
+    // In some cases, like the Icv computing, the Icv size might be less than
+    // the digest size, so copy the part of hash data to the OutData.
+    //
+    CopyMem (OutData, Digest, OutDataSize);
+    return EFI_SUCCESS;
+
+  default:
+    return EFI_UNSUPPORTED;
+  }
+}
+
 /**
   Generates the Diffie-Hellman public key.
 
@@ -28,6 +28,9 @@
 #define IPSEC_AUTH_ALGORITHM_LIST_SIZE    3
 #define IPSEC_HASH_ALGORITHM_LIST_SIZE    3
 
+#define IPSEC_HASH_MAX_BLOCK_SIZE         64
+#define IPSEC_HASH_MAX_DIGEST_SIZE        64
+
 ///
 /// Authentication Algorithm Definition
 ///   The number value definition is aligned to IANA assignment
@@ -306,6 +309,28 @@ BOOLEAN
   OUT     UINT8  *HashValue
   );
 
+/**
+  Prototype of Hash Duplication.
+
+  Makes a copy of an existing hash context.
+
+  If Context is NULL, then ASSERT().
+  If NewContext is NULL, then ASSERT().
+
+  @param[in]   Context     Pointer to the hash context being copied.
+  @param[out]  NewContext  Pointer to the new hash context.
+
+  @retval TRUE   hash context copy succeeded.
+  @retval FALSE  hash context copy failed.
+
+**/
+typedef
+BOOLEAN
+(EFIAPI *CRYPTO_HASH_DUPLICATE)(
+  IN  CONST VOID  *Context,
+  OUT       VOID  *NewContext
+  );
+
 //
 // The struct used to store the information and operation of Block Cipher algorithm.
 //
@@ -418,6 +443,10 @@ typedef struct _HASH_ALGORITHM {
   // The fucntion pointer of Hash Final
   //
   CRYPTO_HASH_FINAL           HashFinal;
+  //
+  // The function pointer of Hash Duplicate
+  //
+  CRYPTO_HASH_DUPLICATE       HashDuplicate;
 } HASH_ALGORITHM;
 
 /**
@@ -636,6 +665,138 @@ IpSecCryptoIoHash (
   IN           UINTN              OutDataSize
   );
 
+/**
+  Create the cipher and HMAC contexts of an ESP SA.
+
+  The cipher key schedule and the hash states after the HMAC inner and outer
+  pads are computed once here, so that the packets of the SA are processed by
+  IpSecCryptoIoEncryptWithContext(), IpSecCryptoIoDecryptWithContext() and
+  IpSecCryptoIoHmacWithContext() without initializing any context.
+
+  @param[in]   EncAlgorithmId   The encryption algorithm ID.
+  @param[in]   EncKey           Pointer to the encryption key.
+  @param[in]   EncKeyBits       The length of the encryption key in bits.
+  @param[in]   AuthAlgorithmId  The authentication algorithm ID.
+  @param[in]   AuthKey          Pointer to the authentication key.
+  @param[in]   AuthKeyLength    The length of the authentication key in bytes.
+  @param[out]  Context          Pointer to the created context on return.
+
+  @retval EFI_SUCCESS           The context was created.
+  @retval EFI_UNSUPPORTED       An algorithm is not supported.
+  @retval EFI_OUT_OF_RESOURCES  The required resource can't be allocated.
+  @retval EFI_DEVICE_ERROR      The crypto library failed to initialize a context.
+
+**/
+EFI_STATUS
+IpSecCryptoIoCreateEspContext (
+  IN     UINT8              EncAlgorithmId,
+  IN     CONST UINT8        *EncKey,       OPTIONAL
+  IN     UINTN              EncKeyBits,
+  IN     UINT8              AuthAlgorithmId,
+  IN     CONST UINT8        *AuthKey,      OPTIONAL
+  IN     UINTN              AuthKeyLength,
+     OUT IPSEC_ESP_CONTEXT  **Context
+  );
+
+/**
+  Free the context created by IpSecCryptoIoCreateEspContext().
+
+  @param[in]  Context    Pointer to the context to be freed. It can be NULL.
+
+**/
+VOID
+IpSecCryptoIoFreeEspContext (
+  IN IPSEC_ESP_CONTEXT     *Context
+  );
+
+/**
+  Encrypt the buffer with the cipher context of an ESP SA.
+
+  InData and OutData may point to the same buffer. The InData should be multiple
+  of block size. This function doesn't perform the padding.
+
+  @param[in]       AlgorithmId    The Alogrithem identification defined in RFC.
+  @param[in]       Context        The ESP context of the SA.
+  @param[in]       Ivec           Point to the buffer containning the Initializeion
+                                  Vector (IV) data.
+  @param[in]       InData         Point to the buffer containing the data to be
+                                  encrypted.
+  @param[in]       InDataLength   The length of InData in Bytes.
+  @param[out]      OutData        Point to the buffer that receives the encryption
+                                  output.
+
+  @retval EFI_UNSUPPORTED       The input Algorithm is not supported.
+  @retval EFI_SUCCESS           The operation completed successfully.
+
+**/
+EFI_STATUS
+IpSecCryptoIoEncryptWithContext (
+  IN CONST UINT8              AlgorithmId,
+  IN       IPSEC_ESP_CONTEXT  *Context,
+  IN CONST UINT8              *Ivec, OPTIONAL
+  IN       UINT8              *InData,
+  IN       UINTN              InDataLength,
+     OUT   UINT8              *OutData
+  );
+
+/**
+  Decrypt the buffer with the cipher context of an ESP SA.
+
+  InData and OutData may point to the same buffer. The InData should be multiple
+  of block size.
+
+  @param[in]       AlgorithmId    The Alogrithem identification defined in RFC.
+  @param[in]       Context        The ESP context of the SA.
+  @param[in]       Ivec           Point to the buffer containning the Initializeion
+                                  Vector (IV) data.
+  @param[in]       InData         Point to the buffer containing the data to be
+                                  decrypted.
+  @param[in]       InDataLength   The length of InData in Bytes.
+  @param[out]      OutData        Pointer to the buffer that receives the decryption
+                                  output.
+
+  @retval EFI_UNSUPPORTED       The input Algorithm is not supported.
+  @retval EFI_SUCCESS           The operation completed successfully.
+
+**/
+EFI_STATUS
+IpSecCryptoIoDecryptWithContext (
+  IN CONST UINT8              AlgorithmId,
+  IN       IPSEC_ESP_CONTEXT  *Context,
+  IN CONST UINT8              *Ivec, OPTIONAL
+  IN       UINT8              *InData,
+  IN       UINTN              InDataLength,
+     OUT   UINT8              *OutData
+  );
+
+/**
+  Digests the Payload with the HMAC context of an ESP SA and store the result
+  into the OutData.
+
+  @param[in]      AlgorithmId     The authentication Identification.
+  @param[in]      Context         The ESP context of the SA.
+  @param[in]      InDataFragment  The list contains all data to be authenticated.
+  @param[in]      FragmentCount   The size of the InDataFragment.
+  @param[out]     OutData         For in, the buffer to receive the output data.
+                                  For out, the buffer contains the authenticated data.
+  @param[in]      OutDataSize     The size of the buffer of OutData.
+
+  @retval EFI_UNSUPPORTED       If the AuthAlg is not in the support list.
+  @retval EFI_INVALID_PARAMETER The OutData buffer size is larger than algorithm digest size.
+  @retval EFI_SUCCESS           Authenticate the payload successfully.
+  @retval otherwise             Authentication of the payload fails.
+
+**/
+EFI_STATUS
+IpSecCryptoIoHmacWithContext (
+  IN     CONST UINT8              AlgorithmId,
+  IN           IPSEC_ESP_CONTEXT  *Context,
+  IN           HASH_DATA_FRAGMENT *InDataFragment,
+  IN           UINTN              FragmentCount,
+     OUT       UINT8              *OutData,
+  IN           UINTN              OutDataSize
+  );
+
 /**
   Generates the Diffie-Hellman public key.
 
@@ -801,10 +801,9 @@ IpSecEspAuthVerifyPayload (
   HashFragment[0].Data     = EspBuffer;
   HashFragment[0].DataSize = AuthSize;
 
-  Status = IpSecCryptoIoHmac (
+  Status = IpSecCryptoIoHmacWithContext (
              SadEntry->Data->AlgoInfo.EspAlgoInfo.AuthAlgoId,
-             SadEntry->Data->AlgoInfo.EspAlgoInfo.AuthKey,
-             SadEntry->Data->AlgoInfo.EspAlgoInfo.AuthKeyLength,
+             SadEntry->Data->EspContext,
              HashFragment,
              1,
              IcvBuffer,
@@ -1390,7 +1389,7 @@ IpSecEspInboundPacket (
   )
 {
   EFI_STATUS            Status;
-  NET_BUF               *Payload;
+  UINTN                 Index;
   UINTN                 EspSize;
   UINTN                 IvSize;
   UINTN                 BlockSize;
@@ -1410,7 +1409,6 @@ IpSecEspInboundPacket (
   UINT8                 *InnerHead;
 
   Status            = EFI_SUCCESS;
-  Payload           = NULL;
   ProcessBuffer     = NULL;
   RecycleContext    = NULL;
   *RecycleEvent     = NULL;
@@ -1418,32 +1416,41 @@ IpSecEspInboundPacket (
   NextHeader        = 0;
 
   //
-  // Build netbuf from fragment table first.
+  // Get the esp size from the fragment table.
   //
-  Payload = NetbufFromExt (
-              (NET_FRAGMENT *) *FragmentTable,
-              *FragmentCount,
-              0,
-              sizeof (EFI_ESP_HEADER),
-              IpSecOnRecyclePacket,
-              NULL
-              );
-  if (Payload == NULL) {
-    Status = EFI_OUT_OF_RESOURCES;
+  EspSize = 0;
+  for (Index = 0; Index < *FragmentCount; Index++) {
+    EspSize += (*FragmentTable)[Index].FragmentLength;
+  }
+
+  if (EspSize < sizeof (EFI_ESP_HEADER)) {
+    Status = EFI_ACCESS_DENIED;
     goto ON_EXIT;
   }
 
   //
-  // Get the esp size and esp header from netbuf.
+  // Allocate buffer for decryption and authentication, and gather the
+  // fragments into it. The packet is then authenticated and decrypted in
+  // place in this buffer.
   //
-  EspSize   = Payload->TotalSize;
-  EspHeader = (EFI_ESP_HEADER *) NetbufGetByte (Payload, 0, NULL);
-
-  if (EspHeader == NULL) {
-    Status = EFI_ACCESS_DENIED;
+  ProcessBuffer = AllocatePool (EspSize);
+  if (ProcessBuffer == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
     goto ON_EXIT;
   }
 
+  EspSize = 0;
+  for (Index = 0; Index < *FragmentCount; Index++) {
+    CopyMem (
+      ProcessBuffer + EspSize,
+      (*FragmentTable)[Index].FragmentBuffer,
+      (*FragmentTable)[Index].FragmentLength
+      );
+    EspSize += (*FragmentTable)[Index].FragmentLength;
+  }
+
+  EspHeader = (EFI_ESP_HEADER *) ProcessBuffer;
+
   //
   // Parse destination address from ip header and found the related SAD Entry.
   //
@@ -1475,17 +1482,6 @@ IpSecEspInboundPacket (
     //
   }
 
-  //
-  // Allocate buffer for decryption and authentication.
-  //
-  ProcessBuffer = AllocateZeroPool (EspSize);
-  if (ProcessBuffer == NULL) {
-    Status = EFI_OUT_OF_RESOURCES;
-    goto ON_EXIT;
-  }
-
-  NetbufCopy (Payload, 0, (UINT32) EspSize, ProcessBuffer);
-
   //
   // Get the IcvSize for authentication and BlockSize/IvSize for Decryption.
   //
@@ -1526,10 +1522,9 @@ IpSecEspInboundPacket (
   // Decrypt the payload by the SAD entry if it has decrypt key.
   //
   if (SadData->AlgoInfo.EspAlgoInfo.EncKey != NULL) {
-    Status = IpSecCryptoIoDecrypt (
+    Status = IpSecCryptoIoDecryptWithContext (
                SadEntry->Data->AlgoInfo.EspAlgoInfo.EncAlgoId,
-               SadEntry->Data->AlgoInfo.EspAlgoInfo.EncKey,
-               SadEntry->Data->AlgoInfo.EspAlgoInfo.EncKeyLength << 3,
+               SadEntry->Data->EspContext,
                ProcessBuffer + sizeof (EFI_ESP_HEADER),
                ProcessBuffer + sizeof (EFI_ESP_HEADER) + IvSize,
                EspSize - sizeof (EFI_ESP_HEADER) - IvSize - IcvSize,
@@ -1640,10 +1635,6 @@ IpSecEspInboundPacket (
   *SpdSelector = SadData->SpdSelector;
 
 ON_EXIT:
-  if (Payload != NULL) {
-    NetbufFree (Payload);
-  }
-
   if (EFI_ERROR (Status)) {
     if (ProcessBuffer != NULL) {
       FreePool (ProcessBuffer);
@@ -1923,10 +1914,9 @@ IpSecEspOutboundPacket (
   // Encryption the payload (after iv) by the SAD entry if has encrypt key.
   //
   if (SadData->AlgoInfo.EspAlgoInfo.EncKey != NULL) {
-    Status = IpSecCryptoIoEncrypt (
+    Status = IpSecCryptoIoEncryptWithContext (
                SadEntry->Data->AlgoInfo.EspAlgoInfo.EncAlgoId,
-               SadEntry->Data->AlgoInfo.EspAlgoInfo.EncKey,
-               SadEntry->Data->AlgoInfo.EspAlgoInfo.EncKeyLength << 3,
+               SadEntry->Data->EspContext,
                (UINT8 *)(EspHeader + 1),
                RestOfPayload,
                EncryptSize,
@@ -1945,10 +1935,9 @@ IpSecEspOutboundPacket (
 
     HashFragment[0].Data     = ProcessBuffer;
     HashFragment[0].DataSize = EspSize - IcvSize;
-    Status = IpSecCryptoIoHmac (
+    Status = IpSecCryptoIoHmacWithContext (
                SadEntry->Data->AlgoInfo.EspAlgoInfo.AuthAlgoId,
-               SadEntry->Data->AlgoInfo.EspAlgoInfo.AuthKey,
-               SadEntry->Data->AlgoInfo.EspAlgoInfo.AuthKeyLength,
+               SadEntry->Data->EspContext,
                HashFragment,
                1,
                ProcessBuffer + EspSize - IcvSize,
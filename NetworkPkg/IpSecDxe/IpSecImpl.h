@@ -87,6 +87,17 @@ struct _IPSEC_SPD_ENTRY {
   LIST_ENTRY              List;
 };
 
+//
+// The cipher and HMAC contexts of an ESP SA. They are initialized with the
+// keys of the SA once, when the SA is added, instead of for every packet.
+//
+typedef struct _IPSEC_ESP_CONTEXT {
+  VOID                   *CipherContext;       // Cipher key schedule, NULL if no cipher
+  VOID                   *HmacInnerContext;    // Hash state after the HMAC inner pad
+  VOID                   *HmacOuterContext;    // Hash state after the HMAC outer pad
+  VOID                   *HashContext;         // Hash context used to process a packet
+} IPSEC_ESP_CONTEXT;
+
 typedef struct _IPSEC_SAD_DATA {
   EFI_IPSEC_MODE         Mode;
   UINT64                 SequenceNumber;
@@ -101,6 +112,7 @@ typedef struct _IPSEC_SAD_DATA {
   BOOLEAN                ManualSet;
   EFI_IP_ADDRESS         TunnelDestAddress;
   EFI_IP_ADDRESS         TunnelSourceAddress;
+  IPSEC_ESP_CONTEXT      *EspContext;
 } IPSEC_SAD_DATA;
 
 typedef struct _IPSEC_SAD_ENTRY {
@@ -19,7 +19,8 @@ CHAR8 *mMtftp6SupportedOptions[MTFTP6_SUPPORTED_OPTIONS_NUM] = {
   "blksize",
   "timeout",
   "tsize",
-  "multicast"
+  "multicast",
+  "windowsize"
 };
 
 
@@ -228,6 +229,19 @@ Mtftp6ParseExtensionOption (
 
       ExtInfo->BitMap |= MTFTP6_OPT_MCAST_BIT;
 
+    } else if (AsciiStriCmp ((CHAR8 *) Opt->OptionStr, "windowsize") == 0) {
+      //
+      // windowsize option (RFC 7440), valid value is between [1, 65535]
+      //
+      Value = (UINT32) AsciiStrDecimalToUintn ((CHAR8 *) Opt->ValueStr);
+
+      if (Value < 1 || Value > 65535) {
+        return EFI_INVALID_PARAMETER;
+      }
+
+      ExtInfo->WindowSize = (UINT16) Value;
+      ExtInfo->BitMap    |= MTFTP6_OPT_WINDOWSIZE_BIT;
+
     } else if (IsRequest) {
       //
       // If it's a request, unsupported; else if it's a reply, ignore.
@@ -56,10 +56,12 @@ Mtftp6RrqSendAck (
   Ack->Ack.Block[0]  = HTONS (BlockNum);
 
   //
-  // Reset current retry count of the instance.
+  // Reset current retry count of the instance. The ACK opens a new
+  // window of blocks on the server.
   //
-  Instance->CurRetry = 0;
+  Instance->CurRetry   = 0;
   Instance->LastPacket = Packet;
+  Instance->WindowBlks = 0;
 
   return Mtftp6TransmitPacket (Instance, Packet);
 }
@@ -234,6 +236,11 @@ Mtftp6RrqHandleData (
   // the last ACK then restart receiving. If we are passive, save
   // the block.
   //
+  // With a window larger than one block, the server keeps sending the
+  // rest of the window after a block is lost. ACK the last block received
+  // in order once, so that the server restarts the window from there,
+  // and ignore the remaining out-of-order blocks of that window.
+  //
   if (Instance->IsMaster && (Expected != BlockNum)) {
     //
     // Free the received packet before send new packet in ReceiveNotify,
@@ -242,7 +249,13 @@ Mtftp6RrqHandleData (
     NetbufFree (*UdpPacket);
     *UdpPacket = NULL;
 
-    Mtftp6TransmitPacket (Instance, Instance->LastPacket);
+    if (Instance->WindowSize == 1) {
+      Mtftp6TransmitPacket (Instance, Instance->LastPacket);
+    } else if (!Instance->IsWindowAcked) {
+      Instance->IsWindowAcked = TRUE;
+      Mtftp6RrqSendAck (Instance, (UINT16) (Expected - 1));
+    }
+
     return EFI_SUCCESS;
   }
 
@@ -252,11 +265,17 @@ Mtftp6RrqHandleData (
     return Status;
   }
 
+  Instance->IsWindowAcked = FALSE;
+  Instance->WindowBlks++;
+
   //
   // Reset the passive client's timer whenever it received a valid data packet.
+  // So does the active client within a window, as it doesn't ACK each block.
   //
   if (!Instance->IsMaster) {
     Instance->PacketToLive = Instance->Timeout * 2;
+  } else if (Instance->WindowBlks < Instance->WindowSize) {
+    Instance->PacketToLive = Instance->Timeout;
   }
 
   //
@@ -280,6 +299,13 @@ Mtftp6RrqHandleData (
 
     } else {
       BlockNum     = (UINT16) (Expected - 1);
+
+      //
+      // Only the last block of a window is acknowledged.
+      //
+      if (Instance->WindowBlks < Instance->WindowSize) {
+        return EFI_SUCCESS;
+      }
     }
     //
     // Free the received packet before send new packet in ReceiveNotify,
@@ -302,6 +328,7 @@ Mtftp6RrqHandleData (
   2. The server can only use smaller blksize than that is requested.
   3. The server can only use the same timeout as requested.
   4. The server doesn't change its multicast channel.
+  5. The server can only use smaller windowsize than that is requested.
 
   @param[in]  Instance              The pointer to the Mtftp6 instance.
   @param[in]  ReplyInfo             The pointer to options information in reply packet.
@@ -335,6 +362,10 @@ Mtftp6RrqOackValid (
     return FALSE;
   }
 
+  if (((ReplyInfo->BitMap & MTFTP6_OPT_WINDOWSIZE_BIT) != 0) && (ReplyInfo->WindowSize > RequestInfo->WindowSize)) {
+    return FALSE;
+  }
+
   //
   // The server can send ",,master" to client to change its master
   // setting. But if it use the specific multicast channel, it can't
@@ -625,6 +656,14 @@ Mtftp6RrqHandleOack (
       Instance->BlkSize = ExtInfo.BlkSize;
     }
 
+    //
+    // The window is only used for unicast download. Without the option
+    // in the OACK, the server falls back to one block per ACK.
+    //
+    if (ExtInfo.WindowSize != 0) {
+      Instance->WindowSize = ExtInfo.WindowSize;
+    }
+
     if (ExtInfo.Timeout != 0) {
       Instance->Timeout = ExtInfo.Timeout;
     }
@@ -939,6 +939,9 @@ Mtftp6OperationClean (
   Instance->McastPort      = 0;
   Instance->BlkSize        = 0;
   Instance->LastBlk        = 0;
+  Instance->WindowSize     = 0;
+  Instance->WindowBlks     = 0;
+  Instance->IsWindowAcked  = FALSE;
   Instance->PacketToLive   = 0;
   Instance->MaxRetry       = 0;
   Instance->CurRetry       = 0;
@@ -1025,6 +1028,14 @@ Mtftp6OperationStart (
     if (EFI_ERROR (Status)) {
       goto ON_ERROR;
     }
+
+    //
+    // Only the download is able to work with a window of blocks.
+    //
+    if (OpCode == EFI_MTFTP6_OPCODE_WRQ && (Instance->ExtInfo.BitMap & MTFTP6_OPT_WINDOWSIZE_BIT) != 0) {
+      Status = EFI_UNSUPPORTED;
+      goto ON_ERROR;
+    }
   }
 
   //
@@ -1064,6 +1075,9 @@ Mtftp6OperationStart (
   if (Instance->BlkSize == 0) {
     Instance->BlkSize = MTFTP6_DEFAULT_BLK_SIZE;
   }
+  if (Instance->WindowSize == 0) {
+    Instance->WindowSize = MTFTP6_DEFAULT_WINDOW_SIZE;
+  }
   if (Instance->MaxRetry == 0) {
     Instance->MaxRetry = MTFTP6_DEFAULT_MAX_RETRY;
   }
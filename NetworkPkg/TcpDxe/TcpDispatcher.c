@@ -125,7 +125,7 @@ Tcp4GetMode (
       Option->EnableTimeStamp        = (BOOLEAN) (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_TS));
       Option->EnableWindowScaling    = (BOOLEAN) (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_WS));
 
-      Option->EnableSelectiveAck     = FALSE;
+      Option->EnableSelectiveAck     = (BOOLEAN) (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK));
       Option->EnablePathMtuDiscovery = FALSE;
     }
   }
@@ -203,7 +203,7 @@ Tcp6GetMode (
       Option->EnableTimeStamp        = (BOOLEAN) (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_TS));
       Option->EnableWindowScaling    = (BOOLEAN) (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_WS));
 
-      Option->EnableSelectiveAck     = FALSE;
+      Option->EnableSelectiveAck     = (BOOLEAN) (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK));
       Option->EnablePathMtuDiscovery = FALSE;
     }
   }
@@ -569,6 +569,7 @@ TcpConfigurePcb (
     IsListEmpty (&Tcb->RcvQue));
 
   TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_NO_KEEPALIVE);
+  TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_NO_SACK);
   Tcb->State            = TCP_CLOSED;
 
   Tcb->SndMss           = 536;
@@ -581,6 +582,10 @@ TcpConfigurePcb (
   Tcb->Ssthresh         = 0xffffffff;
 
   Tcb->CongestState     = TCP_CONGEST_OPEN;
+  Tcb->CongestCtrl      = PcdGet8 (PcdTcpCongestionControl);
+  Tcb->CubicEpochOn     = FALSE;
+  Tcb->CubicWMax        = 0;
+  Tcb->SackNum          = 0;
 
   Tcb->KeepAliveIdle    = TCP_KEEPALIVE_IDLE_MIN;
   Tcb->KeepAlivePeriod  = TCP_KEEPALIVE_PERIOD;
@@ -721,6 +726,10 @@ TcpConfigurePcb (
     if (!Option->EnableWindowScaling) {
       TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_NO_WS);
     }
+
+    if (Option->EnableSelectiveAck) {
+      TCP_CLEAR_FLG (Tcb->CtrlFlag, TCP_CTRL_NO_SACK);
+    }
   }
 
   //
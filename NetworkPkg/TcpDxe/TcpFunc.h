@@ -366,6 +366,23 @@ TcpRetransmit (
   IN TCP_SEQNO Seq
   );
 
+/**
+  Retransmit the first hole in the SACK scoreboard from sequence Seq that
+  has not been retransmitted in the current recovery.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Seq     The sequence number to start the search from.
+
+  @retval TRUE     A hole is retransmitted.
+  @retval FALSE    There is no hole to retransmit, or an error condition occurred.
+
+**/
+BOOLEAN
+TcpSackRetransmit (
+  IN OUT TCP_CB    *Tcb,
+  IN     TCP_SEQNO Seq
+  );
+
 /**
   Check whether to send data/SYN/FIN and piggyback an ACK.
 
@@ -461,6 +478,19 @@ TcpVerifySegment (
 // Functions from TcpInput.c
 //
 
+/**
+  Compute the slow start threshold when a loss is detected.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+  @return          The new slow start threshold.
+
+**/
+UINT32
+TcpComputeSsthresh (
+  IN OUT TCP_CB *Tcb
+  );
+
 /**
   Process the received ICMP error messages for TCP.
 
@@ -59,10 +59,9 @@ TcpFastRecover (
     //
     // Step 1A: Invoking fast retransmission.
     //
-    FlightSize        = TCP_SUB_SEQ (Tcb->SndNxt, Tcb->SndUna);
-
-    Tcb->Ssthresh     = MAX (FlightSize >> 1, (UINT32) (2 * Tcb->SndMss));
+    Tcb->Ssthresh     = TcpComputeSsthresh (Tcb);
     Tcb->Recover      = Tcb->SndNxt;
+    Tcb->SackRexmit   = Tcb->SndUna;
 
     Tcb->CongestState = TCP_CONGEST_RECOVER;
     TCP_CLEAR_FLG (Tcb->CtrlFlag, TCP_CTRL_RTT_ON);
@@ -90,12 +89,20 @@ TcpFastRecover (
     //
     // Step 3: Fast Recovery,
     // If this is a duplicated ACK, increse Cwnd by SMSS.
+    // With SACK, a segment has left the network, use the
+    // room to retransmit the next hole reported lost
+    // instead, and only inflate the Cwnd if there is none.
     //
 
     // Step 4 is skipped here only to be executed later
     // by TcpToSendData
     //
-    Tcb->CWnd += Tcb->SndMss;
+    if (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_SACK) ||
+        !TcpSackRetransmit (Tcb, Tcb->SndUna)
+        ) {
+
+      Tcb->CWnd += Tcb->SndMss;
+    }
     DEBUG (
       (EFI_D_INFO,
       "TcpFastRecover: received another duplicated ACK (%d) for TCB %p\n",
@@ -132,9 +139,16 @@ TcpFastRecover (
       //
       // Step 5 - Partial ACK:
       // fast retransmit the first unacknowledge field
-      // , then deflate the CWnd
+      // , then deflate the CWnd. With SACK, retransmit
+      // the next hole not retransmitted yet.
       //
-      TcpRetransmit (Tcb, Seg->Ack);
+      if (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_SACK) ||
+          !TcpSackRetransmit (Tcb, Seg->Ack)
+          ) {
+
+        TcpRetransmit (Tcb, Seg->Ack);
+      }
+
       Acked = TCP_SUB_SEQ (Seg->Ack, Tcb->SndUna);
 
       //
@@ -198,9 +212,15 @@ TcpFastLossRecover (
 
       //
       // Partial ACK:
-      // fast retransmit the first unacknowledge field.
+      // fast retransmit the first unacknowledge field,
+      // or the next hole not retransmitted yet with SACK.
       //
-      TcpRetransmit (Tcb, Seg->Ack);
+      if (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_SACK) ||
+          !TcpSackRetransmit (Tcb, Seg->Ack)
+          ) {
+
+        TcpRetransmit (Tcb, Seg->Ack);
+      }
       DEBUG (
         (EFI_D_INFO,
         "TcpFastLossRecover: received a partial ACK(%d) for TCB %p\n",
@@ -274,6 +294,313 @@ TcpComputeRtt (
 
 }
 
+/**
+  Compute the slow start threshold when a loss is detected, RFC5681
+  and RFC8312. For CUBIC, the window reduction also ends the current
+  congestion avoidance epoch.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+  @return          The new slow start threshold.
+
+**/
+UINT32
+TcpComputeSsthresh (
+  IN OUT TCP_CB *Tcb
+  )
+{
+  UINT32  FlightSize;
+
+  FlightSize = TCP_SUB_SEQ (Tcb->SndNxt, Tcb->SndUna);
+
+  if (Tcb->CongestCtrl != TCP_CC_CUBIC) {
+    return MAX (FlightSize >> 1, (UINT32) (2 * Tcb->SndMss));
+  }
+
+  //
+  // Fast convergence: if the window didn't grow back to
+  // the last maximum, another flow is likely competing,
+  // release more bandwidth to it.
+  //
+  if (Tcb->CWnd < Tcb->CubicWMax) {
+    Tcb->CubicWMax = (UINT32) RShiftU64 (
+                                MultU64x32 (Tcb->CWnd, 1024 + TCP_CUBIC_BETA),
+                                11
+                                );
+  } else {
+    Tcb->CubicWMax = Tcb->CWnd;
+  }
+
+  Tcb->CubicEpochOn = FALSE;
+
+  return MAX (
+           (UINT32) RShiftU64 (MultU64x32 (FlightSize, TCP_CUBIC_BETA), 10),
+           (UINT32) (2 * Tcb->SndMss)
+           );
+}
+
+/**
+  Compute the integer cube root of a value.
+
+  @param[in]  Value    The value to compute the cube root of.
+
+  @return      The largest integer whose cube is not greater than Value.
+
+**/
+UINT32
+TcpCubicRoot (
+  IN UINT64 Value
+  )
+{
+  UINT32  Root;
+  UINT32  Bit;
+  UINT32  Try;
+
+  //
+  // (2^21)^3 is the largest cube fits in UINT64.
+  //
+  Root = 0;
+
+  for (Bit = 1 << 20; Bit != 0; Bit >>= 1) {
+    Try = Root | Bit;
+
+    if (MultU64x32 (MultU64x32 (Try, Try), Try) <= Value) {
+      Root = Try;
+    }
+  }
+
+  return Root;
+}
+
+/**
+  Compute how much the CUBIC congestion window grows for an ACK
+  received in congestion avoidance, RFC8312.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+  @return          The number of bytes to increase the congestion window by.
+
+**/
+UINT32
+TcpCubicIncrease (
+  IN OUT TCP_CB *Tcb
+  )
+{
+  UINT32  Mss;
+  UINT32  Elapsed;
+  UINT32  Delta;
+  UINT64  Offset;
+  UINT32  Target;
+
+  Mss = Tcb->SndMss;
+
+  //
+  // Start a new epoch. K is the time the cubic function
+  // takes to grow the window back to the origin point:
+  // K^3 = (WMax - CWnd) / C
+  //
+  if (!Tcb->CubicEpochOn) {
+    Tcb->CubicEpochOn = TRUE;
+    Tcb->CubicEpoch   = mTcpTick;
+    Tcb->CubicWEst    = Tcb->CWnd;
+
+    if (Tcb->CWnd < Tcb->CubicWMax) {
+      Tcb->CubicK       = TcpCubicRoot (
+                            DivU64x32 (
+                              MultU64x32 (Tcb->CubicWMax - Tcb->CWnd, TCP_CUBIC_C_DEN),
+                              TCP_CUBIC_C_NUM * Mss
+                              )
+                            );
+      Tcb->CubicOrigin  = Tcb->CubicWMax;
+    } else {
+      Tcb->CubicK       = 0;
+      Tcb->CubicOrigin  = Tcb->CWnd;
+    }
+  }
+
+  //
+  // The target is the cubic window one RTT later:
+  // W(t) = C * (t - K)^3 + Origin
+  //
+  Elapsed = TCP_SUB_TIME (mTcpTick, Tcb->CubicEpoch) + (Tcb->SRtt >> TCP_RTT_SHIFT);
+
+  if (Elapsed > Tcb->CubicK) {
+    Delta = MIN (Elapsed - Tcb->CubicK, TCP_CUBIC_MAX_TICKS);
+  } else {
+    Delta = MIN (Tcb->CubicK - Elapsed, TCP_CUBIC_MAX_TICKS);
+  }
+
+  Offset = DivU64x32 (
+             MultU64x32 (
+               MultU64x32 (MultU64x32 (Delta, Delta), Delta),
+               TCP_CUBIC_C_NUM * Mss
+               ),
+             TCP_CUBIC_C_DEN
+             );
+
+  if (Elapsed > Tcb->CubicK) {
+    Target = Tcb->CubicOrigin + (UINT32) MIN (Offset, TCP_MAX_WIN << TCP_OPTION_MAX_WS);
+  } else if (Offset < Tcb->CubicOrigin) {
+    Target = Tcb->CubicOrigin - (UINT32) Offset;
+  } else {
+    Target = 0;
+  }
+
+  //
+  // TCP friendly region: grow at least as fast as the
+  // standard TCP with the same decrease factor would, that
+  // is 3 * (1 - BETA) / (1 + BETA) segment per RTT.
+  //
+  Tcb->CubicWEst += MAX (
+                      (UINT32) DivU64x32 (
+                                 DivU64x32 (
+                                   MultU64x32 (MultU64x32 (Mss, Mss), 3 * (1024 - TCP_CUBIC_BETA)),
+                                   1024 + TCP_CUBIC_BETA
+                                   ),
+                                 Tcb->CWnd
+                                 ),
+                      1
+                      );
+
+  Target = MAX (Target, Tcb->CubicWEst);
+
+  //
+  // Don't grow more than half a segment for each ACK.
+  //
+  Target = MIN (Target, Tcb->CWnd + (Tcb->CWnd >> 1));
+
+  if (Target <= Tcb->CWnd) {
+    return MAX (Mss * Mss / Tcb->CWnd / 100, 1);
+  }
+
+  return MAX ((UINT32) DivU64x32 (MultU64x32 (Target - Tcb->CWnd, Mss), Tcb->CWnd), 1);
+}
+
+/**
+  Open the congestion window for an ACK of new data received in slow
+  start or congestion avoidance.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpOpenCongestWindow (
+  IN OUT TCP_CB *Tcb
+  )
+{
+  if (Tcb->CWnd < Tcb->Ssthresh) {
+
+    Tcb->CWnd += Tcb->SndMss;
+  } else if (Tcb->CongestCtrl == TCP_CC_CUBIC) {
+
+    Tcb->CWnd += TcpCubicIncrease (Tcb);
+  } else {
+
+    Tcb->CWnd += MAX (Tcb->SndMss * Tcb->SndMss / Tcb->CWnd, 1);
+  }
+
+  Tcb->CWnd = MIN (Tcb->CWnd, TCP_MAX_WIN << Tcb->SndWndScale);
+}
+
+/**
+  Update the SACK scoreboard with the SACK option received and the ACK,
+  RFC2018. Blocks below the ACK are removed, the others are kept sorted
+  and merged.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Option   Pointer to the options of the received segment.
+  @param[in]       Ack      The acknowledge sequence number of the received segment.
+
+**/
+VOID
+TcpSackUpdate (
+  IN OUT TCP_CB     *Tcb,
+  IN     TCP_OPTION *Option,
+  IN     TCP_SEQNO  Ack
+  )
+{
+  TCP_SACK_BLOCK  *Block;
+  TCP_SEQNO       Left;
+  TCP_SEQNO       Right;
+  UINT32          Index;
+  UINT32          Pos;
+  UINT32          Cur;
+
+  Block = Tcb->SackBlock;
+
+  //
+  // Insert the blocks received. Ignore the blocks below the
+  // ACK, such as the duplicate reports of RFC2883, and the
+  // blocks of the data not sent.
+  //
+  for (Index = 0; Index < Option->SackNum; Index++) {
+    Left  = Option->SackBlock[Index].Left;
+    Right = Option->SackBlock[Index].Right;
+
+    if (TCP_SEQ_LEQ (Right, Left) ||
+        TCP_SEQ_LEQ (Right, Ack) ||
+        TCP_SEQ_GT (Right, Tcb->SndNxt)
+        ) {
+
+      continue;
+    }
+
+    for (Pos = 0; Pos < Tcb->SackNum; Pos++) {
+      if (TCP_SEQ_LT (Left, Block[Pos].Left)) {
+        break;
+      }
+    }
+
+    //
+    // If the scoreboard is full, drop the highest block, the
+    // lost data are more likely to be found below.
+    //
+    if (Tcb->SackNum == TCP_SACK_MAX_BLOCK) {
+      if (Pos == TCP_SACK_MAX_BLOCK) {
+        continue;
+      }
+
+      Tcb->SackNum--;
+    }
+
+    CopyMem (&Block[Pos + 1], &Block[Pos], (Tcb->SackNum - Pos) * sizeof (TCP_SACK_BLOCK));
+    Block[Pos].Left  = Left;
+    Block[Pos].Right = Right;
+    Tcb->SackNum++;
+  }
+
+  //
+  // Trim the blocks by the ACK, and merge the overlapped ones.
+  //
+  Cur = 0;
+
+  for (Index = 0; Index < Tcb->SackNum; Index++) {
+    if (TCP_SEQ_LEQ (Block[Index].Right, Ack)) {
+      continue;
+    }
+
+    if (TCP_SEQ_LT (Block[Index].Left, Ack)) {
+      Block[Index].Left = Ack;
+    }
+
+    if ((Cur != 0) && TCP_SEQ_LEQ (Block[Index].Left, Block[Cur - 1].Right)) {
+      if (TCP_SEQ_GT (Block[Index].Right, Block[Cur - 1].Right)) {
+        Block[Cur - 1].Right = Block[Index].Right;
+      }
+
+      continue;
+    }
+
+    if (Cur != Index) {
+      CopyMem (&Block[Cur], &Block[Index], sizeof (TCP_SACK_BLOCK));
+    }
+
+    Cur++;
+  }
+
+  Tcb->SackNum = (UINT8) Cur;
+}
+
 /**
   Trim the data; SYN and FIN to fit into the window defined by Left and Right.
 
@@ -581,6 +908,11 @@ TcpQueueData (
   Seg   = TCPSEG_NETBUF (Nbuf);
   Head  = &Tcb->RcvQue;
 
+  //
+  // Remember the segment to report it first in the SACK option.
+  //
+  Tcb->RcvSackSeq = Seg->Seq;
+
   //
   // Fast path to process normal case. That is,
   // no out-of-order segments are received.
@@ -1192,6 +1524,10 @@ TcpInput (
     TCP_CLEAR_FLG (Tcb->CtrlFlag, TCP_CTRL_RTT_ON);
   }
 
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_SACK)) {
+    TcpSackUpdate (Tcb, &Option, Seg->Ack);
+  }
+
   if (Seg->Ack == Tcb->SndNxt) {
 
     TcpClearTimer (Tcb, TCP_TIMER_REXMIT);
@@ -1224,15 +1560,7 @@ TcpInput (
 
     if (TCP_SEQ_GT (Seg->Ack, Tcb->SndUna)) {
 
-      if (Tcb->CWnd < Tcb->Ssthresh) {
-
-        Tcb->CWnd += Tcb->SndMss;
-      } else {
-
-        Tcb->CWnd += MAX (Tcb->SndMss * Tcb->SndMss / Tcb->CWnd, 1);
-      }
-
-      Tcb->CWnd = MIN (Tcb->CWnd, TCP_MAX_WIN << Tcb->SndWndScale);
+      TcpOpenCongestWindow (Tcb);
     }
 
     if (Tcb->CongestState == TCP_CONGEST_LOSS) {
@@ -164,7 +164,7 @@ Tcp4Configure (
     }
 
     Option = TcpConfigData->ControlOption;
-    if ((NULL != Option) && (Option->EnableSelectiveAck || Option->EnablePathMtuDiscovery)) {
+    if ((NULL != Option) && Option->EnablePathMtuDiscovery) {
       return EFI_UNSUPPORTED;
     }
   }
@@ -679,7 +679,7 @@ Tcp6Configure (
     }
 
     Option = Tcp6ConfigData->ControlOption;
-    if ((NULL != Option) && (Option->EnableSelectiveAck || Option->EnablePathMtuDiscovery)) {
+    if ((NULL != Option) && Option->EnablePathMtuDiscovery) {
       return EFI_UNSUPPORTED;
     }
   }
@@ -68,6 +68,61 @@ TcpPutUint32 (
   CopyMem (Buf, &Data, sizeof (UINT32));
 }
 
+/**
+  Get the next range of contiguous out-of-order data in the reassemble queue.
+
+  @param[in]       Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[in, out]  Entry   On input, the last segment of the previous range, or
+                           the head of the reassemble queue to start from the
+                           beginning. On output, the last segment of the range.
+  @param[out]      Range   Pointer to the TCP_SACK_BLOCK to receive the range.
+
+  @retval TRUE             A range is returned.
+  @retval FALSE            There are no more out-of-order data.
+
+**/
+BOOLEAN
+TcpGetSackRange (
+  IN     TCP_CB         *Tcb,
+  IN OUT LIST_ENTRY     **Entry,
+     OUT TCP_SACK_BLOCK *Range
+  )
+{
+  LIST_ENTRY  *Cur;
+  TCP_SEG     *Seg;
+  BOOLEAN     Found;
+
+  Found = FALSE;
+
+  for (Cur = (*Entry)->ForwardLink; Cur != &Tcb->RcvQue; Cur = Cur->ForwardLink) {
+    Seg = TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Cur, NET_BUF, List));
+
+    //
+    // Segments not beyond RcvNxt aren't out of order, they
+    // will be delivered to the socket.
+    //
+    if (TCP_SEQ_LEQ (Seg->Seq, Tcb->RcvNxt)) {
+      continue;
+    }
+
+    if (!Found) {
+      Range->Left   = Seg->Seq;
+      Range->Right  = Seg->End;
+      Found         = TRUE;
+
+    } else if (Seg->Seq == Range->Right) {
+      Range->Right  = Seg->End;
+
+    } else {
+      break;
+    }
+
+    *Entry = Cur;
+  }
+
+  return Found;
+}
+
 /**
   Compute the window scale value according to the given buffer size.
 
@@ -165,6 +220,28 @@ TcpSynBuildOption (
     TcpPutUint32 (Data, TCP_OPTION_WS_FAST | TcpComputeScale (Tcb));
   }
 
+  //
+  // Build SACK permitted option, only when configured
+  // to send SACK option, and either we are doing active
+  // open or we have received SACK permitted option from peer.
+  //
+  if (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK) &&
+      (!TCP_FLG_ON (TCPSEG_NETBUF (Nbuf)->Flag, TCP_FLG_ACK) ||
+        TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK))
+      ) {
+
+    Data = NetbufAllocSpace (
+             Nbuf,
+             TCP_OPTION_SACK_PERM_ALIGNED_LEN,
+             NET_BUF_HEAD
+             );
+
+    ASSERT (Data != NULL);
+
+    Len += TCP_OPTION_SACK_PERM_ALIGNED_LEN;
+    TcpPutUint32 (Data, TCP_OPTION_SACK_PERM_FAST);
+  }
+
   //
   // Build the MSS option.
   //
@@ -192,8 +269,16 @@ TcpBuildOption (
   IN NET_BUF *Nbuf
   )
 {
-  UINT8   *Data;
-  UINT16  Len;
+  UINT8           *Data;
+  UINT16          Len;
+  LIST_ENTRY      *Entry;
+  TCP_SACK_BLOCK  Range;
+  TCP_SACK_BLOCK  Block[TCP_OPTION_MAX_SACK_BLOCK];
+  UINT32          Room;
+  UINT32          Max;
+  UINT32          Num;
+  UINT32          Index;
+  BOOLEAN         Found;
 
   ASSERT ((Tcb != NULL) && (Nbuf != NULL) && (Nbuf->Tcp == NULL));
   Len = 0;
@@ -219,6 +304,94 @@ TcpBuildOption (
     TcpPutUint32 (Data + 8, Tcb->TsRecent);
   }
 
+  //
+  // Build the SACK option to report the out-of-order data
+  // held in the reassemble queue.
+  //
+  if (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_SACK) ||
+      TCP_FLG_ON (TCPSEG_NETBUF (Nbuf)->Flag, TCP_FLG_RST) ||
+      IsListEmpty (&Tcb->RcvQue)
+      ) {
+
+    return Len;
+  }
+
+  //
+  // The blocks must fit in both the option space and the
+  // peer's MSS together with the data in the segment.
+  // SndMss has excluded the space taken by timestamp.
+  //
+  if (Nbuf->TotalSize - Len >= Tcb->SndMss) {
+    return Len;
+  }
+
+  Room = MIN (TCP_OPTION_MAX_LEN - Len, Tcb->SndMss - (Nbuf->TotalSize - Len));
+
+  if (Room < TCP_OPTION_SACK_ALIGNED_LEN + TCP_OPTION_SACK_BLOCK_LEN) {
+    return Len;
+  }
+
+  Max = MIN (
+          (Room - TCP_OPTION_SACK_ALIGNED_LEN) / TCP_OPTION_SACK_BLOCK_LEN,
+          TCP_OPTION_MAX_SACK_BLOCK
+          );
+
+  //
+  // RFC2018 requires the first block to report the most
+  // recently received segment, the others follow in the
+  // sequence order.
+  //
+  Num   = 0;
+  Found = FALSE;
+  Entry = &Tcb->RcvQue;
+
+  while (TcpGetSackRange (Tcb, &Entry, &Range)) {
+
+    if (TCP_SEQ_LEQ (Range.Left, Tcb->RcvSackSeq) &&
+        TCP_SEQ_LT (Tcb->RcvSackSeq, Range.Right)
+        ) {
+
+      Index = MIN (Num, Max - 1);
+      CopyMem (&Block[1], &Block[0], Index * sizeof (TCP_SACK_BLOCK));
+      CopyMem (&Block[0], &Range, sizeof (TCP_SACK_BLOCK));
+
+      Num   = Index + 1;
+      Found = TRUE;
+
+    } else if (Num < Max) {
+      CopyMem (&Block[Num], &Range, sizeof (TCP_SACK_BLOCK));
+      Num++;
+    }
+
+    if (Found && (Num == Max)) {
+      break;
+    }
+  }
+
+  if (Num == 0) {
+    return Len;
+  }
+
+  Data = NetbufAllocSpace (
+           Nbuf,
+           TCP_OPTION_SACK_ALIGNED_LEN + Num * TCP_OPTION_SACK_BLOCK_LEN,
+           NET_BUF_HEAD
+           );
+
+  ASSERT (Data != NULL);
+  Len = (UINT16) (Len + TCP_OPTION_SACK_ALIGNED_LEN + Num * TCP_OPTION_SACK_BLOCK_LEN);
+
+  TcpPutUint32 (Data, TCP_OPTION_SACK_FAST | (2 + Num * TCP_OPTION_SACK_BLOCK_LEN));
+
+  Data += TCP_OPTION_SACK_ALIGNED_LEN;
+
+  for (Index = 0; Index < Num; Index++) {
+    TcpPutUint32 (Data, Block[Index].Left);
+    TcpPutUint32 (Data + 4, Block[Index].Right);
+
+    Data += TCP_OPTION_SACK_BLOCK_LEN;
+  }
+
   return Len;
 }
 
@@ -244,10 +417,12 @@ TcpParseOption (
   UINT8 Cur;
   UINT8 Type;
   UINT8 Len;
+  UINT8 Index;
 
   ASSERT ((Tcp != NULL) && (Option != NULL));
 
-  Option->Flag  = 0;
+  Option->Flag    = 0;
+  Option->SackNum = 0;
 
   TotalLen      = (UINT8) ((Tcp->HeadLen << 2) - sizeof (TCP_HEAD));
   if (TotalLen <= 0) {
@@ -319,6 +494,45 @@ TcpParseOption (
       Cur += TCP_OPTION_TS_LEN;
       break;
 
+    case TCP_OPTION_SACK_PERM:
+      Len = Head[Cur + 1];
+
+      if ((Len != TCP_OPTION_SACK_PERM_LEN) || (TotalLen - Cur < TCP_OPTION_SACK_PERM_LEN)) {
+
+        return -1;
+      }
+
+      TCP_SET_FLG (Option->Flag, TCP_OPTION_RCVD_SACK_PERM);
+
+      Cur += TCP_OPTION_SACK_PERM_LEN;
+      break;
+
+    case TCP_OPTION_SACK:
+      Len = Head[Cur + 1];
+
+      if ((Len < 2 + TCP_OPTION_SACK_BLOCK_LEN) ||
+          ((Len - 2) % TCP_OPTION_SACK_BLOCK_LEN != 0) ||
+          (TotalLen - Cur < Len)
+          ) {
+
+        return -1;
+      }
+
+      Option->SackNum = (UINT8) MIN (
+                                  (Len - 2) / TCP_OPTION_SACK_BLOCK_LEN,
+                                  TCP_OPTION_MAX_SACK_BLOCK
+                                  );
+
+      for (Index = 0; Index < Option->SackNum; Index++) {
+        Option->SackBlock[Index].Left  = TcpGetUint32 (&Head[Cur + 2 + Index * TCP_OPTION_SACK_BLOCK_LEN]);
+        Option->SackBlock[Index].Right = TcpGetUint32 (&Head[Cur + 6 + Index * TCP_OPTION_SACK_BLOCK_LEN]);
+      }
+
+      TCP_SET_FLG (Option->Flag, TCP_OPTION_RCVD_SACK);
+
+      Cur = (UINT8) (Cur + Len);
+      break;
+
     case TCP_OPTION_NOP:
       Cur++;
       break;
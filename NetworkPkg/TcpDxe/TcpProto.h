@@ -60,6 +60,12 @@
 #define TCP_CONGEST_LOSS         2  ///< Retxmit because of retxmit time out.
 #define TCP_CONGEST_OPEN         3  ///< TCP is opening its congestion window.
 
+//
+// Congestion avoidance algorithms, selected per TCP instance.
+//
+#define TCP_CC_NEWRENO           0  ///< Additive increase of RFC5681.
+#define TCP_CC_CUBIC             1  ///< Cubic window growth of RFC8312.
+
 //
 // TCP control flags
 //
@@ -78,6 +84,9 @@
 #define TCP_CTRL_TIMER_ON        0x1000 ///< At least one of the timer is on.
 #define TCP_CTRL_RTT_ON          0x2000 ///< The RTT measurement is on.
 #define TCP_CTRL_ACK_NOW         0x4000 ///< Send the ACK now, don't delay.
+#define TCP_CTRL_NO_SACK         0x8000 ///< Disable SACK option.
+#define TCP_CTRL_RCVD_SACK       0x10000 ///< Received a SACK permitted option in syn.
+#define TCP_CTRL_SND_SACK        0x20000 ///< Send SACK option to remote.
 
 //
 // Timer related values
@@ -96,6 +105,17 @@
 #define TCP_RTO_MAX              (TCP_TICK_HZ * 60) ///< The maxium value of RTO.
 #define TCP_FOLD_RTT             4                  ///< Timeout threshod to fold RTT.
 
+//
+// CUBIC parameters. The time is measured in TCP ticks, so the
+// constant C = 0.4 segment/second^3 is expressed as a fraction
+// of segment/tick^3. BETA is the multiplicative decrease factor
+// 0.7 scaled by 1024.
+//
+#define TCP_CUBIC_BETA           717
+#define TCP_CUBIC_C_NUM          2
+#define TCP_CUBIC_C_DEN          (5 * TCP_TICK_HZ * TCP_TICK_HZ * TCP_TICK_HZ)
+#define TCP_CUBIC_MAX_TICKS      1024  ///< Limit of |t - K| to avoid overflow.
+
 //
 // Default values for some timers
 //
@@ -114,6 +134,11 @@
 //
 #define TCP_MAX_HEAD             192
 
+//
+// The max number of SACK blocks the sender remembers.
+//
+#define TCP_SACK_MAX_BLOCK       8
+
 //
 // Value ranges for some control option
 //
@@ -225,6 +250,14 @@ typedef struct _TCP_SEG {
   UINT32    Wnd;  ///< TCP window size field.
 } TCP_SEG;
 
+///
+/// A block of contiguous sequence space reported by a SACK option, RFC2018.
+///
+typedef struct _TCP_SACK_BLOCK {
+  TCP_SEQNO Left;   ///< The first sequence number of the block.
+  TCP_SEQNO Right;  ///< The sequence number immediately following the block.
+} TCP_SACK_BLOCK;
+
 ///
 /// Network endpoint, IP plus Port structure.
 ///
@@ -315,6 +348,25 @@ struct _TCP_CONTROL_BLOCK {
   UINT8             LossTimes;    ///< Number of retxmit timeouts in a row.
   TCP_SEQNO         LossRecover;  ///< Recover point for retxmit.
 
+  //
+  // RFC2018 variables, selective acknowledgment.
+  //
+  TCP_SACK_BLOCK    SackBlock[TCP_SACK_MAX_BLOCK]; ///< Data SACKed by the peer, sorted.
+  UINT8             SackNum;      ///< Number of valid blocks in SackBlock.
+  TCP_SEQNO         SackRexmit;   ///< Highest sequence retransmitted in recovery.
+  TCP_SEQNO         RcvSackSeq;   ///< Seq of the last segment queued for reassembly.
+
+  //
+  // RFC8312 variables, CUBIC congestion avoidance.
+  //
+  UINT8             CongestCtrl;  ///< Congestion avoidance algorithm, TCP_CC_*.
+  BOOLEAN           CubicEpochOn; ///< If TRUE, the current epoch is started.
+  UINT32            CubicEpoch;   ///< When the current epoch is started.
+  UINT32            CubicK;       ///< Ticks for the window to reach CubicOrigin.
+  UINT32            CubicOrigin;  ///< Plateau of the cubic function.
+  UINT32            CubicWMax;    ///< Window size just before the last reduction.
+  UINT32            CubicWEst;    ///< Window size estimated for standard TCP.
+
   //
   // configuration parameters, for EFI_TCP4_PROTOCOL specification
   //
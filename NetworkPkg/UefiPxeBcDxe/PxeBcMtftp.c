@@ -19,7 +19,8 @@ CHAR8 *mMtftpOptions[PXE_MTFTP_OPTION_MAXIMUM_INDEX] = {
   "blksize",
   "timeout",
   "tsize",
-  "multicast"
+  "multicast",
+  "windowsize"
 };
 
 
@@ -253,7 +254,7 @@ PxeBcMtftp6ReadFile (
 {
   EFI_MTFTP6_PROTOCOL                 *Mtftp6;
   EFI_MTFTP6_TOKEN                    Token;
-  EFI_MTFTP6_OPTION                   ReqOpt[1];
+  EFI_MTFTP6_OPTION                   ReqOpt[2];
   UINT32                              OptCnt;
   UINT8                               OptBuf[128];
   EFI_STATUS                          Status;
@@ -275,6 +276,16 @@ PxeBcMtftp6ReadFile (
     OptCnt++;
   }
 
+  //
+  // Ask the server to send a window of blocks for each ACK.
+  //
+  if (PcdGet64 (PcdTftpWindowSize) > 1) {
+    ReqOpt[OptCnt].OptionStr = (UINT8 *) mMtftpOptions[PXE_MTFTP_OPTION_WINDOWSIZE_INDEX];
+    ReqOpt[OptCnt].ValueStr  = (OptCnt == 0) ? OptBuf : (ReqOpt[0].ValueStr + AsciiStrLen ((CHAR8 *) ReqOpt[0].ValueStr) + 1);
+    PxeBcUintnToAscDec ((UINTN) PcdGet64 (PcdTftpWindowSize), ReqOpt[OptCnt].ValueStr);
+    OptCnt++;
+  }
+
   Token.Event         = NULL;
   Token.OverrideData  = NULL;
   Token.Filename      = Filename;
@@ -695,7 +706,7 @@ PxeBcMtftp4ReadFile (
 {
   EFI_MTFTP4_PROTOCOL *Mtftp4;
   EFI_MTFTP4_TOKEN    Token;
-  EFI_MTFTP4_OPTION   ReqOpt[1];
+  EFI_MTFTP4_OPTION   ReqOpt[2];
   UINT32              OptCnt;
   UINT8               OptBuf[128];
   EFI_STATUS          Status;
@@ -717,6 +728,16 @@ PxeBcMtftp4ReadFile (
     OptCnt++;
   }
 
+  //
+  // Ask the server to send a window of blocks for each ACK.
+  //
+  if (PcdGet64 (PcdTftpWindowSize) > 1) {
+    ReqOpt[OptCnt].OptionStr = (UINT8 *) mMtftpOptions[PXE_MTFTP_OPTION_WINDOWSIZE_INDEX];
+    ReqOpt[OptCnt].ValueStr  = (OptCnt == 0) ? OptBuf : (ReqOpt[0].ValueStr + AsciiStrLen ((CHAR8 *) ReqOpt[0].ValueStr) + 1);
+    PxeBcUintnToAscDec ((UINTN) PcdGet64 (PcdTftpWindowSize), ReqOpt[OptCnt].ValueStr);
+    OptCnt++;
+  }
+
   Token.Event         = NULL;
   Token.OverrideData  = NULL;
   Token.Filename      = Filename;
@@ -17,6 +17,206 @@
 #include <IndustryStandard/Acpi.h>
 #include <Library/BltLib.h>
 
+/**
+  Record that a rectangle of the shadow frame buffer was changed.
+
+  The rectangle is merged with a dirty rectangle it overlaps or touches. If
+  there is none and all the dirty rectangles are used, it is merged with the
+  dirty rectangle whose area grows least, so that the flush copies adjacent
+  changes in one pass.
+
+  @param  Private        The QEMU video device.
+  @param  X              The left edge of the changed rectangle.
+  @param  Y              The top edge of the changed rectangle.
+  @param  Width          The width of the changed rectangle.
+  @param  Height         The height of the changed rectangle.
+
+**/
+STATIC
+VOID
+QemuVideoAddDirtyRect (
+  IN  QEMU_VIDEO_PRIVATE_DATA  *Private,
+  IN  UINTN                    X,
+  IN  UINTN                    Y,
+  IN  UINTN                    Width,
+  IN  UINTN                    Height
+  )
+{
+  QEMU_VIDEO_RECT  Rect;
+  QEMU_VIDEO_RECT  *Dirty;
+  UINTN            Index;
+  UINTN            Best;
+  UINTN            Growth;
+  UINTN            BestGrowth;
+
+  Rect.X0 = X;
+  Rect.Y0 = Y;
+  Rect.X1 = X + Width;
+  Rect.Y1 = Y + Height;
+
+  //
+  // Merge the rectangle with the dirty rectangles it overlaps or touches,
+  // until it is disjoint from all of them.
+  //
+  Index = 0;
+  while (Index < Private->DirtyRectCount) {
+    Dirty = &Private->DirtyRect[Index];
+    if (Rect.X0 <= Dirty->X1 && Dirty->X0 <= Rect.X1 &&
+        Rect.Y0 <= Dirty->Y1 && Dirty->Y0 <= Rect.Y1) {
+      Rect.X0 = MIN (Rect.X0, Dirty->X0);
+      Rect.Y0 = MIN (Rect.Y0, Dirty->Y0);
+      Rect.X1 = MAX (Rect.X1, Dirty->X1);
+      Rect.Y1 = MAX (Rect.Y1, Dirty->Y1);
+      Private->DirtyRectCount--;
+      *Dirty = Private->DirtyRect[Private->DirtyRectCount];
+      Index = 0;
+      continue;
+    }
+    Index++;
+  }
+
+  if (Private->DirtyRectCount < QEMU_VIDEO_DIRTY_RECT_MAX) {
+    Private->DirtyRect[Private->DirtyRectCount++] = Rect;
+    return;
+  }
+
+  Best       = 0;
+  BestGrowth = MAX_UINTN;
+  for (Index = 0; Index < QEMU_VIDEO_DIRTY_RECT_MAX; Index++) {
+    Dirty  = &Private->DirtyRect[Index];
+    Growth = (MAX (Rect.X1, Dirty->X1) - MIN (Rect.X0, Dirty->X0)) *
+             (MAX (Rect.Y1, Dirty->Y1) - MIN (Rect.Y0, Dirty->Y0)) -
+             (Dirty->X1 - Dirty->X0) * (Dirty->Y1 - Dirty->Y0);
+    if (Growth < BestGrowth) {
+      Best       = Index;
+      BestGrowth = Growth;
+    }
+  }
+
+  Dirty     = &Private->DirtyRect[Best];
+  Dirty->X0 = MIN (Rect.X0, Dirty->X0);
+  Dirty->Y0 = MIN (Rect.Y0, Dirty->Y0);
+  Dirty->X1 = MAX (Rect.X1, Dirty->X1);
+  Dirty->Y1 = MAX (Rect.Y1, Dirty->Y1);
+}
+
+/**
+  Copy the dirty rectangles of the shadow frame buffer to the frame buffer.
+
+  The caller must be at TPL_NOTIFY, as Blt is.
+
+  @param  Private        The QEMU video device.
+
+**/
+STATIC
+VOID
+QemuVideoFlushShadowBuffer (
+  IN  QEMU_VIDEO_PRIVATE_DATA  *Private
+  )
+{
+  EFI_GRAPHICS_OUTPUT_PROTOCOL_MODE  *Mode;
+  QEMU_VIDEO_RECT                    *Dirty;
+  UINT8                              *FrameBuffer;
+  UINTN                              BytesPerPixel;
+  UINTN                              BytesPerScanLine;
+  UINTN                              Offset;
+  UINTN                              Index;
+  UINTN                              Y;
+
+  if (Private->ShadowBuffer == NULL || Private->DirtyRectCount == 0) {
+    return;
+  }
+
+  Mode             = Private->GraphicsOutput.Mode;
+  FrameBuffer      = (UINT8 *) (UINTN) Mode->FrameBufferBase;
+  BytesPerPixel    = (Private->ModeData[Mode->Mode].ColorDepth + 7) / 8;
+  BytesPerScanLine = Mode->Info->PixelsPerScanLine * BytesPerPixel;
+
+  for (Index = 0; Index < Private->DirtyRectCount; Index++) {
+    Dirty  = &Private->DirtyRect[Index];
+    Offset = Dirty->Y0 * BytesPerScanLine + Dirty->X0 * BytesPerPixel;
+    if (Dirty->X0 == 0 && Dirty->X1 == Mode->Info->HorizontalResolution) {
+      //
+      // Full scan lines are contiguous, copy them at once
+      //
+      CopyMem (
+        FrameBuffer + Offset,
+        Private->ShadowBuffer + Offset,
+        (Dirty->Y1 - Dirty->Y0) * BytesPerScanLine
+        );
+      continue;
+    }
+
+    for (Y = Dirty->Y0; Y < Dirty->Y1; Y++) {
+      CopyMem (
+        FrameBuffer + Offset,
+        Private->ShadowBuffer + Offset,
+        (Dirty->X1 - Dirty->X0) * BytesPerPixel
+        );
+      Offset += BytesPerScanLine;
+    }
+  }
+
+  Private->DirtyRectCount = 0;
+}
+
+/**
+  Periodic timer notification function copying the dirty rectangles of the
+  shadow frame buffer to the frame buffer.
+
+  @param  Event          The periodic timer event.
+  @param  Context        The QEMU video device.
+
+**/
+STATIC
+VOID
+EFIAPI
+QemuVideoFlushShadowBufferEvent (
+  IN  EFI_EVENT  Event,
+  IN  VOID       *Context
+  )
+{
+  EFI_TPL  OriginalTPL;
+
+  OriginalTPL = gBS->RaiseTPL (TPL_NOTIFY);
+  QemuVideoFlushShadowBuffer (Context);
+  gBS->RestoreTPL (OriginalTPL);
+}
+
+/**
+  Exit boot services notification function. The operating system takes the
+  frame buffer over, so the pending changes are copied to it and Blt draws
+  directly in it from now on.
+
+  @param  Event          The exit boot services event.
+  @param  Context        The QEMU video device.
+
+**/
+STATIC
+VOID
+EFIAPI
+QemuVideoExitBootServicesEvent (
+  IN  EFI_EVENT  Event,
+  IN  VOID       *Context
+  )
+{
+  QEMU_VIDEO_PRIVATE_DATA  *Private;
+
+  Private = Context;
+
+  gBS->SetTimer (Private->FlushEvent, TimerCancel, 0);
+  QemuVideoFlushShadowBuffer (Private);
+
+  //
+  // The shadow buffer is not freed, the memory map must not change here
+  //
+  Private->ShadowBuffer = NULL;
+  BltLibConfigure (
+    (VOID*)(UINTN) Private->GraphicsOutput.Mode->FrameBufferBase,
+    Private->GraphicsOutput.Mode->Info
+    );
+}
+
 STATIC
 VOID
 QemuVideoCompleteModeInfo (
@@ -200,10 +400,41 @@ Routine Description:
 
   QemuVideoCompleteModeData (Private, This->Mode);
 
-  BltLibConfigure (
-    (VOID*)(UINTN) This->Mode->FrameBufferBase,
-    This->Mode->Info
-    );
+  //
+  // The pending changes of the previous mode are lost with it. Size the
+  // shadow frame buffer for the new mode, and have the first flush bring
+  // the frame buffer to its (cleared) content. Without a shadow frame
+  // buffer, Blt draws directly in the frame buffer.
+  //
+  Private->DirtyRectCount = 0;
+  if (Private->FlushEvent != NULL &&
+      Private->ShadowBufferSize != (UINTN) This->Mode->FrameBufferSize) {
+    if (Private->ShadowBuffer != NULL) {
+      FreePool (Private->ShadowBuffer);
+    }
+    Private->ShadowBufferSize = (UINTN) This->Mode->FrameBufferSize;
+    Private->ShadowBuffer     = AllocatePool (Private->ShadowBufferSize);
+    if (Private->ShadowBuffer == NULL) {
+      Private->ShadowBufferSize = 0;
+    }
+  }
+
+  if (Private->ShadowBuffer != NULL) {
+    ZeroMem (Private->ShadowBuffer, Private->ShadowBufferSize);
+    QemuVideoAddDirtyRect (
+      Private,
+      0,
+      0,
+      ModeData->HorizontalResolution,
+      ModeData->VerticalResolution
+      );
+    BltLibConfigure (Private->ShadowBuffer, This->Mode->Info);
+  } else {
+    BltLibConfigure (
+      (VOID*)(UINTN) This->Mode->FrameBufferBase,
+      This->Mode->Info
+      );
+  }
 
   return EFI_SUCCESS;
 }
@@ -253,6 +484,9 @@ Returns:
 {
   EFI_STATUS                      Status;
   EFI_TPL                         OriginalTPL;
+  QEMU_VIDEO_PRIVATE_DATA         *Private;
+
+  Private = QEMU_VIDEO_PRIVATE_DATA_FROM_GRAPHICS_OUTPUT_THIS (This);
 
   //
   // We have to raise to TPL Notify, so we make an atomic write the frame buffer.
@@ -277,6 +511,10 @@ Returns:
       Height,
       Delta
       );
+    if (!EFI_ERROR (Status) && Private->ShadowBuffer != NULL &&
+        BltOperation != EfiBltVideoToBltBuffer) {
+      QemuVideoAddDirtyRect (Private, DestinationX, DestinationY, Width, Height);
+    }
     break;
 
   default:
@@ -326,13 +564,53 @@ QemuVideoGraphicsOutputConstructor (
   Private->GraphicsOutput.Mode->MaxMode = (UINT32) Private->MaxMode;
   Private->GraphicsOutput.Mode->Mode    = GRAPHICS_OUTPUT_INVALIDE_MODE_NUMBER;
   Private->LineBuffer                   = NULL;
+  Private->ShadowBuffer                 = NULL;
+  Private->ShadowBufferSize             = 0;
+  Private->DirtyRectCount               = 0;
+  Private->FlushEvent                   = NULL;
+  Private->ExitBootServicesEvent        = NULL;
+
+  if (FeaturePcdGet (PcdQemuVideoShadowFrameBuffer)) {
+    Status = gBS->CreateEvent (
+                    EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                    TPL_CALLBACK,
+                    QemuVideoFlushShadowBufferEvent,
+                    Private,
+                    &Private->FlushEvent
+                    );
+    if (EFI_ERROR (Status)) {
+      goto FreeInfo;
+    }
+
+    Status = gBS->CreateEvent (
+                    EVT_SIGNAL_EXIT_BOOT_SERVICES,
+                    TPL_NOTIFY,
+                    QemuVideoExitBootServicesEvent,
+                    Private,
+                    &Private->ExitBootServicesEvent
+                    );
+    if (EFI_ERROR (Status)) {
+      goto CloseFlushEvent;
+    }
+  }
 
   //
   // Initialize the hardware
   //
   Status = GraphicsOutput->SetMode (GraphicsOutput, 0);
   if (EFI_ERROR (Status)) {
-    goto FreeInfo;
+    goto CloseEvents;
+  }
+
+  if (Private->FlushEvent != NULL) {
+    Status = gBS->SetTimer (
+                    Private->FlushEvent,
+                    TimerPeriodic,
+                    QEMU_VIDEO_SHADOW_FLUSH_PERIOD
+                    );
+    if (EFI_ERROR (Status)) {
+      goto CloseEvents;
+    }
   }
 
   DrawLogo (
@@ -343,6 +621,26 @@ QemuVideoGraphicsOutputConstructor (
 
   return EFI_SUCCESS;
 
+CloseEvents:
+  if (Private->ShadowBuffer != NULL) {
+    FreePool (Private->ShadowBuffer);
+    Private->ShadowBuffer = NULL;
+  }
+  if (Private->LineBuffer != NULL) {
+    FreePool (Private->LineBuffer);
+    Private->LineBuffer = NULL;
+  }
+  if (Private->ExitBootServicesEvent != NULL) {
+    gBS->CloseEvent (Private->ExitBootServicesEvent);
+    Private->ExitBootServicesEvent = NULL;
+  }
+
+CloseFlushEvent:
+  if (Private->FlushEvent != NULL) {
+    gBS->CloseEvent (Private->FlushEvent);
+    Private->FlushEvent = NULL;
+  }
+
 FreeInfo:
   FreePool (Private->GraphicsOutput.Mode->Info);
 
@@ -369,6 +667,26 @@ Returns:
 
 --*/
 {
+  EFI_TPL  OriginalTPL;
+
+  if (Private->FlushEvent != NULL) {
+    gBS->CloseEvent (Private->FlushEvent);
+    Private->FlushEvent = NULL;
+  }
+
+  if (Private->ExitBootServicesEvent != NULL) {
+    gBS->CloseEvent (Private->ExitBootServicesEvent);
+    Private->ExitBootServicesEvent = NULL;
+  }
+
+  if (Private->ShadowBuffer != NULL) {
+    OriginalTPL = gBS->RaiseTPL (TPL_NOTIFY);
+    QemuVideoFlushShadowBuffer (Private);
+    gBS->RestoreTPL (OriginalTPL);
+    FreePool (Private->ShadowBuffer);
+    Private->ShadowBuffer = NULL;
+  }
+
   if (Private->LineBuffer != NULL) {
     FreePool (Private->LineBuffer);
   }
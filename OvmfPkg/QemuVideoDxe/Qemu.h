@@ -81,6 +81,25 @@ typedef struct {
 
 #define GRAPHICS_OUTPUT_INVALIDE_MODE_NUMBER  0xffff
 
+//
+// When PcdQemuVideoShadowFrameBuffer is TRUE, Blt operates on a copy of the
+// frame buffer in normal memory. The rectangles it changes are copied to the
+// frame buffer every QEMU_VIDEO_SHADOW_FLUSH_PERIOD (in 100ns units), and
+// when the driver stops or boot services exit.
+//
+#define QEMU_VIDEO_DIRTY_RECT_MAX             8
+#define QEMU_VIDEO_SHADOW_FLUSH_PERIOD        (20 * 10000)
+
+//
+// A rectangle of the screen, from (X0, Y0) included to (X1, Y1) excluded.
+//
+typedef struct {
+  UINTN                                 X0;
+  UINTN                                 Y0;
+  UINTN                                 X1;
+  UINTN                                 Y1;
+} QEMU_VIDEO_RECT;
+
 //
 // QEMU Video Private Data Structure
 //
@@ -119,6 +138,17 @@ typedef struct {
 
   UINT8                                 *LineBuffer;
   QEMU_VIDEO_VARIANT                    Variant;
+
+  //
+  // Shadow frame buffer and the rectangles of it not yet copied to the
+  // frame buffer.
+  //
+  UINT8                                 *ShadowBuffer;
+  UINTN                                 ShadowBufferSize;
+  QEMU_VIDEO_RECT                       DirtyRect[QEMU_VIDEO_DIRTY_RECT_MAX];
+  UINTN                                 DirtyRectCount;
+  EFI_EVENT                             FlushEvent;
+  EFI_EVENT                             ExitBootServicesEvent;
 } QEMU_VIDEO_PRIVATE_DATA;
 
 ///